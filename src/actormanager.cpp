@@ -75,9 +75,21 @@
 #define for_actors for (ActorSpritesConstIterator it = mActors.begin(), \
     it_fend = mActors.end(); it != it_fend; ++it)
 
-#define for_actorsm for (ActorSpritesIterator it = mActors.begin(), \
+#define for_actorsm for (ActorSpritesConstIterator it = mActors.begin(), \
     it_fend = mActors.end(); it != it_fend; ++it)
 
+#define for_grid_actors for (STD_VECTOR<ActorSprite*>::const_iterator \
+    it = gridActors.begin(), it_fend = gridActors.end(); \
+    it != it_fend; ++it)
+
+namespace
+{
+    // beings drawn with offset from own tile while walking or on heights
+    const int pixelTilesMargin = 2;
+    // actors in this distance from screen border in tiles not culled
+    const int cullTilesMargin = 6;
+}  // namespace
+
 ActorManager *actorManager = nullptr;
 
 class FindBeingFunctor final
@@ -137,19 +149,10 @@ class SortBeingFunctor final
             if ((being1 == nullptr) || (being2 == nullptr))
                 return false;
 
-            if (priorityBeings != nullptr)
+            if (filter != nullptr)
             {
-                int w1 = defaultPriorityIndex;
-                int w2 = defaultPriorityIndex;
-                const StringIntMapCIter it1 = priorityBeings->find(
-                    being1->getName());
-                const StringIntMapCIter it2 = priorityBeings->find(
-                    being2->getName());
-                if (it1 != priorityBeings->end())
-                    w1 = (*it1).second;
-                if (it2 != priorityBeings->end())
-                    w2 = (*it2).second;
-
+                const int w1 = filter->getPriorityIndex(being1);
+                const int w2 = filter->getPriorityIndex(being2);
                 if (w1 != w2)
                     return w1 < w2;
             }
@@ -177,31 +180,19 @@ class SortBeingFunctor final
 
             if (d1 != d2)
                 return d1 < d2;
-            if (attackBeings != nullptr)
+            if (filter != nullptr)
             {
-                int w1 = defaultAttackIndex;
-                int w2 = defaultAttackIndex;
-                const StringIntMapCIter it1 = attackBeings->find(
-                    being1->getName());
-                const StringIntMapCIter it2 = attackBeings->find(
-                    being2->getName());
-                if (it1 != attackBeings->end())
-                    w1 = (*it1).second;
-                if (it2 != attackBeings->end())
-                    w2 = (*it2).second;
-
+                const int w1 = filter->getAttackIndex(being1);
+                const int w2 = filter->getAttackIndex(being2);
                 if (w1 != w2)
                     return w1 < w2;
             }
 
             return being1->getName() < being2->getName();
         }
-        StringIntMap *attackBeings;
-        StringIntMap *priorityBeings;
+        const TargetFilter *filter;
         int x;
         int y;
-        int defaultAttackIndex;
-        int defaultPriorityIndex;
         int attackRange;
         bool specialDistance;
 } beingActorSorter;
@@ -209,7 +200,9 @@ class SortBeingFunctor final
 ActorManager::ActorManager() :
     mActors(),
     mDeleteActors(),
-    mActorsIdMap(),
+    mEraseActors(),
+    mGrid(),
+    mGridActors(),
     mIdName(),
     mBlockedBeings(),
     mChars(),
@@ -226,6 +219,10 @@ ActorManager::ActorManager() :
     mCycleNPC(config.getBoolValue("cycleNPC")),
     mExtMouseTargeting(config.getBoolValue("extMouseTargeting")),
     mEnableIdCollecting(config.getBoolValue("enableIdCollecting")),
+    mEnableLogicCulling(config.getBoolValue("enableLogicCulling")),
+    mInLogic(false),
+    mFullLogicCount(0),
+    mCulledLogicCount(0),
     mPriorityAttackMobs(),
     mPriorityAttackMobsSet(),
     mPriorityAttackMobsMap(),
@@ -238,7 +235,8 @@ ActorManager::ActorManager() :
     mPickupItemsSet(),
     mPickupItemsMap(),
     mIgnorePickupItems(),
-    mIgnorePickupItemsSet()
+    mIgnorePickupItemsSet(),
+    mAttackFilter()
 {
     config.addListener("targetDeadPlayers", this);
     config.addListener("targetOnlyReachable", this);
@@ -249,6 +247,7 @@ ActorManager::ActorManager() :
     config.addListener("showBadges", this);
     config.addListener("enableIdCollecting", this);
     config.addListener("visiblenamespos", this);
+    config.addListener("enableLogicCulling", this);
 
     loadAttackList();
 }
@@ -272,8 +271,8 @@ void ActorManager::setMap(Map *const map)
 void ActorManager::setPlayer(LocalPlayer *const player)
 {
     localPlayer = player;
-    mActors.insert(player);
-    mActorsIdMap[player->getId()] = player;
+    mActors.add(player);
+    mGrid.add(player);
     if (socialWindow != nullptr)
         socialWindow->updateAttackFilter();
     if (socialWindow != nullptr)
@@ -289,9 +288,8 @@ Being *ActorManager::createBeing(const BeingId id,
         subtype,
         mMap);
 
-    mActors.insert(being);
-
-    mActorsIdMap[being->getId()] = being;
+    mActors.add(being);
+    mGrid.add(being);
 
     switch (type)
     {
@@ -375,8 +373,8 @@ FloorItem *ActorManager::createItem(const BeingId id,
 
     if (!checkForPickup(floorItem))
         floorItem->disableHightlight();
-    mActors.insert(floorItem);
-    mActorsIdMap[floorItem->getId()] = floorItem;
+    mActors.add(floorItem);
+    mGrid.add(floorItem);
     return floorItem;
 }
 
@@ -397,10 +395,16 @@ void ActorManager::erase(ActorSprite *const actor)
     if (actor == localPlayer)
         return;
 
-    mActors.erase(actor);
-    const ActorSpritesMapIterator it = mActorsIdMap.find(actor->getId());
-    if (it != mActorsIdMap.end() && (*it).second == actor)
-        mActorsIdMap.erase(it);
+    // removal moves last actor to removed position, so while logic
+    // iterates actors by index it delayed to end of logic
+    if (mInLogic)
+    {
+        mEraseActors.push_back(actor);
+        return;
+    }
+
+    mActors.remove(actor);
+    mGrid.remove(actor);
 }
 
 void ActorManager::undelete(const ActorSprite *const actor)
@@ -410,7 +414,7 @@ void ActorManager::undelete(const ActorSprite *const actor)
     if (actor == localPlayer)
         return;
 
-    FOR_EACH (ActorSpritesConstIterator, it, mDeleteActors)
+    FOR_EACH (ActorSpritesSetConstIterator, it, mDeleteActors)
     {
         if (*it == actor)
         {
@@ -420,37 +424,57 @@ void ActorManager::undelete(const ActorSprite *const actor)
     }
 }
 
+void ActorManager::updateActorPosition(ActorSprite *const actor)
+{
+    returnNullptrV(actor)
+    mGrid.update(actor);
+}
+
+void ActorManager::getActorsByPixel(STD_VECTOR<ActorSprite*> &actors,
+                                    const int x1, const int y1,
+                                    const int x2, const int y2) const
+{
+    // beings on heights drawn higher than own tile
+    mGrid.getActors(actors,
+        x1 / mapTileSize - pixelTilesMargin,
+        y1 / mapTileSize - pixelTilesMargin,
+        x2 / mapTileSize + pixelTilesMargin,
+        y2 / mapTileSize + pixelTilesMargin * 2);
+}
+
 Being *ActorManager::findBeing(const BeingId id) const
 {
-    const ActorSpritesMapConstIterator it = mActorsIdMap.find(id);
-    if (it != mActorsIdMap.end())
+    ActorSprite *const actor = mActors.findById(id);
+    if ((actor != nullptr) &&
+        actor->getId() == id &&
+        actor->getType() != ActorType::FloorItem)
     {
-        ActorSprite *const actor = (*it).second;
-        if ((actor != nullptr) &&
-            actor->getId() == id &&
-            actor->getType() != ActorType::FloorItem)
-        {
-            return static_cast<Being*>(actor);
-        }
+        return static_cast<Being*>(actor);
     }
     return nullptr;
 }
 
 ActorSprite *ActorManager::findActor(const BeingId id) const
 {
-    const ActorSpritesMapConstIterator it = mActorsIdMap.find(id);
-    if (it != mActorsIdMap.end())
+    ActorSprite *const actor = mActors.findById(id);
+    if ((actor != nullptr) &&
+        actor->getId() == id)
     {
-        ActorSprite *const actor = (*it).second;
-        if ((actor != nullptr) &&
-            actor->getId() == id)
-        {
-            return actor;
-        }
+        return actor;
     }
     return nullptr;
 }
 
+ActorHandle ActorManager::getActorHandle(const ActorSprite *const actor) const
+{
+    return mActors.getHandle(actor);
+}
+
+ActorSprite *ActorManager::findActor(const ActorHandle &handle) const
+{
+    return mActors.get(handle);
+}
+
 Being *ActorManager::findBeing(const int x, const int y,
                                const ActorTypeT type) const
 {
@@ -458,10 +482,15 @@ Being *ActorManager::findBeing(const int x, const int y,
     beingActorFinder.y = CAST_U16(y);
     beingActorFinder.type = type;
 
-    const ActorSpritesConstIterator it = std::find_if(
-        mActors.begin(), mActors.end(), beingActorFinder);
+    STD_VECTOR<ActorSprite*> &gridActors = mGridActors;
+    gridActors.clear();
+    getActorsByPixel(gridActors,
+        x * mapTileSize, y * mapTileSize,
+        (x + 1) * mapTileSize - 1, (y + 2) * mapTileSize - 1);
+    const STD_VECTOR<ActorSprite*>::const_iterator it = std::find_if(
+        gridActors.begin(), gridActors.end(), beingActorFinder);
 
-    return (it == mActors.end()) ? nullptr : static_cast<Being*>(*it);
+    return (it == gridActors.end()) ? nullptr : static_cast<Being*>(*it);
 }
 
 Being *ActorManager::findBeingByPixel(const int x, const int y,
@@ -474,12 +503,18 @@ Being *ActorManager::findBeingByPixel(const int x, const int y,
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
 
+    STD_VECTOR<ActorSprite*> &gridActors = mGridActors;
+    gridActors.clear();
+    getActorsByPixel(gridActors,
+        x - mapTileSize, y - mapTileSize / 2,
+        x + mapTileSize, y + mapTileSize * 2);
+
     if (mExtMouseTargeting)
     {
         Being *tempBeing = nullptr;
         bool noBeing(false);
 
-        for_actorsm
+        for_grid_actors
         {
 // disabled for performance
 //            if (reportTrue(*it == nullptr))
@@ -546,7 +581,7 @@ Being *ActorManager::findBeingByPixel(const int x, const int y,
             return nullptr;
         return tempBeing;
     }
-    for_actorsm
+    for_grid_actors
     {
 // disabled for performance
 //            if (reportTrue(*it == nullptr))
@@ -591,7 +626,13 @@ void ActorManager::findBeingsByPixel(STD_VECTOR<ActorSprite*> &beings,
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
 
-    for_actors
+    STD_VECTOR<ActorSprite*> &gridActors = mGridActors;
+    gridActors.clear();
+    getActorsByPixel(gridActors,
+        x - xtol, y,
+        x + xtol, y + uptol);
+
+    for_grid_actors
     {
         ActorSprite *const actor = *it;
 
@@ -658,7 +699,11 @@ Being *ActorManager::findPortalByTile(const int x, const int y) const
     if (mMap == nullptr)
         return nullptr;
 
-    for_actorsm
+    STD_VECTOR<ActorSprite*> &gridActors = mGridActors;
+    gridActors.clear();
+    mGrid.getActors(gridActors, x, y, x, y);
+
+    for_grid_actors
     {
 // disabled for performance
 //        if (reportTrue(*it == nullptr))
@@ -678,23 +723,23 @@ Being *ActorManager::findPortalByTile(const int x, const int y) const
 
 FloorItem *ActorManager::findItem(const BeingId id) const
 {
-    const ActorSpritesMapConstIterator it = mActorsIdMap.find(id);
-    if (it != mActorsIdMap.end())
+    ActorSprite *const actor = mActors.findById(id);
+    if ((actor != nullptr) &&
+        actor->getId() == id &&
+        actor->getType() == ActorType::FloorItem)
     {
-        ActorSprite *const actor = (*it).second;
-        returnNullptr(nullptr, actor)
-        if (actor->getId() == id &&
-            actor->getType() == ActorType::FloorItem)
-        {
-            return static_cast<FloorItem*>(actor);
-        }
+        return static_cast<FloorItem*>(actor);
     }
     return nullptr;
 }
 
 FloorItem *ActorManager::findItem(const int x, const int y) const
 {
-    for_actorsm
+    STD_VECTOR<ActorSprite*> &gridActors = mGridActors;
+    gridActors.clear();
+    mGrid.getActors(gridActors, x, y, x, y);
+
+    for_grid_actors
     {
 // disabled for performance
 //        if (reportTrue(*it == nullptr))
@@ -720,9 +765,13 @@ bool ActorManager::pickUpAll(const int x1, const int y1,
     bool finded(false);
     const bool allowAll = mPickupItemsSet.find(std::string()) !=
         mPickupItemsSet.end();
+
+    STD_VECTOR<ActorSprite*> &gridActors = mGridActors;
+    gridActors.clear();
+    mGrid.getActors(gridActors, x1, y1, x2, y2);
     if (!serverBuggy)
     {
-        for_actorsm
+        for_grid_actors
         {
 // disabled for performance
 //            if (reportTrue(*it == nullptr))
@@ -758,7 +807,7 @@ bool ActorManager::pickUpAll(const int x1, const int y1,
     {
         FloorItem *item = nullptr;
         unsigned cnt = 65535;
-        for_actorsm
+        for_grid_actors
         {
 // disabled for performance
 //            if (reportTrue(*it == nullptr))
@@ -816,13 +865,20 @@ bool ActorManager::pickUpNearest(const int x, const int y,
     if (localPlayer == nullptr)
         return false;
 
+    // nearest item outside of radius will be not picked up anyway
+    STD_VECTOR<ActorSprite*> &gridActors = mGridActors;
+    gridActors.clear();
+    mGrid.getActors(gridActors,
+        x - maxdist, y - maxdist,
+        x + maxdist, y + maxdist);
+
     maxdist = maxdist * maxdist;
     FloorItem *closestItem = nullptr;
     int dist = 0;
     const bool allowAll = mPickupItemsSet.find(std::string()) !=
         mPickupItemsSet.end();
 
-    for_actorsm
+    for_grid_actors
     {
 // disabled for performance
 //        if (reportTrue(*it == nullptr))
@@ -940,18 +996,63 @@ Being *ActorManager::findNearestByName(const std::string &name,
 
 const ActorSprites &ActorManager::getAll() const
 {
-    return mActors;
+    return mActors.getAll();
 }
 
 void ActorManager::logic()
 {
     BLOCK_START("ActorManager::logic")
-    for_actors
+    const bool culling = mEnableLogicCulling && viewport != nullptr;
+    int x1 = 0;
+    int y1 = 0;
+    int x2 = 0;
+    int y2 = 0;
+    if (culling)
+    {
+        const int margin = cullTilesMargin * mapTileSize;
+        x1 = viewport->getCameraX() - margin;
+        y1 = viewport->getCameraY() - margin;
+        x2 = viewport->getCameraX() + viewport->getWidth() + margin;
+        y2 = viewport->getCameraY() + viewport->getHeight() + margin;
+    }
+    mFullLogicCount = 0;
+    mCulledLogicCount = 0;
+
+    // by index, because logic can add actors
+    mInLogic = true;
+    const ActorSprites &actors = mActors.getAll();
+    for (size_t f = 0; f < actors.size(); f ++)
     {
+        ActorSprite *const actor = actors[f];
 // disabled for performance
-//        if (reportFalse(*it))
-        (*it)->logic();
+//        if (reportFalse(actor))
+        if (culling && actor != localPlayer)
+        {
+            const int x = actor->getPixelX();
+            const int y = actor->getPixelY();
+            const bool culled = x < x1 || x > x2 || y < y1 || y > y2;
+            actor->setCulled(culled);
+            if (culled)
+                mCulledLogicCount ++;
+            else
+                mFullLogicCount ++;
+        }
+        else
+        {
+            actor->setCulled(false);
+            mFullLogicCount ++;
+        }
+        actor->logic();
+        mGrid.update(actor);
+    }
+    mInLogic = false;
+
+    FOR_EACH (ActorSpritesConstIterator, it, mEraseActors)
+    {
+        mActors.remove(*it);
+        mGrid.remove(*it);
     }
+    mEraseActors.clear();
 
     if (mDeleteActors.empty())
     {
@@ -960,7 +1061,7 @@ void ActorManager::logic()
     }
 
     BLOCK_START("ActorManager::logic 1")
-    FOR_EACH (ActorSpritesConstIterator, it, mDeleteActors)
+    FOR_EACH (ActorSpritesSetConstIterator, it, mDeleteActors)
     {
         const ActorSprite *const actor = *it;
         const ActorTypeT &type = actor->getType();
@@ -982,18 +1083,13 @@ void ActorManager::logic()
             viewport->clearHover(*it);
     }
 
-    FOR_EACH (ActorSpritesConstIterator, it, mDeleteActors)
+    FOR_EACH (ActorSpritesSetConstIterator, it, mDeleteActors)
     {
         ActorSprite *actor = *it;
-        mActors.erase(actor);
-
         if (actor != nullptr)
         {
-            const ActorSpritesMapIterator itr = mActorsIdMap.find(
-                actor->getId());
-            if (itr != mActorsIdMap.end() && (*itr).second == actor)
-                mActorsIdMap.erase(itr);
-
+            mActors.remove(actor);
+            mGrid.remove(actor);
             delete actor;
         }
     }
@@ -1012,19 +1108,22 @@ void ActorManager::clear()
     {
         localPlayer->setTarget(nullptr);
         localPlayer->unSetPickUpTarget();
-        mActors.erase(localPlayer);
+        mActors.remove(localPlayer);
     }
 
-    for_actors
-        delete *it;
+    // storage resets actor slots, so clear it before deleting actors
+    const ActorSprites actors = mActors.getAll();
+    mGrid.clear();
     mActors.clear();
+    FOR_EACH (ActorSpritesConstIterator, it, actors)
+        delete *it;
     mDeleteActors.clear();
-    mActorsIdMap.clear();
+    mEraseActors.clear();
 
     if (localPlayer != nullptr)
     {
-        mActors.insert(localPlayer);
-        mActorsIdMap[localPlayer->getId()] = localPlayer;
+        mActors.add(localPlayer);
+        mGrid.add(localPlayer);
     }
 
     mChars.clear();
@@ -1128,13 +1227,6 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
     if ((aroundBeing == nullptr) || (localPlayer == nullptr))
         return nullptr;
 
-    std::set<std::string> attackMobs;
-    std::set<std::string> priorityMobs;
-    std::set<std::string> ignoreAttackMobs;
-    StringIntMap attackMobsMap;
-    StringIntMap priorityMobsMap;
-    int defaultAttackIndex = 10000;
-    int defaultPriorityIndex = 10000;
     const int attackRange = localPlayer->getAttackRange();
 
     bool specialDistance = false;
@@ -1144,6 +1236,7 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
         specialDistance = true;
     }
 
+    const int radius = maxDist;
     maxDist = maxDist * maxDist;
 
     const bool cycleSelect = allowSort == AllowSort_true
@@ -1157,33 +1250,17 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
 
-    bool ignoreDefault = false;
     if (filtered)
     {
-        attackMobs = mAttackMobsSet;
-        priorityMobs = mPriorityAttackMobsSet;
-        ignoreAttackMobs = mIgnoreAttackMobsSet;
-        attackMobsMap = mAttackMobsMap;
-        priorityMobsMap = mPriorityAttackMobsMap;
-        beingActorSorter.attackBeings = &attackMobsMap;
-        beingActorSorter.priorityBeings = &priorityMobsMap;
         beingActorSorter.specialDistance = specialDistance;
         beingActorSorter.attackRange = attackRange;
-        if (ignoreAttackMobs.find(std::string()) != ignoreAttackMobs.end())
-            ignoreDefault = true;
-        StringIntMapCIter itr = attackMobsMap.find(std::string());
-        if (itr != attackMobsMap.end())
-            defaultAttackIndex = (*itr).second;
-        itr = priorityMobsMap.find(std::string());
-        if (itr != priorityMobsMap.end())
-            defaultPriorityIndex = (*itr).second;
     }
 
     if (cycleSelect)
     {
         STD_VECTOR<Being*> sortedBeings;
 
-        FOR_EACH (ActorSprites::iterator, i, mActors)
+        FOR_EACH (ActorSpritesConstIterator, i, mActors)
         {
 //  disabled for performance
 //            if (reportTrue(*i == nullptr))
@@ -1197,20 +1274,8 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
 
             Being *const being = static_cast<Being*>(*i);
 
-            if (filtered)
-            {
-                if (ignoreAttackMobs.find(being->getName())
-                    != ignoreAttackMobs.end())
-                {
-                    continue;
-                }
-                if (ignoreDefault && attackMobs.find(being->getName())
-                    == attackMobs.end() && priorityMobs.find(being->getName())
-                    == priorityMobs.end())
-                {
-                    continue;
-                }
-            }
+            if (filtered && mAttackFilter.isIgnored(being))
+                continue;
 
             if ((being->getInfo() != nullptr)
                 && !(being->getInfo()->isTargetSelection() || modActive))
@@ -1231,24 +1296,9 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
 
         beingActorSorter.x = x;
         beingActorSorter.y = y;
-        if (filtered)
-        {
-            beingActorSorter.attackBeings = &attackMobsMap;
-            beingActorSorter.defaultAttackIndex = defaultAttackIndex;
-            beingActorSorter.priorityBeings = &priorityMobsMap;
-            beingActorSorter.defaultPriorityIndex = defaultPriorityIndex;
-        }
-        else
-        {
-            beingActorSorter.attackBeings = nullptr;
-            beingActorSorter.priorityBeings = nullptr;
-        }
+        beingActorSorter.filter = filtered ? &mAttackFilter : nullptr;
         std::sort(sortedBeings.begin(), sortedBeings.end(), beingActorSorter);
-        if (filtered)
-        {
-            beingActorSorter.attackBeings = nullptr;
-            beingActorSorter.priorityBeings = nullptr;
-        }
+        beingActorSorter.filter = nullptr;
 
         if (localPlayer->getTarget() == nullptr)
         {
@@ -1278,10 +1328,27 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
     }
 
     int dist = 0;
-    int index = defaultPriorityIndex;
+    int index = mAttackFilter.getDefaultPriorityIndex();
     Being *closestBeing = nullptr;
 
-    FOR_EACH (ActorSprites::iterator, i, mActors)
+    // without filter nearest being outside of radius will be not returned,
+    // but distance to monsters can be measured by path length
+    STD_VECTOR<ActorSprite*> &gridActors = mGridActors;
+    gridActors.clear();
+    if (!filtered &&
+        (!mTargetOnlyReachable ||
+        (type != ActorType::Monster && type != ActorType::Unknown)))
+    {
+        mGrid.getActors(gridActors,
+            x - radius, y - radius,
+            x + radius, y + radius);
+    }
+    else
+    {
+        gridActors.assign(mActors.begin(), mActors.end());
+    }
+
+    FOR_EACH (STD_VECTOR<ActorSprite*>::const_iterator, i, gridActors)
     {
 //  disabled for performance
 //            if (reportTrue(*i == nullptr))
@@ -1294,20 +1361,8 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
         }
         Being *const being = static_cast<Being*>(*i);
 
-        if (filtered)
-        {
-            if (ignoreAttackMobs.find(being->getName())
-                != ignoreAttackMobs.end())
-            {
-                continue;
-            }
-            if (ignoreDefault && attackMobs.find(being->getName())
-                == attackMobs.end() && priorityMobs.find(being->getName())
-                == priorityMobs.end())
-            {
-                continue;
-            }
-        }
+        if (filtered && mAttackFilter.isIgnored(being))
+            continue;
 
         if ((being->getInfo() != nullptr)
             && !(being->getInfo()->isTargetSelection() || modActive))
@@ -1345,14 +1400,9 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
         }
         else if (filtered)
         {
-            int w2 = defaultPriorityIndex;
             if (closestBeing != nullptr)
             {
-                const StringIntMapCIter it2 =  priorityMobsMap.find(
-                    being->getName());
-                if (it2 != priorityMobsMap.end())
-                    w2 = (*it2).second;
-
+                const int w2 = mAttackFilter.getPriorityIndex(being);
                 if (w2 < index)
                 {
                     dist = d;
@@ -1373,12 +1423,7 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
             {
                 dist = d;
                 closestBeing = being;
-                const StringIntMapCIter it1 = priorityMobsMap.find(
-                    being->getName());
-                if (it1 != priorityMobsMap.end())
-                    index = (*it1).second;
-                else
-                    index = defaultPriorityIndex;
+                index = mAttackFilter.getPriorityIndex(being);
             }
         }
     }
@@ -1560,13 +1605,7 @@ void ActorManager::itenplz() const
 
 bool ActorManager::hasActorSprite(const ActorSprite *const actor) const
 {
-    for_actors
-    {
-        if (actor == *it)
-            return true;
-    }
-
-    return false;
+    return mActors.contains(actor);
 }
 
 void ActorManager::addBlock(const BeingId id)
@@ -1620,7 +1659,7 @@ void ActorManager::printBeingsToChat(const std::string &header) const
             ChatMsgType::BY_SERVER,
             IgnoreRecord_false,
             TryRemoveColors_true);
-        if (mActorsIdMap.find(being->getId()) == mActorsIdMap.end())
+        if (mActors.findById(being->getId()) != being)
         {
             debugChatTab->chatLog("missing in id map: %s",
                 being->getName().c_str());
@@ -1630,30 +1669,10 @@ void ActorManager::printBeingsToChat(const std::string &header) const
         ChatMsgType::BY_SERVER,
         IgnoreRecord_false,
         TryRemoveColors_true);
-    FOR_EACH (ActorSpritesMapConstIterator, itr, mActorsIdMap)
+    for_actors
     {
-        const ActorSprite *const actor = (*itr).second;
-        if (actor == nullptr)
-            continue;
-        if (actor->getId() != (*itr).first)
-            debugChatTab->chatLog("Actor with wrong key in map", "");
-
-        bool found(false);
-
-        for_actors
-        {
-// disabled for performance
-//            if (!*it)
-//                continue;
-
-            if ((*it)->getId() == actor->getId())
-            {
-                found = true;
-                break;
-            }
-        }
-        if (!found)
-            debugChatTab->chatLog("Actor present in map but not in set", "");
+        if (!mActors.contains(*it))
+            debugChatTab->chatLog("Actor with wrong storage slot", "");
     }
 }
 
@@ -1855,6 +1874,8 @@ void ActorManager::optionChanged(const std::string &name)
         updateBadges();
     else if (name == "enableIdCollecting")
         mEnableIdCollecting = config.getBoolValue("enableIdCollecting");
+    else if (name == "enableLogicCulling")
+        mEnableLogicCulling = config.getBoolValue("enableLogicCulling");
 }
 
 void ActorManager::removeAttackMob(const std::string &name)
@@ -1958,11 +1979,20 @@ void ActorManager::addIgnorePickupItem(const std::string &name)
 void ActorManager::rebuildPriorityAttackMobs()
 {
     rebuildMobsList(PriorityAttackMob)
+    rebuildAttackFilter();
 }
 
 void ActorManager::rebuildAttackMobs()
 {
     rebuildMobsList(AttackMob)
+    rebuildAttackFilter();
+}
+
+void ActorManager::rebuildAttackFilter()
+{
+    mAttackFilter.rebuild(mPriorityAttackMobsMap,
+        mAttackMobsMap,
+        mIgnoreAttackMobsSet);
 }
 
 void ActorManager::rebuildPickupItems()
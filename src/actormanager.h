@@ -24,6 +24,10 @@
 #ifndef ACTORMANAGER_H
 #define ACTORMANAGER_H
 
+#include "being/actorgrid.h"
+#include "being/actorstorage.h"
+#include "being/targetfilter.h"
+
 #include "enums/being/actortype.h"
 
 #include "enums/resources/item/itemtype.h"
@@ -56,12 +60,8 @@ class Map;
 
 struct ChatObject;
 
-typedef std::set<ActorSprite*> ActorSprites;
-typedef ActorSprites::iterator ActorSpritesIterator;
-typedef ActorSprites::const_iterator ActorSpritesConstIterator;
-typedef std::map<BeingId, ActorSprite*> ActorSpritesMap;
-typedef ActorSpritesMap::iterator ActorSpritesMapIterator;
-typedef ActorSpritesMap::const_iterator ActorSpritesMapConstIterator;
+typedef std::set<ActorSprite*> ActorSpritesSet;
+typedef ActorSpritesSet::const_iterator ActorSpritesSetConstIterator;
 
 typedef std::map<BeingId, std::set<std::string> > IdNameMapping;
 typedef IdNameMapping::const_iterator IdNameMappingCIter;
@@ -121,6 +121,11 @@ class ActorManager final : public ConfigListener
 
         void undelete(const ActorSprite *const actor);
 
+        /**
+         * Updates actor position in actors grid after actor changed tile.
+         */
+        void updateActorPosition(ActorSprite *const actor);
+
         /**
          * Returns a specific Being, by id;
          */
@@ -128,6 +133,18 @@ class ActorManager final : public ConfigListener
 
         ActorSprite *findActor(const BeingId id) const A_WARN_UNUSED;
 
+        /**
+         * Returns handle what stays safe to check after actor deleted.
+         */
+        ActorHandle getActorHandle(const ActorSprite *const actor)
+                                   const A_WARN_UNUSED;
+
+        /**
+         * Returns actor by handle or nullptr if actor was deleted.
+         */
+        ActorSprite *findActor(const ActorHandle &handle)
+                               const A_WARN_UNUSED;
+
         /**
          * Returns a being at specific coordinates.
          */
@@ -241,6 +258,19 @@ class ActorManager final : public ConfigListener
          */
         const ActorSprites &getAll() const A_CONST;
 
+        /**
+         * Returns count of actors updated fully in last logic call.
+         */
+        int getFullLogicCount() const noexcept2 A_WARN_UNUSED
+        { return mFullLogicCount; }
+
+        /**
+         * Returns count of off screen actors updated in last logic call
+         * without sprites.
+         */
+        int getCulledLogicCount() const noexcept2 A_WARN_UNUSED
+        { return mCulledLogicCount; }
+
         /**
          * Returns true if the given ActorSprite is in the manager's list,
          * false otherwise.
@@ -411,9 +441,22 @@ class ActorManager final : public ConfigListener
 
         void storeAttackList() const;
 
-        ActorSprites mActors;
-        ActorSprites mDeleteActors;
-        ActorSpritesMap mActorsIdMap;
+        void rebuildAttackFilter();
+
+        /**
+         * Adds to list actors what can be drawn inside given rectangle
+         * of pixels.
+         */
+        void getActorsByPixel(STD_VECTOR<ActorSprite*> &actors,
+                              const int x1, const int y1,
+                              const int x2, const int y2) const;
+
+        ActorStorage mActors;
+        ActorSpritesSet mDeleteActors;
+        ActorSprites mEraseActors;
+        ActorGrid mGrid;
+        // result of grid query, kept to not allocate it for each query
+        mutable STD_VECTOR<ActorSprite*> mGridActors;
         IdNameMapping mIdName;
         std::set<BeingId> mBlockedBeings;
         std::map<int32_t, std::string> mChars;
@@ -431,6 +474,10 @@ class ActorManager final : public ConfigListener
         bool mCycleNPC;
         bool mExtMouseTargeting;
         bool mEnableIdCollecting;
+        bool mEnableLogicCulling;
+        bool mInLogic;
+        int mFullLogicCount;
+        int mCulledLogicCount;
 
 #define defVarsP(mob) \
         std::list<std::string> mPriority##mob;\
@@ -447,6 +494,8 @@ class ActorManager final : public ConfigListener
         defVarsP(AttackMobs)
         defVars(AttackMobs)
         defVars(PickupItems)
+
+        TargetFilter mAttackFilter;
 };
 
 extern ActorManager *actorManager;
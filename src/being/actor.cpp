@@ -32,7 +32,7 @@ Actor::Actor() :
     mMap(nullptr),
     mPos(),
     mYDiff(0),
-    mMapActor()
+    mMapActor(-1)
 {
 }
 
@@ -27,7 +27,7 @@
 
 #include "resources/vector.h"
 
-#include <list>
+#include "utils/vector.h"
 
 #include "localconsts.h"
 
@@ -35,7 +35,25 @@ class Actor;
 class Graphics;
 class Map;
 
-typedef std::list<Actor*> Actors;
+/**
+ * Actor in map draw order with its cached sort Y coordinate.
+ */
+struct MapActor final
+{
+    MapActor(Actor *const actor0,
+             const int sortY0) :
+        actor(actor0),
+        sortY(sortY0)
+    {
+    }
+
+    A_DEFAULT_COPY(MapActor)
+
+    Actor *actor;
+    int sortY;
+};
+
+typedef STD_VECTOR<MapActor> Actors;
 typedef Actors::const_iterator ActorsCIter;
 
 class Actor notfinal
@@ -141,7 +159,9 @@ class Actor notfinal
         int mYDiff;
 
     private:
-        Actors::iterator mMapActor;
+        friend class Map;
+
+        int mMapActor;
 };
 
 #endif  // BEING_ACTOR_H
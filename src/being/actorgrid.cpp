@@ -0,0 +1,163 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "being/actorgrid.h"
+
+#include "being/actorsprite.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+
+#include "debug.h"
+
+namespace
+{
+    // cell size in tiles
+    const int cellSize = 4;
+    // must be power of two
+    const int bucketsCount = 1024;
+}  // namespace
+
+ActorGrid::ActorGrid() :
+    mBuckets(bucketsCount)
+{
+}
+
+int ActorGrid::getCell(const int tile)
+{
+    if (tile < 0)
+        return 0;
+    return tile / cellSize;
+}
+
+int ActorGrid::getBucket(const int cellX,
+                         const int cellY)
+{
+    return CAST_S32((CAST_U32(cellX) * 73856093U ^
+        CAST_U32(cellY) * 19349663U) & (bucketsCount - 1));
+}
+
+void ActorGrid::add(ActorSprite *const actor)
+{
+    if (actor->mInGrid)
+        remove(actor);
+    actor->mGridX = getCell(actor->getTileX());
+    actor->mGridY = getCell(actor->getTileY());
+    actor->mInGrid = true;
+    mBuckets[getBucket(actor->mGridX, actor->mGridY)].push_back(actor);
+}
+
+void ActorGrid::remove(ActorSprite *const actor)
+{
+    if (!actor->mInGrid)
+        return;
+    actor->mInGrid = false;
+    STD_VECTOR<ActorSprite*> &bucket = mBuckets[getBucket(actor->mGridX,
+        actor->mGridY)];
+    FOR_EACH (STD_VECTOR<ActorSprite*>::iterator, it, bucket)
+    {
+        if (*it == actor)
+        {
+            *it = bucket.back();
+            bucket.pop_back();
+            return;
+        }
+    }
+}
+
+void ActorGrid::update(ActorSprite *const actor)
+{
+    if (!actor->mInGrid)
+        return;
+    if (getCell(actor->getTileX()) == actor->mGridX &&
+        getCell(actor->getTileY()) == actor->mGridY)
+    {
+        return;
+    }
+    remove(actor);
+    add(actor);
+}
+
+void ActorGrid::clear()
+{
+    FOR_EACH (STD_VECTOR<STD_VECTOR<ActorSprite*> >::iterator,
+              it, mBuckets)
+    {
+        FOR_EACHP (STD_VECTOR<ActorSprite*>::iterator, it2, it)
+            (*it2)->mInGrid = false;
+        (*it).clear();
+    }
+}
+
+void ActorGrid::getActors(STD_VECTOR<ActorSprite*> &actors,
+                          const int x1, const int y1,
+                          const int x2, const int y2) const
+{
+    const int cellX1 = getCell(x1);
+    const int cellY1 = getCell(y1);
+    const int cellX2 = getCell(x2);
+    const int cellY2 = getCell(y2);
+    if (cellX2 < cellX1 || cellY2 < cellY1)
+        return;
+
+    // big area faster to check by all buckets
+    const int width = cellX2 - cellX1 + 1;
+    const int height = cellY2 - cellY1 + 1;
+    if (width >= bucketsCount ||
+        height >= bucketsCount ||
+        width * height >= bucketsCount)
+    {
+        FOR_EACH (STD_VECTOR<STD_VECTOR<ActorSprite*> >::const_iterator,
+                  it, mBuckets)
+        {
+            FOR_EACHP (STD_VECTOR<ActorSprite*>::const_iterator, it2, it)
+            {
+                ActorSprite *const actor = *it2;
+                if (actor->mGridX >= cellX1 &&
+                    actor->mGridX <= cellX2 &&
+                    actor->mGridY >= cellY1 &&
+                    actor->mGridY <= cellY2)
+                {
+                    actors.push_back(actor);
+                }
+            }
+        }
+        return;
+    }
+
+    for (int cellY = cellY1; cellY <= cellY2; cellY ++)
+    {
+        for (int cellX = cellX1; cellX <= cellX2; cellX ++)
+        {
+            const STD_VECTOR<ActorSprite*> &bucket =
+                mBuckets[getBucket(cellX, cellY)];
+            // bucket shared with other cells, so check actor cell too
+            FOR_EACH (STD_VECTOR<ActorSprite*>::const_iterator, it, bucket)
+            {
+                ActorSprite *const actor = *it;
+                if (actor->mGridX == cellX &&
+                    actor->mGridY == cellY)
+                {
+                    actors.push_back(actor);
+                }
+            }
+        }
+    }
+}
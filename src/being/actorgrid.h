@@ -0,0 +1,73 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEING_ACTORGRID_H
+#define BEING_ACTORGRID_H
+
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+class ActorSprite;
+
+/**
+ * Spatial hash of actors by tile position.
+ *
+ * Tiles grouped to square cells, and cells hashed to fixed number of
+ * buckets, so grid not depends on map size. Actor remembers own cell,
+ * and must be updated after its tile changed.
+ */
+class ActorGrid final
+{
+    public:
+        ActorGrid();
+
+        A_DELETE_COPY(ActorGrid)
+
+        void add(ActorSprite *const actor) A_NONNULL(2);
+
+        void remove(ActorSprite *const actor) A_NONNULL(2);
+
+        /**
+         * Moves actor to other cell if its tile position changed.
+         * Actors what was not added ignored.
+         */
+        void update(ActorSprite *const actor) A_NONNULL(2);
+
+        void clear();
+
+        /**
+         * Adds to list actors from cells what intersects given rectangle
+         * of tiles. Caller must check actor positions itself.
+         */
+        void getActors(STD_VECTOR<ActorSprite*> &actors,
+                       const int x1, const int y1,
+                       const int x2, const int y2) const;
+
+    private:
+        static int getCell(const int tile) A_WARN_UNUSED;
+
+        static int getBucket(const int cellX,
+                             const int cellY) A_WARN_UNUSED;
+
+        STD_VECTOR<STD_VECTOR<ActorSprite*> > mBuckets;
+};
+
+#endif  // BEING_ACTORGRID_H
@@ -81,7 +81,12 @@ ActorSprite::ActorSprite(const BeingId id) :
     mMustResetParticles(false),
     mPoison(false),
     mHaveCart(false),
-    mTrickDead(false)
+    mTrickDead(false),
+    mCulled(false),
+    mStorageSlot(-1),
+    mGridX(0),
+    mGridY(0),
+    mInGrid(false)
 {
 }
 
@@ -111,7 +116,8 @@ void ActorSprite::logic()
 {
     BLOCK_START("ActorSprite::logic")
     // Update sprite animations
-    update(tick_time * MILLISECONDS_IN_A_TICK);
+    if (!mCulled)
+        update(tick_time * MILLISECONDS_IN_A_TICK);
 
     // Restart status/particle effects, if needed
     if (mMustResetParticles)
@@ -136,6 +142,15 @@ void ActorSprite::logic()
     BLOCK_END("ActorSprite::logic")
 }
 
+void ActorSprite::setCulled(const bool culled)
+{
+    if (mCulled == culled)
+        return;
+    mCulled = culled;
+    // status effects container is parent, so it paused too
+    mChildParticleEffects.setPaused(culled);
+}
+
 void ActorSprite::setMap(Map *const map)
 {
     Actor::setMap(map);
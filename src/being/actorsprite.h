@@ -200,6 +200,16 @@ class ActorSprite notfinal : public CompoundSprite, public Actor
 
         void controlParticleDeleted(const Particle *const particle);
 
+        /**
+         * Sets actor far outside of screen. Culled actor not updates own
+         * sprites and its particle emitters paused. After culling
+         * disabled sprites skip whole animation loops of elapsed time.
+         */
+        void setCulled(const bool culled);
+
+        bool isCulled() const noexcept2 A_WARN_UNUSED
+        { return mCulled; }
+
     protected:
         /**
          * Notify self that a status effect has flipped.
@@ -261,6 +271,18 @@ class ActorSprite notfinal : public CompoundSprite, public Actor
         bool mPoison;
         bool mHaveCart;
         bool mTrickDead;
+        bool mCulled;
+
+    private:
+        friend class ActorGrid;
+        friend class ActorStorage;
+
+        /** Slot in actors storage */
+        int mStorageSlot;
+        /** Cell in actors grid */
+        int mGridX;
+        int mGridY;
+        bool mInGrid;
 };
 
 #endif  // BEING_ACTORSPRITE_H
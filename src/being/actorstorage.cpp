@@ -0,0 +1,152 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "being/actorstorage.h"
+
+#include "being/actorsprite.h"
+
+#include "utils/cast.h"
+
+#include "debug.h"
+
+ActorStorage::ActorStorage() :
+    mActors(),
+    mSlots(),
+    mIds(),
+    mFreeSlot(-1)
+{
+}
+
+void ActorStorage::add(ActorSprite *const actor)
+{
+    int slot = actor->mStorageSlot;
+    if (slot < 0)
+    {
+        if (mFreeSlot >= 0)
+        {
+            slot = mFreeSlot;
+            mFreeSlot = mSlots[slot].nextFree;
+        }
+        else
+        {
+            slot = CAST_S32(mSlots.size());
+            mSlots.push_back(Slot());
+        }
+        Slot &data = mSlots[slot];
+        data.actor = actor;
+        data.position = CAST_S32(mActors.size());
+        data.nextFree = -1;
+        mActors.push_back(actor);
+        actor->mStorageSlot = slot;
+    }
+    IdEntry &entry = mIds.insert(actor->getId());
+    entry.slot = slot;
+    entry.generation = mSlots[slot].generation;
+}
+
+void ActorStorage::remove(ActorSprite *const actor)
+{
+    const int slot = actor->mStorageSlot;
+    if (slot < 0 ||
+        slot >= CAST_S32(mSlots.size()) ||
+        mSlots[slot].actor != actor)
+    {
+        return;
+    }
+    const IdEntry *const entry = mIds.find(actor->getId());
+    if (entry != nullptr && entry->slot == slot)
+        mIds.erase(actor->getId());
+
+    Slot &data = mSlots[slot];
+    ActorSprite *const last = mActors.back();
+    mActors[data.position] = last;
+    mSlots[last->mStorageSlot].position = data.position;
+    mActors.pop_back();
+
+    data.actor = nullptr;
+    data.position = -1;
+    data.generation ++;
+    data.nextFree = mFreeSlot;
+    mFreeSlot = slot;
+    actor->mStorageSlot = -1;
+}
+
+void ActorStorage::clear()
+{
+    // slots kept, so old handles stay invalid
+    mFreeSlot = -1;
+    for (int f = CAST_S32(mSlots.size()) - 1; f >= 0; f --)
+    {
+        Slot &data = mSlots[f];
+        if (data.actor != nullptr)
+        {
+            data.actor->mStorageSlot = -1;
+            data.actor = nullptr;
+            data.position = -1;
+            data.generation ++;
+        }
+        data.nextFree = mFreeSlot;
+        mFreeSlot = f;
+    }
+    mActors.clear();
+    mIds.clear();
+}
+
+bool ActorStorage::contains(const ActorSprite *const actor) const
+{
+    if (actor == nullptr)
+        return false;
+    const int slot = actor->mStorageSlot;
+    return slot >= 0 &&
+        slot < CAST_S32(mSlots.size()) &&
+        mSlots[slot].actor == actor;
+}
+
+ActorSprite *ActorStorage::findById(const BeingId id) const
+{
+    const IdEntry *const entry = mIds.find(id);
+    if (entry == nullptr)
+        return nullptr;
+    const Slot &data = mSlots[entry->slot];
+    if (data.generation != entry->generation)
+        return nullptr;
+    return data.actor;
+}
+
+ActorHandle ActorStorage::getHandle(const ActorSprite *const actor) const
+{
+    if (!contains(actor))
+        return ActorHandle();
+    const int slot = actor->mStorageSlot;
+    return ActorHandle(slot, mSlots[slot].generation);
+}
+
+ActorSprite *ActorStorage::get(const ActorHandle &handle) const
+{
+    if (handle.slot < 0 ||
+        handle.slot >= CAST_S32(mSlots.size()))
+    {
+        return nullptr;
+    }
+    const Slot &data = mSlots[handle.slot];
+    if (data.generation != handle.generation)
+        return nullptr;
+    return data.actor;
+}
@@ -0,0 +1,154 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEING_ACTORSTORAGE_H
+#define BEING_ACTORSTORAGE_H
+
+#include "enums/simpletypes/beingid.h"
+
+#include "utils/hashtable.h"
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+class ActorSprite;
+
+typedef STD_VECTOR<ActorSprite*> ActorSprites;
+typedef ActorSprites::iterator ActorSpritesIterator;
+typedef ActorSprites::const_iterator ActorSpritesConstIterator;
+
+/**
+ * Reference to actor what not becomes dangling after actor removed.
+ */
+struct ActorHandle final
+{
+    ActorHandle() :
+        slot(-1),
+        generation(0U)
+    {
+    }
+
+    ActorHandle(const int slot0,
+                const unsigned int generation0) :
+        slot(slot0),
+        generation(generation0)
+    {
+    }
+
+    A_DEFAULT_COPY(ActorHandle)
+
+    int slot;
+    unsigned int generation;
+};
+
+/**
+ * Storage of actors.
+ *
+ * Actors kept in dense array for fast iteration, and each actor owns
+ * slot with generation counter for handles. Actors ids mapped to slots
+ * in open addressing hash table. Order of actors changed on removal.
+ */
+class ActorStorage final
+{
+    public:
+        ActorStorage();
+
+        A_DELETE_COPY(ActorStorage)
+
+        /**
+         * Adds actor if it not added yet and maps actor id to it.
+         * Other actor with same id not removed, but can not be found
+         * by id anymore.
+         */
+        void add(ActorSprite *const actor) A_NONNULL(2);
+
+        void remove(ActorSprite *const actor) A_NONNULL(2);
+
+        void clear();
+
+        bool contains(const ActorSprite *const actor) const A_WARN_UNUSED;
+
+        ActorSprite *findById(const BeingId id) const A_WARN_UNUSED;
+
+        ActorHandle getHandle(const ActorSprite *const actor)
+                              const A_WARN_UNUSED;
+
+        /**
+         * Returns actor for handle or nullptr if actor was removed.
+         */
+        ActorSprite *get(const ActorHandle &handle) const A_WARN_UNUSED;
+
+        const ActorSprites &getAll() const noexcept2 A_WARN_UNUSED
+        { return mActors; }
+
+        ActorSpritesConstIterator begin() const A_WARN_UNUSED
+        { return mActors.begin(); }
+
+        ActorSpritesConstIterator end() const A_WARN_UNUSED
+        { return mActors.end(); }
+
+        size_t size() const noexcept2 A_WARN_UNUSED
+        { return mActors.size(); }
+
+        bool empty() const noexcept2 A_WARN_UNUSED
+        { return mActors.empty(); }
+
+    private:
+        struct Slot final
+        {
+            Slot() :
+                actor(nullptr),
+                generation(0U),
+                position(-1),
+                nextFree(-1)
+            {
+            }
+
+            A_DEFAULT_COPY(Slot)
+
+            ActorSprite *actor;
+            unsigned int generation;
+            int position;
+            int nextFree;
+        };
+
+        struct IdEntry final
+        {
+            IdEntry() :
+                slot(-1),
+                generation(0U)
+            {
+            }
+
+            A_DEFAULT_COPY(IdEntry)
+
+            int slot;
+            unsigned int generation;
+        };
+
+        typedef HashTable<BeingId, IdEntry, IntHash> IdEntries;
+
+        ActorSprites mActors;
+        STD_VECTOR<Slot> mSlots;
+        IdEntries mIds;
+        int mFreeSlot;
+};
+
+#endif  // BEING_ACTORSTORAGE_H
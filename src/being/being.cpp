@@ -36,12 +36,15 @@
 
 #include "being/beingcacheentry.h"
 #include "being/beingflag.h"
+#include "being/beinginfocache.h"
 #include "being/beingspeech.h"
 #include "being/castingeffect.h"
 #include "being/localplayer.h"
 #include "being/playerinfo.h"
 #include "being/playerrelations.h"
+#include "being/spriteordercache.h"
 #include "being/homunculusinfo.h"
+#include "being/targetfilter.h"
 #include "being/mercenaryinfo.h"
 
 #include "const/utils/timer.h"
@@ -109,6 +112,7 @@
 #include "resources/skill/skillinfo.h"
 
 #include "resources/sprite/animatedsprite.h"
+#include "resources/sprite/spritedef.h"
 
 #include "gui/widgets/createwidget.h"
 
@@ -122,7 +126,8 @@
 
 #include "debug.h"
 
-const unsigned int CACHE_SIZE = 50;
+const int CACHE_SIZE = 49;
+const int SPRITE_ORDER_CACHE_SIZE = 256;
 
 time_t Being::mUpdateConfigTime = 0;
 unsigned int Being::mConfLineLim = 0;
@@ -145,7 +150,8 @@ BadgeDrawType::Type Being::mShowBadges = BadgeDrawType::Top;
 int Being::mAwayEffect = -1;
 VisibleNamePos::Type Being::mVisibleNamePos = VisibleNamePos::Bottom;
 
-std::list<BeingCacheEntry*> beingInfoCache;
+BeingInfoCache beingInfoCache(CACHE_SIZE);
+SpriteOrderCache spriteOrderCache(SPRITE_ORDER_CACHE_SIZE);
 typedef std::map<int, Guild*>::const_iterator GuildsMapCIter;
 typedef std::map<int, int>::const_iterator IntMapCIter;
 
@@ -196,6 +202,7 @@ Being::Being(const BeingId id,
     mAttackRange(1),
     mLastAttackX(0),
     mLastAttackY(0),
+    mNameId(-1),
     mPreStandTime(0),
     mGender(Gender::UNSPECIFIED),
     mAction(BeingAction::STAND),
@@ -543,12 +550,14 @@ void Being::setDestination(const int dstX,
     if (mMap == nullptr)
         return;
 
-    setPath(mMap->findPath(mX,
+    mMap->findPath(mPath,
+        mX,
         mY,
         dstX,
         dstY,
         getBlockWalkMask(),
-        20));
+        20);
+    startPath();
 }
 
 void Being::clearPath() restrict2
@@ -559,6 +568,11 @@ void Being::clearPath() restrict2
 void Being::setPath(const Path &restrict path) restrict2
 {
     mPath = path;
+    startPath();
+}
+
+void Being::startPath() restrict2
+{
     if (mPath.empty())
         return;
 
@@ -1161,6 +1175,9 @@ void Being::setName(const std::string &restrict name) restrict2
         if (getShowName())
             showName();
     }
+    // attack filter used only for monsters
+    if (mType == ActorType::Monster)
+        mNameId = TargetFilter::getNameId(mName);
 }
 
 void Being::setShowName(const bool doShowName) restrict2
@@ -1661,21 +1678,22 @@ void Being::setAction(const BeingActionT &restrict action,
     if (currentAction != SpriteAction::INVALID)
     {
         mSpriteAction = currentAction;
-        play(currentAction);
+        const int actionId = SpriteDef::getActionId(currentAction);
+        play(actionId);
         if (mEmotionSprite != nullptr)
-            mEmotionSprite->play(currentAction);
+            mEmotionSprite->play(actionId);
         if (mAnimationEffect != nullptr)
-            mAnimationEffect->play(currentAction);
+            mAnimationEffect->play(actionId);
         for_each_badges()
         {
             AnimatedSprite *const sprite = mBadges[f];
             if (sprite != nullptr)
-                sprite->play(currentAction);
+                sprite->play(actionId);
         }
         for_each_horses(mDownHorseSprites)
-            (*it)->play(currentAction);
+            (*it)->play(actionId);
         for_each_horses(mUpHorseSprites)
-            (*it)->play(currentAction);
+            (*it)->play(actionId);
         mAction = action;
     }
 
@@ -1850,37 +1868,41 @@ void Being::logic() restrict2
         }
     }
 
-    const int time = tick_time * MILLISECONDS_IN_A_TICK;
-    if (mEmotionSprite != nullptr)
-        mEmotionSprite->update(time);
-    for_each_horses(mDownHorseSprites)
-        (*it)->update(time);
-    for_each_horses(mUpHorseSprites)
-        (*it)->update(time);
-
     if (A_UNLIKELY(mCastEndTime != 0 && mCastEndTime < tick_time))
     {
         mCastEndTime = 0;
         delete2(mCastingEffect)
     }
 
-    if (A_UNLIKELY(mAnimationEffect))
+    // off screen sprites updated after being visible again
+    if (!mCulled)
     {
-        mAnimationEffect->update(time);
-        if (mAnimationEffect->isTerminated())
-            delete2(mAnimationEffect)
-    }
-    if (A_UNLIKELY(mCastingEffect))
-    {
-        mCastingEffect->update(time);
-        if (mCastingEffect->isTerminated())
-            delete2(mCastingEffect)
-    }
-    for_each_badges()
-    {
-        AnimatedSprite *restrict const sprite = mBadges[f];
-        if (sprite != nullptr)
-            sprite->update(time);
+        const int time = tick_time * MILLISECONDS_IN_A_TICK;
+        if (mEmotionSprite != nullptr)
+            mEmotionSprite->update(time);
+        for_each_horses(mDownHorseSprites)
+            (*it)->update(time);
+        for_each_horses(mUpHorseSprites)
+            (*it)->update(time);
+
+        if (A_UNLIKELY(mAnimationEffect))
+        {
+            mAnimationEffect->update(time);
+            if (mAnimationEffect->isTerminated())
+                delete2(mAnimationEffect)
+        }
+        if (A_UNLIKELY(mCastingEffect))
+        {
+            mCastingEffect->update(time);
+            if (mCastingEffect->isTerminated())
+                delete2(mCastingEffect)
+        }
+        for_each_badges()
+        {
+            AnimatedSprite *restrict const sprite = mBadges[f];
+            if (sprite != nullptr)
+                sprite->update(time);
+        }
     }
 
     int frameCount = CAST_S32(getFrameCount());
@@ -3515,18 +3537,7 @@ void Being::addToCache() const restrict2
     if (localPlayer == this)
         return;
 
-    BeingCacheEntry *entry = Being::getCacheEntry(getId());
-    if (entry == nullptr)
-    {
-        entry = new BeingCacheEntry(getId());
-        beingInfoCache.push_front(entry);
-
-        if (beingInfoCache.size() >= CACHE_SIZE)
-        {
-            delete beingInfoCache.back();
-            beingInfoCache.pop_back();
-        }
-    }
+    BeingCacheEntry *const entry = beingInfoCache.add(getId());
     if (!mLowTraffic)
         return;
 
@@ -3558,23 +3569,7 @@ void Being::addToCache() const restrict2
 
 BeingCacheEntry* Being::getCacheEntry(const BeingId id)
 {
-    FOR_EACH (std::list<BeingCacheEntry*>::iterator, i, beingInfoCache)
-    {
-        if (*i == nullptr)
-            continue;
-
-        if (id == (*i)->getId())
-        {
-            // Raise priority: move it to front
-            if ((*i)->getTime() + 120 < cur_time)
-            {
-                beingInfoCache.splice(beingInfoCache.begin(),
-                                      beingInfoCache, i);
-            }
-            return *i;
-        }
-    }
-    return nullptr;
+    return beingInfoCache.get(id);
 }
 
 
@@ -3927,6 +3922,26 @@ void Being::drawSpritesSDL(Graphics *restrict const graphics,
     }
 }
 
+bool Being::getLayersKey(SpriteCacheKeys &data) const restrict2
+{
+    // same order and hidden layers as in drawSpritesSDL
+    const size_t sz = mSprites.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        const int rSprite = mSpriteHide[mSpriteRemap[f]];
+        const Sprite *restrict const sprite = mSprites[mSpriteRemap[f]];
+        SpriteCacheKey key(0U, nullptr);
+        if (rSprite != 1 &&
+            sprite != nullptr &&
+            !sprite->getCacheKey(key))
+        {
+            return false;
+        }
+        data.push_back(key);
+    }
+    return true;
+}
+
 void Being::drawBasic(Graphics *restrict const graphics,
                       const int x,
                       const int y) const restrict2
@@ -4366,12 +4381,6 @@ void Being::recalcSpritesOrder() restrict2
     if (sz < 1)
         return;
 
-    STD_VECTOR<int> slotRemap;
-    IntMap itemSlotRemap;
-
-    STD_VECTOR<int>::iterator it;
-    int oldHide[20];
-    bool updatedSprite[20];
     int dir = mSpriteDirection;
     if (dir < 0 || dir >= 9)
         dir = 0;
@@ -4381,6 +4390,35 @@ void Being::recalcSpritesOrder() restrict2
 
     const unsigned int hairSlot = charServerHandler->hairSprite();
 
+    size_t spriteIdSize = mSlots.size();
+    if (reportTrue(spriteIdSize > 20))
+        spriteIdSize = 20;
+
+    // same equipment in same direction always have same order
+    STD_VECTOR<int> key;
+    key.reserve(spriteIdSize + 3);
+    for (size_t slot = 0; slot < spriteIdSize; slot ++)
+        key.push_back(mSlots[slot].spriteId);
+    key.push_back(dir);
+    key.push_back(CAST_S32(hairSlot));
+    key.push_back(CAST_S32(sz));
+
+    const SpriteOrder *restrict order = spriteOrderCache.get(key);
+    if (order == nullptr)
+    {
+        SpriteOrder *restrict const newOrder = spriteOrderCache.add(key);
+        if (newOrder == nullptr)
+            return;
+        newOrder->clear();
+        calcSpritesOrder(*newOrder,
+            key,
+            spriteIdSize,
+            dir);
+        order = newOrder;
+    }
+
+    int oldHide[20];
+    bool updatedSprite[20];
     for (size_t slot = sz; slot < 20; slot ++)
     {
         oldHide[slot] = 0;
@@ -4390,13 +4428,72 @@ void Being::recalcSpritesOrder() restrict2
     for (size_t slot = 0; slot < sz; slot ++)
     {
         oldHide[slot] = mSpriteHide[slot];
-        mSpriteHide[slot] = 0;
+        mSpriteHide[slot] = order->hide[slot];
         updatedSprite[slot] = false;
     }
 
-    size_t spriteIdSize = mSlots.size();
-    if (reportTrue(spriteIdSize > 20))
-        spriteIdSize = 20;
+    const size_t tempSize = order->tempSlots.size();
+    for (size_t f = 0; f < tempSize; f ++)
+    {
+        const unsigned int slot = CAST_U32(order->tempSlots[f]);
+        if (slot != hairSlot)
+            setTempSprite(slot, order->tempIds[f]);
+        else
+            setHairTempSprite(slot, order->tempIds[f]);
+        updatedSprite[slot] = true;
+    }
+
+    if (!order->reordered)
+        return;
+
+//    logger->log("after remap");
+    for (unsigned int slot = 0; slot < sz; slot ++)
+    {
+        mSpriteRemap[slot] = order->remap[slot];
+        if (mSpriteHide[slot] == 0)
+        {
+            if (oldHide[slot] != 0 && oldHide[slot] != 1)
+            {
+                const BeingSlot &beingSlot = mSlots[slot];
+                const int id = beingSlot.spriteId;
+                if (id == 0)
+                    continue;
+
+                updatedSprite[slot] = true;
+                setTempSprite(slot,
+                    id);
+            }
+        }
+    }
+    for (size_t slot = 0; slot < spriteIdSize; slot ++)
+    {
+        if (mSpriteHide[slot] == 0)
+        {
+            const BeingSlot &beingSlot = mSlots[slot];
+            const int id = beingSlot.spriteId;
+            if (updatedSprite[slot] == false &&
+                mSpriteDraw[slot] != id)
+            {
+                setTempSprite(static_cast<unsigned int>(slot),
+                    id);
+            }
+        }
+    }
+}
+
+void Being::calcSpritesOrder(SpriteOrder &restrict order,
+                             const STD_VECTOR<int> &restrict ids,
+                             const size_t spriteIdSize,
+                             const int dir) const restrict2
+{
+    const size_t sz = mSprites.size();
+    STD_VECTOR<int> &restrict spriteHide = order.hide;
+    spriteHide.resize(sz, 0);
+
+    STD_VECTOR<int> slotRemap;
+    IntMap itemSlotRemap;
+
+    STD_VECTOR<int>::iterator it;
 
     for (size_t slot = 0; slot < sz; slot ++)
     {
@@ -4405,7 +4502,7 @@ void Being::recalcSpritesOrder() restrict2
         if (spriteIdSize <= slot)
             continue;
 
-        const int id = mSlots[slot].spriteId;
+        const int id = ids[slot];
         if (id == 0)
             continue;
 
@@ -4424,16 +4521,19 @@ void Being::recalcSpritesOrder() restrict2
                     const IntMap &restrict itemReplacer = itr->second;
                     if (remSlot >= 0)
                     {   // slot known
-                        if (CAST_U32(remSlot) >= spriteIdSize)
+                        if (CAST_U32(remSlot) >= spriteIdSize ||
+                            CAST_U32(remSlot) >= sz)
+                        {
                             continue;
+                        }
                         if (itemReplacer.empty())
                         {
-                            mSpriteHide[remSlot] = 1;
+                            spriteHide[remSlot] = 1;
                         }
-                        else if (mSpriteHide[remSlot] != 1)
+                        else if (spriteHide[remSlot] != 1)
                         {
                             IntMapCIter repIt = itemReplacer.find(
-                                mSlots[remSlot].spriteId);
+                                ids[remSlot]);
                             if (repIt == itemReplacer.end())
                             {
                                 repIt = itemReplacer.find(0);
@@ -4445,21 +4545,11 @@ void Being::recalcSpritesOrder() restrict2
                             }
                             if (repIt != itemReplacer.end())
                             {
-                                mSpriteHide[remSlot] = repIt->second;
+                                spriteHide[remSlot] = repIt->second;
                                 if (repIt->second != 1)
                                 {
-                                    if (CAST_U32(remSlot)
-                                        != hairSlot)
-                                    {
-                                        setTempSprite(remSlot,
-                                            repIt->second);
-                                    }
-                                    else
-                                    {
-                                        setHairTempSprite(remSlot,
-                                            repIt->second);
-                                    }
-                                    updatedSprite[remSlot] = true;
+                                    order.tempSlots.push_back(remSlot);
+                                    order.tempIds.push_back(repIt->second);
                                 }
                             }
                         }
@@ -4468,24 +4558,19 @@ void Being::recalcSpritesOrder() restrict2
                     {   // slot unknown. Search for real slot, this can be slow
                         FOR_EACH (IntMapCIter, repIt, itemReplacer)
                         {
-                            for (unsigned int slot2 = 0; slot2 < sz; slot2 ++)
+                            for (unsigned int slot2 = 0;
+                                 slot2 < sz && slot2 < spriteIdSize;
+                                 slot2 ++)
                             {
-                                if (mSlots[slot2].spriteId == repIt->first)
+                                if (ids[slot2] == repIt->first)
                                 {
-                                    mSpriteHide[slot2] = repIt->second;
+                                    spriteHide[slot2] = repIt->second;
                                     if (repIt->second != 1)
                                     {
-                                        if (slot2 != hairSlot)
-                                        {
-                                            setTempSprite(slot2,
-                                                repIt->second);
-                                        }
-                                        else
-                                        {
-                                            setHairTempSprite(slot2,
-                                                repIt->second);
-                                        }
-                                        updatedSprite[slot2] = true;
+                                        order.tempSlots.push_back(
+                                            CAST_S32(slot2));
+                                        order.tempIds.push_back(
+                                            repIt->second);
                                     }
                                 }
                             }
@@ -4497,7 +4582,9 @@ void Being::recalcSpritesOrder() restrict2
 
         if (info.mDrawBefore[dir] > 0)
         {
-            const int id2 = mSlots[info.mDrawBefore[dir]].spriteId;
+            const int id2 = getSlotId(ids,
+                spriteIdSize,
+                info.mDrawBefore[dir]);
             if (itemSlotRemap.find(id2) != itemSlotRemap.end())
             {
 //                logger->log("found duplicate (before)");
@@ -4518,7 +4605,9 @@ void Being::recalcSpritesOrder() restrict2
         }
         else if (info.mDrawAfter[dir] > 0)
         {
-            const int id2 = mSlots[info.mDrawAfter[dir]].spriteId;
+            const int id2 = getSlotId(ids,
+                spriteIdSize,
+                info.mDrawAfter[dir]);
             if (itemSlotRemap.find(id2) != itemSlotRemap.end())
             {
                 const ItemInfo &info2 = ItemDB::get(id2);
@@ -4556,7 +4645,7 @@ void Being::recalcSpritesOrder() restrict2
             int id = 0;
 
             if (CAST_S32(spriteIdSize) > val)
-                id = mSlots[val].spriteId;
+                id = ids[val];
 
             int idx = -1;
             int idx1 = -1;
@@ -4612,39 +4701,17 @@ void Being::recalcSpritesOrder() restrict2
         }
     }
 
-//    logger->log("after remap");
-    for (unsigned int slot = 0; slot < sz; slot ++)
-    {
-        mSpriteRemap[slot] = slotRemap[slot];
-        if (mSpriteHide[slot] == 0)
-        {
-            if (oldHide[slot] != 0 && oldHide[slot] != 1)
-            {
-                const BeingSlot &beingSlot = mSlots[slot];
-                const int id = beingSlot.spriteId;
-                if (id == 0)
-                    continue;
+    order.remap.swap(slotRemap);
+    order.reordered = true;
+}
 
-                updatedSprite[slot] = true;
-                setTempSprite(slot,
-                    id);
-            }
-        }
-    }
-    for (size_t slot = 0; slot < spriteIdSize; slot ++)
-    {
-        if (mSpriteHide[slot] == 0)
-        {
-            const BeingSlot &beingSlot = mSlots[slot];
-            const int id = beingSlot.spriteId;
-            if (updatedSprite[slot] == false &&
-                mSpriteDraw[slot] != id)
-            {
-                setTempSprite(static_cast<unsigned int>(slot),
-                    id);
-            }
-        }
-    }
+int Being::getSlotId(const STD_VECTOR<int> &restrict ids,
+                     const size_t spriteIdSize,
+                     const int slot)
+{
+    if (slot < 0 || CAST_SIZE(slot) >= spriteIdSize)
+        return 0;
+    return ids[slot];
 }
 
 int Being::searchSlotValue(const STD_VECTOR<int> &restrict slotRemap,
@@ -4718,8 +4785,8 @@ void Being::undressItemById(const int id) restrict2
 
 void Being::clearCache()
 {
-    delete_all(beingInfoCache);
     beingInfoCache.clear();
+    spriteOrderCache.clear();
 }
 
 void Being::updateComment() restrict2
@@ -5018,6 +5085,8 @@ void Being::setTileCoords(const int x, const int y) restrict2
         mOldHeight = mMap->getHeightOffset(mX, mY);
         mNeedPosUpdate = true;
     }
+    if (actorManager != nullptr)
+        actorManager->updateActorPosition(this);
 }
 
 void Being::setMap(Map *restrict const map) restrict2
@@ -47,6 +47,8 @@
 
 #include "listeners/configlistener.h"
 
+#include <list>
+
 #include "localconsts.h"
 
 static const int DEFAULT_BEING_WIDTH = 32;
@@ -54,6 +56,7 @@ static const int DEFAULT_BEING_HEIGHT = 32;
 
 class AnimatedSprite;
 class BeingCacheEntry;
+class BeingInfoCache;
 class CastingEffect;
 class Color;
 class Equipment;
@@ -69,6 +72,7 @@ struct ChatObject;
 struct HorseInfo;
 struct MissileInfo;
 struct SkillInfo;
+struct SpriteOrder;
 struct ParticleInfo;
 
 extern volatile time_t cur_time;
@@ -235,6 +239,13 @@ class Being notfinal : public ActorSprite,
         const std::string &getExtName() const restrict2 noexcept2 A_WARN_UNUSED
         { return mExtName; }
 
+        /**
+         * Returns id of monster name for target filter, or -1 for
+         * other beings.
+         */
+        int getNameId() const restrict2 noexcept2 A_WARN_UNUSED
+        { return mNameId; }
+
         /**
          * Sets the name for the being.
          *
@@ -1108,6 +1119,11 @@ class Being notfinal : public ActorSprite,
                                   Map *const map);
 
     protected:
+        /**
+         * Starts moving by current path if being not moving yet.
+         */
+        void startPath() restrict2;
+
         void drawPlayerSpriteAt(Graphics *restrict const graphics,
                                 const int x,
                                 const int y) const restrict2 A_NONNULL(2);
@@ -1222,6 +1238,7 @@ class Being notfinal : public ActorSprite,
         int mAttackRange;
         int mLastAttackX;
         int mLastAttackY;
+        int mNameId;
 
         int mPreStandTime;
 
@@ -1240,6 +1257,9 @@ class Being notfinal : public ActorSprite,
 
         void updateBadgesPosition();
 
+        bool getLayersKey(SpriteCacheKeys &data) const
+                          restrict2 override final A_WARN_UNUSED;
+
         /**
          * Calculates the offset in the given directions.
          * If walking in direction 'neg' the value is negated.
@@ -1247,6 +1267,19 @@ class Being notfinal : public ActorSprite,
         template<signed char pos, signed char neg>
         int getOffset() const restrict2 A_WARN_UNUSED;
 
+        /**
+         * Calculates sprites order for given sprite ids without
+         * changing being.
+         */
+        void calcSpritesOrder(SpriteOrder &restrict order,
+                              const STD_VECTOR<int> &restrict ids,
+                              const size_t spriteIdSize,
+                              const int dir) const restrict2;
+
+        static int getSlotId(const STD_VECTOR<int> &restrict ids,
+                             const size_t spriteIdSize,
+                             const int slot) A_WARN_UNUSED;
+
         int searchSlotValue(const STD_VECTOR<int> &restrict slotRemap,
                             const int val) const restrict2 A_WARN_UNUSED;
 
@@ -1386,6 +1419,6 @@ class Being notfinal : public ActorSprite,
         bool mAllowNpcEquipment;
 };
 
-extern std::list<BeingCacheEntry*> beingInfoCache;
+extern BeingInfoCache beingInfoCache;
 
 #endif  // BEING_BEING_H
@@ -0,0 +1,68 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "being/beinginfocache.h"
+
+#include "being/beingcacheentry.h"
+
+#include "utils/foreach.h"
+
+#include "debug.h"
+
+BeingInfoCache::BeingInfoCache(const int capacity) :
+    mCache(capacity)
+{
+}
+
+BeingInfoCache::~BeingInfoCache()
+{
+    clear();
+}
+
+BeingCacheEntry *BeingInfoCache::get(const BeingId id)
+{
+    BeingCacheEntry *const *const entry = mCache.get(id);
+    if (entry == nullptr)
+        return nullptr;
+    return *entry;
+}
+
+BeingCacheEntry *BeingInfoCache::add(const BeingId id)
+{
+    BeingCacheEntry **const entry = mCache.add(id);
+    if (entry == nullptr)
+        return nullptr;
+    if (*entry != nullptr)
+    {
+        if ((*entry)->getId() == id)
+            return *entry;
+        // entry reused from oldest being
+        delete *entry;
+    }
+    *entry = new BeingCacheEntry(id);
+    return *entry;
+}
+
+void BeingInfoCache::clear()
+{
+    FOR_EACH (Entries::iterator, it, mCache)
+        delete (*it).value;
+    mCache.clear();
+}
@@ -0,0 +1,75 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEING_BEINGINFOCACHE_H
+#define BEING_BEINGINFOCACHE_H
+
+#include "enums/simpletypes/beingid.h"
+
+#include "utils/lrucache.h"
+
+#include "localconsts.h"
+
+class BeingCacheEntry;
+
+/**
+ * Cache of beings info what left view.
+ *
+ * Entries linked in least recently used order, and found by id in
+ * hash table. Oldest entry removed when cache full.
+ */
+class BeingInfoCache final
+{
+    public:
+        explicit BeingInfoCache(const int capacity);
+
+        A_DELETE_COPY(BeingInfoCache)
+
+        ~BeingInfoCache();
+
+        /**
+         * Returns entry for being id or nullptr, and updates hit and
+         * miss counters.
+         */
+        BeingCacheEntry *get(const BeingId id) A_WARN_UNUSED;
+
+        /**
+         * Returns entry for being id, creates new entry if needed.
+         */
+        BeingCacheEntry *add(const BeingId id) A_WARN_UNUSED;
+
+        void clear();
+
+        int size() const noexcept2 A_WARN_UNUSED
+        { return mCache.size(); }
+
+        int getHits() const noexcept2 A_WARN_UNUSED
+        { return mCache.getHits(); }
+
+        int getMisses() const noexcept2 A_WARN_UNUSED
+        { return mCache.getMisses(); }
+
+    private:
+        typedef LruCache<BeingId, BeingCacheEntry*, IntHash> Entries;
+
+        Entries mCache;
+};
+
+#endif  // BEING_BEINGINFOCACHE_H
@@ -0,0 +1,153 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "being/compoundimagecache.h"
+
+#include "resources/image/image.h"
+
+#include "utils/cast.h"
+
+#include "debug.h"
+
+CompoundImageCache compoundImageCache;
+
+CompoundImageCache::CompoundImageCache() :
+    mItems(),
+    mUnusedHead(nullptr),
+    mUnusedTail(nullptr),
+    mMemory(0),
+    mMaxMemory(16 * 1024 * 1024),
+    mHits(0),
+    mMisses(0)
+{
+}
+
+CompoundImageCache::~CompoundImageCache()
+{
+    // images deleted in clear before video shutdown
+}
+
+int CompoundImageCache::getImageMemory(const Image *const image)
+{
+    if (image == nullptr)
+        return 0;
+    return image->getWidth() * image->getHeight() * 4;
+}
+
+void CompoundImageCache::linkUnused(CompoundItem *const item)
+{
+    item->prev = nullptr;
+    item->next = mUnusedHead;
+    if (mUnusedHead != nullptr)
+        mUnusedHead->prev = item;
+    else
+        mUnusedTail = item;
+    mUnusedHead = item;
+}
+
+void CompoundImageCache::unlinkUnused(CompoundItem *const item)
+{
+    if (item->prev != nullptr)
+        item->prev->next = item->next;
+    else
+        mUnusedHead = item->next;
+    if (item->next != nullptr)
+        item->next->prev = item->prev;
+    else
+        mUnusedTail = item->prev;
+    item->prev = nullptr;
+    item->next = nullptr;
+}
+
+CompoundItem *CompoundImageCache::get(const SpriteCacheKeys &data,
+                                      const int tileWidth)
+{
+    CompoundItem *const *const found = mItems.find(ItemKey(data,
+        tileWidth));
+    if (found == nullptr)
+    {
+        mMisses ++;
+        return nullptr;
+    }
+    mHits ++;
+    CompoundItem *const item = *found;
+    if (item->refCount == 0)
+        unlinkUnused(item);
+    item->refCount ++;
+    return item;
+}
+
+CompoundItem *CompoundImageCache::add(const SpriteCacheKeys &data,
+                                      const int tileWidth,
+                                      Image *const image,
+                                      Image *const alphaImage,
+                                      const int offsetX,
+                                      const int offsetY)
+{
+    CompoundItem *const item = new CompoundItem;
+    item->data = data;
+    item->image = image;
+    item->alphaImage = alphaImage;
+    item->tileWidth = tileWidth;
+    item->offsetX = offsetX;
+    item->offsetY = offsetY;
+    item->memory = getImageMemory(image) + getImageMemory(alphaImage);
+    item->refCount = 1;
+    mItems.insert(ItemKey(data, tileWidth)) = item;
+    mMemory += item->memory;
+    trim();
+    return item;
+}
+
+void CompoundImageCache::release(CompoundItem *const item)
+{
+    item->refCount --;
+    if (item->refCount > 0)
+        return;
+    linkUnused(item);
+    trim();
+}
+
+void CompoundImageCache::trim()
+{
+    // used items can not be removed
+    while (mMemory > mMaxMemory && mUnusedTail != nullptr)
+        deleteUnused(mUnusedTail);
+}
+
+void CompoundImageCache::deleteUnused(CompoundItem *const item)
+{
+    unlinkUnused(item);
+    mItems.erase(ItemKey(item->data, item->tileWidth));
+    mMemory -= item->memory;
+    delete item;
+}
+
+void CompoundImageCache::clear()
+{
+    while (mUnusedTail != nullptr)
+        deleteUnused(mUnusedTail);
+}
+
+void CompoundImageCache::setMaxMemory(const int memory)
+{
+    mMaxMemory = memory;
+    trim();
+}
@@ -0,0 +1,132 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEING_COMPOUNDIMAGECACHE_H
+#define BEING_COMPOUNDIMAGECACHE_H
+
+#include "being/compounditem.h"
+
+#include "utils/hashtable.h"
+
+#include "localconsts.h"
+
+/**
+ * Shared cache of compound sprites images for software mode.
+ *
+ * Items found by layer keys and tile width in open addressing hash
+ * table, so beings with same look use same images. Items used by sprites
+ * have references, not used items linked in least recently used order
+ * and removed if cache memory bigger than limit.
+ */
+class CompoundImageCache final
+{
+    public:
+        CompoundImageCache();
+
+        A_DELETE_COPY(CompoundImageCache)
+
+        ~CompoundImageCache();
+
+        /**
+         * Returns item for layers and adds reference to it,
+         * or nullptr if item not cached.
+         */
+        CompoundItem *get(const SpriteCacheKeys &data,
+                          const int tileWidth) A_WARN_UNUSED;
+
+        /**
+         * Adds item with one reference. Cache takes ownership of images.
+         */
+        CompoundItem *add(const SpriteCacheKeys &data,
+                          const int tileWidth,
+                          Image *const image,
+                          Image *const alphaImage,
+                          const int offsetX,
+                          const int offsetY) A_WARN_UNUSED;
+
+        void release(CompoundItem *const item) A_NONNULL(2);
+
+        /**
+         * Deletes all not used items. Must be called before video
+         * shutdown, because cache is static object.
+         */
+        void clear();
+
+        void setMaxMemory(const int memory);
+
+        int size() const noexcept2 A_WARN_UNUSED
+        { return mItems.size(); }
+
+        int getMemory() const noexcept2 A_WARN_UNUSED
+        { return mMemory; }
+
+        int getHits() const noexcept2 A_WARN_UNUSED
+        { return mHits; }
+
+        int getMisses() const noexcept2 A_WARN_UNUSED
+        { return mMisses; }
+
+    private:
+        static int getImageMemory(const Image *const image) A_WARN_UNUSED;
+
+        void linkUnused(CompoundItem *const item);
+
+        void unlinkUnused(CompoundItem *const item);
+
+        void deleteUnused(CompoundItem *const item);
+
+        void trim();
+
+        typedef std::pair<SpriteCacheKeys, int> ItemKey;
+
+        struct ItemKeyHash final
+        {
+            unsigned int operator()(const ItemKey &key) const
+            {
+                // FNV-1a by sprite ids, frame pointers and tile width
+                unsigned int hash = 2166136261U ^ CAST_U32(key.second);
+                for (SpriteCacheKeys::const_iterator it = key.first.begin(),
+                     it_end = key.first.end(); it != it_end; ++ it)
+                {
+                    const size_t ptr = reinterpret_cast<size_t>(
+                        (*it).second);
+                    hash ^= (*it).first;
+                    hash *= 16777619U;
+                    hash ^= CAST_U32(ptr ^ (ptr >> 16));
+                    hash *= 16777619U;
+                }
+                return hash;
+            }
+        };
+
+        typedef HashTable<ItemKey, CompoundItem*, ItemKeyHash> Items;
+
+        Items mItems;
+        CompoundItem *mUnusedHead;
+        CompoundItem *mUnusedTail;
+        int mMemory;
+        int mMaxMemory;
+        int mHits;
+        int mMisses;
+};
+
+extern CompoundImageCache compoundImageCache;
+
+#endif  // BEING_COMPOUNDIMAGECACHE_H
@@ -22,14 +22,12 @@
 #ifndef BEING_COMPOUNDITEM_H
 #define BEING_COMPOUNDITEM_H
 
-#include <list>
+#include "resources/sprite/sprite.h"
 
 #include "localconsts.h"
 
 class Image;
 
-typedef std::list <const void*> VectorPointers;
-
 class CompoundItem final
 {
     public:
@@ -39,9 +37,16 @@ class CompoundItem final
 
         ~CompoundItem();
 
-        VectorPointers data;
+        SpriteCacheKeys data;
         Image *image;
         Image *alphaImage;
+        int tileWidth;
+        int offsetX;
+        int offsetY;
+        int memory;
+        int refCount;
+        CompoundItem *prev;
+        CompoundItem *next;
 };
 
 #endif  // BEING_COMPOUNDITEM_H
@@ -26,7 +26,7 @@
 
 #include "sdlshared.h"
 
-#include "being/compounditem.h"
+#include "being/compoundimagecache.h"
 
 #include "render/surfacegraphics.h"
 
@@ -35,6 +35,8 @@
 #endif  // USE_OPENGL
 #include "resources/image/image.h"
 
+#include "resources/sprite/spritedef.h"
+
 #include "utils/delete2.h"
 #include "utils/dtor.h"
 #include "utils/foreach.h"
@@ -58,13 +60,25 @@ PRAGMA48(GCC diagnostic ignored "-Wshadow")
 PRAGMA48(GCC diagnostic pop)
 #endif  // USE_SDL2
 
+#include <climits>
+
 #include "debug.h"
 
 #ifndef USE_SDL2
 static const int BUFFER_WIDTH = 100;
 static const int BUFFER_HEIGHT = 100;
-static const unsigned cache_max_size = 10;
-static const unsigned cache_clean_part = 3;
+
+static int getMapTileWidth()
+{
+    const Game *const game = Game::instance();
+    if (game != nullptr)
+    {
+        const Map *const map = game->getCurrentMap();
+        if (map != nullptr)
+            return map->getTileWidth();
+    }
+    return mapTileSize;
+}
 #endif  // USE_SDL2
 
 bool CompoundSprite::mEnableDelay = true;
@@ -72,7 +86,7 @@ bool CompoundSprite::mEnableDelay = true;
 CompoundSprite::CompoundSprite() :
     Sprite(),
     mSprites(),
-    imagesCache(),
+    mCacheKey(),
     mCacheItem(nullptr),
     mImage(nullptr),
     mAlphaImage(nullptr),
@@ -80,6 +94,7 @@ CompoundSprite::CompoundSprite() :
     mOffsetY(0),
     mStartTime(0),
     mLastTime(0),
+    mNextTime(0),
 #ifndef USE_SDL2
     mNextRedrawTime(0),
 #endif  // USE_SDL2
@@ -108,11 +123,17 @@ bool CompoundSprite::reset()
     }
     if (ret)
         mLastTime = 0;
+    mNextTime = 0;
     mNeedsRedraw |= ret;
     return ret;
 }
 
 bool CompoundSprite::play(const std::string &action)
+{
+    return play(SpriteDef::getActionId(action));
+}
+
+bool CompoundSprite::play(const int actionId)
 {
     bool ret = false;
     bool ret2 = true;
@@ -120,7 +141,7 @@ bool CompoundSprite::play(const std::string &action)
     {
         if (*it != nullptr)
         {
-            const bool tmpVal = (*it)->play(action);
+            const bool tmpVal = (*it)->play(actionId);
             ret |= tmpVal;
             ret2 &= tmpVal;
         }
@@ -128,6 +149,7 @@ bool CompoundSprite::play(const std::string &action)
     mNeedsRedraw |= ret;
     if (ret2)
         mLastTime = 0;
+    mNextTime = 0;
     return ret;
 }
 
@@ -135,13 +157,29 @@ bool CompoundSprite::update(const int time)
 {
     bool ret = false;
     if (A_UNLIKELY(mLastTime == 0))
+    {
         mStartTime = time;
+    }
+    else if (time < mNextTime && time >= mLastTime)
+    {
+        // no layers can change yet
+        mLastTime = time;
+        return false;
+    }
     mLastTime = time;
+    int nextTime = INT_MAX;
     FOR_EACH (SpriteIterator, it, mSprites)
     {
-        if (*it != nullptr)
-            ret |= (*it)->update(time);
+        Sprite *const sprite = *it;
+        if (sprite != nullptr)
+        {
+            ret |= sprite->update(time);
+            const int spriteTime = sprite->getNextUpdateTime();
+            if (spriteTime < nextTime)
+                nextTime = spriteTime;
+        }
     }
+    mNextTime = nextTime;
     mNeedsRedraw |= ret;
     return ret;
 }
@@ -237,6 +275,7 @@ bool CompoundSprite::setSpriteDirection(const SpriteDirection::Type direction)
     }
     if (ret)
         mLastTime = 0;
+    mNextTime = 0;
     mNeedsRedraw |= ret;
     return ret;
 }
@@ -272,6 +311,7 @@ void CompoundSprite::addSprite(Sprite *const sprite)
 {
     mSprites.push_back(sprite);
     mNeedsRedraw = true;
+    mNextTime = 0;
 }
 
 void CompoundSprite::setSprite(const size_t layer, Sprite *const sprite)
@@ -283,6 +323,7 @@ void CompoundSprite::setSprite(const size_t layer, Sprite *const sprite)
     delete mSprites[layer];
     mSprites[layer] = sprite;
     mNeedsRedraw = true;
+    mNextTime = 0;
 }
 
 void CompoundSprite::removeSprite(const int layer)
@@ -293,6 +334,7 @@ void CompoundSprite::removeSprite(const int layer)
 
     delete2(mSprites[layer])
     mNeedsRedraw = true;
+    mNextTime = 0;
 }
 
 void CompoundSprite::clear()
@@ -304,10 +346,9 @@ void CompoundSprite::clear()
         mSprites.clear();
     }
     mNeedsRedraw = true;
-    delete_all(imagesCache);
-    imagesCache.clear();
-    delete2(mCacheItem)
+    releaseImages();
     mLastTime = 0;
+    mNextTime = 0;
 }
 
 void CompoundSprite::ensureSize(const size_t layerCount)
@@ -347,19 +388,9 @@ void CompoundSprite::redraw() const
     graphics->setTarget(surface);
     graphics->beginDraw();
 
-    int tileX = mapTileSize / 2;
-    int tileY = mapTileSize;
-
-    const Game *const game = Game::instance();
-    if (game != nullptr)
-    {
-        const Map *const map = game->getCurrentMap();
-        if (map != nullptr)
-        {
-            tileX = map->getTileWidth() / 2;
-            tileY = map->getTileWidth();
-        }
-    }
+    const int tileWidth = getMapTileWidth();
+    const int tileX = tileWidth / 2;
+    const int tileY = tileWidth;
 
     const int posX = BUFFER_WIDTH / 2 - tileX;
     const int posY = BUFFER_HEIGHT - tileY;
@@ -433,9 +464,13 @@ void CompoundSprite::updateImages() const
     if (!mDisableBeingCaching)
     {
         if (mSprites.size() <= 3U)
+        {
+            releaseImages();
             return;
+        }
 
-        if (!mDisableAdvBeingCaching)
+        // alpha fix changes layers, so images can not be shared
+        if (!mDisableAdvBeingCaching && !mEnableAlphaFix)
         {
             if (updateFromCache())
                 return;
@@ -456,87 +491,75 @@ void CompoundSprite::updateImages() const
 bool CompoundSprite::updateFromCache() const
 {
 #ifndef USE_SDL2
-//    static int hits = 0;
-//    static int miss = 0;
-
-    if ((mCacheItem != nullptr) && (mCacheItem->image != nullptr))
+    releaseImages();
+    mCacheKey.clear();
+    if (!getLayersKey(mCacheKey))
     {
-        imagesCache.push_front(mCacheItem);
-        mCacheItem = nullptr;
-        if (imagesCache.size() > cache_max_size)
-        {
-            for (unsigned f = 0; f < cache_clean_part; f ++)
-            {
-                CompoundItem *item = imagesCache.back();
-                imagesCache.pop_back();
-                delete item;
-            }
-        }
+        // images owned by sprite if layers can not be identified
+        mCacheKey.clear();
+        return false;
     }
 
-//    logger->log("cache size: %d, hit %d, miss %d",
-//        (int)imagesCache.size(), hits, miss);
-
-    const size_t sz = mSprites.size();
-    FOR_EACH (ImagesCache::iterator, it, imagesCache)
+    CompoundItem *const item = compoundImageCache.get(mCacheKey,
+        getMapTileWidth());
+    if (item != nullptr)
     {
-        CompoundItem *const ic = *it;
-        if ((ic != nullptr) && ic->data.size() == sz)
-        {
-            bool fail(false);
-            VectorPointers::const_iterator it2 = ic->data.begin();
-            const VectorPointers::const_iterator it2_end = ic->data.end();
-
-            for (SpriteConstIterator it1 = mSprites.begin(),
-                 it1_end = mSprites.end();
-                 it1 != it1_end && it2 != it2_end;
-                 ++ it1, ++ it2)
-            {
-                const void *ptr1 = nullptr;
-                const void *ptr2 = nullptr;
-                if (*it1 != nullptr)
-                    ptr1 = (*it1)->getHash();
-                if (*it2 != nullptr)
-                    ptr2 = *it2;
-                if (ptr1 != ptr2)
-                {
-                    fail = true;
-                    break;
-                }
-            }
-            if (!fail)
-            {
-//                hits ++;
-                mImage = (*it)->image;
-                mAlphaImage = (*it)->alphaImage;
-                imagesCache.erase(it);
-                mCacheItem = ic;
-                return true;
-            }
-        }
+        mCacheItem = item;
+        mImage = item->image;
+        mAlphaImage = item->alphaImage;
+        mOffsetX = item->offsetX;
+        mOffsetY = item->offsetY;
+        return true;
     }
-    mImage = nullptr;
-    mAlphaImage = nullptr;
-//    miss++;
 #endif  // USE_SDL2
     return false;
 }
 
 void CompoundSprite::initCurrentCacheItem() const
 {
-    delete mCacheItem;
-    mCacheItem = new CompoundItem;
-    mCacheItem->image = mImage;
-    mCacheItem->alphaImage = mAlphaImage;
-//    mCacheItem->alpha = mAlpha;
+#ifndef USE_SDL2
+    if (mCacheKey.empty())
+        return;
+    // cache owns images after this
+    mCacheItem = compoundImageCache.add(mCacheKey,
+        getMapTileWidth(),
+        mImage,
+        mAlphaImage,
+        mOffsetX,
+        mOffsetY);
+#endif  // USE_SDL2
+}
+
+void CompoundSprite::releaseImages() const
+{
+    if (mCacheItem != nullptr)
+    {
+        compoundImageCache.release(mCacheItem);
+        mCacheItem = nullptr;
+        mImage = nullptr;
+        mAlphaImage = nullptr;
+    }
+    else
+    {
+        delete2(mImage)
+        delete2(mAlphaImage)
+    }
+}
 
+bool CompoundSprite::getLayersKey(SpriteCacheKeys &data) const
+{
     FOR_EACH (SpriteConstIterator, it, mSprites)
     {
-        if (*it != nullptr)
-            mCacheItem->data.push_back((*it)->getHash());
-        else
-            mCacheItem->data.push_back(nullptr);
+        const Sprite *const sprite = *it;
+        SpriteCacheKey key(0U, nullptr);
+        if (sprite != nullptr &&
+            !sprite->getCacheKey(key))
+        {
+            return false;
+        }
+        data.push_back(key);
     }
+    return true;
 }
 
 bool CompoundSprite::updateNumber(const unsigned num)
@@ -550,13 +573,21 @@ bool CompoundSprite::updateNumber(const unsigned num)
                 res = true;
         }
     }
+    mNextTime = 0;
     return res;
 }
 
 CompoundItem::CompoundItem() :
     data(),
     image(nullptr),
-    alphaImage(nullptr)
+    alphaImage(nullptr),
+    tileWidth(0),
+    offsetX(0),
+    offsetY(0),
+    memory(0),
+    refCount(0),
+    prev(nullptr),
+    next(nullptr)
 {
 }
 
@@ -27,8 +27,6 @@
 
 #include "utils/vector.h"
 
-#include <list>
-
 #include "localconsts.h"
 
 class CompoundItem;
@@ -50,8 +48,13 @@ class CompoundSprite notfinal : public Sprite
 
         bool play(const std::string &action) override final;
 
+        bool play(const int actionId) override final;
+
         bool update(const int time) override final;
 
+        int getNextUpdateTime() const override final A_WARN_UNUSED
+        { return mNextTime; }
+
         void drawSimple(Graphics *const graphics,
                         const int posX,
                         const int posY) const A_NONNULL(2);
@@ -119,8 +122,15 @@ class CompoundSprite notfinal : public Sprite
 
         void initCurrentCacheItem() const;
 
-        typedef std::list<CompoundItem*> ImagesCache;
-        mutable ImagesCache imagesCache;
+        void releaseImages() const;
+
+        /**
+         * Adds to list keys of layers in drawing order.
+         * Returns false if some layer have no key.
+         */
+        virtual bool getLayersKey(SpriteCacheKeys &data) const A_WARN_UNUSED;
+
+        mutable SpriteCacheKeys mCacheKey;
         mutable CompoundItem *mCacheItem;
 
         mutable Image *mImage;
@@ -130,6 +140,8 @@ class CompoundSprite notfinal : public Sprite
         mutable int mOffsetY;
         int mStartTime;
         int mLastTime;
+        // minimal next update time of all layers
+        int mNextTime;
 #ifndef USE_SDL2
         mutable int mNextRedrawTime;
 #endif  // USE_SDL2
@@ -28,6 +28,7 @@
 #include "gamemodifiers.h"
 #include "guild.h"
 #include "party.h"
+#include "pathrequestmanager.h"
 #include "settings.h"
 #include "soundmanager.h"
 #include "statuseffect.h"
@@ -147,6 +148,8 @@ LocalPlayer::LocalPlayer(const BeingId id,
     mOldTileX(0),
     mOldTileY(0),
     mNavigatePath(),
+    mNavigateTicket(0),
+    mFixAttackTicket(0),
     mLastHitFrom(),
     mWaitFor(),
     mAdvertTime(0),
@@ -240,6 +243,7 @@ LocalPlayer::~LocalPlayer()
     serverConfig.removeListener("enableBuggyServers", this);
 
     navigateClean();
+    cancelPathRequests();
     mCrossX = 0;
     mCrossY = 0;
 
@@ -275,6 +279,8 @@ void LocalPlayer::logic()
         mFreezed = false;
     }
 
+    updatePathRequests();
+
     if ((mAction != BeingAction::MOVE || mNextStep) && !mNavigatePath.empty())
     {
         mNextStep = false;
@@ -535,17 +541,7 @@ bool LocalPlayer::pickUp(FloorItem *const item)
     }
     else if (pickUpType >= 4 && pickUpType <= 6)
     {
-        const Path debugPath = mMap->findPath(
-            (mPixelX - mapTileSize / 2) / mapTileSize,
-            (mPixelY - mapTileSize) / mapTileSize,
-            item->getTileX(),
-            item->getTileY(),
-            getBlockWalkMask(),
-            0);
-        if (!debugPath.empty())
-            navigateTo(item->getTileX(), item->getTileY());
-        else
-            setDestination(item->getTileX(), item->getTileY());
+        navigateOrMoveTo(item->getTileX(), item->getTileY());
 
         mPickUpTarget = item;
         mPickUpTarget->addActorSpriteListener(this);
@@ -1380,7 +1376,7 @@ void LocalPlayer::moveToTarget(int dist)
     {
         if (mMap != nullptr)
         {
-            debugPath = mMap->findPath(
+            mMap->findPath(debugPath,
                 (mPixelX - mapTileSize / 2) / mapTileSize,
                 (mPixelY - mapTileSize) / mapTileSize,
                 mTarget->mX,
@@ -1565,6 +1561,7 @@ bool LocalPlayer::isReachable(Being *const being,
         return true;
     }
 
+    // caller need answer now, async request not usable here
     const Path debugPath = mMap->findPath(
         (mPixelX - mapTileSize / 2) / mapTileSize,
         (mPixelY - mapTileSize) / mapTileSize,
@@ -1835,6 +1832,7 @@ void LocalPlayer::setMap(Map *const map)
             socialWindow->updateActiveList();
     }
     navigateClean();
+    cancelPathRequests();
     mCrossX = 0;
     mCrossY = 0;
 
@@ -2121,15 +2119,8 @@ void LocalPlayer::afkRespond(ChatTab *const tab, const std::string &nick)
     }
 }
 
-bool LocalPlayer::navigateTo(const int x, const int y)
+void LocalPlayer::setNavigateTarget(const int x, const int y)
 {
-    if (mMap == nullptr)
-        return false;
-
-    SpecialLayer *const tmpLayer = mMap->getTempLayer();
-    if (tmpLayer == nullptr)
-        return false;
-
     mShowNavigePath = true;
     mOldX = mPixelX;
     mOldY = mPixelY;
@@ -2138,8 +2129,27 @@ bool LocalPlayer::navigateTo(const int x, const int y)
     mNavigateX = x;
     mNavigateY = y;
     mNavigateId = BeingId_zero;
+}
 
-    mNavigatePath = mMap->findPath(
+bool LocalPlayer::navigateTo(const int x, const int y)
+{
+    if (mMap == nullptr)
+        return false;
+
+    SpecialLayer *const tmpLayer = mMap->getTempLayer();
+    if (tmpLayer == nullptr)
+        return false;
+
+    // synchronous path replace any pending request
+    if (mNavigateTicket != 0)
+    {
+        if (pathRequestManager != nullptr)
+            pathRequestManager->cancel(mNavigateTicket);
+        mNavigateTicket = 0;
+    }
+    setNavigateTarget(x, y);
+
+    mMap->findPath(mNavigatePath,
         (mPixelX - mapTileSize / 2) / mapTileSize,
         (mPixelY - mapTileSize) / mapTileSize,
         x,
@@ -2152,8 +2162,106 @@ bool LocalPlayer::navigateTo(const int x, const int y)
     return !mNavigatePath.empty();
 }
 
+void LocalPlayer::navigateOrMoveTo(const int x, const int y)
+{
+    if (mMap == nullptr ||
+        mMap->getTempLayer() == nullptr)
+    {
+        setDestination(x, y);
+        return;
+    }
+
+    if (pathRequestManager != nullptr)
+    {
+        if (mNavigateTicket != 0)
+            pathRequestManager->cancel(mNavigateTicket);
+        mNavigateTicket = pathRequestManager->request(
+            (mPixelX - mapTileSize / 2) / mapTileSize,
+            (mPixelY - mapTileSize) / mapTileSize,
+            x,
+            y,
+            getBlockWalkMask(),
+            0);
+        if (mNavigateTicket != 0)
+        {
+            // old path walked until new one set in updatePathRequests,
+            // if path not found player moved directly
+            setNavigateTarget(x, y);
+            return;
+        }
+    }
+
+    if (!navigateTo(x, y))
+        setDestination(x, y);
+}
+
+void LocalPlayer::updatePathRequests()
+{
+    if (pathRequestManager == nullptr)
+        return;
+
+    if (mNavigateTicket != 0)
+    {
+        if (pathRequestManager->getResult(mNavigateTicket, mNavigatePath))
+        {
+            mNavigateTicket = 0;
+            if (mNavigatePath.empty())
+            {
+                setDestination(mNavigateX, mNavigateY);
+            }
+            else if (mDrawPath && mMap != nullptr)
+            {
+                SpecialLayer *const tmpLayer = mMap->getTempLayer();
+                if (tmpLayer != nullptr)
+                    tmpLayer->addRoad(mNavigatePath);
+            }
+        }
+        else if (!pathRequestManager->isPending(mNavigateTicket))
+        {
+            mNavigateTicket = 0;
+        }
+    }
+
+    if (mFixAttackTicket != 0)
+    {
+        Path path;
+        if (pathRequestManager->getResult(mFixAttackTicket, path))
+        {
+            mFixAttackTicket = 0;
+            if (!path.empty() && mTarget != nullptr)
+            {
+                const Path::const_iterator i = path.begin();
+                setDestination((*i).x, (*i).y);
+            }
+        }
+        else if (!pathRequestManager->isPending(mFixAttackTicket))
+        {
+            mFixAttackTicket = 0;
+        }
+    }
+}
+
+void LocalPlayer::cancelPathRequests()
+{
+    if (pathRequestManager != nullptr)
+    {
+        if (mNavigateTicket != 0)
+            pathRequestManager->cancel(mNavigateTicket);
+        if (mFixAttackTicket != 0)
+            pathRequestManager->cancel(mFixAttackTicket);
+    }
+    mNavigateTicket = 0;
+    mFixAttackTicket = 0;
+}
+
 void LocalPlayer::navigateClean()
 {
+    if (mNavigateTicket != 0)
+    {
+        if (pathRequestManager != nullptr)
+            pathRequestManager->cancel(mNavigateTicket);
+        mNavigateTicket = 0;
+    }
     if (mMap == nullptr)
         return;
 
@@ -2724,9 +2832,26 @@ void LocalPlayer::fixAttackTarget()
         return;
     }
 
+    const int startX = (mPixelX - mapTileSize / 2) / mapTileSize;
+    const int startY = (mPixelY - mapTileSize) / mapTileSize;
+    if (pathRequestManager != nullptr)
+    {
+        // first step of path set in updatePathRequests
+        if (mFixAttackTicket != 0)
+            pathRequestManager->cancel(mFixAttackTicket);
+        mFixAttackTicket = pathRequestManager->request(startX,
+            startY,
+            mTarget->mX,
+            mTarget->mY,
+            getBlockWalkMask(),
+            0);
+        if (mFixAttackTicket != 0)
+            return;
+    }
+
     const Path debugPath = mMap->findPath(
-        (mPixelX - mapTileSize / 2) / mapTileSize,
-        (mPixelY - mapTileSize) / mapTileSize,
+        startX,
+        startY,
         mTarget->mX,
         mTarget->mY,
         getBlockWalkMask(),
@@ -245,6 +245,12 @@ class LocalPlayer final : public Being,
 
         bool navigateTo(const int x, const int y);
 
+        /**
+         * Requests path to given tile in path thread. Player moves to
+         * tile directly if path not found.
+         */
+        void navigateOrMoveTo(const int x, const int y);
+
         void navigateClean();
 
         void imitateEmote(const Being *const being,
@@ -453,6 +459,12 @@ class LocalPlayer final : public Being,
 
         void loadHomes();
 
+        void updatePathRequests();
+
+        void cancelPathRequests();
+
+        void setNavigateTarget(const int x, const int y);
+
         // move state. used if mMoveType == 2
         unsigned int mMoveState;
 
@@ -496,6 +508,8 @@ class LocalPlayer final : public Being,
         int mOldTileX;
         int mOldTileY;
         Path mNavigatePath;
+        int mNavigateTicket;
+        int mFixAttackTicket;
 
         std::string mLastHitFrom;
         std::string mWaitFor;
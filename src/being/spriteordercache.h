@@ -0,0 +1,75 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEING_SPRITEORDERCACHE_H
+#define BEING_SPRITEORDERCACHE_H
+
+#include "utils/lrucache.h"
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+/**
+ * Result of sprites reordering for one equipment set.
+ */
+struct SpriteOrder final
+{
+    SpriteOrder() :
+        hide(),
+        remap(),
+        tempSlots(),
+        tempIds(),
+        reordered(false)
+    {
+    }
+
+    A_DEFAULT_COPY(SpriteOrder)
+
+    void clear()
+    {
+        hide.clear();
+        remap.clear();
+        tempSlots.clear();
+        tempIds.clear();
+        reordered = false;
+    }
+
+    // hide flag or replacement item for each layer
+    STD_VECTOR<int> hide;
+    // draw order of layers
+    STD_VECTOR<int> remap;
+    // replaced sprites in order of replacing
+    STD_VECTOR<int> tempSlots;
+    STD_VECTOR<int> tempIds;
+    // false if draw order can not be calculated
+    bool reordered;
+};
+
+/**
+ * Shared cache of sprites order by equipment, direction and action.
+ *
+ * Key is list of sprite ids with other parameters added to end.
+ */
+typedef LruCache<STD_VECTOR<int>, SpriteOrder, IntVectorHash>
+    SpriteOrderCache;
+
+extern SpriteOrderCache spriteOrderCache;
+
+#endif  // BEING_SPRITEORDERCACHE_H
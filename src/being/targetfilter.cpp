@@ -0,0 +1,121 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "being/targetfilter.h"
+
+#include "being/being.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+
+#include "debug.h"
+
+namespace
+{
+    StringIntMap nameIds;
+    int nameIdsCount = 1;
+
+    // index used for mobs what not present in list
+    const int defaultIndex = 10000;
+}  // namespace
+
+TargetFilter::TargetFilter() :
+    mEntries(),
+    mDefaultPriorityIndex(defaultIndex),
+    mDefaultAttackIndex(defaultIndex),
+    mIgnoreDefault(false)
+{
+}
+
+int TargetFilter::getNameId(const std::string &name)
+{
+    if (name.empty())
+        return 0;
+    const StringIntMapCIter it = nameIds.find(name);
+    if (it != nameIds.end())
+        return (*it).second;
+    const int id = nameIdsCount;
+    nameIdsCount ++;
+    nameIds[name] = id;
+    return id;
+}
+
+TargetFilter::Entry &TargetFilter::getEntry(const std::string &name)
+{
+    const size_t id = CAST_SIZE(getNameId(name));
+    if (id >= mEntries.size())
+        mEntries.resize(id + 1);
+    return mEntries[id];
+}
+
+void TargetFilter::rebuild(const StringIntMap &priorityMobs,
+                           const StringIntMap &attackMobs,
+                           const std::set<std::string> &ignoreMobs)
+{
+    mEntries.clear();
+    FOR_EACH (StringIntMapCIter, it, priorityMobs)
+        getEntry((*it).first).priorityIndex = (*it).second;
+    FOR_EACH (StringIntMapCIter, it, attackMobs)
+        getEntry((*it).first).attackIndex = (*it).second;
+    FOR_EACH (std::set<std::string>::const_iterator, it, ignoreMobs)
+        getEntry(*it).ignored = true;
+
+    mDefaultPriorityIndex = defaultIndex;
+    mDefaultAttackIndex = defaultIndex;
+    mIgnoreDefault = false;
+    if (!mEntries.empty())
+    {
+        const Entry &entry = mEntries[0];
+        if (entry.priorityIndex >= 0)
+            mDefaultPriorityIndex = entry.priorityIndex;
+        if (entry.attackIndex >= 0)
+            mDefaultAttackIndex = entry.attackIndex;
+        mIgnoreDefault = entry.ignored;
+    }
+}
+
+bool TargetFilter::isIgnored(const Being *const being) const
+{
+    const size_t id = CAST_SIZE(being->getNameId());
+    if (id >= mEntries.size())
+        return mIgnoreDefault;
+    const Entry &entry = mEntries[id];
+    if (entry.ignored)
+        return true;
+    return mIgnoreDefault &&
+        entry.priorityIndex < 0 &&
+        entry.attackIndex < 0;
+}
+
+int TargetFilter::getPriorityIndex(const Being *const being) const
+{
+    const size_t id = CAST_SIZE(being->getNameId());
+    if (id >= mEntries.size() || mEntries[id].priorityIndex < 0)
+        return mDefaultPriorityIndex;
+    return mEntries[id].priorityIndex;
+}
+
+int TargetFilter::getAttackIndex(const Being *const being) const
+{
+    const size_t id = CAST_SIZE(being->getNameId());
+    if (id >= mEntries.size() || mEntries[id].attackIndex < 0)
+        return mDefaultAttackIndex;
+    return mEntries[id].attackIndex;
+}
@@ -0,0 +1,96 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEING_TARGETFILTER_H
+#define BEING_TARGETFILTER_H
+
+#include "utils/stringmap.h"
+#include "utils/vector.h"
+
+#include <set>
+
+#include "localconsts.h"
+
+class Being;
+
+/**
+ * Attack lists compiled to table indexed by being name id.
+ *
+ * Names converted to ids once, when being name set, so checks for
+ * targets not compare or copy strings. Id of empty name is zero.
+ */
+class TargetFilter final
+{
+    public:
+        TargetFilter();
+
+        A_DELETE_COPY(TargetFilter)
+
+        /**
+         * Returns id for given name. New names get new ids.
+         */
+        static int getNameId(const std::string &name) A_WARN_UNUSED;
+
+        void rebuild(const StringIntMap &priorityMobs,
+                     const StringIntMap &attackMobs,
+                     const std::set<std::string> &ignoreMobs);
+
+        /**
+         * Returns true if being present in ignore list, or if it not
+         * present in any list and other mobs ignored by default.
+         */
+        bool isIgnored(const Being *const being) const A_WARN_UNUSED;
+
+        int getPriorityIndex(const Being *const being) const A_WARN_UNUSED;
+
+        int getAttackIndex(const Being *const being) const A_WARN_UNUSED;
+
+        int getDefaultPriorityIndex() const noexcept2 A_WARN_UNUSED
+        { return mDefaultPriorityIndex; }
+
+        int getDefaultAttackIndex() const noexcept2 A_WARN_UNUSED
+        { return mDefaultAttackIndex; }
+
+    private:
+        struct Entry final
+        {
+            Entry() :
+                priorityIndex(-1),
+                attackIndex(-1),
+                ignored(false)
+            {
+            }
+
+            A_DEFAULT_COPY(Entry)
+
+            int priorityIndex;
+            int attackIndex;
+            bool ignored;
+        };
+
+        Entry &getEntry(const std::string &name);
+
+        STD_VECTOR<Entry> mEntries;
+        int mDefaultPriorityIndex;
+        int mDefaultAttackIndex;
+        bool mIgnoreDefault;
+};
+
+#endif  // BEING_TARGETFILTER_H
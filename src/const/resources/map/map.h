@@ -26,4 +26,7 @@
 
 static const int mapTileSize = 32;
 
+// cluster size in tiles for hierarchical path finding
+static const int mapClusterSize = 16;
+
 #endif  // CONST_RESOURCES_MAP_MAP_H
@@ -274,9 +274,19 @@ void setConfigDefaults(Configuration &cfg)
     AddDEF("enableMapReduce", true);
     AddDEF("showPlayersStatus", true);
     AddDEF("beingopacity", false);
+    AddDEF("enableHierarchicalPath", false);
+    AddDEF("enableJumpPointSearch", true);
+    AddDEF("enableMapCache", true);
+    AddDEF("enableParallelMapLoad", true);
+    AddDEF("enableParallelSoftwareRender", true);
+    AddDEF("enableMapPreload", true);
+    AddDEF("preloadMapsDistance", 10);
+    AddDEF("preloadMapsMemory", 64);
+    AddDEF("enableLogicCulling", true);
     AddDEF("adjustPerfomance", true);
     AddDEF("enableAlphaFix", false);
-    AddDEF("disableAdvBeingCaching", true);
+    AddDEF("disableAdvBeingCaching", false);
+    AddDEF("compoundImageCacheSize", 16);
     AddDEF("disableBeingCaching", false);
     AddDEF("enableReorderSprites", true);
     AddDEF("showip", false);
@@ -349,6 +359,8 @@ void setConfigDefaults(Configuration &cfg)
 
     AddDEF("useAtlases", true);
 #endif  // ANDROID
+    AddDEF("packAtlases", true);
+    AddDEF("enableAtlasCache", true);
 
     AddDEF("useTextureSampler", false);
     AddDEF("ministatussaved", 0);
@@ -29,9 +29,12 @@
 #include "effectmanager.h"
 #include "eventsmanager.h"
 #include "gamemodifiers.h"
+#include "mappreloader.h"
+#include "pathrequestmanager.h"
 #include "soundmanager.h"
 #include "settings.h"
 
+#include "being/compoundimagecache.h"
 #include "being/crazymoves.h"
 #include "being/localplayer.h"
 #include "being/playerinfo.h"
@@ -173,6 +176,8 @@ static void initEngines()
 #endif  // TMWA_SUPPORT
 
     crazyMoves = new CrazyMoves;
+    pathRequestManager = new PathRequestManager;
+    mapPreloader = new MapPreloader;
 
     particleEngine = new ParticleEngine;
     particleEngine->setMap(nullptr);
@@ -443,6 +448,8 @@ Game::Game() :
 
     CompoundSprite::setEnableDelay(
         config.getBoolValue("enableCompoundSpriteDelay"));
+    compoundImageCache.setMaxMemory(
+        config.getIntValue("compoundImageCacheSize") * 1024 * 1024);
 
     createGuiWindows();
     windowMenu = new WindowMenu(nullptr);
@@ -510,9 +517,13 @@ Game::~Game()
 #endif  // USE_MUMBLE
 
     delete2(crazyMoves)
+    delete2(pathRequestManager)
+    delete2(mapPreloader)
+    MapReader::deleteThreadPool();
     delete2(emptyBeingSlot)
 
     Being::clearCache();
+    compoundImageCache.clear();
     mInstance = nullptr;
     PlayerInfo::gameDestroyed();
 }
@@ -672,6 +683,10 @@ void Game::logic()
         particleEngine->update();
     if (mCurrentMap != nullptr)
         mCurrentMap->update(1);
+    if (pathRequestManager != nullptr)
+        pathRequestManager->logic();
+    if (mapPreloader != nullptr)
+        mapPreloader->logic();
 
     BLOCK_END("Game::logic")
 }
@@ -1146,6 +1161,10 @@ void Game::changeMap(const std::string &mapPath)
         particleEngine->setMap(newMap);
     if (viewport != nullptr)
         viewport->setMap(newMap);
+    if (pathRequestManager != nullptr)
+        pathRequestManager->setMap(newMap);
+    if (mapPreloader != nullptr)
+        mapPreloader->setMap(newMap);
 
     // Initialize map-based particle effects
     if (newMap != nullptr)
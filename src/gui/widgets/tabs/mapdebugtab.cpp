@@ -23,8 +23,10 @@
 
 #include "gui/widgets/tabs/mapdebugtab.h"
 
+#include "actormanager.h"
 #include "game.h"
 
+#include "being/beinginfocache.h"
 #include "being/localplayer.h"
 
 #include "particle/particleengine.h"
@@ -66,10 +68,16 @@ MapDebugTab::MapDebugTab(const Widget2 *const widget) :
     mMapActorCountLabel(new Label(this, strprintf("%s %d",
         // TRANSLATORS: debug window label
         _("Map actors count:"), 88888))),
+    mBeingCacheLabel(new Label(this, strprintf("%s %d / %d",
+        // TRANSLATORS: debug window label
+        _("Beings cache hits / misses:"), 88888, 88888))),
+    mActorLogicLabel(new Label(this, strprintf("%s %d / %d",
+        // TRANSLATORS: debug window label
+        _("Actors logic full / culled:"), 88888, 88888))),
 #ifdef USE_OPENGL
-    mMapAtlasCountLabel(new Label(this, strprintf("%s %d",
+    mMapAtlasCountLabel(new Label(this, strprintf("%s %d / %d%%",
         // TRANSLATORS: debug window label
-        _("Map atlas count:"), 88888))),
+        _("Map atlas count / occupancy:"), 88888, 100))),
 #endif  // USE_OPENGL
     // TRANSLATORS: debug window label
     mXYLabel(new Label(this, strprintf("%s (?,?)", _("Player Position:")))),
@@ -78,7 +86,7 @@ MapDebugTab::MapDebugTab(const Widget2 *const widget) :
 #ifdef DEBUG_DRAW_CALLS
     mDrawCallsLabel(new Label(this, strprintf("%s %s",
         // TRANSLATORS: debug window label
-        _("Draw calls:"), "?"))),
+        _("Draw calls / batches:"), "?"))),
 #endif  // DEBUG_DRAW_CALLS
 #ifdef DEBUG_BIND_TEXTURE
     mBindsLabel(new Label(this, strprintf("%s %s",
@@ -142,11 +150,13 @@ MapDebugTab::MapDebugTab(const Widget2 *const widget) :
     place(0, 6, mTileMouseLabel, 2, 1);
     place(0, 7, mParticleCountLabel, 2, 1);
     place(0, 8, mMapActorCountLabel, 2, 1);
+    place(0, 9, mBeingCacheLabel, 2, 1);
+    place(0, 10, mActorLogicLabel, 2, 1);
 #ifdef USE_OPENGL
-    place(0, 9, mMapAtlasCountLabel, 2, 1);
+    place(0, 11, mMapAtlasCountLabel, 2, 1);
 #if defined (DEBUG_OPENGL_LEAKS) || defined(DEBUG_DRAW_CALLS) \
     || defined(DEBUG_BIND_TEXTURE)
-    int n = 10;
+    int n = 12;
 #endif  // defined (DEBUG_OPENGL_LEAKS) || defined(DEBUG_DRAW_CALLS)
         // || defined(DEBUG_BIND_TEXTURE)
 #ifdef DEBUG_OPENGL_LEAKS
@@ -223,11 +233,25 @@ void MapDebugTab::logic()
                 // TRANSLATORS: debug window label
                 strprintf("%s %d", _("Map actors count:"),
                 map->getActorsCount()));
+            mBeingCacheLabel->setCaption(strprintf("%s %d / %d",
+                // TRANSLATORS: debug window label
+                _("Beings cache hits / misses:"),
+                beingInfoCache.getHits(),
+                beingInfoCache.getMisses()));
+            if (actorManager != nullptr)
+            {
+                mActorLogicLabel->setCaption(strprintf("%s %d / %d",
+                    // TRANSLATORS: debug window label
+                    _("Actors logic full / culled:"),
+                    actorManager->getFullLogicCount(),
+                    actorManager->getCulledLogicCount()));
+            }
 #ifdef USE_OPENGL
             mMapAtlasCountLabel->setCaption(
                 // TRANSLATORS: debug window label
-                strprintf("%s %d", _("Map atlas count:"),
-                map->getAtlasCount()));
+                strprintf("%s %d / %d%%", _("Map atlas count / occupancy:"),
+                map->getAtlasCount(),
+                map->getAtlasOccupancy()));
 #ifdef DEBUG_OPENGL_LEAKS
             mTexturesLabel->setCaption(strprintf("%s %d",
                 // TRANSLATORS: debug window label
@@ -236,9 +260,11 @@ void MapDebugTab::logic()
 #ifdef DEBUG_DRAW_CALLS
             if (mainGraphics)
             {
-                mDrawCallsLabel->setCaption(strprintf("%s %d",
+                mDrawCallsLabel->setCaption(strprintf("%s %d / %d",
                     // TRANSLATORS: debug window label
-                    _("Draw calls:"), mainGraphics->getDrawCalls()));
+                    _("Draw calls / batches:"),
+                    mainGraphics->getDrawCalls(),
+                    mainGraphics->getBatches()));
             }
 #endif  // DEBUG_DRAW_CALLS
 #ifdef DEBUG_BIND_TEXTURE
@@ -270,11 +296,13 @@ void MapDebugTab::logic()
 #ifdef USE_OPENGL
         mMapAtlasCountLabel->setCaption(
             // TRANSLATORS: debug window label
-            strprintf("%s ?", _("Map atlas count:")));
+            strprintf("%s ?", _("Map atlas count / occupancy:")));
 #endif  // USE_OPENGL
     }
 
     mMapActorCountLabel->adjustSize();
+    mBeingCacheLabel->adjustSize();
+    mActorLogicLabel->adjustSize();
     mParticleCountLabel->adjustSize();
 #ifdef USE_OPENGL
     mMapAtlasCountLabel->adjustSize();
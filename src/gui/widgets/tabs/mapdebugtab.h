@@ -47,6 +47,8 @@ class MapDebugTab final : public DebugTab
         Label *mTileMouseLabel A_NONNULLPOINTER;
         Label *mParticleCountLabel A_NONNULLPOINTER;
         Label *mMapActorCountLabel A_NONNULLPOINTER;
+        Label *mBeingCacheLabel A_NONNULLPOINTER;
+        Label *mActorLogicLabel A_NONNULLPOINTER;
 #ifdef USE_OPENGL
         Label *mMapAtlasCountLabel A_NONNULLPOINTER;
 #endif  // USE_OPENGL
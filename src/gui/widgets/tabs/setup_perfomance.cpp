@@ -101,11 +101,47 @@ Setup_Perfomance::Setup_Perfomance(const Widget2 *const widget) :
         MainConfig_true);
 #endif  // USE_SDL2
 
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Enable hierarchical path finding"), "",
+        "enableHierarchicalPath", this, "enableHierarchicalPathEvent",
+        MainConfig_true);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Enable jump point path finding"), "",
+        "enableJumpPointSearch", this, "enableJumpPointSearchEvent",
+        MainConfig_true);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Enable compiled map cache"), "",
+        "enableMapCache", this, "enableMapCacheEvent",
+        MainConfig_true);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Enable parallel map layers decoding"), "",
+        "enableParallelMapLoad", this, "enableParallelMapLoadEvent",
+        MainConfig_true);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Enable maps preloading (needs map cache)"), "",
+        "enableMapPreload", this, "enableMapPreloadEvent",
+        MainConfig_true);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Reduce logic for actors outside of screen"), "",
+        "enableLogicCulling", this, "enableLogicCullingEvent",
+        MainConfig_true);
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Enable compound sprite delay (Software)"), "",
         "enableCompoundSpriteDelay", this, "enableCompoundSpriteDelayEvent",
         MainConfig_true);
 
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(
+        _("Enable parallel rendering (Software, SDL2 only)"), "",
+        "enableParallelSoftwareRender", this,
+        "enableParallelSoftwareRenderEvent", MainConfig_true);
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Enable delayed images load (OpenGL)"), "",
         "enableDelayedAnimations", this, "enableDelayedAnimationsEvent",
@@ -202,6 +238,16 @@ Setup_Perfomance::Setup_Perfomance(const Widget2 *const widget) :
         "useAtlases", this, "useAtlasesEvent",
         MainConfig_true);
 
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Pack texture atlases tightly (OpenGL)"), "",
+        "packAtlases", this, "packAtlasesEvent",
+        MainConfig_true);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Cache texture atlases on disk (OpenGL)"), "",
+        "enableAtlasCache", this, "enableAtlasCacheEvent",
+        MainConfig_true);
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Cache all sprites per map (can use "
         "additional memory)"), "", "uselonglivesprites", this,
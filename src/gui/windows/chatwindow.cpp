@@ -705,7 +705,7 @@ void ChatWindow::doPresent() const
     std::string response;
     int playercount = 0;
 
-    FOR_EACH (ActorSpritesIterator, it, actors)
+    FOR_EACH (ActorSpritesConstIterator, it, actors)
     {
         if ((*it)->getType() == ActorType::Player)
         {
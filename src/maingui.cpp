@@ -57,6 +57,7 @@ PRAGMA48(GCC diagnostic pop)
 
 #include "utils/cpu.h"
 #include "utils/sdlhelper.h"
+#include "render/pixelblend.h"
 #include "resources/dye/dyepalette.h"
 #ifdef UNITTESTS_CATCH
 #define CATCH_CONFIG_RUNNER
@@ -216,6 +217,7 @@ int main(int argc, char *argv[])
     VirtFs::init(argv[0]);
     Cpu::detect();
     DyePalette::initFunctions();
+    PixelBlend::initFunctions();
 #ifdef UNITTESTS_CATCH
     return Catch::Session().run(argc, argv);
 #elif defined(UNITTESTS_DOCTEST)
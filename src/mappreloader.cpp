@@ -0,0 +1,334 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mappreloader.h"
+
+#include "configuration.h"
+#include "logger.h"
+
+#include "being/localplayer.h"
+
+#include "enums/resources/map/mapitemtype.h"
+
+#include "fs/virtfs/fs.h"
+
+#include "resources/mapreader.h"
+
+#include "resources/db/mapdb.h"
+
+#include "resources/image/image.h"
+
+#include "resources/loaders/imageloader.h"
+
+#include "resources/map/map.h"
+#include "resources/map/mapcache.h"
+#include "resources/map/mapitem.h"
+
+#include "utils/foreach.h"
+#include "utils/sdlhelper.h"
+#include "utils/stringutils.h"
+
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_mutex.h>
+PRAGMA48(GCC diagnostic pop)
+
+#include <cstdlib>
+
+#include "debug.h"
+
+MapPreloader *mapPreloader = nullptr;
+
+MapPreloader::MapPreloader() :
+    mMap(nullptr),
+    mMapFiles(),
+    mImageFiles(),
+    mImages(),
+    mCurrentFile(),
+    mTarget(),
+    mState(STATE_IDLE),
+    mMemory(0),
+    mLastX(-1),
+    mLastY(-1),
+    mThread(nullptr),
+    mMutex(SDL_CreateMutex()),
+    mCond(SDL_CreateCond()),
+    mDataFile(),
+    mResultFile(),
+    mResultCache(nullptr),
+    mCompiled(false),
+    mStop(false)
+{
+    if (mMutex != nullptr && mCond != nullptr)
+        mThread = SDL::createThread(&compileThread, "mappreload", this);
+    if (mThread == nullptr)
+        logger->log1("Could not create map preload thread");
+}
+
+MapPreloader::~MapPreloader()
+{
+    if (mThread != nullptr)
+    {
+        SDL_mutexP(mMutex);
+        mStop = true;
+        SDL_CondSignal(mCond);
+        SDL_mutexV(mMutex);
+        SDL::WaitThread(mThread);
+        mThread = nullptr;
+    }
+    if (mCond != nullptr)
+        SDL_DestroyCond(mCond);
+    if (mMutex != nullptr)
+        SDL_DestroyMutex(mMutex);
+    delete mResultCache;
+    releaseImages();
+}
+
+void MapPreloader::setMap(const Map *const map)
+{
+    mMap = map;
+    mCurrentFile.clear();
+    if (mMap != nullptr)
+        mCurrentFile = mMap->getProperty("_filename", std::string());
+    mMapFiles.clear();
+    mImageFiles.clear();
+    mTarget.clear();
+    mState = STATE_IDLE;
+    mLastX = -1;
+    mLastY = -1;
+    // new map already loaded, so preloaded images not needed anymore
+    releaseImages();
+}
+
+void MapPreloader::logic()
+{
+    if (mMap == nullptr || localPlayer == nullptr)
+        return;
+
+    if (mState == STATE_COMPILE)
+    {
+        MapCache *cache = nullptr;
+        bool compiled = false;
+        SDL_mutexP(mMutex);
+        if (mCompiled && mResultFile == mTarget)
+        {
+            cache = mResultCache;
+            mResultCache = nullptr;
+            mCompiled = false;
+            compiled = true;
+        }
+        SDL_mutexV(mMutex);
+        if (compiled && cache == nullptr)
+        {
+            mState = STATE_DONE;
+        }
+        else if (cache != nullptr)
+        {
+            addImages(*cache);
+            delete cache;
+            mState = STATE_IMAGES;
+        }
+    }
+    else if (mState == STATE_IMAGES)
+    {
+        loadNextImage();
+    }
+
+    const int tileX = localPlayer->getTileX();
+    const int tileY = localPlayer->getTileY();
+    if (tileX == mLastX && tileY == mLastY)
+        return;
+    mLastX = tileX;
+    mLastY = tileY;
+
+    // preloaded map kept only in map cache
+    if (!config.getBoolValue("enableMapPreload") ||
+        !config.getBoolValue("enableMapCache"))
+    {
+        return;
+    }
+
+    const int maxDistance = config.getIntValue("preloadMapsDistance");
+    int bestDistance = maxDistance + 1;
+    std::string bestFile;
+    const STD_VECTOR<MapItem*> &portals = mMap->getPortals();
+    FOR_EACH (STD_VECTOR<MapItem*>::const_iterator, it, portals)
+    {
+        const MapItem *const portal = *it;
+        if (portal == nullptr ||
+            portal->getType() != MapItemType::PORTAL)
+        {
+            continue;
+        }
+        const int dx = abs(portal->getX() - tileX);
+        const int dy = abs(portal->getY() - tileY);
+        const int distance = dx > dy ? dx : dy;
+        if (distance >= bestDistance)
+            continue;
+        const std::string fileName = findMapFile(portal->getDestination());
+        if (fileName.empty())
+            continue;
+        bestDistance = distance;
+        bestFile = fileName;
+    }
+    if (!bestFile.empty() && bestFile != mTarget)
+        startPreload(bestFile);
+}
+
+std::string MapPreloader::findMapFile(const std::string &mapName)
+{
+    if (mapName.empty())
+        return std::string();
+    const std::map<std::string, std::string>::const_iterator found =
+        mMapFiles.find(mapName);
+    if (found != mMapFiles.end())
+        return found->second;
+
+    std::string fileName = pathJoin(paths.getValue("maps", "maps/"),
+        MapDB::getMapName(mapName)).append(".tmx");
+    if (!VirtFs::exists(fileName))
+        fileName.append(".gz");
+    std::string result;
+    if (fileName != mCurrentFile && VirtFs::exists(fileName))
+        result = fileName;
+    mMapFiles[mapName] = result;
+    return result;
+}
+
+void MapPreloader::startPreload(const std::string &fileName)
+{
+    releaseImages();
+    mImageFiles.clear();
+    mTarget = fileName;
+    mState = STATE_DONE;
+    if (mThread == nullptr)
+        return;
+
+    SDL_mutexP(mMutex);
+    mDataFile = fileName;
+    mCompiled = false;
+    SDL_CondSignal(mCond);
+    SDL_mutexV(mMutex);
+    mState = STATE_COMPILE;
+}
+
+void MapPreloader::addImages(const MapCache &cache)
+{
+    const STD_VECTOR<MapCacheTileset> &tilesets = cache.getTilesets();
+    FOR_EACH (STD_VECTOR<MapCacheTileset>::const_iterator, it, tilesets)
+    {
+        if (!(*it).image.empty())
+            mImageFiles.push_back((*it).image);
+    }
+}
+
+void MapPreloader::loadNextImage()
+{
+    if (mImageFiles.empty())
+    {
+        mState = STATE_DONE;
+        return;
+    }
+    const std::string fileName = mImageFiles.back();
+    mImageFiles.pop_back();
+
+    Image *const image = Loader::getImage(fileName);
+    if (image == nullptr)
+        return;
+    const int size = image->getWidth() * image->getHeight() * 4;
+    if (mMemory + size > config.getIntValue("preloadMapsMemory")
+        * 1024 * 1024)
+    {
+        image->decRef();
+        mImageFiles.clear();
+        mState = STATE_DONE;
+        return;
+    }
+    mMemory += size;
+    mImages.push_back(image);
+}
+
+void MapPreloader::releaseImages()
+{
+    FOR_EACH (STD_VECTOR<Image*>::iterator, it, mImages)
+        (*it)->decRef();
+    mImages.clear();
+    mMemory = 0;
+}
+
+MapCache *MapPreloader::compileMap(const std::string &fileName)
+{
+    MapCache *const cache = new MapCache(fileName);
+    // map already compiled, only images needed
+    if (cache->isCacheable() && cache->load())
+        return cache;
+
+    int size = 0;
+    const char *const data = VirtFs::loadFile(fileName, size);
+    if (data == nullptr)
+    {
+        delete cache;
+        return nullptr;
+    }
+    logger->log_r("Preloading map %s", fileName.c_str());
+    const bool compiled = MapReader::compileMap(data, size,
+        fileName,
+        *cache);
+    delete [] data;
+    if (!compiled)
+    {
+        logger->log_r("Map preload failed: %s", fileName.c_str());
+        delete cache;
+        return nullptr;
+    }
+    MapReader::compileTilesets(*cache, true);
+    cache->save();
+    return cache;
+}
+
+int MapPreloader::compileThread(void *ptr)
+{
+    MapPreloader *const preloader = reinterpret_cast<MapPreloader*>(ptr);
+    if (preloader == nullptr)
+        return 0;
+
+    SDL_mutexP(preloader->mMutex);
+    while (!preloader->mStop)
+    {
+        if (preloader->mDataFile.empty())
+        {
+            SDL_CondWait(preloader->mCond, preloader->mMutex);
+            continue;
+        }
+        const std::string fileName = preloader->mDataFile;
+        preloader->mDataFile.clear();
+        SDL_mutexV(preloader->mMutex);
+
+        MapCache *const cache = compileMap(fileName);
+
+        SDL_mutexP(preloader->mMutex);
+        delete preloader->mResultCache;
+        preloader->mResultFile = fileName;
+        preloader->mResultCache = cache;
+        preloader->mCompiled = true;
+    }
+    SDL_mutexV(preloader->mMutex);
+    return 0;
+}
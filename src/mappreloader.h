@@ -0,0 +1,125 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPRELOADER_H
+#define MAPPRELOADER_H
+
+#include "utils/stringvector.h"
+#include "utils/vector.h"
+
+#include <map>
+
+#include "localconsts.h"
+
+class Image;
+class Map;
+class MapCache;
+
+struct SDL_cond;
+struct SDL_mutex;
+struct SDL_Thread;
+
+/**
+ * Preloads map behind nearest portal while player walks to it.
+ *
+ * Worker thread loads target map from map cache, or reads and compiles
+ * map with its external tilesets and saves map cache. After it main
+ * thread loads tileset images one per logic call, holding them while
+ * memory budget allows. After warp map and images taken from caches.
+ */
+class MapPreloader final
+{
+    public:
+        MapPreloader();
+
+        A_DELETE_COPY(MapPreloader)
+
+        ~MapPreloader();
+
+        /**
+         * Sets current map. Held images of previous target released.
+         */
+        void setMap(const Map *const map);
+
+        void logic();
+
+        const std::string &getTargetMap() const noexcept2 A_WARN_UNUSED
+        { return mTarget; }
+
+        int getMemoryUsage() const noexcept2 A_WARN_UNUSED
+        { return mMemory; }
+
+    private:
+        enum State
+        {
+            STATE_IDLE = 0,
+            STATE_COMPILE,
+            STATE_IMAGES,
+            STATE_DONE
+        };
+
+        /**
+         * Returns real file name of map with given name,
+         * or empty string.
+         */
+        std::string findMapFile(const std::string &mapName);
+
+        void startPreload(const std::string &fileName);
+
+        void addImages(const MapCache &cache);
+
+        void loadNextImage();
+
+        void releaseImages();
+
+        /**
+         * Returns loaded or compiled map cache, or nullptr.
+         * Called from worker thread.
+         */
+        static MapCache *compileMap(const std::string &fileName);
+
+        static int compileThread(void *ptr);
+
+        const Map *mMap;
+        std::map<std::string, std::string> mMapFiles;
+        StringVect mImageFiles;
+        STD_VECTOR<Image*> mImages;
+        std::string mCurrentFile;
+        std::string mTarget;
+        State mState;
+        int mMemory;
+        int mLastX;
+        int mLastY;
+
+        // shared with worker thread
+        SDL_Thread *mThread;
+        SDL_mutex *mMutex;
+        SDL_cond *mCond;
+        // requested map, empty if nothing requested
+        std::string mDataFile;
+        std::string mResultFile;
+        MapCache *mResultCache;
+        bool mCompiled;
+        bool mStop;
+};
+
+extern MapPreloader *mapPreloader;
+
+#endif  // MAPPRELOADER_H
@@ -21,18 +21,27 @@
 
 #include "navigationmanager.h"
 
+#include "const/resources/map/map.h"
+
 #include "enums/resources/map/blockmask.h"
 
+#include "resources/map/clustergraph.h"
 #include "resources/map/map.h"
 #include "resources/map/metatile.h"
 #include "resources/map/walklayer.h"
 
 #include "debug.h"
 
-static const int blockWalkMask = (BlockMask::WALL |
+static const unsigned char blockWalkMask = (BlockMask::WALL |
     BlockMask::AIR |
     BlockMask::WATER);
 
+// same as LocalPlayer::getBlockWalkMask
+static const unsigned char playerWalkMask = (BlockMask::WALL |
+    BlockMask::AIR |
+    BlockMask::WATER |
+    BlockMask::PLAYERWALL);
+
 #ifndef DYECMD
 namespace
 {
@@ -70,7 +79,9 @@ Resource *NavigationManager::loadWalkLayer(const Map *const map)
     const int height = map->getHeight();
     if (width < 2 || height < 2)
         return nullptr;
-    WalkLayer *const walkLayer = new WalkLayer(width, height);
+    WalkLayer *const walkLayer = new WalkLayer(width,
+        height,
+        blockWalkMask);
 
     const MetaTile *const tiles = map->getMetaTiles();
     int *const data = walkLayer->getData();
@@ -85,10 +96,32 @@ Resource *NavigationManager::loadWalkLayer(const Map *const map)
         fillNum(x, y, width, height, num, tiles, data);
         num ++;
     }
+    walkLayer->calcAreaSizes();
 
     return walkLayer;
 }
 
+ClusterGraph *NavigationManager::loadClusterGraph(const Map *const map)
+{
+    if (map == nullptr)
+        return nullptr;
+
+    const int width = map->getWidth();
+    const int height = map->getHeight();
+    const MetaTile *const tiles = map->getMetaTiles();
+    // small maps searched fast enough without graph
+    if (tiles == nullptr ||
+        std::max(width, height) < mapClusterSize * 4)
+    {
+        return nullptr;
+    }
+
+    // graph built on first hierarchical search
+    return new ClusterGraph(width,
+        height,
+        playerWalkMask);
+}
+
 void NavigationManager::fillNum(int x, int y,
                                 const int width,
                                 const int height,
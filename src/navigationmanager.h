@@ -24,6 +24,7 @@
 
 #include "localconsts.h"
 
+class ClusterGraph;
 class Map;
 class Resource;
 
@@ -40,6 +41,8 @@ class NavigationManager final
 
 #ifndef DYECMD
         static Resource *loadWalkLayer(const Map *const map);
+
+        static ClusterGraph *loadClusterGraph(const Map *const map);
 #endif  // DYECMD
 
     private:
@@ -83,7 +83,8 @@ Particle::Particle() :
     mDeathEffectConditions(0x00),
     mAutoDelete(true),
     mAllowSizeAdjust(false),
-    mFollow(false)
+    mFollow(false),
+    mPaused(false)
 {
     ParticleEngine::particleCount++;
 }
@@ -215,7 +216,8 @@ void Particle::updateSelf() restrict2
     }
 
     // Update child emitters
-    if ((ParticleEngine::emitterSkip != 0) &&
+    if (!mPaused &&
+        (ParticleEngine::emitterSkip != 0) &&
         (mLifetimePast - 1) % ParticleEngine::emitterSkip == 0)
     {
         FOR_EACH (EmitterConstIterator, e, mChildEmitters)
@@ -553,6 +555,13 @@ Particle *Particle::addEffect(const std::string &restrict particleEffectFile,
     return newParticle;
 }
 
+void Particle::setPaused(const bool paused) restrict2
+{
+    mPaused = paused;
+    FOR_EACH (ParticleIterator, it, mChildParticles)
+        (*it)->setPaused(paused);
+}
+
 void Particle::adjustEmitterSize(const int w, const int h) restrict2
 {
     if (mAllowSizeAdjust)
@@ -200,6 +200,12 @@ class Particle notfinal : public Actor
          */
         void adjustEmitterSize(const int w, const int h) restrict2;
 
+        /**
+         * Stops or resumes creating new particles by emitters of this
+         * particle and its children. Existing particles still updated.
+         */
+        void setPaused(const bool paused) restrict2;
+
         void setAllowSizeAdjust(const bool adjust) restrict2 noexcept2
         { mAllowSizeAdjust = adjust; }
 
@@ -325,6 +331,9 @@ class Particle notfinal : public Actor
 
         // is this particle moved when its parent particle moves?
         bool mFollow;
+
+        // child emitters not creating new particles
+        bool mPaused;
 };
 
 #endif  // PARTICLE_PARTICLE_H
@@ -30,7 +30,8 @@
 ParticleContainer::ParticleContainer(ParticleContainer *const parent,
                                      const bool delParent) :
     mNext(parent),
-    mDelParent(delParent)
+    mDelParent(delParent),
+    mPaused(false)
 {
 }
 
@@ -54,3 +55,10 @@ void ParticleContainer::moveTo(const float x, const float y)
     if (mNext != nullptr)
         mNext->moveTo(x, y);
 }
+
+void ParticleContainer::setPaused(const bool paused)
+{
+    mPaused = paused;
+    if (mNext != nullptr)
+        mNext->setPaused(paused);
+}
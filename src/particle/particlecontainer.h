@@ -64,9 +64,15 @@ class ParticleContainer notfinal
          */
         virtual void moveTo(const float x, const float y);
 
+        /**
+         * Pauses or resumes emitters of all elements
+         */
+        virtual void setPaused(const bool paused);
+
     protected:
         ParticleContainer *mNext;           /**< Contained container, if any */
         bool mDelParent;                    /**< Delete mNext in destructor */
+        bool mPaused;                       /**< Pause new elements too */
 };
 
 #endif  // PARTICLE_PARTICLECONTAINER_H
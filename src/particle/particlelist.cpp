@@ -47,6 +47,8 @@ void ParticleList::addLocally(Particle *const particle)
 {
     if (particle != nullptr)
     {
+        if (mPaused)
+            particle->setPaused(true);
         mElements.push_back(particle);
         mSize ++;
     }
@@ -105,3 +107,11 @@ void ParticleList::moveTo(const float x, const float y)
         }
     }
 }
+
+void ParticleList::setPaused(const bool paused)
+{
+    ParticleContainer::setPaused(paused);
+
+    FOR_EACH (ParticleListIter, it, mElements)
+        (*it)->setPaused(paused);
+}
@@ -59,6 +59,8 @@ class ParticleList final : public ParticleContainer
 
         void moveTo(const float x, const float y) override final;
 
+        void setPaused(const bool paused) override final;
+
         size_t size() const
         { return mSize; }
 
@@ -46,7 +46,11 @@ void ParticleVector::setLocally(const int index, Particle *const particle)
         mIndexedElements.resize(index + 1, nullptr);
 
     if (particle != nullptr)
+    {
         particle->disableAutoDelete();
+        if (mPaused)
+            particle->setPaused(true);
+    }
     mIndexedElements[index] = particle;
 }
 
@@ -97,6 +101,19 @@ void ParticleVector::moveTo(const float x, const float y)
     }
 }
 
+void ParticleVector::setPaused(const bool paused)
+{
+    ParticleContainer::setPaused(paused);
+
+    for (STD_VECTOR<Particle *>::iterator it = mIndexedElements.begin();
+         it != mIndexedElements.end(); ++it)
+    {
+        Particle *const p = *it;
+        if (p != nullptr)
+            p->setPaused(paused);
+    }
+}
+
 size_t ParticleVector::usedSize() const
 {
     size_t cnt = 0;
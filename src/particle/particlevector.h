@@ -60,6 +60,8 @@ class ParticleVector final : public ParticleContainer
 
         void moveTo(const float x, const float y) override final;
 
+        void setPaused(const bool paused) override final;
+
         size_t size() const
         { return mIndexedElements.size(); }
 
@@ -0,0 +1,331 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pathrequestmanager.h"
+
+#include "configuration.h"
+#include "logger.h"
+
+#include "resources/map/map.h"
+#include "resources/map/metatile.h"
+#include "resources/map/pathfinder.h"
+
+#include "utils/delete2.h"
+#include "utils/foreach.h"
+#include "utils/sdlhelper.h"
+
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_mutex.h>
+PRAGMA48(GCC diagnostic pop)
+
+#include "debug.h"
+
+PathRequestManager *pathRequestManager = nullptr;
+
+PathRequestManager::PathRequestManager() :
+    mThread(nullptr),
+    mMutex(SDL_CreateMutex()),
+    mCond(SDL_CreateCond()),
+    mMap(nullptr),
+    mMapVersion(0),
+    mLastTicket(0),
+    mPending(),
+    mResults(),
+    mMasks(),
+    mRequests(),
+    mDone(),
+    mSnapshot(),
+    mChanges(),
+    mSnapshotWidth(0),
+    mSnapshotHeight(0),
+    mSnapshotId(0),
+    mStop(false),
+    mTiles(nullptr),
+    mPathFinder(nullptr),
+    mTilesId(0),
+    mTilesSize(0)
+{
+    if (mMutex != nullptr && mCond != nullptr)
+        mThread = SDL::createThread(&pathThread, "path", this);
+    if (mThread == nullptr)
+        logger->log1("Could not create path finding thread");
+}
+
+PathRequestManager::~PathRequestManager()
+{
+    if (mThread != nullptr)
+    {
+        SDL_mutexP(mMutex);
+        mStop = true;
+        SDL_CondSignal(mCond);
+        SDL_mutexV(mMutex);
+        SDL::WaitThread(mThread);
+        mThread = nullptr;
+    }
+    if (mCond != nullptr)
+        SDL_DestroyCond(mCond);
+    if (mMutex != nullptr)
+        SDL_DestroyMutex(mMutex);
+    delete2(mPathFinder)
+    delete [] mTiles;
+}
+
+void PathRequestManager::setMap(const Map *const map)
+{
+    mMap = map;
+    mPending.clear();
+    mResults.clear();
+    mMasks.clear();
+    if (mThread == nullptr)
+        return;
+
+    STD_VECTOR<unsigned char> snapshot;
+    SDL_mutexP(mMutex);
+    mRequests.clear();
+    mDone.clear();
+    // free old snapshot after unlock
+    mSnapshot.swap(snapshot);
+    mChanges.clear();
+    mSnapshotWidth = 0;
+    mSnapshotHeight = 0;
+    mSnapshotId ++;
+    SDL_mutexV(mMutex);
+}
+
+int PathRequestManager::request(const int startX, const int startY,
+                                const int destX, const int destY,
+                                const unsigned char blockWalkMask,
+                                const int maxCost)
+{
+    if (mThread == nullptr || mMap == nullptr)
+        return 0;
+
+    mLastTicket ++;
+    if (mLastTicket <= 0)
+        mLastTicket = 1;
+    const int ticket = mLastTicket;
+    const bool jumpPointSearch = config.getBoolValue(
+        "enableJumpPointSearch");
+
+    updateSnapshot();
+    SDL_mutexP(mMutex);
+    mRequests.push_back(PathRequest(ticket,
+        startX, startY,
+        destX, destY,
+        blockWalkMask,
+        maxCost,
+        jumpPointSearch));
+    SDL_CondSignal(mCond);
+    SDL_mutexV(mMutex);
+
+    mPending.insert(ticket);
+    return ticket;
+}
+
+void PathRequestManager::cancel(const int ticket)
+{
+    if (mPending.erase(ticket) == 0)
+    {
+        mResults.erase(ticket);
+        return;
+    }
+
+    SDL_mutexP(mMutex);
+    for (std::list<PathRequest>::iterator it = mRequests.begin();
+         it != mRequests.end();
+         ++ it)
+    {
+        if ((*it).ticket == ticket)
+        {
+            mRequests.erase(it);
+            break;
+        }
+    }
+    SDL_mutexV(mMutex);
+}
+
+bool PathRequestManager::getResult(const int ticket,
+                                   Path &path)
+{
+    const std::map<int, Path>::iterator it = mResults.find(ticket);
+    if (it == mResults.end())
+        return false;
+    path.swap((*it).second);
+    mResults.erase(it);
+    return true;
+}
+
+void PathRequestManager::logic()
+{
+    if (mThread == nullptr || mPending.empty())
+        return;
+
+    std::list<PathResult> done;
+    SDL_mutexP(mMutex);
+    done.swap(mDone);
+    SDL_mutexV(mMutex);
+
+    FOR_EACH (std::list<PathResult>::iterator, it, done)
+    {
+        PathResult &result = *it;
+        // ignore cancelled requests
+        if (mPending.erase(result.ticket) == 0)
+            continue;
+        mResults[result.ticket].swap(result.path);
+    }
+}
+
+void PathRequestManager::updateSnapshot()
+{
+    const int version = mMap->getBlockMaskVersion();
+    const int width = mMap->getWidth();
+    const int height = mMap->getHeight();
+    const int size = width * height;
+    if (!mMasks.empty() &&
+        mMapVersion == version &&
+        CAST_S32(mMasks.size()) == size)
+    {
+        return;
+    }
+    mMapVersion = version;
+
+    const MetaTile *const tiles = mMap->getMetaTiles();
+    if (CAST_S32(mMasks.size()) != size)
+    {
+        // new map or map size changed, send full copy to worker
+        mMasks.resize(size);
+        for (int f = 0; f < size; f ++)
+            mMasks[f] = tiles[f].blockmask;
+        STD_VECTOR<unsigned char> snapshot(mMasks);
+
+        SDL_mutexP(mMutex);
+        mSnapshot.swap(snapshot);
+        mChanges.clear();
+        mSnapshotWidth = width;
+        mSnapshotHeight = height;
+        mSnapshotId ++;
+        SDL_mutexV(mMutex);
+        return;
+    }
+
+    STD_VECTOR<TileChange> changes;
+    for (int f = 0; f < size; f ++)
+    {
+        const unsigned char mask = tiles[f].blockmask;
+        if (mMasks[f] != mask)
+        {
+            mMasks[f] = mask;
+            changes.push_back(TileChange(f, mask));
+        }
+    }
+    if (changes.empty())
+        return;
+
+    SDL_mutexP(mMutex);
+    mChanges.insert(mChanges.end(), changes.begin(), changes.end());
+    SDL_mutexV(mMutex);
+}
+
+void PathRequestManager::updateTiles(STD_VECTOR<unsigned char> &snapshot,
+                                     const int width,
+                                     const int height,
+                                     const STD_VECTOR<TileChange> &changes)
+{
+    if (!snapshot.empty())
+    {
+        const int size = width * height;
+        delete2(mPathFinder)
+        delete [] mTiles;
+        mTiles = new MetaTile[size];
+        for (int f = 0; f < size; f ++)
+            mTiles[f].blockmask = snapshot[f];
+        mPathFinder = new PathFinder(mTiles,
+            width,
+            height);
+        mTilesSize = size;
+        snapshot.clear();
+    }
+    if (mTiles == nullptr)
+        return;
+    FOR_EACH (STD_VECTOR<TileChange>::const_iterator, it, changes)
+    {
+        const TileChange &change = *it;
+        if (change.index < mTilesSize)
+            mTiles[change.index].blockmask = change.blockmask;
+    }
+}
+
+void PathRequestManager::solve(const PathRequest &request,
+                               Path &path)
+{
+    if (mPathFinder == nullptr)
+        return;
+    mPathFinder->setJumpPointSearch(request.jumpPointSearch);
+    mPathFinder->findPath(path,
+        request.startX, request.startY,
+        request.destX, request.destY,
+        request.blockWalkMask,
+        request.maxCost);
+}
+
+int PathRequestManager::pathThread(void *ptr)
+{
+    PathRequestManager *const manager =
+        reinterpret_cast<PathRequestManager*>(ptr);
+    if (manager == nullptr)
+        return 0;
+
+    STD_VECTOR<unsigned char> snapshot;
+    STD_VECTOR<TileChange> changes;
+    std::list<PathResult> done;
+    SDL_mutexP(manager->mMutex);
+    while (!manager->mStop)
+    {
+        if (manager->mRequests.empty())
+        {
+            SDL_CondWait(manager->mCond, manager->mMutex);
+            continue;
+        }
+        const PathRequest request = manager->mRequests.front();
+        manager->mRequests.pop_front();
+        // only take data here, copy and allocate after unlock
+        const int width = manager->mSnapshotWidth;
+        const int height = manager->mSnapshotHeight;
+        if (manager->mTilesId != manager->mSnapshotId)
+        {
+            snapshot.swap(manager->mSnapshot);
+            manager->mTilesId = manager->mSnapshotId;
+        }
+        changes.swap(manager->mChanges);
+        SDL_mutexV(manager->mMutex);
+
+        manager->updateTiles(snapshot, width, height, changes);
+        changes.clear();
+        done.push_back(PathResult(request.ticket));
+        manager->solve(request, done.back().path);
+
+        SDL_mutexP(manager->mMutex);
+        // list node moved without copy of path
+        manager->mDone.splice(manager->mDone.end(), done);
+    }
+    SDL_mutexV(manager->mMutex);
+    return 0;
+}
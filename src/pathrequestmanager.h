@@ -0,0 +1,198 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATHREQUESTMANAGER_H
+#define PATHREQUESTMANAGER_H
+
+#include "position.h"
+
+#include "utils/vector.h"
+
+#include <list>
+#include <map>
+#include <set>
+
+#include "localconsts.h"
+
+class Map;
+class PathFinder;
+
+struct MetaTile;
+struct SDL_cond;
+struct SDL_mutex;
+struct SDL_Thread;
+
+/**
+ * Solves path requests in worker thread.
+ *
+ * Worker searches in own copy of map block masks. Main thread sends to
+ * worker only changed tiles, or full copy after map change. Copies and
+ * allocations done outside of mutex. Solved paths moved to main thread
+ * in logic().
+ */
+class PathRequestManager final
+{
+    public:
+        PathRequestManager();
+
+        A_DELETE_COPY(PathRequestManager)
+
+        ~PathRequestManager();
+
+        /**
+         * Sets map for new requests. Pending requests and results
+         * dropped.
+         */
+        void setMap(const Map *const map);
+
+        /**
+         * Adds path request and returns its ticket,
+         * or 0 if request can't be added.
+         */
+        int request(const int startX, const int startY,
+                    const int destX, const int destY,
+                    const unsigned char blockWalkMask,
+                    const int maxCost);
+
+        /**
+         * Drops request if it not needed anymore.
+         */
+        void cancel(const int ticket);
+
+        /**
+         * If request with given ticket solved, moves found path to path
+         * and returns true. Empty path means path not found.
+         */
+        bool getResult(const int ticket,
+                       Path &path);
+
+        bool isPending(const int ticket) const A_WARN_UNUSED
+        { return mPending.find(ticket) != mPending.end(); }
+
+        /**
+         * Collects solved requests. Must be called from main loop.
+         */
+        void logic();
+
+    private:
+        struct PathRequest final
+        {
+            PathRequest(const int ticket0,
+                        const int startX0, const int startY0,
+                        const int destX0, const int destY0,
+                        const unsigned char blockWalkMask0,
+                        const int maxCost0,
+                        const bool jumpPointSearch0) :
+                ticket(ticket0),
+                startX(startX0),
+                startY(startY0),
+                destX(destX0),
+                destY(destY0),
+                maxCost(maxCost0),
+                blockWalkMask(blockWalkMask0),
+                jumpPointSearch(jumpPointSearch0)
+            {
+            }
+
+            A_DEFAULT_COPY(PathRequest)
+
+            int ticket;
+            int startX;
+            int startY;
+            int destX;
+            int destY;
+            int maxCost;
+            unsigned char blockWalkMask;
+            bool jumpPointSearch;
+        };
+
+        struct TileChange final
+        {
+            TileChange(const int index0,
+                       const unsigned char blockmask0) :
+                index(index0),
+                blockmask(blockmask0)
+            {
+            }
+
+            A_DEFAULT_COPY(TileChange)
+
+            int index;
+            unsigned char blockmask;
+        };
+
+        struct PathResult final
+        {
+            explicit PathResult(const int ticket0) :
+                ticket(ticket0),
+                path()
+            {
+            }
+
+            A_DEFAULT_COPY(PathResult)
+
+            int ticket;
+            Path path;
+        };
+
+        static int pathThread(void *ptr);
+
+        void updateSnapshot();
+
+        void updateTiles(STD_VECTOR<unsigned char> &snapshot,
+                         const int width,
+                         const int height,
+                         const STD_VECTOR<TileChange> &changes);
+
+        void solve(const PathRequest &request,
+                   Path &path);
+
+        SDL_Thread *mThread;
+        SDL_mutex *mMutex;
+        SDL_cond *mCond;
+
+        // main thread only
+        const Map *mMap;
+        int mMapVersion;
+        int mLastTicket;
+        std::set<int> mPending;
+        std::map<int, Path> mResults;
+        STD_VECTOR<unsigned char> mMasks;
+
+        // shared with worker, guarded by mMutex
+        std::list<PathRequest> mRequests;
+        std::list<PathResult> mDone;
+        STD_VECTOR<unsigned char> mSnapshot;
+        STD_VECTOR<TileChange> mChanges;
+        int mSnapshotWidth;
+        int mSnapshotHeight;
+        int mSnapshotId;
+        bool mStop;
+
+        // worker only
+        MetaTile *mTiles;
+        PathFinder *mPathFinder;
+        int mTilesId;
+        int mTilesSize;
+};
+
+extern PathRequestManager *pathRequestManager;
+
+#endif  // PATHREQUESTMANAGER_H
@@ -24,8 +24,9 @@
 #ifndef POSITION_H
 #define POSITION_H
 
+#include "utils/vector.h"
+
 #include <iostream>
-#include <list>
 
 #include "localconsts.h"
 
@@ -46,7 +47,142 @@ struct Position final
     int y;
 };
 
-typedef std::list<Position> Path;
+/**
+ * Sequence of positions stored in one memory block.
+ * Removing from front only moves start offset, so walking path
+ * and reusing same object for new paths not allocate memory.
+ */
+class Path final
+{
+    public:
+        typedef STD_VECTOR<Position>::iterator iterator;
+        typedef STD_VECTOR<Position>::const_iterator const_iterator;
+        typedef STD_VECTOR<Position>::reverse_iterator reverse_iterator;
+        typedef STD_VECTOR<Position>::const_reverse_iterator
+            const_reverse_iterator;
+
+        Path() :
+            mPositions(),
+            mStart(0U)
+        { }
+
+        Path(const Path &path) :
+            mPositions(path.begin(), path.end()),
+            mStart(0U)
+        { }
+
+        Path &operator=(const Path &path)
+        {
+            if (this != &path)
+            {
+                mPositions.assign(path.begin(), path.end());
+                mStart = 0U;
+            }
+            return *this;
+        }
+
+        bool empty() const noexcept2 A_WARN_UNUSED
+        { return mStart == mPositions.size(); }
+
+        size_t size() const noexcept2 A_WARN_UNUSED
+        { return mPositions.size() - mStart; }
+
+        /**
+         * Removes all positions. Memory kept for next path,
+         * except one left by very long path.
+         */
+        void clear() noexcept2
+        {
+            if (mPositions.capacity() > maxCapacity)
+                STD_VECTOR<Position>().swap(mPositions);
+            else
+                mPositions.clear();
+            mStart = 0U;
+        }
+
+        size_t capacity() const noexcept2 A_WARN_UNUSED
+        { return mPositions.capacity(); }
+
+        static const size_t maxCapacity = 1024U;
+
+        void reserve(const size_t sz)
+        { mPositions.reserve(mStart + sz); }
+
+        Position &front()
+        { return mPositions[mStart]; }
+
+        const Position &front() const
+        { return mPositions[mStart]; }
+
+        Position &back()
+        { return mPositions.back(); }
+
+        const Position &back() const
+        { return mPositions.back(); }
+
+        void push_back(const Position &pos)
+        { mPositions.push_back(pos); }
+
+        /**
+         * Exchanges content with other path without copying positions.
+         */
+        void swap(Path &path) noexcept2
+        {
+            mPositions.swap(path.mPositions);
+            const size_t start = mStart;
+            mStart = path.mStart;
+            path.mStart = start;
+        }
+
+        void pop_front() noexcept2
+        {
+            mStart ++;
+            if (mStart >= mPositions.size())
+                clear();
+        }
+
+        void pop_back() noexcept2
+        {
+            mPositions.pop_back();
+            if (mStart >= mPositions.size())
+                clear();
+        }
+
+        /**
+         * Appends all positions from other path.
+         */
+        void append(const Path &path)
+        { mPositions.insert(mPositions.end(), path.begin(), path.end()); }
+
+        iterator begin()
+        { return mPositions.begin() + mStart; }
+
+        const_iterator begin() const
+        { return mPositions.begin() + mStart; }
+
+        iterator end()
+        { return mPositions.end(); }
+
+        const_iterator end() const
+        { return mPositions.end(); }
+
+        reverse_iterator rbegin()
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend()
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const
+        { return const_reverse_iterator(begin()); }
+
+    private:
+        STD_VECTOR<Position> mPositions;
+        size_t mStart;
+};
+
 typedef Path::iterator PathIterator;
 typedef Path::reverse_iterator PathRIterator;
 
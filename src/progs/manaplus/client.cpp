@@ -36,6 +36,7 @@
 #include "soundmanager.h"
 #include "spellmanager.h"
 
+#include "being/compoundimagecache.h"
 #include "being/localclan.h"
 #include "being/localplayer.h"
 #include "being/playerinfo.h"
@@ -106,6 +107,8 @@
 
 #include "particle/particleengine.h"
 
+#include "render/pixelblend.h"
+
 #include "resources/dbmanager.h"
 #include "resources/imagehelper.h"
 
@@ -411,6 +414,7 @@ void Client::gameInit()
     logVars();
     Cpu::detect();
     DyePalette::initFunctions();
+    PixelBlend::initFunctions();
 #if defined(USE_OPENGL)
 #if !defined(ANDROID) && !defined(__APPLE__)
 #if !defined(__native_client__) && !defined(__SWITCH__) && !defined(UNITTESTS)
@@ -717,6 +721,7 @@ void Client::gameClear()
         logger->log1("Quitting5");
 
     BeingInfo::clear();
+    compoundImageCache.clear();
 
     // Shutdown sound
     soundManager.close();
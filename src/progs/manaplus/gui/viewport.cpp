@@ -26,6 +26,7 @@
 #include "actormanager.h"
 #include "configuration.h"
 #include "game.h"
+#include "pathrequestmanager.h"
 #include "settings.h"
 #include "sdlshared.h"
 #include "textmanager.h"
@@ -253,7 +254,7 @@ void Viewport::draw(Graphics *const graphics)
 
     // Draw player names, speech, and emotion sprite as needed
     const ActorSprites &actors = actorManager->getAll();
-    FOR_EACH (ActorSpritesIterator, it, actors)
+    FOR_EACH (ActorSpritesConstIterator, it, actors)
     {
         if ((*it)->getType() == ActorType::FloorItem)
             continue;
@@ -318,6 +319,7 @@ void Viewport::drawDebugPath(Graphics *const graphics)
     Gui::getMouseState(mMouseX, mMouseY);
 
     static Path debugPath;
+    static int debugPathTicket = 0;
     static Vector lastMouseDestination = Vector(0.0F, 0.0F, 0.0F);
     const int mousePosX = mMouseX + mPixelViewX;
     const int mousePosY = mMouseY + mPixelViewY;
@@ -326,15 +328,39 @@ void Viewport::drawDebugPath(Graphics *const graphics)
     if (mouseDestination.x != lastMouseDestination.x
         || mouseDestination.y != lastMouseDestination.y)
     {
-        debugPath = mMap->findPath(
-            CAST_S32(localPlayer->mPixelX - mapTileSize / 2) / mapTileSize,
-            CAST_S32(localPlayer->mPixelY - mapTileSize) / mapTileSize,
-            mousePosX / mapTileSize,
-            mousePosY / mapTileSize,
-            localPlayer->getBlockWalkMask(),
-            500);
+        const int startX = CAST_S32(localPlayer->mPixelX - mapTileSize / 2) /
+            mapTileSize;
+        const int startY = CAST_S32(localPlayer->mPixelY - mapTileSize) /
+            mapTileSize;
+        // old path drawn until new one found in path thread
+        if (pathRequestManager != nullptr)
+        {
+            pathRequestManager->cancel(debugPathTicket);
+            debugPathTicket = pathRequestManager->request(startX,
+                startY,
+                mousePosX / mapTileSize,
+                mousePosY / mapTileSize,
+                localPlayer->getBlockWalkMask(),
+                500);
+        }
+        if (debugPathTicket == 0)
+        {
+            mMap->findPath(debugPath,
+                startX,
+                startY,
+                mousePosX / mapTileSize,
+                mousePosY / mapTileSize,
+                localPlayer->getBlockWalkMask(),
+                500);
+        }
         lastMouseDestination = mouseDestination;
     }
+    if (debugPathTicket != 0 &&
+        pathRequestManager != nullptr &&
+        pathRequestManager->getResult(debugPathTicket, debugPath))
+    {
+        debugPathTicket = 0;
+    }
     drawPath(graphics, debugPath, userPalette->getColorWithAlpha(
         UserColorId::ROAD_POINT));
 
@@ -821,21 +847,7 @@ void Viewport::walkByMouse(const MouseEvent &event)
                 getMouseTile(event.getX(), event.getY(),
                     destX, destY);
                 if (playerX != destX || playerY != destY)
-                {
-                    if (!localPlayer->navigateTo(destX, destY))
-                    {
-                        if (playerX > destX)
-                            playerX --;
-                        else if (playerX < destX)
-                            playerX ++;
-                        if (playerY > destY)
-                            playerY --;
-                        else if (playerY < destY)
-                            playerY ++;
-                        if (mMap->getWalk(playerX, playerY, 0))
-                            localPlayer->navigateTo(playerX, playerY);
-                    }
-                }
+                    localPlayer->navigateOrMoveTo(destX, destY);
             }
         }
     }
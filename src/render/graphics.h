@@ -230,6 +230,20 @@ class Graphics notfinal
         virtual void drawTileVertexes(const ImageVertexes *restrict const vert)
                                       restrict2 = 0;
 
+        /**
+         * Draws vertexes calculated without clip area offset, moved by
+         * given offset. Supported only if isAllowMoveVertexes returns true.
+         */
+        virtual void drawMovedTileVertexes(const ImageVertexes *restrict const
+                                           vert A_UNUSED,
+                                           const int dx A_UNUSED,
+                                           const int dy A_UNUSED) restrict2
+        {
+        }
+
+        virtual bool isAllowMoveVertexes() const restrict2 noexcept2
+        { return false; }
+
         virtual void drawTileCollection(const ImageCollection
                                         *restrict const vertCol) restrict2
                                         A_NONNULL(2) = 0;
@@ -329,6 +343,9 @@ class Graphics notfinal
 #ifdef DEBUG_DRAW_CALLS
         virtual unsigned int getDrawCalls() const restrict2
         { return 0; }
+
+        virtual unsigned int getBatches() const restrict2
+        { return 0; }
 #endif  // DEBUG_DRAW_CALLS
 #ifdef DEBUG_BIND_TEXTURE
         virtual unsigned int getBinds() const restrict2
@@ -363,6 +380,13 @@ class Graphics notfinal
 
         virtual void completeCache() restrict2 = 0;
 
+        /**
+         * Draws commands what collected for drawing later.
+         * Must be called before pixels of drawn surfaces changed in place.
+         */
+        virtual void flushDeferred() restrict2
+        { }
+
         int getScale() const restrict2 noexcept2
         { return mScale; }
 
@@ -873,6 +873,18 @@ void MobileOpenGLGraphics::drawTileVertexes(const ImageVertexes *
     drawVertexes(vert->ogl);
 }
 
+void MobileOpenGLGraphics::drawMovedTileVertexes(const ImageVertexes *
+                                                 restrict const vert,
+                                                 const int dx,
+                                                 const int dy) restrict2
+{
+    glTranslatef(static_cast<GLfloat>(dx),
+                 static_cast<GLfloat>(dy), 0);
+    drawTileVertexes(vert);
+    glTranslatef(static_cast<GLfloat>(-dx),
+                 static_cast<GLfloat>(-dy), 0);
+}
+
 void MobileOpenGLGraphics::calcWindow(ImageCollection *restrict const vertCol,
                                       const int x, const int y,
                                       const int w, const int h,
@@ -96,6 +96,13 @@ class MobileOpenGLGraphics final : public Graphics
         #include "render/openglgraphicsdefadvanced.hpp"
         RENDER_OPENGLGRAPHICSDEFADVANCED_HPP
 
+        void drawMovedTileVertexes(const ImageVertexes *restrict const vert,
+                                   const int dx,
+                                   const int dy) restrict2 override final;
+
+        bool isAllowMoveVertexes() const restrict2 noexcept2 override final
+        { return true; }
+
     private:
         GLfloat *mFloatTexArray;
         GLshort *mShortVertArray;
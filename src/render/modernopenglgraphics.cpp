@@ -50,6 +50,12 @@
 
 #include "debug.h"
 
+namespace
+{
+    // size of batch in GLint values, 24 values per quad
+    const int batchSize = 2048 * 24;
+}  // namespace
+
 #define vertFill2D(var, x1, y1, x2, y2, dstX, dstY, w, h) \
     var[vp + 0] = dstX; \
     var[vp + 1] = dstY; \
@@ -85,14 +91,18 @@ GLuint ModernOpenGLGraphics::mTextureBinded = 0;
 #ifdef DEBUG_DRAW_CALLS
 unsigned int ModernOpenGLGraphics::mDrawCalls = 0;
 unsigned int ModernOpenGLGraphics::mLastDrawCalls = 0;
+unsigned int ModernOpenGLGraphics::mBatches = 0;
+unsigned int ModernOpenGLGraphics::mLastBatches = 0;
 #endif  // DEBUG_DRAW_CALLS
 
 ModernOpenGLGraphics::ModernOpenGLGraphics() :
     mIntArray(nullptr),
     mIntArrayCached(nullptr),
+    mBatchArray(nullptr),
     mProgram(nullptr),
     mAlphaCached(1.0F),
     mVpCached(0),
+    mBatchVp(0),
     mFloatColor(1.0F),
     mMaxVertices(500),
     mProgramId(0U),
@@ -100,6 +110,7 @@ ModernOpenGLGraphics::ModernOpenGLGraphics() :
     mPosAttrib(0),
     mTextureColorUniform(0U),
     mScreenUniform(0U),
+    mOffsetUniform(0U),
     mDrawTypeUniform(0U),
     mVao(0U),
     mVbo(0U),
@@ -107,6 +118,7 @@ ModernOpenGLGraphics::ModernOpenGLGraphics() :
     mVboBinded(0U),
     mEboBinded(0U),
     mAttributesBinded(0U),
+    mBatchTexture(0U),
     mColorAlpha(false),
     mTextureDraw(false),
 #ifdef DEBUG_BIND_TEXTURE
@@ -157,6 +169,8 @@ void ModernOpenGLGraphics::initArrays(const int vertCount) restrict2
         mIntArray = new GLint[sz];
     if (mIntArrayCached == nullptr)
         mIntArrayCached = new GLint[sz];
+    if (mBatchArray == nullptr)
+        mBatchArray = new GLint[batchSize];
 }
 
 void ModernOpenGLGraphics::postInit() restrict2
@@ -190,6 +204,7 @@ void ModernOpenGLGraphics::postInit() restrict2
 
     mSimpleColorUniform = mglGetUniformLocation(mProgramId, "color");
     mScreenUniform = mglGetUniformLocation(mProgramId, "screen");
+    mOffsetUniform = mglGetUniformLocation(mProgramId, "offset");
     mDrawTypeUniform = mglGetUniformLocation(mProgramId, "drawType");
     mTextureColorUniform = mglGetUniformLocation(mProgramId, "alpha");
 
@@ -203,6 +218,7 @@ void ModernOpenGLGraphics::postInit() restrict2
     mglUniform2f(mScreenUniform,
         static_cast<float>(mWidth) / 2.0F,
         static_cast<float>(mHeight) / 2.0F);
+    mglUniform2f(mOffsetUniform, 0.0F, 0.0F);
     mglUniform4f(mSimpleColorUniform,
         0.0F,
         0.0F,
@@ -212,6 +228,7 @@ void ModernOpenGLGraphics::postInit() restrict2
 
 void ModernOpenGLGraphics::screenResized() restrict2
 {
+    flushBatch();
     deleteGLObjects();
     mVboBinded = 0U;
     mEboBinded = 0U;
@@ -231,6 +248,9 @@ void ModernOpenGLGraphics::deleteArraysInternal() restrict2
     mIntArray = nullptr;
     delete [] mIntArrayCached;
     mIntArrayCached = nullptr;
+    delete [] mBatchArray;
+    mBatchArray = nullptr;
+    mBatchVp = 0;
 }
 
 bool ModernOpenGLGraphics::setVideoMode(const int w, const int h,
@@ -259,6 +279,8 @@ void ModernOpenGLGraphics::setColor(const Color &restrict color) restrict2
     mColorAlpha = (color.a != 255);
     if (mColor != color)
     {
+        if (!mTextureDraw)
+            flushBatch();
         mColor = color;
         mglUniform4f(mSimpleColorUniform,
             static_cast<float>(color.r) / 255.0F,
@@ -272,6 +294,7 @@ void ModernOpenGLGraphics::setColorAlpha(const float alpha) restrict2
 {
     if (mAlphaCached != alpha)
     {
+        flushBatch();
         mAlphaCached = alpha;
         mglUniform1f(mTextureColorUniform, alpha);
     }
@@ -284,29 +307,16 @@ void ModernOpenGLGraphics::drawQuad(const int srcX,
                                     const int width,
                                     const int height) restrict2
 {
-    const int texX2 = srcX + width;
-    const int texY2 = srcY + height;
-    const int x2 = dstX + width;
-    const int y2 = dstY + height;
-
-    GLint vertices[] =
-    {
-        dstX, dstY, srcX, srcY,
-        x2, dstY, texX2, srcY,
-        dstX, y2, srcX, texY2,
-        x2, y2, texX2, texY2
-    };
-
-//    logger->log("allocate: %d, %ld", mVboBinded, sizeof(vertices));
-    mglBufferData(GL_ARRAY_BUFFER, sizeof(vertices),
-        vertices, GL_STREAM_DRAW);
+    if (mBatchVp + 24 > batchSize)
+        flushBatch();
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
 #endif  // DEBUG_DRAW_CALLS
-    mglDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-#ifdef OPENGLERRORS
-    graphicsManager.logError();
-#endif  // OPENGLERRORS
+    const int vp = mBatchVp;
+    vertFill2D(mBatchArray,
+        srcX, srcY, srcX + width, srcY + height,
+        dstX, dstY, width, height);
+    mBatchVp += 24;
 }
 
 void ModernOpenGLGraphics::drawRescaledQuad(const int srcX, const int srcY,
@@ -315,26 +325,49 @@ void ModernOpenGLGraphics::drawRescaledQuad(const int srcX, const int srcY,
                                             const int desiredWidth,
                                             const int desiredHeight) restrict2
 {
-    const int texX2 = srcX + width;
-    const int texY2 = srcY + height;
-    const int x2 = dstX + desiredWidth;
-    const int y2 = dstY + desiredHeight;
+    if (mBatchVp + 24 > batchSize)
+        flushBatch();
+#ifdef DEBUG_DRAW_CALLS
+    mDrawCalls ++;
+#endif  // DEBUG_DRAW_CALLS
+    const int vp = mBatchVp;
+    vertFill2D(mBatchArray,
+        srcX, srcY, srcX + width, srcY + height,
+        dstX, dstY, desiredWidth, desiredHeight);
+    mBatchVp += 24;
+}
 
-    GLint vertices[] =
+void ModernOpenGLGraphics::prepareBatch(const Image *restrict const image)
+                                        restrict2
+{
+    const GLuint texture = image->mGLImage;
+    if (mBatchTexture != texture)
     {
-        dstX, dstY, srcX, srcY,
-        x2, dstY, texX2, srcY,
-        dstX, y2, srcX, texY2,
-        x2, y2, texX2, texY2
-    };
+        flushBatch();
+        mBatchTexture = texture;
+    }
+    enableTexturingAndBlending();
+    setColorAlpha(image->mAlpha);
+    bindTexture(OpenGLImageHelper::mTextureType, texture);
+}
 
-//    logger->log("allocate: %d, %ld", mVboBinded, sizeof(vertices));
-    mglBufferData(GL_ARRAY_BUFFER, sizeof(vertices),
-        vertices, GL_STREAM_DRAW);
+void ModernOpenGLGraphics::flushBatch() restrict2
+{
+    if (mBatchVp == 0)
+        return;
+    // other code can bind own texture or buffer between batched draws
+    if (mTextureDraw)
+        bindTexture(OpenGLImageHelper::mTextureType, mBatchTexture);
+    bindArrayBufferAndAttributes(mVbo);
+    const int size = mBatchVp;
+    mBatchVp = 0;
+    mglBufferData(GL_ARRAY_BUFFER, size * sizeof(GLint),
+        mBatchArray, GL_STREAM_DRAW);
 #ifdef DEBUG_DRAW_CALLS
-    mDrawCalls ++;
+    // quads in batch already counted as draw calls
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
-    mglDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    mglDrawArrays(GL_TRIANGLES, 0, size / 4);
 #ifdef OPENGLERRORS
     graphicsManager.logError();
 #endif  // OPENGLERRORS
@@ -356,10 +389,7 @@ void ModernOpenGLGraphics::drawImageInline(const Image *restrict const image,
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
 #endif  // DEBUG_BIND_TEXTURE
-    bindTexture(GL_TEXTURE_2D, image->mGLImage);
-    enableTexturingAndBlending();
-    bindArrayBufferAndAttributes(mVbo);
-    setColorAlpha(image->mAlpha);
+    prepareBatch(image);
 
     const ClipRect &clipArea = mClipStack.top();
     const SDL_Rect &imageRect = image->mBounds;
@@ -376,6 +406,7 @@ void ModernOpenGLGraphics::copyImage(const Image *restrict const image,
 
 void ModernOpenGLGraphics::testDraw() restrict2
 {
+    flushBatch();
 /*
     GLint vertices[] =
     {
@@ -393,6 +424,7 @@ void ModernOpenGLGraphics::testDraw() restrict2
 //        elements, GL_STREAM_DRAW);
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     mglDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 //    glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_INT, 0);
@@ -438,13 +470,10 @@ void ModernOpenGLGraphics::drawRescaledImage(const Image *restrict const image,
         return;
     }
 
-    setColorAlpha(image->mAlpha);
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
 #endif  // DEBUG_BIND_TEXTURE
-    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
-    enableTexturingAndBlending();
-    bindArrayBufferAndAttributes(mVbo);
+    prepareBatch(image);
 
     const ClipRect &clipArea = mClipStack.top();
     // Draw a textured quad.
@@ -486,15 +515,7 @@ void ModernOpenGLGraphics::drawPatternInline(const Image *restrict const image,
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
 #endif  // DEBUG_BIND_TEXTURE
-
-    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
-
-    enableTexturingAndBlending();
-    bindArrayBufferAndAttributes(mVbo);
-    setColorAlpha(image->mAlpha);
-
-    unsigned int vp = 0;
-    const unsigned int vLimit = mMaxVertices * 4;
+    prepareBatch(image);
 
     for (int py = 0; py < h; py += ih)
     {
@@ -508,20 +529,15 @@ void ModernOpenGLGraphics::drawPatternInline(const Image *restrict const image,
 
             const int texX2 = srcX + width;
 
-            vertFill2D(mIntArray,
+            if (mBatchVp + 24 > batchSize)
+                flushBatch();
+            const int vp = mBatchVp;
+            vertFill2D(mBatchArray,
                 srcX, srcY, texX2, texY2,
                 dstX, dstY, width, height);
-
-            vp += 24;
-            if (vp >= vLimit)
-            {
-                drawTriangleArray(vp);
-                vp = 0;
-            }
+            mBatchVp += 24;
         }
     }
-    if (vp > 0)
-        drawTriangleArray(vp);
 }
 
 void ModernOpenGLGraphics::drawRescaledPattern(const Image *
@@ -549,15 +565,7 @@ void ModernOpenGLGraphics::drawRescaledPattern(const Image *
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
 #endif  // DEBUG_BIND_TEXTURE
-
-    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
-
-    enableTexturingAndBlending();
-    bindArrayBufferAndAttributes(mVbo);
-    setColorAlpha(image->mAlpha);
-
-    unsigned int vp = 0;
-    const unsigned int vLimit = mMaxVertices * 4;
+    prepareBatch(image);
 
     const ClipRect &clipArea = mClipStack.top();
     const int x2 = x + clipArea.xOffset;
@@ -579,20 +587,15 @@ void ModernOpenGLGraphics::drawRescaledPattern(const Image *
             const int dstX = x2 + px;
             const int scaledX = srcX + width / scaleFactorW;
 
-            vertFill2D(mIntArray,
+            if (mBatchVp + 24 > batchSize)
+                flushBatch();
+            const int vp = mBatchVp;
+            vertFill2D(mBatchArray,
                 srcX, srcY, scaledX, scaledY,
                 dstX, dstY, width, height);
-
-            vp += 24;
-            if (vp >= vLimit)
-            {
-                drawTriangleArray(vp);
-                vp = 0;
-            }
+            mBatchVp += 24;
         }
     }
-    if (vp > 0)
-        drawTriangleArray(vp);
 }
 
 inline void ModernOpenGLGraphics::drawVertexes(const
@@ -617,6 +620,7 @@ inline void ModernOpenGLGraphics::drawVertexes(const
         bindArrayBufferAndAttributes(*ivbo);
 #ifdef DEBUG_DRAW_CALLS
         mDrawCalls ++;
+        mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
 //        logger->log("draw from array: %u", *ivbo);
         mglDrawArrays(GL_TRIANGLES, 0, *ivp / 4);
@@ -721,6 +725,7 @@ void ModernOpenGLGraphics::drawTileCollection(const ImageCollection
                                               *restrict const vertCol)
                                               restrict2
 {
+    flushBatch();
     enableTexturingAndBlending();
 /*
     if (!vertCol)
@@ -832,6 +837,7 @@ void ModernOpenGLGraphics::drawTileVertexes(const ImageVertexes *
         return;
     const Image *const image = vert->image;
 
+    flushBatch();
     setColorAlpha(image->mAlpha);
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
@@ -844,6 +850,20 @@ void ModernOpenGLGraphics::drawTileVertexes(const ImageVertexes *
     drawVertexes(vert->ogl);
 }
 
+void ModernOpenGLGraphics::drawMovedTileVertexes(const ImageVertexes *
+                                                 restrict const vert,
+                                                 const int dx,
+                                                 const int dy) restrict2
+{
+    flushBatch();
+    const ClipRect &clipArea = mClipStack.top();
+    mglUniform2f(mOffsetUniform,
+        static_cast<float>(dx + clipArea.xOffset),
+        static_cast<float>(dy + clipArea.yOffset));
+    drawTileVertexes(vert);
+    mglUniform2f(mOffsetUniform, 0.0F, 0.0F);
+}
+
 void ModernOpenGLGraphics::calcWindow(ImageCollection *restrict const vertCol,
                                       const int x, const int y,
                                       const int w, const int h,
@@ -872,9 +892,12 @@ void ModernOpenGLGraphics::calcWindow(ImageCollection *restrict const vertCol,
 void ModernOpenGLGraphics::updateScreen() restrict2
 {
     BLOCK_START("Graphics::updateScreen")
+    flushBatch();
 #ifdef DEBUG_DRAW_CALLS
     mLastDrawCalls = mDrawCalls;
     mDrawCalls = 0;
+    mLastBatches = mBatches;
+    mBatches = 0;
 #endif  // DEBUG_DRAW_CALLS
 #ifdef USE_SDL2
     SDL_GL_SwapWindow(mWindow);
@@ -898,11 +921,13 @@ void ModernOpenGLGraphics::beginDraw() restrict2
 
 void ModernOpenGLGraphics::endDraw() restrict2
 {
+    flushBatch();
     popClipArea();
 }
 
 void ModernOpenGLGraphics::pushClipArea(const Rect &restrict area) restrict2
 {
+    flushBatch();
     Graphics::pushClipArea(area);
     const ClipRect &clipArea = mClipStack.top();
 
@@ -916,6 +941,7 @@ void ModernOpenGLGraphics::popClipArea() restrict2
 {
     if (mClipStack.empty())
         return;
+    flushBatch();
     Graphics::popClipArea();
     if (mClipStack.empty())
         return;
@@ -929,6 +955,7 @@ void ModernOpenGLGraphics::popClipArea() restrict2
 
 void ModernOpenGLGraphics::drawPoint(int x, int y) restrict2
 {
+    flushBatch();
     disableTexturingAndBlending();
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -941,6 +968,7 @@ void ModernOpenGLGraphics::drawPoint(int x, int y) restrict2
         vertices, GL_STREAM_DRAW);
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     mglDrawArrays(GL_POINTS, 0, 1);
 #ifdef OPENGLERRORS
@@ -951,6 +979,7 @@ void ModernOpenGLGraphics::drawPoint(int x, int y) restrict2
 void ModernOpenGLGraphics::drawLine(int x1, int y1,
                                     int x2, int y2) restrict2
 {
+    flushBatch();
     disableTexturingAndBlending();
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -964,6 +993,7 @@ void ModernOpenGLGraphics::drawLine(int x1, int y1,
         vertices, GL_STREAM_DRAW);
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     mglDrawArrays(GL_LINES, 0, 2);
 #ifdef OPENGLERRORS
@@ -973,6 +1003,7 @@ void ModernOpenGLGraphics::drawLine(int x1, int y1,
 
 void ModernOpenGLGraphics::drawRectangle(const Rect &restrict rect) restrict2
 {
+    flushBatch();
     disableTexturingAndBlending();
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -993,6 +1024,7 @@ void ModernOpenGLGraphics::drawRectangle(const Rect &restrict rect) restrict2
         vertices, GL_STREAM_DRAW);
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     mglDrawArrays(GL_LINE_LOOP, 0, 4);
 #ifdef OPENGLERRORS
@@ -1003,41 +1035,31 @@ void ModernOpenGLGraphics::drawRectangle(const Rect &restrict rect) restrict2
 void ModernOpenGLGraphics::fillRectangle(const Rect &restrict rect) restrict2
 {
     disableTexturingAndBlending();
-    bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
-    const int x1 = rect.x + clipArea.xOffset;
-    const int y1 = rect.y + clipArea.yOffset;
-    const int x2 = x1 + rect.width;
-    const int y2 = y1 + rect.height;
-    GLint vertices[] =
-    {
-        x1, y1, 0, 0,
-        x2, y1, 0, 0,
-        x1, y2, 0, 0,
-        x2, y2, 0, 0
-    };
-
-//    logger->log("allocate: %d, %ld", mVboBinded, sizeof(vertices));
-    mglBufferData(GL_ARRAY_BUFFER, sizeof(vertices),
-        vertices, GL_STREAM_DRAW);
+    if (mBatchVp + 24 > batchSize)
+        flushBatch();
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
 #endif  // DEBUG_DRAW_CALLS
-    mglDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-#ifdef OPENGLERRORS
-    graphicsManager.logError();
-#endif  // OPENGLERRORS
+    const int vp = mBatchVp;
+    vertFill2D(mBatchArray,
+        0, 0, 0, 0,
+        rect.x + clipArea.xOffset, rect.y + clipArea.yOffset,
+        rect.width, rect.height);
+    mBatchVp += 24;
 }
 
 void ModernOpenGLGraphics::enableTexturingAndBlending() restrict2
 {
     if (!mTextureDraw)
     {
+        flushBatch();
         mTextureDraw = true;
         mglUniform1f(mDrawTypeUniform, 1.0F);
     }
     if (!mAlpha)
     {
+        flushBatch();
         mglEnable(GL_BLEND);
         mAlpha = true;
     }
@@ -1047,16 +1069,19 @@ void ModernOpenGLGraphics::disableTexturingAndBlending() restrict2
 {
     if (mTextureDraw)
     {
+        flushBatch();
         mTextureDraw = false;
         mglUniform1f(mDrawTypeUniform, 0.0F);
     }
     if (mAlpha && !mColorAlpha)
     {
+        flushBatch();
         mglDisable(GL_BLEND);
         mAlpha = false;
     }
     else if (!mAlpha && mColorAlpha)
     {
+        flushBatch();
         mglEnable(GL_BLEND);
         mAlpha = true;
     }
@@ -1074,6 +1099,7 @@ void ModernOpenGLGraphics::drawNet(const int x1, const int y1,
     unsigned int vp = 0;
     const unsigned int vLimit = mMaxVertices * 4;
 
+    flushBatch();
     disableTexturingAndBlending();
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -1336,20 +1362,6 @@ void ModernOpenGLGraphics::finalize(ImageVertexes *restrict const vert)
     intTexPool.clear();
 }
 
-void ModernOpenGLGraphics::drawTriangleArray(const int size) restrict2
-{
-//    logger->log("allocate: %d, %ld", mVboBinded, size * sizeof(GLint));
-    mglBufferData(GL_ARRAY_BUFFER, size * sizeof(GLint),
-        mIntArray, GL_STREAM_DRAW);
-#ifdef DEBUG_DRAW_CALLS
-    mDrawCalls ++;
-#endif  // DEBUG_DRAW_CALLS
-    mglDrawArrays(GL_TRIANGLES, 0, size / 4);
-#ifdef OPENGLERRORS
-    graphicsManager.logError();
-#endif  // OPENGLERRORS
-}
-
 void ModernOpenGLGraphics::drawTriangleArray(const GLint *restrict const array,
                                              const int size) restrict2
 {
@@ -1358,6 +1370,7 @@ void ModernOpenGLGraphics::drawTriangleArray(const GLint *restrict const array,
         array, GL_STREAM_DRAW);
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     mglDrawArrays(GL_TRIANGLES, 0, size / 4);
 #ifdef OPENGLERRORS
@@ -1372,6 +1385,7 @@ void ModernOpenGLGraphics::drawLineArrays(const int size)
         mIntArray, GL_STREAM_DRAW);
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     mglDrawArrays(GL_LINES, 0, size / 4);
 #ifdef OPENGLERRORS
@@ -100,6 +100,23 @@ class ModernOpenGLGraphics final : public Graphics
         #include "render/openglgraphicsdefadvanced.hpp"
         RENDER_OPENGLGRAPHICSDEFADVANCED_HPP
 
+        void drawMovedTileVertexes(const ImageVertexes *restrict const vert,
+                                   const int dx,
+                                   const int dy) restrict2 override final;
+
+        bool isAllowMoveVertexes() const restrict2 noexcept2 override final
+        { return true; }
+
+#ifdef DEBUG_DRAW_CALLS
+    public:
+        unsigned int getBatches() const restrict2 noexcept2 override final
+        { return mLastBatches; }
+
+        static unsigned int mBatches;
+
+        static unsigned int mLastBatches;
+#endif  // DEBUG_DRAW_CALLS
+
     private:
         void deleteGLObjects() restrict2;
 
@@ -117,8 +134,6 @@ class ModernOpenGLGraphics final : public Graphics
                                      const int desiredHeight)
                                      restrict2 A_INLINE;
 
-        inline void drawTriangleArray(const int size) restrict2 A_INLINE;
-
         inline void drawTriangleArray(const GLint *restrict const array,
                                       const int size) restrict2 A_INLINE;
 
@@ -133,11 +148,26 @@ class ModernOpenGLGraphics final : public Graphics
 
         inline void bindElementBuffer(const GLuint ebo) restrict2 A_INLINE;
 
+        /**
+         * Prepares state for adding image quads to batch.
+         * Draws pending batch if it was for other image state.
+         */
+        inline void prepareBatch(const Image *restrict const image)
+                                 restrict2 A_INLINE;
+
+        /**
+         * Draws all quads collected in batch by one draw call.
+         * Must be called before any other drawing or state change.
+         */
+        void flushBatch() restrict2;
+
         GLint *mIntArray A_NONNULLPOINTER;
         GLint *mIntArrayCached A_NONNULLPOINTER;
+        GLint *mBatchArray A_NONNULLPOINTER;
         ShaderProgram *mProgram;
         float mAlphaCached;
         int mVpCached;
+        int mBatchVp;
 
         float mFloatColor;
         int mMaxVertices;
@@ -146,6 +176,7 @@ class ModernOpenGLGraphics final : public Graphics
         GLint mPosAttrib;
         GLint mTextureColorUniform;
         GLuint mScreenUniform;
+        GLuint mOffsetUniform;
         GLuint mDrawTypeUniform;
         GLuint mVao;
         GLuint mVbo;
@@ -153,6 +184,7 @@ class ModernOpenGLGraphics final : public Graphics
         GLuint mVboBinded;
         GLuint mEboBinded;
         GLuint mAttributesBinded;
+        GLuint mBatchTexture;
         bool mColorAlpha;
         bool mTextureDraw;
 #ifdef DEBUG_BIND_TEXTURE
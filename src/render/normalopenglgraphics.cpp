@@ -1233,6 +1233,18 @@ void NormalOpenGLGraphics::drawTileVertexes(const ImageVertexes *
     drawVertexes(vert->ogl);
 }
 
+void NormalOpenGLGraphics::drawMovedTileVertexes(const ImageVertexes *
+                                                 restrict const vert,
+                                                 const int dx,
+                                                 const int dy) restrict2
+{
+    glTranslatef(static_cast<GLfloat>(dx),
+                 static_cast<GLfloat>(dy), 0);
+    drawTileVertexes(vert);
+    glTranslatef(static_cast<GLfloat>(-dx),
+                 static_cast<GLfloat>(-dy), 0);
+}
+
 void NormalOpenGLGraphics::calcWindow(ImageCollection *restrict const vertCol,
                                       const int x, const int y,
                                       const int w, const int h,
@@ -105,6 +105,13 @@ class NormalOpenGLGraphics final : public Graphics
         #include "render/openglgraphicsdefadvanced.hpp"
         RENDER_OPENGLGRAPHICSDEFADVANCED_HPP
 
+        void drawMovedTileVertexes(const ImageVertexes *restrict const vert,
+                                   const int dx,
+                                   const int dy) restrict2 override final;
+
+        bool isAllowMoveVertexes() const restrict2 noexcept2 override final
+        { return true; }
+
 #ifdef DEBUG_BIND_TEXTURE
         unsigned int getBinds() const restrict2 noexcept2
         { return mLastBinds; }
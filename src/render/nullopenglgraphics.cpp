@@ -42,6 +42,8 @@ GLuint NullOpenGLGraphics::mTextureBinded = 0;
 #ifdef DEBUG_DRAW_CALLS
 unsigned int NullOpenGLGraphics::mDrawCalls = 0;
 unsigned int NullOpenGLGraphics::mLastDrawCalls = 0;
+unsigned int NullOpenGLGraphics::mBatches = 0;
+unsigned int NullOpenGLGraphics::mLastBatches = 0;
 #endif  // DEBUG_DRAW_CALLS
 
 NullOpenGLGraphics::NullOpenGLGraphics() :
@@ -131,12 +133,14 @@ static inline void drawQuad(const Image *restrict const image A_UNUSED,
     {
 #ifdef DEBUG_DRAW_CALLS
         NullOpenGLGraphics::mDrawCalls ++;
+        NullOpenGLGraphics::mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     }
     else
     {
 #ifdef DEBUG_DRAW_CALLS
         NullOpenGLGraphics::mDrawCalls ++;
+        NullOpenGLGraphics::mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     }
 }
@@ -155,12 +159,14 @@ static inline void drawRescaledQuad(const Image *restrict const image A_UNUSED,
     {
 #ifdef DEBUG_DRAW_CALLS
         NullOpenGLGraphics::mDrawCalls ++;
+        NullOpenGLGraphics::mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     }
     else
     {
 #ifdef DEBUG_DRAW_CALLS
         NullOpenGLGraphics::mDrawCalls ++;
+        NullOpenGLGraphics::mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
     }
 }
@@ -961,6 +967,8 @@ void NullOpenGLGraphics::updateScreen() restrict2
 #ifdef DEBUG_DRAW_CALLS
     mLastDrawCalls = mDrawCalls;
     mDrawCalls = 0;
+    mLastBatches = mBatches;
+    mBatches = 0;
 #endif  // DEBUG_DRAW_CALLS
 
     BLOCK_END("Graphics::updateScreen")
@@ -1063,6 +1071,7 @@ void NullOpenGLGraphics::drawRectangle(const Rect &restrict rect A_UNUSED,
 
 #ifdef DEBUG_DRAW_CALLS
         mDrawCalls ++;
+        mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
 
     BLOCK_END("Graphics::drawRectangle")
@@ -1131,6 +1140,7 @@ inline void NullOpenGLGraphics::drawQuadArrayfi(const int size A_UNUSED)
 {
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
 }
 
@@ -1143,6 +1153,7 @@ inline void NullOpenGLGraphics::drawQuadArrayfi(const GLint *restrict const
 {
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
 }
 
@@ -1151,6 +1162,7 @@ inline void NullOpenGLGraphics::drawQuadArrayii(const int size A_UNUSED)
 {
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
 }
 
@@ -1163,6 +1175,7 @@ inline void NullOpenGLGraphics::drawQuadArrayii(const GLint *restrict const
 {
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
 }
 
@@ -1171,6 +1184,7 @@ inline void NullOpenGLGraphics::drawLineArrayi(const int size A_UNUSED)
 {
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
 }
 
@@ -1179,6 +1193,7 @@ inline void NullOpenGLGraphics::drawLineArrayf(const int size A_UNUSED)
 {
 #ifdef DEBUG_DRAW_CALLS
     mDrawCalls ++;
+    mBatches ++;
 #endif  // DEBUG_DRAW_CALLS
 }
 
@@ -98,6 +98,17 @@ class NullOpenGLGraphics final : public Graphics
         #include "render/openglgraphicsdefadvanced.hpp"
         RENDER_OPENGLGRAPHICSDEFADVANCED_HPP
 
+#ifdef DEBUG_DRAW_CALLS
+    public:
+        // each quad sent separately, so batches same as draw calls
+        unsigned int getBatches() const restrict2 noexcept2 override final
+        { return mLastBatches; }
+
+        static unsigned int mBatches;
+
+        static unsigned int mLastBatches;
+#endif  // DEBUG_DRAW_CALLS
+
     private:
         GLfloat *mFloatTexArray A_NONNULLPOINTER;
         GLint *mIntTexArray A_NONNULLPOINTER;
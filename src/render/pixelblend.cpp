@@ -0,0 +1,207 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/pixelblend.h"
+
+#include "utils/cast.h"
+#include "utils/cpu.h"
+
+#ifdef SIMD_SUPPORTED
+// avx2
+#include <immintrin.h>
+#endif  // SIMD_SUPPORTED
+
+#include "debug.h"
+
+namespace PixelBlend
+{
+    BlendFunctionPtr blend = &PixelBlend::blendDefault;
+    FillFunctionPtr fill = &PixelBlend::fillDefault;
+}  // namespace PixelBlend
+
+namespace
+{
+    bool isByteMask(const uint32_t mask)
+    {
+        return mask == 0xffU ||
+            mask == 0xff00U ||
+            mask == 0xff0000U ||
+            mask == 0xff000000U;
+    }
+}  // namespace
+
+void PixelBlend::initFunctions()
+{
+#ifdef SIMD_SUPPORTED
+    const uint32_t flags = Cpu::getFlags();
+    if ((flags & Cpu::FEATURE_AVX2) != 0U)
+    {
+        blend = &PixelBlend::blendAvx2;
+        fill = &PixelBlend::fillAvx2;
+    }
+    else if ((flags & Cpu::FEATURE_SSE2) != 0U)
+    {
+        blend = &PixelBlend::blendSse2;
+        fill = &PixelBlend::fillSse2;
+    }
+    else
+#endif  // SIMD_SUPPORTED
+    {
+        blend = &PixelBlend::blendDefault;
+        fill = &PixelBlend::fillDefault;
+    }
+}
+
+uint32_t PixelBlend::getColorMask(const uint32_t rMask,
+                                  const uint32_t gMask,
+                                  const uint32_t bMask)
+{
+    if (!isByteMask(rMask) ||
+        !isByteMask(gMask) ||
+        !isByteMask(bMask))
+    {
+        return 0U;
+    }
+    return rMask | gMask | bMask;
+}
+
+void PixelBlend::blendDefault(uint32_t *restrict pixels,
+                              const int count,
+                              const uint32_t pixel,
+                              const unsigned int alpha,
+                              const uint32_t mask)
+{
+    const unsigned int a1 = 255U - alpha;
+    const unsigned int c0 = (pixel & 0xffU) * alpha;
+    const unsigned int c1 = ((pixel >> 8) & 0xffU) * alpha;
+    const unsigned int c2 = ((pixel >> 16) & 0xffU) * alpha;
+    const unsigned int c3 = (pixel >> 24) * alpha;
+
+    for (int f = 0; f < count; f ++)
+    {
+        const uint32_t dst = pixels[f];
+        pixels[f] = (((c0 + (dst & 0xffU) * a1) >> 8)
+            | (((c1 + ((dst >> 8) & 0xffU) * a1) >> 8) << 8)
+            | (((c2 + ((dst >> 16) & 0xffU) * a1) >> 8) << 16)
+            | (((c3 + (dst >> 24) * a1) >> 8) << 24)) & mask;
+    }
+}
+
+void PixelBlend::fillDefault(uint32_t *restrict pixels,
+                             const int count,
+                             const uint32_t pixel)
+{
+    for (int f = 0; f < count; f ++)
+        pixels[f] = pixel;
+}
+
+#ifdef SIMD_SUPPORTED
+
+void PixelBlend::blendSse2(uint32_t *restrict pixels,
+                           const int count,
+                           const uint32_t pixel,
+                           const unsigned int alpha,
+                           const uint32_t mask)
+{
+    const int bufEnd = count - count % 4;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i colorMask = _mm_set1_epi32(CAST_S32(mask));
+    const __m128i alpha1 = _mm_set1_epi16(CAST_S16(255U - alpha));
+    // color bytes multiplied by alpha, in 16 bit parts
+    const __m128i color = _mm_mullo_epi16(
+        _mm_unpacklo_epi8(_mm_set1_epi32(CAST_S32(pixel)), zero),
+        _mm_set1_epi16(CAST_S16(alpha)));
+
+    for (int ptr = 0; ptr < bufEnd; ptr += 4)
+    {
+        __m128i *const p = reinterpret_cast<__m128i*>(&pixels[ptr]);
+        const __m128i dst = _mm_loadu_si128(p);
+        __m128i low = _mm_unpacklo_epi8(dst, zero);
+        __m128i high = _mm_unpackhi_epi8(dst, zero);
+        low = _mm_srli_epi16(_mm_add_epi16(
+            _mm_mullo_epi16(low, alpha1), color), 8);
+        high = _mm_srli_epi16(_mm_add_epi16(
+            _mm_mullo_epi16(high, alpha1), color), 8);
+        _mm_storeu_si128(p, _mm_and_si128(
+            _mm_packus_epi16(low, high), colorMask));
+    }
+    blendDefault(pixels + bufEnd, count - bufEnd, pixel, alpha, mask);
+}
+
+void PixelBlend::blendAvx2(uint32_t *restrict pixels,
+                           const int count,
+                           const uint32_t pixel,
+                           const unsigned int alpha,
+                           const uint32_t mask)
+{
+    const int bufEnd = count - count % 8;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i colorMask = _mm256_set1_epi32(CAST_S32(mask));
+    const __m256i alpha1 = _mm256_set1_epi16(CAST_S16(255U - alpha));
+    // all pixels same, so unpack inside 128 bit lanes not changes order
+    const __m256i color = _mm256_mullo_epi16(
+        _mm256_unpacklo_epi8(_mm256_set1_epi32(CAST_S32(pixel)), zero),
+        _mm256_set1_epi16(CAST_S16(alpha)));
+
+    for (int ptr = 0; ptr < bufEnd; ptr += 8)
+    {
+        __m256i *const p = reinterpret_cast<__m256i*>(&pixels[ptr]);
+        const __m256i dst = _mm256_loadu_si256(p);
+        __m256i low = _mm256_unpacklo_epi8(dst, zero);
+        __m256i high = _mm256_unpackhi_epi8(dst, zero);
+        low = _mm256_srli_epi16(_mm256_add_epi16(
+            _mm256_mullo_epi16(low, alpha1), color), 8);
+        high = _mm256_srli_epi16(_mm256_add_epi16(
+            _mm256_mullo_epi16(high, alpha1), color), 8);
+        _mm256_storeu_si256(p, _mm256_and_si256(
+            _mm256_packus_epi16(low, high), colorMask));
+    }
+    blendSse2(pixels + bufEnd, count - bufEnd, pixel, alpha, mask);
+}
+
+void PixelBlend::fillSse2(uint32_t *restrict pixels,
+                          const int count,
+                          const uint32_t pixel)
+{
+    const int bufEnd = count - count % 4;
+    const __m128i color = _mm_set1_epi32(CAST_S32(pixel));
+    for (int ptr = 0; ptr < bufEnd; ptr += 4)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&pixels[ptr]),
+            color);
+    }
+    fillDefault(pixels + bufEnd, count - bufEnd, pixel);
+}
+
+void PixelBlend::fillAvx2(uint32_t *restrict pixels,
+                          const int count,
+                          const uint32_t pixel)
+{
+    const int bufEnd = count - count % 8;
+    const __m256i color = _mm256_set1_epi32(CAST_S32(pixel));
+    for (int ptr = 0; ptr < bufEnd; ptr += 8)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&pixels[ptr]),
+            color);
+    }
+    fillSse2(pixels + bufEnd, count - bufEnd, pixel);
+}
+
+#endif  // SIMD_SUPPORTED
@@ -0,0 +1,96 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_PIXELBLEND_H
+#define RENDER_PIXELBLEND_H
+
+#include "localconsts.h"
+
+/**
+ * Blend and fill functions for rows of 32 bit pixels.
+ * Selected by cpu features in initFunctions.
+ */
+namespace PixelBlend
+{
+    typedef void (*BlendFunctionPtr)(uint32_t *restrict pixels,
+                                     const int count,
+                                     const uint32_t pixel,
+                                     const unsigned int alpha,
+                                     const uint32_t mask);
+
+    typedef void (*FillFunctionPtr)(uint32_t *restrict pixels,
+                                    const int count,
+                                    const uint32_t pixel);
+
+    void initFunctions();
+
+    /**
+     * Returns mask of color bytes if each color mask covers one byte,
+     * or 0 if format can not be blended by bytes.
+     */
+    uint32_t getColorMask(const uint32_t rMask,
+                          const uint32_t gMask,
+                          const uint32_t bMask) A_WARN_UNUSED;
+
+    /**
+     * Blends pixel with given alpha over each byte selected by mask.
+     * Other bytes cleared.
+     */
+    void blendDefault(uint32_t *restrict pixels,
+                      const int count,
+                      const uint32_t pixel,
+                      const unsigned int alpha,
+                      const uint32_t mask);
+
+    void fillDefault(uint32_t *restrict pixels,
+                     const int count,
+                     const uint32_t pixel);
+
+#ifdef SIMD_SUPPORTED
+    __attribute__ ((target ("sse2")))
+    void blendSse2(uint32_t *restrict pixels,
+                   const int count,
+                   const uint32_t pixel,
+                   const unsigned int alpha,
+                   const uint32_t mask);
+
+    __attribute__ ((target ("avx2")))
+    void blendAvx2(uint32_t *restrict pixels,
+                   const int count,
+                   const uint32_t pixel,
+                   const unsigned int alpha,
+                   const uint32_t mask);
+
+    __attribute__ ((target ("sse2")))
+    void fillSse2(uint32_t *restrict pixels,
+                  const int count,
+                  const uint32_t pixel);
+
+    __attribute__ ((target ("avx2")))
+    void fillAvx2(uint32_t *restrict pixels,
+                  const int count,
+                  const uint32_t pixel);
+#endif  // SIMD_SUPPORTED
+
+    extern BlendFunctionPtr blend;
+    extern FillFunctionPtr fill;
+}  // namespace PixelBlend
+
+#endif  // RENDER_PIXELBLEND_H
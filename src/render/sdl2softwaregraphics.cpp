@@ -25,8 +25,13 @@
 
 #include "render/sdl2softwaregraphics.h"
 
+#include "configuration.h"
 #include "graphicsmanager.h"
 
+#include "render/striprasterizer.h"
+
+#include "render/pixelblend.h"
+
 #include "render/vertexes/imagecollection.h"
 
 #include "resources/imagerect.h"
@@ -34,7 +39,9 @@
 
 #include "resources/image/image.h"
 
+#include "utils/delete2.h"
 #include "utils/sdlcheckutils.h"
+#include "utils/threadpool.h"
 
 #include "utils/sdlpixel.h"
 
@@ -63,6 +70,7 @@ SDL2SoftwareGraphics::SDL2SoftwareGraphics() :
     Graphics(),
     mRendererFlags(SDL_RENDERER_SOFTWARE),
     mSurface(nullptr),
+    mRasterizer(nullptr),
     mOldPixel(0),
     mOldAlpha(0)
 {
@@ -72,6 +80,61 @@ SDL2SoftwareGraphics::SDL2SoftwareGraphics() :
 
 SDL2SoftwareGraphics::~SDL2SoftwareGraphics()
 {
+    delete2(mRasterizer)
+}
+
+void SDL2SoftwareGraphics::createRasterizer() restrict2
+{
+    delete2(mRasterizer)
+    if (!config.getBoolValue("enableParallelSoftwareRender"))
+        return;
+    const int threads = ThreadPool::getDefaultThreadsCount(7);
+    // with one core drawing in place is faster
+    if (threads > 0)
+        mRasterizer = new StripRasterizer(threads);
+}
+
+void SDL2SoftwareGraphics::blitSurface(SDL_Surface *restrict const src,
+                                       SDL_Rect &restrict srcRect,
+                                       SDL_Rect &restrict dstRect) restrict2
+{
+    if (mRasterizer)
+    {
+        if (mRasterizer->addBlit(src, srcRect, dstRect))
+            return;
+        mRasterizer->flush(mSurface);
+    }
+    SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+}
+
+void SDL2SoftwareGraphics::flushDeferred() restrict2
+{
+    if (mRasterizer)
+        mRasterizer->flush(mSurface);
+}
+
+bool SDL2SoftwareGraphics::addStripsFill(const SDL_Rect &restrict rect)
+                                         restrict2
+{
+    if (!mRasterizer)
+        return false;
+
+    const uint32_t pixel = SDL_MapRGB(mSurface->format,
+        CAST_U8(mColor.r),
+        CAST_U8(mColor.g),
+        CAST_U8(mColor.b));
+    if (!mAlpha)
+    {
+        mRasterizer->addFill(rect, pixel);
+        return true;
+    }
+    if (mRasterizer->addFillAlpha(mSurface->format, rect,
+        pixel, mColor.a))
+    {
+        return true;
+    }
+    mRasterizer->flush(mSurface);
+    return false;
 }
 
 void SDL2SoftwareGraphics::drawRescaledImage(const Image *restrict const image,
@@ -84,6 +147,8 @@ void SDL2SoftwareGraphics::drawRescaledImage(const Image *restrict const image,
     if (!mSurface || !image || !image->mSDLSurface)
         return;
 
+    flushDeferred();
+
     Image *const tmpImage = image->SDLgetScaledImage(
         desiredWidth, desiredHeight);
 
@@ -202,7 +267,7 @@ void SDL2SoftwareGraphics::drawImageInline(const Image *restrict const image,
             CAST_U16(h)
         };
 
-        SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+        blitSurface(src, srcRect, dstRect);
     }
 }
 
@@ -295,7 +360,7 @@ void SDL2SoftwareGraphics::drawImageCached(const Image *restrict const image,
             CAST_U16(h)
         };
 
-        SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+        blitSurface(src, srcRect, dstRect);
     }
 }
 
@@ -402,7 +467,7 @@ void SDL2SoftwareGraphics::drawPatternCached(const Image *restrict const image,
                         CAST_U16(h2)
                     };
 
-                    SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+                    blitSurface(src, srcRect, dstRect);
                 }
 
 //            SDL_BlitSurface(image->mSDLSurface, &srcRect, mWindow, &dstRect);
@@ -525,7 +590,7 @@ void SDL2SoftwareGraphics::drawPatternInline(const Image *restrict const image,
                         CAST_U16(h2)
                     };
 
-                    SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+                    blitSurface(src, srcRect, dstRect);
                 }
 
 //            SDL_BlitSurface(image->mSDLSurface, &srcRect, mWindow, &dstRect);
@@ -551,6 +616,7 @@ void SDL2SoftwareGraphics::drawRescaledPattern(const Image *
     if (scaledHeight == 0 || scaledWidth == 0)
         return;
 
+    flushDeferred();
     Image *const tmpImage = image->SDLgetScaledImage(
         scaledWidth, scaledHeight);
     if (!tmpImage)
@@ -778,8 +844,7 @@ void SDL2SoftwareGraphics::drawTileCollection(const ImageCollection
         const DoubleRects::const_iterator it2_end = rects->end();
         while (it2 != it2_end)
         {
-            SDL_LowerBlit(img->mSDLSurface, &(*it2)->src,
-                mSurface, &(*it2)->dst);
+            blitSurface(img->mSDLSurface, (*it2)->src, (*it2)->dst);
             ++ it2;
         }
     }
@@ -797,7 +862,7 @@ void SDL2SoftwareGraphics::drawTileVertexes(const ImageVertexes *
     const DoubleRects::const_iterator it_end = rects->end();
     while (it != it_end)
     {
-        SDL_LowerBlit(img->mSDLSurface, &(*it)->src, mSurface, &(*it)->dst);
+        blitSurface(img->mSDLSurface, (*it)->src, (*it)->dst);
         ++ it;
     }
 }
@@ -805,6 +870,7 @@ void SDL2SoftwareGraphics::drawTileVertexes(const ImageVertexes *
 void SDL2SoftwareGraphics::updateScreen() restrict2
 {
     BLOCK_START("Graphics::updateScreen")
+    flushDeferred();
     SDL_UpdateWindowSurfaceRects(mWindow, &mRect, 1);
     BLOCK_END("Graphics::updateScreen")
 }
@@ -949,13 +1015,30 @@ void SDL2SoftwareGraphics::fillRectangle(const Rect &restrict rectangle)
         int x;
         int y;
 
-        SDL_LockSurface(mSurface);
-
         const int bpp = mSurface->format->BytesPerPixel;
         const uint32_t pixel = SDL_MapRGB(mSurface->format,
             CAST_U8(mColor.r), CAST_U8(mColor.g),
             CAST_U8(mColor.b));
 
+        if (mRasterizer)
+        {
+            const SDL_Rect rect =
+            {
+                x1,
+                y1,
+                x2 - x1,
+                y2 - y1
+            };
+            if (mRasterizer->addFillAlpha(mSurface->format, rect,
+                pixel, mColor.a))
+            {
+                return;
+            }
+            mRasterizer->flush(mSurface);
+        }
+
+        SDL_LockSurface(mSurface);
+
         switch (bpp)
         {
             case 1:
@@ -1037,6 +1120,23 @@ void SDL2SoftwareGraphics::fillRectangle(const Rect &restrict rectangle)
                 }
 #else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
 
+                const uint32_t colorMask = PixelBlend::getColorMask(
+                    mSurface->format->Rmask,
+                    mSurface->format->Gmask,
+                    mSurface->format->Bmask);
+                if (colorMask != 0U)
+                {
+                    for (y = y1; y < y2; y++)
+                    {
+                        uint32_t *const p0 = reinterpret_cast<uint32_t*>(
+                            static_cast<uint8_t*>(mSurface->pixels)
+                            + y * mSurface->pitch);
+                        PixelBlend::blend(p0 + x1, x2 - x1, pixel,
+                            mColor.a, colorMask);
+                    }
+                    break;
+                }
+
                 if (!cR)
                 {
                     cR = new unsigned int[0x100];
@@ -1114,6 +1214,26 @@ void SDL2SoftwareGraphics::fillRectangle(const Rect &restrict rectangle)
             CAST_S8(mColor.g),
             CAST_S8(mColor.b),
             CAST_S8(mColor.a));
+        if (mRasterizer)
+        {
+            // SDL_FillRect clips by surface clip area, so clip here
+            const SDL_Rect &clip = mSurface->clip_rect;
+            const int x1 = rect.x > clip.x ? rect.x : clip.x;
+            const int y1 = rect.y > clip.y ? rect.y : clip.y;
+            const int x2 = rect.x + rect.w < clip.x + clip.w ?
+                rect.x + rect.w : clip.x + clip.w;
+            const int y2 = rect.y + rect.h < clip.y + clip.h ?
+                rect.y + rect.h : clip.y + clip.h;
+            const SDL_Rect clipRect =
+            {
+                x1,
+                y1,
+                x2 - x1,
+                y2 - y1
+            };
+            mRasterizer->addFill(clipRect, color);
+            return;
+        }
         SDL_FillRect(mSurface, &rect, color);
     }
 }
@@ -1162,6 +1282,10 @@ void SDL2SoftwareGraphics::drawPoint(int x, int y) restrict2
     if (!top.isPointInRect(x, y))
         return;
 
+    const SDL_Rect rect = { x, y, 1, 1 };
+    if (addStripsFill(rect))
+        return;
+
     if (mAlpha)
         SDLputPixelAlpha(mSurface, x, y, mColor);
     else
@@ -1209,6 +1333,10 @@ void SDL2SoftwareGraphics::drawHLine(int x1, int y, int x2) restrict2
         x2 = sumX -1;
     }
 
+    const SDL_Rect rect = { x1, y, x2 - x1 + 1, 1 };
+    if (addStripsFill(rect))
+        return;
+
     const int bpp = mSurface->format->BytesPerPixel;
 
     SDL_LockSurface(mSurface);
@@ -1265,28 +1393,15 @@ void SDL2SoftwareGraphics::drawHLine(int x1, int y, int x2) restrict2
 
         case 4:
         {
-            uint32_t *q = reinterpret_cast<uint32_t*>(p);
+            uint32_t *const q = reinterpret_cast<uint32_t*>(p);
             if (mAlpha)
             {
-                unsigned char a = CAST_U8(mColor.a);
-                unsigned char a1 = CAST_U8(255U - a);
-                const int b0 = (pixel & 0xff) * a;
-                const int g0 = (pixel & 0xff00) * a;
-                const int r0 = (pixel & 0xff0000) * a;
-                for (; x1 <= x2; ++x1)
-                {
-                    const unsigned int b = (b0 + (*q & 0xff) * a1) >> 8;
-                    const unsigned int g = (g0 + (*q & 0xff00) * a1) >> 8;
-                    const unsigned int r = (r0 + (*q & 0xff0000) * a1) >> 8;
-                    *q = (b & 0xff) | (g & 0xff00) | (r & 0xff0000);
-
-                    q++;
-                }
+                PixelBlend::blend(q, x2 - x1 + 1, pixel, mColor.a,
+                    0xffffffU);
             }
             else
             {
-                for (; x1 <= x2; ++x1)
-                    *(q++) = pixel;
+                PixelBlend::fill(q, x2 - x1 + 1, pixel);
             }
             break;
         }
@@ -1336,6 +1451,10 @@ void SDL2SoftwareGraphics::drawVLine(int x, int y1, int y2) restrict2
         y2 = sumY - 1;
     }
 
+    const SDL_Rect rect = { x, y1, 1, y2 - y1 + 1 };
+    if (addStripsFill(rect))
+        return;
+
     const int bpp = mSurface->format->BytesPerPixel;
 
     SDL_LockSurface(mSurface);
@@ -1494,6 +1613,7 @@ bool SDL2SoftwareGraphics::setVideoMode(const int w, const int h,
     mSurface = SDL_GetWindowSurface(mWindow);
     ImageHelper::dumpSurfaceFormat(mSurface);
     SDL2SoftwareImageHelper::setFormat(mSurface->format);
+    createRasterizer();
 
     int w1 = 0;
     int h1 = 0;
@@ -1508,6 +1628,7 @@ bool SDL2SoftwareGraphics::setVideoMode(const int w, const int h,
 bool SDL2SoftwareGraphics::resizeScreen(const int width,
                                         const int height) restrict2
 {
+    flushDeferred();
     const bool ret = Graphics::resizeScreen(width, height);
 
     mSurface = SDL_GetWindowSurface(mWindow);
@@ -34,6 +34,7 @@ class Image;
 class ImageCollection;
 class ImageVertexes;
 class MapLayer;
+class StripRasterizer;
 
 struct SDL_Surface;
 
@@ -70,6 +71,8 @@ class SDL2SoftwareGraphics final : public Graphics
         bool resizeScreen(const int width,
                           const int height) restrict2 override final;
 
+        void flushDeferred() restrict2 override final;
+
     protected:
         int SDL_FakeUpperBlit(const SDL_Surface *restrict const src,
                               SDL_Rect *restrict const srcrect,
@@ -80,8 +83,22 @@ class SDL2SoftwareGraphics final : public Graphics
 
         void drawVLine(int x, int y1, int y2) restrict2;
 
+        void blitSurface(SDL_Surface *restrict const src,
+                         SDL_Rect &restrict srcRect,
+                         SDL_Rect &restrict dstRect) restrict2;
+
+        /**
+         * Adds fill of clipped rectangle by current color to strips.
+         * Returns false if it must be drawn in place.
+         */
+        bool addStripsFill(const SDL_Rect &restrict rect) restrict2
+                           A_WARN_UNUSED;
+
+        void createRasterizer() restrict2;
+
         uint32_t mRendererFlags;
         SDL_Surface *mSurface;
+        StripRasterizer *mRasterizer;
         uint32_t mOldPixel;
         unsigned int mOldAlpha;
 };
@@ -31,6 +31,8 @@
 
 #include "utils/sdlpixel.h"
 
+#include "render/pixelblend.h"
+
 #include "render/vertexes/imagecollection.h"
 
 #include "resources/imagerect.h"
@@ -1030,6 +1032,24 @@ void SDLGraphics::fillRectangle(const Rect &restrict rectangle) restrict2
                     }
                 }
 #else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
+
+                const uint32_t colorMask = PixelBlend::getColorMask(
+                    mWindow->format->Rmask,
+                    mWindow->format->Gmask,
+                    mWindow->format->Bmask);
+                if (colorMask != 0U)
+                {
+                    for (int y = y1; y < y2; y++)
+                    {
+                        uint32_t *const p0 = reinterpret_cast<uint32_t*>(
+                            static_cast<uint8_t*>(mWindow->pixels)
+                            + y * mWindow->pitch);
+                        PixelBlend::blend(p0 + x1, x2 - x1, pixel,
+                            mColor.a, colorMask);
+                    }
+                    break;
+                }
+
                 if (cR == nullptr)
                 {
                     cR = new unsigned int[0x100];
@@ -1274,28 +1294,15 @@ void SDLGraphics::drawHLine(int x1, int y, int x2) restrict2
 
         case 4:
         {
-            uint32_t *q = reinterpret_cast<uint32_t*>(p);
+            uint32_t *const q = reinterpret_cast<uint32_t*>(p);
             if (mAlpha)
             {
-                unsigned char a = CAST_U8(mColor.a);
-                unsigned char a1 = CAST_U8(255U - a);
-                const int b0 = (pixel & 0xff) * a;
-                const int g0 = (pixel & 0xff00) * a;
-                const int r0 = (pixel & 0xff0000) * a;
-                for (; x1 <= x2; ++x1)
-                {
-                    const unsigned int b = (b0 + (*q & 0xff) * a1) >> 8;
-                    const unsigned int g = (g0 + (*q & 0xff00) * a1) >> 8;
-                    const unsigned int r = (r0 + (*q & 0xff0000) * a1) >> 8;
-                    *q = (b & 0xff) | (g & 0xff00) | (r & 0xff0000);
-
-                    q++;
-                }
+                PixelBlend::blend(q, x2 - x1 + 1, pixel, mColor.a,
+                    0xffffffU);
             }
             else
             {
-                for (; x1 <= x2; ++x1)
-                    *(q++) = pixel;
+                PixelBlend::fill(q, x2 - x1 + 1, pixel);
             }
             break;
         }
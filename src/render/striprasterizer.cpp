@@ -0,0 +1,416 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef USE_SDL2
+
+#include "render/striprasterizer.h"
+
+#include "render/pixelblend.h"
+
+#include "utils/delete2.h"
+#include "utils/foreach.h"
+#include "utils/threadpool.h"
+
+#include "debug.h"
+
+namespace
+{
+    // max own surfaces per strip before cleaning
+    const size_t maxWrappers = 4096;
+}  // namespace
+
+StripRasterizer::StripRasterizer(const int threadsCount) :
+    mCommands(),
+    mSources(),
+    mSourceIndexes(),
+    mStrips(),
+    mPool(new ThreadPool(threadsCount)),
+    mPixels(nullptr),
+    mWidth(0),
+    mHeight(0),
+    mPitch(0),
+    mStripsCount(0)
+{
+    // two strips per thread for balance between screen parts
+    mStripsCount = (mPool->getThreadsCount() + 1) * 2;
+}
+
+StripRasterizer::~StripRasterizer()
+{
+    releaseSources();
+    clearStrips();
+    delete2(mPool)
+}
+
+bool StripRasterizer::addBlit(SDL_Surface *const src,
+                              const SDL_Rect &restrict srcRect,
+                              const SDL_Rect &restrict dstRect)
+{
+    if (src->pixels == nullptr ||
+        src->format->palette != nullptr ||
+        (src->flags & SDL_RLEACCEL) != 0 ||
+        SDL_MUSTLOCK(src))
+    {
+        return false;
+    }
+
+    int source = 0;
+    const std::map<const SDL_Surface*, int>::const_iterator it =
+        mSourceIndexes.find(src);
+    if (it == mSourceIndexes.end())
+    {
+        source = CAST_S32(mSources.size());
+        // keep surface alive if image deleted before flush
+        src->refcount ++;
+        mSources.push_back(src);
+        mSourceIndexes[src] = source;
+    }
+    else
+    {
+        source = (*it).second;
+    }
+
+    mCommands.push_back(Command());
+    Command &command = mCommands.back();
+    command.type = COMMAND_BLIT;
+    command.source = source;
+    command.src = srcRect;
+    command.dst = dstRect;
+    // surface settings can be changed before flush, so copy it
+#if SDL_VERSION_ATLEAST(2, 0, 9)
+    // SDL_GetColorKey sets error message if no color key
+    command.hasColorKey = SDL_HasColorKey(src) == SDL_TRUE &&
+        SDL_GetColorKey(src, &command.colorKey) == 0;
+#else  // SDL_VERSION_ATLEAST(2, 0, 9)
+
+    command.hasColorKey = SDL_GetColorKey(src, &command.colorKey) == 0;
+#endif  // SDL_VERSION_ATLEAST(2, 0, 9)
+
+    SDL_GetSurfaceBlendMode(src, &command.blendMode);
+    SDL_GetSurfaceAlphaMod(src, &command.alphaMod);
+    SDL_GetSurfaceColorMod(src,
+        &command.colorModR,
+        &command.colorModG,
+        &command.colorModB);
+    return true;
+}
+
+void StripRasterizer::addFill(const SDL_Rect &restrict rect,
+                              const uint32_t color)
+{
+    if (rect.w <= 0 || rect.h <= 0)
+        return;
+    mCommands.push_back(Command());
+    Command &command = mCommands.back();
+    command.type = COMMAND_FILL;
+    command.dst = rect;
+    command.color = color;
+}
+
+bool StripRasterizer::addFillAlpha(const SDL_PixelFormat *restrict const
+                                   format,
+                                   const SDL_Rect &restrict rect,
+                                   const uint32_t pixel,
+                                   const unsigned int alpha)
+{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    // only 32 bit formats with 8 bit colors
+    if (format->BytesPerPixel != 4 ||
+        format->Rmask / (format->Rmask / 0xff) != 0xff ||
+        format->Gmask / (format->Gmask / 0xff) != 0xff ||
+        format->Bmask / (format->Bmask / 0xff) != 0xff)
+    {
+        return false;
+    }
+    if (rect.w <= 0 || rect.h <= 0)
+        return true;
+    mCommands.push_back(Command());
+    Command &command = mCommands.back();
+    command.type = COMMAND_FILL_ALPHA;
+    command.dst = rect;
+    command.color = pixel;
+    command.alpha = alpha;
+    return true;
+#else  // SDL_BYTEORDER == SDL_LIL_ENDIAN
+
+    return false;
+#endif  // SDL_BYTEORDER == SDL_LIL_ENDIAN
+}
+
+void StripRasterizer::flush(SDL_Surface *const surface)
+{
+    if (mCommands.empty())
+        return;
+    BLOCK_START("StripRasterizer::flush")
+    updateStrips(surface);
+    prepareSources();
+    mPool->run(&stripJob, this, CAST_S32(mStrips.size()));
+    mCommands.clear();
+    releaseSources();
+    BLOCK_END("StripRasterizer::flush")
+}
+
+void StripRasterizer::stripJob(void *const data,
+                               const int index)
+{
+    const StripRasterizer *const rasterizer =
+        static_cast<const StripRasterizer*>(data);
+    rasterizer->drawStrip(rasterizer->mStrips[index]);
+}
+
+void StripRasterizer::drawStrip(const Strip &strip) const
+{
+    SDL_Surface *const surface = strip.surface;
+    const int y1 = strip.y1;
+    const int y2 = strip.y2;
+    FOR_EACH (STD_VECTOR<Command>::const_iterator, it, mCommands)
+    {
+        const Command &command = *it;
+        const SDL_Rect &dst = command.dst;
+        // part of command inside strip
+        const int top = dst.y > y1 ? dst.y : y1;
+        const int bottom = dst.y + dst.h < y2 ? dst.y + dst.h : y2;
+        if (top >= bottom)
+            continue;
+        SDL_Rect dstRect;
+        dstRect.x = dst.x;
+        dstRect.y = top - y1;
+        dstRect.w = dst.w;
+        dstRect.h = bottom - top;
+        switch (command.type)
+        {
+            case COMMAND_BLIT:
+            {
+                SDL_Surface *const src = strip.sources[command.source];
+                if (command.hasColorKey)
+                    SDL_SetColorKey(src, SDL_TRUE, command.colorKey);
+                else
+                    SDL_SetColorKey(src, SDL_FALSE, 0);
+                SDL_SetSurfaceBlendMode(src, command.blendMode);
+                SDL_SetSurfaceAlphaMod(src, command.alphaMod);
+                SDL_SetSurfaceColorMod(src,
+                    command.colorModR,
+                    command.colorModG,
+                    command.colorModB);
+                SDL_Rect srcRect = command.src;
+                srcRect.y += top - dst.y;
+                srcRect.h = dstRect.h;
+                SDL_LowerBlit(src, &srcRect, surface, &dstRect);
+                break;
+            }
+            case COMMAND_FILL:
+                SDL_FillRect(surface, &dstRect, command.color);
+                break;
+            case COMMAND_FILL_ALPHA:
+                fillAlpha(surface, dstRect, command.color, command.alpha);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void StripRasterizer::fillAlpha(SDL_Surface *restrict const surface,
+                                const SDL_Rect &restrict rect,
+                                const uint32_t pixel,
+                                const unsigned int alpha)
+{
+    const SDL_PixelFormat *const format = surface->format;
+    const uint32_t colorMask = PixelBlend::getColorMask(format->Rmask,
+        format->Gmask,
+        format->Bmask);
+    if (colorMask != 0U)
+    {
+        const int y2 = rect.y + rect.h;
+        for (int y = rect.y; y < y2; y++)
+        {
+            uint32_t *const p0 = reinterpret_cast<uint32_t*>(
+                static_cast<uint8_t*>(surface->pixels)
+                + y * surface->pitch);
+            PixelBlend::blend(p0 + rect.x, rect.w, pixel, alpha, colorMask);
+        }
+        return;
+    }
+
+    // same calculations as in table based blending in renderer
+    const unsigned rMask = format->Rmask;
+    const unsigned gMask = format->Gmask;
+    const unsigned bMask = format->Bmask;
+    unsigned rShift = rMask / 0xff;
+    unsigned gShift = gMask / 0xff;
+    unsigned bShift = bMask / 0xff;
+    if (!rShift)
+        rShift = 1;
+    if (!gShift)
+        gShift = 1;
+    if (!bShift)
+        bShift = 1;
+    const unsigned pb = (pixel & bMask) * alpha;
+    const unsigned pg = (pixel & gMask) * alpha;
+    const unsigned pr = (pixel & rMask) * alpha;
+    const unsigned a0 = (255 - alpha);
+    const unsigned int a1 = a0 * bShift;
+    const unsigned int a2 = a0 * gShift;
+    const unsigned int a3 = a0 * rShift;
+
+    const int x1 = rect.x;
+    const int x2 = rect.x + rect.w;
+    const int y2 = rect.y + rect.h;
+    for (int y = rect.y; y < y2; y++)
+    {
+        uint32_t *const p0 = reinterpret_cast<uint32_t*>(
+            static_cast<uint8_t*>(surface->pixels)
+            + y * surface->pitch);
+        for (int x = x1; x < x2; x++)
+        {
+            uint32_t *const p = p0 + x;
+            const uint32_t dst = *p;
+            *p = (((pb + (dst & bMask / bShift) * a1) >> 8) & bMask)
+                | (((pg + (dst & gMask) / gShift * a2) >> 8) & gMask)
+                | (((pr + (dst & rMask) / rShift * a3) >> 8) & rMask);
+        }
+    }
+}
+
+void StripRasterizer::updateStrips(SDL_Surface *const surface)
+{
+    if (!mStrips.empty() &&
+        mPixels == surface->pixels &&
+        mWidth == surface->w &&
+        mHeight == surface->h &&
+        mPitch == surface->pitch)
+    {
+        return;
+    }
+    clearStrips();
+    mPixels = surface->pixels;
+    mWidth = surface->w;
+    mHeight = surface->h;
+    mPitch = surface->pitch;
+
+    const SDL_PixelFormat *const format = surface->format;
+    int count = mStripsCount;
+    if (count > mHeight)
+        count = mHeight;
+    for (int f = 0; f < count; f ++)
+    {
+        const int y1 = mHeight * f / count;
+        const int y2 = mHeight * (f + 1) / count;
+        SDL_Surface *const stripSurface = SDL_CreateRGBSurfaceFrom(
+            static_cast<uint8_t*>(mPixels) + y1 * mPitch,
+            mWidth,
+            y2 - y1,
+            format->BitsPerPixel,
+            mPitch,
+            format->Rmask,
+            format->Gmask,
+            format->Bmask,
+            format->Amask);
+        if (stripSurface == nullptr)
+        {
+            clearStrips();
+            return;
+        }
+        mStrips.push_back(Strip());
+        Strip &strip = mStrips.back();
+        strip.surface = stripSurface;
+        strip.y1 = y1;
+        strip.y2 = y2;
+    }
+}
+
+void StripRasterizer::prepareSources()
+{
+    FOR_EACH (STD_VECTOR<Strip>::iterator, it, mStrips)
+    {
+        Strip &strip = *it;
+        if (strip.wrappers.size() + mSources.size() > maxWrappers)
+            clearWrappers(strip);
+        strip.sources.clear();
+        FOR_EACH (STD_VECTOR<SDL_Surface*>::const_iterator, it2, mSources)
+        {
+            SDL_Surface *const src = *it2;
+            SDL_Surface *&wrapper = strip.wrappers[src];
+            // surface with same address can be other surface
+            if (wrapper != nullptr &&
+                (wrapper->pixels != src->pixels ||
+                wrapper->w != src->w ||
+                wrapper->h != src->h ||
+                wrapper->pitch != src->pitch ||
+                wrapper->format->format != src->format->format))
+            {
+                SDL_FreeSurface(wrapper);
+                wrapper = nullptr;
+            }
+            if (wrapper == nullptr)
+            {
+                const SDL_PixelFormat *const format = src->format;
+                wrapper = SDL_CreateRGBSurfaceFrom(src->pixels,
+                    src->w,
+                    src->h,
+                    format->BitsPerPixel,
+                    src->pitch,
+                    format->Rmask,
+                    format->Gmask,
+                    format->Bmask,
+                    format->Amask);
+            }
+            strip.sources.push_back(wrapper);
+        }
+    }
+}
+
+void StripRasterizer::clearWrappers(Strip &strip)
+{
+    for (std::map<const SDL_Surface*, SDL_Surface*>::iterator
+         it = strip.wrappers.begin(), it_end = strip.wrappers.end();
+         it != it_end; ++ it)
+    {
+        if ((*it).second != nullptr)
+            SDL_FreeSurface((*it).second);
+    }
+    strip.wrappers.clear();
+    strip.sources.clear();
+}
+
+void StripRasterizer::clearStrips()
+{
+    FOR_EACH (STD_VECTOR<Strip>::iterator, it, mStrips)
+    {
+        clearWrappers(*it);
+        SDL_FreeSurface((*it).surface);
+    }
+    mStrips.clear();
+    mPixels = nullptr;
+    mWidth = 0;
+    mHeight = 0;
+    mPitch = 0;
+}
+
+void StripRasterizer::releaseSources()
+{
+    // only decrease reference counters, or free deleted surfaces
+    FOR_EACH (STD_VECTOR<SDL_Surface*>::iterator, it, mSources)
+        SDL_FreeSurface(*it);
+    mSources.clear();
+    mSourceIndexes.clear();
+}
+
+#endif  // USE_SDL2
@@ -0,0 +1,194 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_STRIPRASTERIZER_H
+#define RENDER_STRIPRASTERIZER_H
+
+#ifdef USE_SDL2
+
+#include "utils/vector.h"
+
+#include <map>
+
+#include "localconsts.h"
+
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_video.h>
+PRAGMA48(GCC diagnostic pop)
+
+class ThreadPool;
+
+/**
+ * Deferred drawing for software renderer.
+ *
+ * Blits and fills of frame collected to list, and on flush screen split
+ * to horizontal strips, and each strip draws all commands in same order
+ * in own job. Strips not overlap, so result same as drawing in place.
+ *
+ * Strip jobs use SDL blitters, but SDL keeps blit state in source
+ * surface. Because this each strip have own surfaces what points to
+ * pixels of source and screen surfaces. Source surfaces kept alive by
+ * reference counter until flush.
+ */
+class StripRasterizer final
+{
+    public:
+        explicit StripRasterizer(const int threadsCount);
+
+        A_DELETE_COPY(StripRasterizer)
+
+        ~StripRasterizer();
+
+        /**
+         * Adds blit with rectangles already clipped by screen clip area.
+         * Returns false if surface can not be drawn deferred.
+         */
+        bool addBlit(SDL_Surface *const src,
+                     const SDL_Rect &restrict srcRect,
+                     const SDL_Rect &restrict dstRect) A_WARN_UNUSED;
+
+        /**
+         * Adds fill of clipped rectangle by color in screen format.
+         */
+        void addFill(const SDL_Rect &restrict rect,
+                     const uint32_t color);
+
+        /**
+         * Adds blending of clipped rectangle with color.
+         * Returns false if screen format not supported.
+         */
+        bool addFillAlpha(const SDL_PixelFormat *restrict const format,
+                          const SDL_Rect &restrict rect,
+                          const uint32_t pixel,
+                          const unsigned int alpha) A_WARN_UNUSED;
+
+        /**
+         * Draws all collected commands to surface.
+         */
+        void flush(SDL_Surface *const surface);
+
+        bool isEmpty() const noexcept2 A_WARN_UNUSED
+        { return mCommands.empty(); }
+
+        int getStripsCount() const noexcept2 A_WARN_UNUSED
+        { return mStripsCount; }
+
+    private:
+        enum CommandType
+        {
+            COMMAND_BLIT = 0,
+            COMMAND_FILL,
+            COMMAND_FILL_ALPHA
+        };
+
+        struct Command final
+        {
+            Command() :
+                src(),
+                dst(),
+                type(COMMAND_BLIT),
+                source(-1),
+                color(0U),
+                alpha(0U),
+                colorKey(0U),
+                hasColorKey(false),
+                blendMode(SDL_BLENDMODE_NONE),
+                alphaMod(255U),
+                colorModR(255U),
+                colorModG(255U),
+                colorModB(255U)
+            {
+            }
+
+            A_DEFAULT_COPY(Command)
+
+            SDL_Rect src;
+            SDL_Rect dst;
+            CommandType type;
+            int source;
+            uint32_t color;
+            unsigned int alpha;
+            uint32_t colorKey;
+            bool hasColorKey;
+            SDL_BlendMode blendMode;
+            uint8_t alphaMod;
+            uint8_t colorModR;
+            uint8_t colorModG;
+            uint8_t colorModB;
+        };
+
+        struct Strip final
+        {
+            Strip() :
+                surface(nullptr),
+                wrappers(),
+                sources(),
+                y1(0),
+                y2(0)
+            {
+            }
+
+            A_DEFAULT_COPY(Strip)
+
+            // strip of screen
+            SDL_Surface *surface;
+            // own surfaces for source surfaces
+            std::map<const SDL_Surface*, SDL_Surface*> wrappers;
+            // own surfaces for sources of current commands
+            STD_VECTOR<SDL_Surface*> sources;
+            int y1;
+            int y2;
+        };
+
+        static void stripJob(void *const data,
+                             const int index);
+
+        void drawStrip(const Strip &strip) const;
+
+        static void fillAlpha(SDL_Surface *restrict const surface,
+                              const SDL_Rect &restrict rect,
+                              const uint32_t pixel,
+                              const unsigned int alpha);
+
+        void updateStrips(SDL_Surface *const surface);
+
+        void prepareSources();
+
+        void clearWrappers(Strip &strip);
+
+        void clearStrips();
+
+        void releaseSources();
+
+        STD_VECTOR<Command> mCommands;
+        STD_VECTOR<SDL_Surface*> mSources;
+        std::map<const SDL_Surface*, int> mSourceIndexes;
+        STD_VECTOR<Strip> mStrips;
+        ThreadPool *mPool;
+        void *mPixels;
+        int mWidth;
+        int mHeight;
+        int mPitch;
+        int mStripsCount;
+};
+
+#endif  // USE_SDL2
+#endif  // RENDER_STRIPRASTERIZER_H
@@ -25,63 +25,80 @@
 
 #include "resources/animation/animation.h"
 
-#include "utils/dtor.h"
-#include "utils/foreach.h"
-
 #include "debug.h"
 
 Action::Action(const std::string &name) noexcept2 :
     MemoryCounter(),
     mAnimations(),
+    mDirections(),
     mCounterName(name),
     mNumber(100)
 {
+    for (int f = 0; f < SpriteDirection::INVALID; f ++)
+    {
+        mAnimations[f] = nullptr;
+        mDirections[f] = nullptr;
+    }
 }
 
 Action::~Action()
 {
-    delete_all(mAnimations);
+    for (int f = 0; f < SpriteDirection::INVALID; f ++)
+        delete mAnimations[f];
 }
 
-const Animation *Action::getAnimation(SpriteDirection::Type direction)
-                                      const noexcept2
+void Action::updateDirections() noexcept2
 {
-    Animations::const_iterator i = mAnimations.find(direction);
-
-    if (i == mAnimations.end())
+    // When the given direction is not available, use the first one.
+    // (either DEFAULT, or more usually DOWN).
+    const Animation *first = nullptr;
+    for (int f = 0; f < SpriteDirection::INVALID; f ++)
     {
-        if (direction == SpriteDirection::UPLEFT
-            || direction == SpriteDirection::UPRIGHT)
+        if (mAnimations[f] != nullptr)
         {
-            direction = SpriteDirection::UP;
+            first = mAnimations[f];
+            break;
         }
-        else if (direction == SpriteDirection::DOWNLEFT
-                 || direction == SpriteDirection::DOWNRIGHT)
+    }
+
+    for (int f = 0; f < SpriteDirection::INVALID; f ++)
+    {
+        const Animation *animation = mAnimations[f];
+        if (animation == nullptr)
         {
-            direction = SpriteDirection::DOWN;
+            if (f == SpriteDirection::UPLEFT ||
+                f == SpriteDirection::UPRIGHT)
+            {
+                animation = mAnimations[SpriteDirection::UP];
+            }
+            else if (f == SpriteDirection::DOWNLEFT ||
+                     f == SpriteDirection::DOWNRIGHT)
+            {
+                animation = mAnimations[SpriteDirection::DOWN];
+            }
         }
-        i = mAnimations.find(direction);
-
-        // When the given direction is not available, return the first one.
-        // (either DEFAULT, or more usually DOWN).
-        if (i == mAnimations.end())
-            i = mAnimations.begin();
+        if (animation == nullptr)
+            animation = first;
+        mDirections[f] = animation;
     }
-
-    return (i == mAnimations.end()) ? nullptr : i->second;
 }
 
 void Action::setAnimation(const SpriteDirection::Type direction,
                           Animation *const animation) noexcept2
 {
+    if (direction >= SpriteDirection::INVALID)
+        return;
+    if (mAnimations[direction] != animation)
+        delete mAnimations[direction];
     mAnimations[direction] = animation;
+    updateDirections();
 }
 
 void Action::setLastFrameDelay(const int delay) noexcept2
 {
-    FOR_EACH (AnimationIter, it, mAnimations)
+    for (int f = 0; f < SpriteDirection::INVALID; f ++)
     {
-        Animation *const animation = (*it).second;
+        Animation *const animation = mAnimations[f];
         if (animation == nullptr)
             continue;
         animation->setLastFrameDelay(delay);
@@ -96,11 +113,11 @@ int Action::calcMemoryLocal() const
 int Action::calcMemoryChilds(const int level) const
 {
     int sz = 0;
-    FOR_EACH (AnimationCIter, it, mAnimations)
+    for (int f = 0; f < SpriteDirection::INVALID; f ++)
     {
-        sz += sizeof(SpriteDirection::Type);
-        const Animation *const animation = (*it).second;
-        sz += animation->calcMemory(level + 1);
+        const Animation *const animation = mAnimations[f];
+        if (animation != nullptr)
+            sz += animation->calcMemory(level + 1);
     }
     return sz;
 }
@@ -28,7 +28,7 @@
 
 #include "resources/memorycounter.h"
 
-#include <map>
+#include <string>
 
 #include "localconsts.h"
 
@@ -49,8 +49,13 @@ class Action final : public MemoryCounter
         void setAnimation(const SpriteDirection::Type direction,
                           Animation *const animation) noexcept2;
 
-        const Animation *getAnimation(SpriteDirection::Type direction) const
-                                      noexcept2 A_WARN_UNUSED;
+        const Animation *getAnimation(const SpriteDirection::Type direction)
+                                      const noexcept2 A_WARN_UNUSED
+        {
+            if (direction >= SpriteDirection::INVALID)
+                return mDirections[SpriteDirection::DEFAULT];
+            return mDirections[direction];
+        }
 
         unsigned getNumber() const noexcept2 A_WARN_UNUSED
         { return mNumber; }
@@ -68,11 +73,15 @@ class Action final : public MemoryCounter
         { return mCounterName; }
 
     protected:
-        typedef std::map<SpriteDirection::Type, Animation*> Animations;
-        typedef Animations::iterator AnimationIter;
-        typedef Animations::const_iterator AnimationCIter;
-
-        Animations mAnimations;
+        /**
+         * Fills animations for directions what not have own animation.
+         */
+        void updateDirections() noexcept2;
+
+        // animations loaded for each direction
+        Animation *mAnimations[SpriteDirection::INVALID];
+        // animation what will be used for each direction
+        const Animation *mDirections[SpriteDirection::INVALID];
         std::string mCounterName;
         unsigned mNumber;
 };
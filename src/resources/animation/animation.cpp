@@ -50,7 +50,8 @@ void Animation::addFrame(Image *const image, const int delay,
     Frame frame
         = { image, delay, offsetX, offsetY, rand, FrameType::ANIMATION, "" };
     mFrames.push_back(frame);
-    mDuration += delay;
+    if (delay > 0)
+        mDuration += delay;
 }
 
 void Animation::addTerminator(const int rand) noexcept2
@@ -80,6 +81,8 @@ void Animation::addPause(const int delay, const int rand) noexcept2
 {
     const Frame frame = { nullptr, delay, 0, 0, rand, FrameType::PAUSE, "" };
     mFrames.push_back(frame);
+    if (delay > 0)
+        mDuration += delay;
 }
 
 void Animation::setLastFrameDelay(const int delay) noexcept2
@@ -89,6 +92,10 @@ void Animation::setLastFrameDelay(const int delay) noexcept2
     {
         if ((*it).type == FrameType::ANIMATION && ((*it).image != nullptr))
         {
+            if ((*it).delay > 0)
+                mDuration -= (*it).delay;
+            if (delay > 0)
+                mDuration += delay;
             (*it).delay = delay;
             break;
         }
@@ -70,6 +70,12 @@ class Animation final : public MemoryCounter
         size_t getLength() const noexcept2 A_WARN_UNUSED
         { return mFrames.size(); }
 
+        /**
+         * Returns sum of frames and pauses delays.
+         */
+        int getDuration() const noexcept2 A_WARN_UNUSED
+        { return mDuration; }
+
         void addJump(const std::string &name, const int rand) noexcept2;
 
         void addLabel(const std::string &name) noexcept2;
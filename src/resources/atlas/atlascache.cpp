@@ -0,0 +1,251 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/atlas/atlascache.h"
+
+#include "logger.h"
+#include "settings.h"
+
+#include "fs/files.h"
+#include "fs/mkdir.h"
+
+#include "fs/virtfs/fs.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+#include "utils/pnglib.h"
+#include "utils/stringutils.h"
+
+#include <fstream>
+#include <sys/stat.h>
+
+#include "debug.h"
+
+namespace
+{
+    const std::string cacheMagic("MPAC");
+    const int cacheVersion = 1;
+
+    unsigned int addHash(unsigned int hash,
+                         const std::string &str)
+    {
+        // FNV-1a by chars
+        FOR_EACH (std::string::const_iterator, it, str)
+        {
+            hash ^= CAST_U32(CAST_U8(*it));
+            hash *= 16777619U;
+        }
+        // separator, so "ab" + "c" differs from "a" + "bc"
+        hash ^= 0xffU;
+        hash *= 16777619U;
+        return hash;
+    }
+
+    unsigned int addHash(unsigned int hash,
+                         const int value)
+    {
+        hash ^= CAST_U32(value);
+        hash *= 16777619U;
+        return hash;
+    }
+}  // namespace
+
+AtlasCache::AtlasCache(const std::string &name,
+                       const unsigned int key) :
+    mBaseName(),
+    mPages(),
+    mKey(key)
+{
+    std::string fileName = name;
+    replaceAll(fileName, "/", "_");
+    replaceAll(fileName, "\\", "_");
+    replaceAll(fileName, ":", "_");
+    replaceAll(fileName, "|", "_");
+    mBaseName = pathJoin(settings.localDataDir, "atlascache", fileName);
+}
+
+bool AtlasCache::load()
+{
+    mPages.clear();
+    const std::string fileName = mBaseName + ".txt";
+    std::ifstream file;
+    file.open(fileName.c_str(), std::ios::in);
+    if (!file.is_open())
+        return false;
+
+    std::string magic;
+    int version = 0;
+    unsigned int key = 0U;
+    int pagesCount = 0;
+    file >> magic >> version >> key >> pagesCount;
+    if (!file ||
+        magic != cacheMagic ||
+        version != cacheVersion ||
+        key != mKey)
+    {
+        logger->log("Atlas cache outdated: %s", fileName.c_str());
+        return false;
+    }
+
+    for (int f = 0; f < pagesCount; f ++)
+    {
+        int width = 0;
+        int height = 0;
+        int itemsCount = 0;
+        file >> width >> height >> itemsCount;
+        // skip space before name
+        file.get();
+        std::string pageName;
+        std::getline(file, pageName);
+        if (!file ||
+            pageName.empty() ||
+            width <= 0 ||
+            height <= 0 ||
+            itemsCount <= 0)
+        {
+            mPages.clear();
+            return false;
+        }
+        Page page(pageName, width, height);
+        for (int i = 0; i < itemsCount; i ++)
+        {
+            int x = 0;
+            int y = 0;
+            int itemWidth = 0;
+            int itemHeight = 0;
+            file >> x >> y >> itemWidth >> itemHeight;
+            // skip space before name
+            file.get();
+            std::string name;
+            std::getline(file, name);
+            if (!file ||
+                name.empty() ||
+                x < 0 ||
+                y < 0 ||
+                x + itemWidth > width ||
+                y + itemHeight > height)
+            {
+                mPages.clear();
+                return false;
+            }
+            page.items.push_back(Item(name, x, y, itemWidth, itemHeight));
+        }
+        mPages.push_back(page);
+    }
+    return true;
+}
+
+bool AtlasCache::createDir() const
+{
+    const size_t pos = mBaseName.rfind('/');
+    return pos == std::string::npos ||
+        mkdir_r(mBaseName.substr(0, pos).c_str()) == 0;
+}
+
+bool AtlasCache::save() const
+{
+    if (!createDir())
+        return false;
+    const std::string fileName = mBaseName + ".txt";
+    const std::string tempName = fileName + ".tmp";
+    std::ofstream file;
+    file.open(tempName.c_str(), std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        logger->log_r("Error opening atlas cache for writing: %s",
+            tempName.c_str());
+        return false;
+    }
+    file << cacheMagic << " " << cacheVersion << " " << mKey << " "
+        << mPages.size() << "\n";
+    FOR_EACH (STD_VECTOR<Page>::const_iterator, it, mPages)
+    {
+        const Page &page = *it;
+        file << page.width << " " << page.height << " "
+            << page.items.size() << " " << page.name << "\n";
+        FOR_EACH (STD_VECTOR<Item>::const_iterator, it2, page.items)
+        {
+            const Item &item = *it2;
+            file << item.x << " " << item.y << " "
+                << item.width << " " << item.height << " "
+                << item.name << "\n";
+        }
+    }
+    file.close();
+    if (!file)
+    {
+        ::remove(tempName.c_str());
+        return false;
+    }
+    ::remove(fileName.c_str());
+    return Files::renameFile(tempName, fileName) == 0;
+}
+
+std::string AtlasCache::getPageFileName(const int index) const
+{
+    return strprintf("%s_%d.png", mBaseName.c_str(), index);
+}
+
+bool AtlasCache::savePage(const int index,
+                          SDL_Surface *const surface) const
+{
+    if (!createDir())
+        return false;
+    const std::string fileName = getPageFileName(index);
+    // remove layout first, so it never points to changed page
+    ::remove((mBaseName + ".txt").c_str());
+    return PngLib::writePNG(surface, fileName);
+}
+
+unsigned int AtlasCache::calcKey(const std::string &name,
+                                 const StringVect &files,
+                                 const int size,
+                                 const bool packed)
+{
+    unsigned int hash = 2166136261U;
+    hash = addHash(hash, name);
+    hash = addHash(hash, size);
+    hash = addHash(hash, packed ? 1 : 0);
+    FOR_EACH (StringVectCIter, it, files)
+    {
+        const std::string &str = *it;
+        hash = addHash(hash, str);
+        std::string path = str;
+        const size_t pos = path.find('|');
+        if (pos != std::string::npos)
+            path = path.substr(0, pos);
+
+        // for images in archives used size and time of archive
+        const std::string realDir = VirtFs::getRealDir(path);
+        struct stat statbuf;
+        if (!realDir.empty() &&
+            (stat(pathJoin(realDir, path).c_str(), &statbuf) == 0 ||
+            stat(realDir.c_str(), &statbuf) == 0))
+        {
+            hash = addHash(hash, CAST_S32(statbuf.st_size));
+            hash = addHash(hash, CAST_S32(statbuf.st_mtime));
+        }
+        else
+        {
+            hash = addHash(hash, -1);
+        }
+    }
+    return hash;
+}
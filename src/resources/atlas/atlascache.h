@@ -0,0 +1,136 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_ATLAS_ATLASCACHE_H
+#define RESOURCES_ATLAS_ATLASCACHE_H
+
+#include "utils/stringvector.h"
+
+#include "localconsts.h"
+
+struct SDL_Surface;
+
+/**
+ * Disk cache of packed texture atlases.
+ *
+ * Layout file keeps key of atlas group and position of each image on
+ * atlas pages. Pixels of each page saved near it as png image. Key is
+ * hash of group name, atlas size, packing method and names, sizes and
+ * modification times of all source images, so any changed image
+ * invalidates cache. Layout saved after pages, so partially saved cache
+ * never loaded.
+ */
+class AtlasCache final
+{
+    public:
+        struct Item final
+        {
+            Item(const std::string &name0,
+                 const int x0,
+                 const int y0,
+                 const int width0,
+                 const int height0) :
+                name(name0),
+                x(x0),
+                y(y0),
+                width(width0),
+                height(height0)
+            {
+            }
+
+            A_DEFAULT_COPY(Item)
+
+            std::string name;
+            int x;
+            int y;
+            int width;
+            int height;
+        };
+
+        struct Page final
+        {
+            Page(const std::string &name0,
+                 const int width0,
+                 const int height0) :
+                name(name0),
+                items(),
+                width(width0),
+                height(height0)
+            {
+            }
+
+            A_DEFAULT_COPY(Page)
+
+            std::string name;
+            STD_VECTOR<Item> items;
+            int width;
+            int height;
+        };
+
+        AtlasCache(const std::string &name,
+                   const unsigned int key);
+
+        A_DELETE_COPY(AtlasCache)
+
+        /**
+         * Reads layout file. Returns false if file missing or was
+         * created from other images.
+         */
+        bool load();
+
+        /**
+         * Writes layout file. Page images must be saved before it.
+         */
+        bool save() const;
+
+        void addPage(const Page &page)
+        { mPages.push_back(page); }
+
+        void clear()
+        { mPages.clear(); }
+
+        const STD_VECTOR<Page> &getPages() const noexcept2 A_WARN_UNUSED
+        { return mPages; }
+
+        /**
+         * Returns file name for image of page with given index.
+         */
+        std::string getPageFileName(const int index) const A_WARN_UNUSED;
+
+        bool savePage(const int index,
+                      SDL_Surface *const surface) const A_NONNULL(3);
+
+        /**
+         * Returns key for atlas group from its images in virtual fs.
+         */
+        static unsigned int calcKey(const std::string &name,
+                                    const StringVect &files,
+                                    const int size,
+                                    const bool packed) A_WARN_UNUSED;
+
+    private:
+        bool createDir() const A_WARN_UNUSED;
+
+        std::string mBaseName;
+        STD_VECTOR<Page> mPages;
+        unsigned int mKey;
+};
+
+#endif  // RESOURCES_ATLAS_ATLASCACHE_H
@@ -23,11 +23,9 @@
 
 #include "resources/atlas/atlasmanager.h"
 
-#include "settings.h"
-
-#ifdef DEBUG_IMAGES
+#include "configuration.h"
 #include "logger.h"
-#endif  // DEBUG_IMAGES
+#include "settings.h"
 
 #include "fs/virtfs/rwops.h"
 
@@ -36,6 +34,8 @@
 
 #include "resources/openglimagehelper.h"
 
+#include "resources/atlas/atlascache.h"
+#include "resources/atlas/atlaspacker.h"
 #include "resources/atlas/atlasresource.h"
 #include "resources/atlas/textureatlas.h"
 
@@ -51,9 +51,28 @@ PRAGMA48(GCC diagnostic ignored "-Wshadow")
 PRAGMA48(GCC diagnostic pop)
 
 #include "utils/checkutils.h"
+#include "utils/dtor.h"
+
+#include <algorithm>
 
 #include "debug.h"
 
+static class SortImageFunctor final
+{
+    public:
+        A_DEFAULT_COPY(SortImageFunctor)
+
+        bool operator() (const Image *const image1,
+                         const Image *const image2) const
+        {
+            const SDL_Rect &rect1 = image1->mBounds;
+            const SDL_Rect &rect2 = image2->mBounds;
+            if (rect1.h != rect2.h)
+                return rect1.h > rect2.h;
+            return rect1.w > rect2.w;
+        }
+} imageSorter;
+
 AtlasManager::AtlasManager()
 {
 }
@@ -66,7 +85,6 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
     STD_VECTOR<Image*> images;
     AtlasResource *resource = new AtlasResource;
 
-    loadImages(files, images);
     int maxSize = OpenGLImageHelper::getTextureSize();
 #if !defined(ANDROID) && !defined(__APPLE__)
     int sz = settings.textureSize;
@@ -74,8 +92,32 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
         maxSize = sz;
 #endif  // !defined(ANDROID) && !defined(__APPLE__)
 
+    const bool packAtlases = config.getBoolValue("packAtlases");
+    AtlasCache *cache = nullptr;
+    if (config.getBoolValue("enableAtlasCache"))
+    {
+        cache = new AtlasCache(name,
+            AtlasCache::calcKey(name, files, maxSize, packAtlases));
+        if (cache->load() && loadCachedAtlases(*cache, resource))
+        {
+            logger->log("Atlas group %s: %d atlases loaded from cache",
+                name.c_str(),
+                CAST_S32(resource->atlases.size()));
+            delete cache;
+            BLOCK_END("AtlasManager::loadTextureAtlas")
+            return resource;
+        }
+        // new layout will be added while creating atlases
+        cache->clear();
+    }
+
+    loadImages(files, images);
+
     // sorting images on atlases.
-    simpleSort(name, atlases, images, maxSize);
+    if (packAtlases)
+        maxRectsSort(name, atlases, images, maxSize);
+    else
+        simpleSort(name, atlases, images, maxSize);
 
     FOR_EACH (STD_VECTOR<TextureAtlas*>::iterator, it, atlases)
     {
@@ -83,12 +125,24 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
         if (atlas == nullptr)
             continue;
 
-        createSDLAtlas(atlas);
+        createSDLAtlas(atlas, cache);
         if (atlas->atlasImage == nullptr)
             continue;
         convertAtlas(atlas);
         resource->atlases.push_back(atlas);
     }
+    logger->log("Atlas group %s: %d atlases, occupancy %d%%",
+        name.c_str(),
+        CAST_S32(resource->atlases.size()),
+        resource->getOccupancy());
+
+    if (cache != nullptr)
+    {
+        // save layout only if all pages was saved
+        if (cache->getPages().size() == resource->atlases.size())
+            cache->save();
+        delete cache;
+    }
 
     BLOCK_END("AtlasManager::loadTextureAtlas")
     return resource;
@@ -125,6 +179,74 @@ AtlasResource *AtlasManager::loadEmptyAtlas(const std::string &name,
     return resource;
 }
 
+void AtlasManager::removeTempResource(const std::string &name)
+{
+    // check is image with same name already in cache
+    // and if yes, move it to deleted set
+    Resource *const res = ResourceManager::getTempResource(name);
+    if (res != nullptr)
+    {
+        // increase counter because in moveToDeleted it will be decreased.
+        res->incRef();
+        ResourceManager::moveToDeleted(res);
+    }
+}
+
+bool AtlasManager::loadCachedAtlases(const AtlasCache &restrict cache,
+                                     AtlasResource *restrict const resource)
+{
+    BLOCK_START("AtlasManager::loadCachedAtlases")
+    const STD_VECTOR<AtlasCache::Page> &pages = cache.getPages();
+    const int pagesCount = CAST_S32(pages.size());
+    STD_VECTOR<Image*> images;
+    for (int f = 0; f < pagesCount; f ++)
+    {
+        const AtlasCache::Page &page = pages[f];
+        const std::string fileName = cache.getPageFileName(f);
+        SDL_RWops *const rw = SDL_RWFromFile(fileName.c_str(), "rb");
+        Image *const image = rw != nullptr ? imageHelper->load(rw) : nullptr;
+        if (image == nullptr ||
+            image->mBounds.w != page.width ||
+            image->mBounds.h != page.height)
+        {
+            logger->log("Error loading atlas cache page: %s",
+                fileName.c_str());
+            delete image;
+            delete_all(images);
+            BLOCK_END("AtlasManager::loadCachedAtlases")
+            return false;
+        }
+        images.push_back(image);
+    }
+
+    for (int f = 0; f < pagesCount; f ++)
+    {
+        const AtlasCache::Page &page = pages[f];
+        TextureAtlas *const atlas = new TextureAtlas;
+        atlas->name = page.name;
+        atlas->width = page.width;
+        atlas->height = page.height;
+        atlas->atlasImage = images[f];
+        FOR_EACH (STD_VECTOR<AtlasCache::Item>::const_iterator,
+                  it, page.items)
+        {
+            const AtlasCache::Item &cacheItem = *it;
+            removeTempResource(cacheItem.name);
+            AtlasItem *const item = new AtlasItem(nullptr);
+            item->name = cacheItem.name;
+            item->x = cacheItem.x;
+            item->y = cacheItem.y;
+            item->width = cacheItem.width;
+            item->height = cacheItem.height;
+            atlas->items.push_back(item);
+        }
+        convertAtlas(atlas);
+        resource->atlases.push_back(atlas);
+    }
+    BLOCK_END("AtlasManager::loadCachedAtlases")
+    return true;
+}
+
 void AtlasManager::loadImages(const StringVect &files,
                               STD_VECTOR<Image*> &images)
 {
@@ -133,15 +255,7 @@ void AtlasManager::loadImages(const StringVect &files,
     FOR_EACH (StringVectCIter, it, files)
     {
         const std::string str = *it;
-        // check is image with same name already in cache
-        // and if yes, move it to deleted set
-        Resource *const res = ResourceManager::getTempResource(str);
-        if (res != nullptr)
-        {
-            // increase counter because in moveToDeleted it will be decreased.
-            res->incRef();
-            ResourceManager::moveToDeleted(res);
-        }
+        removeTempResource(str);
 
         std::string path = str;
         const size_t p = path.find('|');
@@ -183,15 +297,7 @@ void AtlasManager::loadEmptyImages(const StringVect &files,
     FOR_EACH (StringVectCIter, it, files)
     {
         const std::string str = *it;
-        // check is image with same name already in cache
-        // and if yes, move it to deleted set
-        Resource *const res = ResourceManager::getTempResource(str);
-        if (res != nullptr)
-        {
-            // increase counter because in moveToDeleted it will be decreased.
-            res->incRef();
-            ResourceManager::moveToDeleted(res);
-        }
+        removeTempResource(str);
 
         Image *const image = new Image(0,
             2048, 2048,
@@ -273,6 +379,76 @@ void AtlasManager::simpleSort(const std::string &restrict name,
     BLOCK_END("AtlasManager::simpleSort")
 }
 
+void AtlasManager::maxRectsSort(const std::string &restrict name,
+                                STD_VECTOR<TextureAtlas*> &restrict atlases,
+                                const STD_VECTOR<Image*> &restrict images,
+                                const int size)
+{
+    BLOCK_START("AtlasManager::maxRectsSort")
+    STD_VECTOR<Image*> sortedImages;
+    sortedImages.reserve(images.size());
+    FOR_EACH (STD_VECTOR<Image*>::const_iterator, it, images)
+    {
+        if (*it != nullptr)
+            sortedImages.push_back(*it);
+    }
+    // higher images first gives less holes between rows
+    std::stable_sort(sortedImages.begin(), sortedImages.end(), imageSorter);
+
+    const size_t oldSize = atlases.size();
+    STD_VECTOR<AtlasPacker*> packers;
+    FOR_EACH (STD_VECTOR<Image*>::const_iterator, it, sortedImages)
+    {
+        Image *const img = *it;
+        AtlasItem *const item = new AtlasItem(img);
+        item->name = img->mIdPath;
+
+        // try put image in any already started atlas
+        TextureAtlas *atlas = nullptr;
+        const size_t sz = packers.size();
+        for (size_t f = 0; f < sz; f ++)
+        {
+            if (packers[f]->insert(item->width, item->height,
+                item->x, item->y))
+            {
+                atlas = atlases[oldSize + f];
+                break;
+            }
+        }
+
+        if (atlas == nullptr)
+        {
+            atlas = new TextureAtlas;
+            atlas->name = std::string("atlas_").append(name).append(
+                "_").append(img->mIdPath);
+            atlases.push_back(atlas);
+            AtlasPacker *packer = nullptr;
+            if (item->width <= size && item->height <= size)
+            {
+                packer = new AtlasPacker(size, size);
+                packer->insert(item->width, item->height,
+                    item->x, item->y);
+            }
+            else
+            {
+                // too big image placed alone
+                packer = new AtlasPacker(0, 0);
+                item->x = 0;
+                item->y = 0;
+            }
+            packers.push_back(packer);
+        }
+
+        atlas->items.push_back(item);
+        if (item->x + item->width > atlas->width)
+            atlas->width = item->x + item->width;
+        if (item->y + item->height > atlas->height)
+            atlas->height = item->y + item->height;
+    }
+    delete_all(packers);
+    BLOCK_END("AtlasManager::maxRectsSort")
+}
+
 void AtlasManager::emptySort(const std::string &restrict name,
                              STD_VECTOR<TextureAtlas*> &restrict atlases,
                              const STD_VECTOR<Image*> &restrict images)
@@ -311,7 +487,8 @@ void AtlasManager::emptySort(const std::string &restrict name,
     BLOCK_END("AtlasManager::simpleSort")
 }
 
-void AtlasManager::createSDLAtlas(TextureAtlas *const atlas)
+void AtlasManager::createSDLAtlas(TextureAtlas *const atlas,
+                                  AtlasCache *const cache)
 {
     BLOCK_START("AtlasManager::createSDLAtlas")
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
@@ -359,17 +536,73 @@ void AtlasManager::createSDLAtlas(TextureAtlas *const atlas)
     logger->log("OpenGL debug: creating atlase %dx%d", width, height);
 #endif  // OPENGLERRORS
 
+    if (cache != nullptr)
+    {
+        // for cache atlas pixels need in memory,
+        // so images drawn to surface before uploading
+        FOR_EACH (STD_VECTOR<AtlasItem*>::iterator, it, atlas->items)
+        {
+            AtlasItem *const item = *it;
+            SDL_Surface *const itemSurface = item->image->mSDLSurface;
+            if (itemSurface == nullptr)
+                continue;
+            // copy alpha channel as is
+#ifdef USE_SDL2
+            SDL_SetSurfaceBlendMode(itemSurface, SDL_BLENDMODE_NONE);
+#else  // USE_SDL2
+
+            SDL_SetAlpha(itemSurface, 0, SDL_ALPHA_OPAQUE);
+#endif  // USE_SDL2
+
+            SDL_Rect rect;
+            rect.x = CAST_S16(item->x);
+            rect.y = CAST_S16(item->y);
+            rect.w = CAST_U16(itemSurface->w);
+            rect.h = CAST_U16(itemSurface->h);
+            SDL_BlitSurface(itemSurface, nullptr, surface, &rect);
+        }
+    }
+
     Image *image = imageHelper->loadSurface(surface);
-    // free SDL atlas surface
-    MSDL_FreeSurface(surface);
     if (image == nullptr)
     {
+        MSDL_FreeSurface(surface);
         reportAlways("Error converting surface to texture. Size: %dx%d",
             width,
             height)
         return;
     }
 
+    if (cache != nullptr)
+    {
+        const int index = CAST_S32(cache->getPages().size());
+        if (cache->savePage(index, surface))
+        {
+            AtlasCache::Page page(atlas->name, width, height);
+            FOR_EACH (STD_VECTOR<AtlasItem*>::const_iterator,
+                      it, atlas->items)
+            {
+                const AtlasItem *const item = *it;
+                page.items.push_back(AtlasCache::Item(item->name,
+                    item->x, item->y,
+                    item->width, item->height));
+            }
+            cache->addPage(page);
+        }
+        else
+        {
+            logger->log("Error saving atlas cache page: %s",
+                cache->getPageFileName(index).c_str());
+        }
+        // free SDL atlas surface
+        MSDL_FreeSurface(surface);
+        atlas->atlasImage = image;
+        BLOCK_END("AtlasManager::createSDLAtlas")
+        return;
+    }
+    // free SDL atlas surface
+    MSDL_FreeSurface(surface);
+
     // drawing SDL images to surface
     FOR_EACH (STD_VECTOR<AtlasItem*>::iterator, it, atlas->items)
     {
@@ -28,6 +28,7 @@
 
 #include "localconsts.h"
 
+class AtlasCache;
 class AtlasResource;
 class Image;
 
@@ -53,6 +54,12 @@ class AtlasManager final
         static void moveToDeleted(AtlasResource *const resource);
 
     private:
+        static void removeTempResource(const std::string &name);
+
+        static bool loadCachedAtlases(const AtlasCache &restrict cache,
+                                      AtlasResource *restrict const resource)
+                                      A_NONNULL(2);
+
         static void loadImages(const StringVect &files,
                                STD_VECTOR<Image*> &images);
 
@@ -68,7 +75,13 @@ class AtlasManager final
                                const STD_VECTOR<Image*> &restrict images,
                                int size);
 
-        static void createSDLAtlas(TextureAtlas *const atlas) A_NONNULL(1);
+        static void maxRectsSort(const std::string &restrict name,
+                                 STD_VECTOR<TextureAtlas*> &restrict atlases,
+                                 const STD_VECTOR<Image*> &restrict images,
+                                 const int size);
+
+        static void createSDLAtlas(TextureAtlas *const atlas,
+                                   AtlasCache *const cache) A_NONNULL(1);
 
         static void convertAtlas(TextureAtlas *const atlas) A_NONNULL(1);
 
@@ -0,0 +1,159 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/atlas/atlaspacker.h"
+
+#include "utils/cast.h"
+
+#include "debug.h"
+
+AtlasPacker::AtlasPacker(const int width,
+                         const int height) :
+    mFreeRects(),
+    mUsedWidth(0),
+    mUsedHeight(0),
+    mUsedArea(0)
+{
+    if (width > 0 && height > 0)
+        mFreeRects.push_back(Rect(0, 0, width, height));
+}
+
+bool AtlasPacker::insert(const int width,
+                         const int height,
+                         int &restrict x,
+                         int &restrict y)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    int bestIndex = -1;
+    int bestBottom = 0;
+    int bestX = 0;
+    const int sz = CAST_S32(mFreeRects.size());
+    for (int f = 0; f < sz; f ++)
+    {
+        const Rect &rect = mFreeRects[f];
+        if (rect.width < width || rect.height < height)
+            continue;
+        const int bottom = rect.y + height;
+        if (bestIndex < 0 ||
+            bottom < bestBottom ||
+            (bottom == bestBottom && rect.x < bestX))
+        {
+            bestIndex = f;
+            bestBottom = bottom;
+            bestX = rect.x;
+        }
+    }
+    if (bestIndex < 0)
+        return false;
+
+    x = bestX;
+    y = mFreeRects[bestIndex].y;
+    splitFreeRects(Rect(x, y, width, height));
+    pruneFreeRects();
+
+    if (x + width > mUsedWidth)
+        mUsedWidth = x + width;
+    if (y + height > mUsedHeight)
+        mUsedHeight = y + height;
+    mUsedArea += width * height;
+    return true;
+}
+
+void AtlasPacker::splitFreeRects(const Rect &placed)
+{
+    const int placedRight = placed.x + placed.width;
+    const int placedBottom = placed.y + placed.height;
+    // new rects added to end, and not need to be checked
+    int f = 0;
+    int count = CAST_S32(mFreeRects.size());
+    while (f < count)
+    {
+        const Rect rect = mFreeRects[f];
+        const int right = rect.x + rect.width;
+        const int bottom = rect.y + rect.height;
+        if (placed.x >= right ||
+            placedRight <= rect.x ||
+            placed.y >= bottom ||
+            placedBottom <= rect.y)
+        {
+            f ++;
+            continue;
+        }
+
+        if (placed.x > rect.x)
+        {
+            mFreeRects.push_back(Rect(rect.x, rect.y,
+                placed.x - rect.x, rect.height));
+        }
+        if (placedRight < right)
+        {
+            mFreeRects.push_back(Rect(placedRight, rect.y,
+                right - placedRight, rect.height));
+        }
+        if (placed.y > rect.y)
+        {
+            mFreeRects.push_back(Rect(rect.x, rect.y,
+                rect.width, placed.y - rect.y));
+        }
+        if (placedBottom < bottom)
+        {
+            mFreeRects.push_back(Rect(rect.x, placedBottom,
+                rect.width, bottom - placedBottom));
+        }
+
+        // replace by last not checked rect
+        count --;
+        mFreeRects[f] = mFreeRects[count];
+        mFreeRects[count] = mFreeRects.back();
+        mFreeRects.pop_back();
+    }
+}
+
+void AtlasPacker::pruneFreeRects()
+{
+    // remove rects what fully inside other rects
+    for (int f = 0; f < CAST_S32(mFreeRects.size()); f ++)
+    {
+        for (int k = f + 1; k < CAST_S32(mFreeRects.size()); k ++)
+        {
+            const Rect &rect1 = mFreeRects[f];
+            const Rect &rect2 = mFreeRects[k];
+            if (rect1.x >= rect2.x &&
+                rect1.y >= rect2.y &&
+                rect1.x + rect1.width <= rect2.x + rect2.width &&
+                rect1.y + rect1.height <= rect2.y + rect2.height)
+            {
+                mFreeRects.erase(mFreeRects.begin() + f);
+                f --;
+                break;
+            }
+            if (rect2.x >= rect1.x &&
+                rect2.y >= rect1.y &&
+                rect2.x + rect2.width <= rect1.x + rect1.width &&
+                rect2.y + rect2.height <= rect1.y + rect1.height)
+            {
+                mFreeRects.erase(mFreeRects.begin() + k);
+                k --;
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_ATLAS_ATLASPACKER_H
+#define RESOURCES_ATLAS_ATLASPACKER_H
+
+#include "gui/rect.h"
+
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+/**
+ * Packs rectangles into area using maximal rectangles algorithm.
+ *
+ * Packer keeps list of maximal free rectangles, and puts each new
+ * rectangle to lowest, then leftmost free position. Best results if
+ * rectangles inserted sorted by height.
+ */
+class AtlasPacker final
+{
+    public:
+        AtlasPacker(const int width,
+                    const int height);
+
+        A_DELETE_COPY(AtlasPacker)
+
+        /**
+         * Finds place for rectangle and marks it as used.
+         * Returns false if no free place found.
+         */
+        bool insert(const int width,
+                    const int height,
+                    int &restrict x,
+                    int &restrict y);
+
+        /**
+         * Returns width of bounding box of used area.
+         */
+        int getUsedWidth() const noexcept2 A_WARN_UNUSED
+        { return mUsedWidth; }
+
+        /**
+         * Returns height of bounding box of used area.
+         */
+        int getUsedHeight() const noexcept2 A_WARN_UNUSED
+        { return mUsedHeight; }
+
+        /**
+         * Returns sum of areas of all inserted rectangles.
+         */
+        int getUsedArea() const noexcept2 A_WARN_UNUSED
+        { return mUsedArea; }
+
+    private:
+        void splitFreeRects(const Rect &placed);
+
+        void pruneFreeRects();
+
+        STD_VECTOR<Rect> mFreeRects;
+        int mUsedWidth;
+        int mUsedHeight;
+        int mUsedArea;
+};
+
+#endif  // RESOURCES_ATLAS_ATLASPACKER_H
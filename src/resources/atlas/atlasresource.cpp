@@ -89,4 +89,23 @@ int AtlasResource::calcMemoryChilds(const int level) const
     return sz;
 }
 
+int AtlasResource::getOccupancy() const
+{
+    double usedArea = 0;
+    double area = 0;
+    FOR_EACH (STD_VECTOR<TextureAtlas*>::const_iterator, it, atlases)
+    {
+        const TextureAtlas *const atlas = *it;
+        area += static_cast<double>(atlas->width) * atlas->height;
+        FOR_EACH (STD_VECTOR<AtlasItem*>::const_iterator, it2, atlas->items)
+        {
+            const AtlasItem *const item = *it2;
+            usedArea += static_cast<double>(item->width) * item->height;
+        }
+    }
+    if (area <= 0)
+        return 0;
+    return static_cast<int>(usedArea * 100 / area);
+}
+
 #endif  // USE_OPENGL
@@ -49,6 +49,11 @@ class AtlasResource final : public Resource
 
         int calcMemoryChilds(const int level) const override final;
 
+        /**
+         * Returns percent of atlases area used by images.
+         */
+        int getOccupancy() const A_WARN_UNUSED;
+
         STD_VECTOR<TextureAtlas*> atlases;
 };
 
@@ -25,6 +25,8 @@
 
 #include "logger.h"
 
+#include "render/graphics.h"
+
 #ifdef USE_OPENGL
 #include "resources/openglimagehelper.h"
 #endif  // USE_OPENGL
@@ -353,6 +355,11 @@ void Image::setAlpha(const float alpha)
         }
         else
         {
+            // surface can be queued for drawing with old pixels.
+            // surface from alpha cache is new copy, so not queued.
+            if (!mUseAlphaCache && mainGraphics != nullptr)
+                mainGraphics->flushDeferred();
+
             if (SDL_MUSTLOCK(mSDLSurface))
                 SDL_LockSurface(mSDLSurface);
 
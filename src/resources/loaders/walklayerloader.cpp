@@ -21,8 +21,6 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "resources/resourcemanager/resourcemanager.h"
-
 #include "navigationmanager.h"
 
 #include "resources/map/walklayer.h"
@@ -34,38 +32,22 @@
 #include "debug.h"
 
 #ifndef DYECMD
-struct WalkLayerLoader final
+WalkLayer *Loader::getWalkLayer(Map *const map)
 {
-    A_DEFAULT_COPY(WalkLayerLoader)
-
-    const std::string name;
-    const Map *const map;
-
-    static Resource *load(const void *const v)
+    // Walk layer not cached, because map updates it on
+    // block mask changes.
+    Resource *const resource = NavigationManager::loadWalkLayer(map);
+    if (resource == nullptr)
     {
-        if (v == nullptr)
-            return nullptr;
-
-        const WalkLayerLoader *const rl = static_cast<const
-            WalkLayerLoader *>(v);
-        Resource *const resource = NavigationManager::loadWalkLayer(rl->map);
-        if (resource == nullptr)
-            reportAlways("WalkLayer creation error")
-        return resource;
+        reportAlways("WalkLayer creation error")
+        return nullptr;
     }
-};
-
-WalkLayer *Loader::getWalkLayer(const std::string &name,
-                                Map *const map)
-{
-    WalkLayerLoader rl = {name, map};
-    return static_cast<WalkLayer*>(ResourceManager::get("walklayer_" + name,
-        WalkLayerLoader::load, &rl));
+    resource->incRef();
+    return static_cast<WalkLayer*>(resource);
 }
 #else  // DYECMD
 
-WalkLayer *Loader::getWalkLayer(const std::string &name A_UNUSED,
-                                Map *const map A_UNUSED)
+WalkLayer *Loader::getWalkLayer(Map *const map A_UNUSED)
 {
     return nullptr;
 }
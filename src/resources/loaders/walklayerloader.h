@@ -24,8 +24,6 @@
 #ifndef RESOURCES_LOADERS_WALKLAYERLOADER_H
 #define RESOURCES_LOADERS_WALKLAYERLOADER_H
 
-#include <string>
-
 #include "localconsts.h"
 
 class Map;
@@ -33,8 +31,7 @@ class WalkLayer;
 
 namespace Loader
 {
-    WalkLayer *getWalkLayer(const std::string &name,
-                            Map *const map) A_WARN_UNUSED;
+    WalkLayer *getWalkLayer(Map *const map) A_WARN_UNUSED;
 }  // namespace Loader
 
 #endif  // RESOURCES_LOADERS_WALKLAYERLOADER_H
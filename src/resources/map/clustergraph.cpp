@@ -0,0 +1,591 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/clustergraph.h"
+
+#include "const/resources/map/map.h"
+
+#include "enums/resources/map/blockmask.h"
+
+#include "resources/map/metatile.h"
+
+#include "utils/foreach.h"
+
+#include <algorithm>
+#include <climits>
+#include <queue>
+
+#include "debug.h"
+
+namespace
+{
+    // Same costs as in Map::findPath
+    const int straightCost = 100 + 1;
+    const int diagonalCost = 100 * 362 / 256;
+    const float diagonalCostF = 100.0 * 362 / 256;
+
+    // Openings shorter than this get one portal in the middle,
+    // longer ones get portals on both ends.
+    const int maxSinglePortal = 6;
+
+    typedef std::pair<int, int> CostNode;
+    typedef std::priority_queue<CostNode,
+        STD_VECTOR<CostNode>,
+        std::greater<CostNode> > CostQueue;
+
+    int calcHeuristic(const int x, const int y,
+                      const int destX, const int destY)
+    {
+        const int dx = std::abs(x - destX);
+        const int dy = std::abs(y - destY);
+        return std::abs(dx - dy) * 100 +
+            CAST_S32(static_cast<float>(std::min(dx, dy)) * diagonalCostF);
+    }
+}  // namespace
+
+ClusterGraph::ClusterGraph(const int width,
+                           const int height,
+                           const unsigned char blockWalkMask) :
+    MemoryCounter(),
+    mWidth(width),
+    mHeight(height),
+    mClustersX((width + mapClusterSize - 1) / mapClusterSize),
+    mClustersY((height + mapClusterSize - 1) / mapClusterSize),
+    mBlockWalkMask(blockWalkMask),
+    mValid(false),
+    mNodes(),
+    mFreeNodes(),
+    mClusterNodes(mClustersX * mClustersY),
+    mDirtyClusters(),
+    mDirtyFlags(mClustersX * mClustersY),
+    mLocalCost(mapClusterSize * mapClusterSize),
+    mStartEdges(),
+    mGoalCost(),
+    mGcost(),
+    mParent(),
+    mClosed()
+{
+}
+
+ClusterGraph::~ClusterGraph()
+{
+}
+
+bool ClusterGraph::isBlocked(const MetaTile *const tiles,
+                             const int x,
+                             const int y) const
+{
+    const unsigned char mask = tiles[x + y * mWidth].blockmask;
+    return (mask & mBlockWalkMask) != 0 ||
+        (mask & BlockMask::WALL) != 0;
+}
+
+int ClusterGraph::getCluster(const int x,
+                             const int y) const
+{
+    return x / mapClusterSize + (y / mapClusterSize) * mClustersX;
+}
+
+void ClusterGraph::build(const MetaTile *const tiles)
+{
+    mNodes.clear();
+    mFreeNodes.clear();
+    FOR_EACH (STD_VECTOR<STD_VECTOR<int> >::iterator, it, mClusterNodes)
+        (*it).clear();
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, mDirtyClusters)
+        mDirtyFlags[*it] = 0U;
+    mDirtyClusters.clear();
+
+    const int clusters = mClustersX * mClustersY;
+    for (int f = 0; f < clusters * 2; f ++)
+        addBorderEntrances(tiles, f);
+
+    for (int f = 0; f < clusters; f ++)
+        connectCluster(tiles, f);
+
+    resizeBuffers();
+    mValid = true;
+}
+
+void ClusterGraph::update(const MetaTile *const tiles)
+{
+    if (!mValid)
+        build(tiles);
+    else if (!mDirtyClusters.empty())
+        rebuildClusters(tiles);
+}
+
+void ClusterGraph::updateTile(const int x,
+                              const int y)
+{
+    // not built graph will be built fully
+    if (!mValid)
+        return;
+    const int cluster = getCluster(x, y);
+    if (mDirtyFlags[cluster] != 0U)
+        return;
+    mDirtyFlags[cluster] = 1U;
+    mDirtyClusters.push_back(cluster);
+}
+
+void ClusterGraph::rebuildClusters(const MetaTile *const tiles)
+{
+    // all borders of changed clusters
+    STD_VECTOR<int> borders;
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, mDirtyClusters)
+    {
+        const int cluster = *it;
+        mDirtyFlags[cluster] = 0U;
+        borders.push_back(cluster * 2);
+        borders.push_back(cluster * 2 + 1);
+        if (cluster % mClustersX > 0)
+            borders.push_back((cluster - 1) * 2);
+        if (cluster >= mClustersX)
+            borders.push_back((cluster - mClustersX) * 2 + 1);
+    }
+    mDirtyClusters.clear();
+    std::sort(borders.begin(), borders.end());
+    borders.erase(std::unique(borders.begin(), borders.end()),
+        borders.end());
+
+    // clusters on both sides of these borders
+    STD_VECTOR<int> clusters;
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, borders)
+    {
+        const int cluster = *it / 2;
+        clusters.push_back(cluster);
+        if ((*it % 2) == 0)
+        {
+            if (cluster % mClustersX + 1 < mClustersX)
+                clusters.push_back(cluster + 1);
+        }
+        else if (cluster + mClustersX < mClustersX * mClustersY)
+        {
+            clusters.push_back(cluster + mClustersX);
+        }
+    }
+    std::sort(clusters.begin(), clusters.end());
+    clusters.erase(std::unique(clusters.begin(), clusters.end()),
+        clusters.end());
+
+    // remove portals of changed borders
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, clusters)
+    {
+        const STD_VECTOR<int> nodes = mClusterNodes[*it];
+        FOR_EACH (STD_VECTOR<int>::const_iterator, it2, nodes)
+        {
+            const int node = *it2;
+            const int pair = mNodes[node].pair;
+            if (pair < 0 || !std::binary_search(borders.begin(),
+                borders.end(),
+                getBorder(node, pair)))
+            {
+                continue;
+            }
+            removeNode(pair);
+            removeNode(node);
+        }
+    }
+
+    // edges inside clusters calculated again, only pair edges left
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, clusters)
+    {
+        const STD_VECTOR<int> &nodes = mClusterNodes[*it];
+        FOR_EACH (STD_VECTOR<int>::const_iterator, it2, nodes)
+        {
+            Node &node = mNodes[*it2];
+            node.edges.clear();
+            node.edges.push_back(Edge(node.pair, straightCost));
+        }
+    }
+
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, borders)
+        addBorderEntrances(tiles, *it);
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, clusters)
+        connectCluster(tiles, *it);
+    resizeBuffers();
+}
+
+void ClusterGraph::resizeBuffers()
+{
+    const size_t sz = mNodes.size() + 2;
+    mGoalCost.assign(mNodes.size(), INT_MAX);
+    mGcost.resize(sz);
+    mParent.resize(sz);
+    mClosed.resize(sz);
+}
+
+int ClusterGraph::getBorder(const int node1,
+                            const int node2) const
+{
+    const Node &restrict portal1 = mNodes[node1];
+    const Node &restrict portal2 = mNodes[node2];
+    const int cluster = getCluster(std::min(portal1.x, portal2.x),
+        std::min(portal1.y, portal2.y));
+    // border to right cluster is even, to bottom cluster is odd
+    if (portal1.x != portal2.x)
+        return cluster * 2;
+    return cluster * 2 + 1;
+}
+
+void ClusterGraph::addBorderEntrances(const MetaTile *const tiles,
+                                      const int border)
+{
+    const int cluster = border / 2;
+    const int cx = cluster % mClustersX;
+    const int cy = cluster / mClustersX;
+    if ((border % 2) == 0)
+    {
+        // opening between left and right clusters
+        if (cx + 1 >= mClustersX)
+            return;
+        const int x = (cx + 1) * mapClusterSize;
+        const int y0 = cy * mapClusterSize;
+        const int length = std::min(mapClusterSize, mHeight - y0);
+        addEntrances(tiles, x - 1, y0, x, y0, 0, 1, length);
+    }
+    else
+    {
+        // opening between top and bottom clusters
+        if (cy + 1 >= mClustersY)
+            return;
+        const int y = (cy + 1) * mapClusterSize;
+        const int x0 = cx * mapClusterSize;
+        const int length = std::min(mapClusterSize, mWidth - x0);
+        addEntrances(tiles, x0, y - 1, x0, y, 1, 0, length);
+    }
+}
+
+void ClusterGraph::addEntrances(const MetaTile *const tiles,
+                                const int ax, const int ay,
+                                const int bx, const int by,
+                                const int stepX, const int stepY,
+                                const int length)
+{
+    int runStart = -1;
+    for (int f = 0; f <= length; f ++)
+    {
+        const int dx = f * stepX;
+        const int dy = f * stepY;
+        if (f < length &&
+            !isBlocked(tiles, ax + dx, ay + dy) &&
+            !isBlocked(tiles, bx + dx, by + dy))
+        {
+            if (runStart < 0)
+                runStart = f;
+            continue;
+        }
+        if (runStart < 0)
+            continue;
+
+        const int runLength = f - runStart;
+        if (runLength < maxSinglePortal)
+        {
+            const int mid = runStart + runLength / 2;
+            addPortal(ax + mid * stepX, ay + mid * stepY,
+                bx + mid * stepX, by + mid * stepY);
+        }
+        else
+        {
+            const int last = f - 1;
+            addPortal(ax + runStart * stepX, ay + runStart * stepY,
+                bx + runStart * stepX, by + runStart * stepY);
+            addPortal(ax + last * stepX, ay + last * stepY,
+                bx + last * stepX, by + last * stepY);
+        }
+        runStart = -1;
+    }
+}
+
+void ClusterGraph::addPortal(const int ax, const int ay,
+                             const int bx, const int by)
+{
+    const int nodeA = addNode(ax, ay);
+    const int nodeB = addNode(bx, by);
+    mNodes[nodeA].pair = nodeB;
+    mNodes[nodeB].pair = nodeA;
+    mNodes[nodeA].edges.push_back(Edge(nodeB, straightCost));
+    mNodes[nodeB].edges.push_back(Edge(nodeA, straightCost));
+}
+
+int ClusterGraph::addNode(const int x, const int y)
+{
+    int node;
+    if (mFreeNodes.empty())
+    {
+        node = CAST_S32(mNodes.size());
+        mNodes.push_back(Node(x, y));
+    }
+    else
+    {
+        node = mFreeNodes.back();
+        mFreeNodes.pop_back();
+        mNodes[node] = Node(x, y);
+    }
+    mClusterNodes[getCluster(x, y)].push_back(node);
+    return node;
+}
+
+void ClusterGraph::removeNode(const int node)
+{
+    Node &restrict portal = mNodes[node];
+    STD_VECTOR<int> &nodes = mClusterNodes[getCluster(portal.x, portal.y)];
+    nodes.erase(std::find(nodes.begin(), nodes.end(), node));
+    // removed node not connected, so search never reach it
+    portal.pair = -1;
+    portal.edges.clear();
+    mFreeNodes.push_back(node);
+}
+
+void ClusterGraph::connectCluster(const MetaTile *const tiles,
+                                  const int cluster)
+{
+    const STD_VECTOR<int> &nodes = mClusterNodes[cluster];
+    const size_t sz = nodes.size();
+    for (size_t f = 0; f + 1 < sz; f ++)
+    {
+        const int nodeA = nodes[f];
+        calcLocalCosts(tiles, cluster, mNodes[nodeA].x, mNodes[nodeA].y);
+        for (size_t d = f + 1; d < sz; d ++)
+        {
+            const int nodeB = nodes[d];
+            const int cost = getLocalCost(cluster,
+                mNodes[nodeB].x,
+                mNodes[nodeB].y);
+            if (cost == INT_MAX)
+                continue;
+            mNodes[nodeA].edges.push_back(Edge(nodeB, cost));
+            mNodes[nodeB].edges.push_back(Edge(nodeA, cost));
+        }
+    }
+}
+
+void ClusterGraph::calcLocalCosts(const MetaTile *const tiles,
+                                  const int cluster,
+                                  const int startX,
+                                  const int startY)
+{
+    const int x0 = (cluster % mClustersX) * mapClusterSize;
+    const int y0 = (cluster / mClustersX) * mapClusterSize;
+    const int x1 = std::min(x0 + mapClusterSize, mWidth);
+    const int y1 = std::min(y0 + mapClusterSize, mHeight);
+
+    std::fill(mLocalCost.begin(), mLocalCost.end(), INT_MAX);
+
+    CostQueue queue;
+    const int startPtr = (startX - x0) + (startY - y0) * mapClusterSize;
+    mLocalCost[startPtr] = 0;
+    queue.push(CostNode(0, startPtr));
+
+    while (!queue.empty())
+    {
+        const CostNode curr = queue.top();
+        queue.pop();
+        const int ptr = curr.second;
+        if (curr.first != mLocalCost[ptr])
+            continue;
+        const int cx = x0 + ptr % mapClusterSize;
+        const int cy = y0 + ptr / mapClusterSize;
+
+        for (int dy = -1; dy <= 1; dy ++)
+        {
+            const int y = cy + dy;
+            if (y < y0 || y >= y1)
+                continue;
+            for (int dx = -1; dx <= 1; dx ++)
+            {
+                const int x = cx + dx;
+                if ((dx == 0 && dy == 0) || x < x0 || x >= x1)
+                    continue;
+                if (isBlocked(tiles, x, y))
+                    continue;
+                int cost = curr.first;
+                if (dx != 0 && dy != 0)
+                {
+                    // same corner check as in Map::findPath
+                    if (((tiles[cx + y * mWidth].blockmask |
+                        tiles[x + cy * mWidth].blockmask) &
+                        mBlockWalkMask) != 0)
+                    {
+                        continue;
+                    }
+                    cost += diagonalCost;
+                }
+                else
+                {
+                    cost += straightCost;
+                }
+                const int newPtr = (x - x0) + (y - y0) * mapClusterSize;
+                if (cost < mLocalCost[newPtr])
+                {
+                    mLocalCost[newPtr] = cost;
+                    queue.push(CostNode(cost, newPtr));
+                }
+            }
+        }
+    }
+}
+
+int ClusterGraph::getLocalCost(const int cluster,
+                               const int x,
+                               const int y) const
+{
+    const int x0 = (cluster % mClustersX) * mapClusterSize;
+    const int y0 = (cluster / mClustersX) * mapClusterSize;
+    return mLocalCost[(x - x0) + (y - y0) * mapClusterSize];
+}
+
+bool ClusterGraph::findPath(const MetaTile *const tiles,
+                            const int startX, const int startY,
+                            const int destX, const int destY,
+                            STD_VECTOR<Position> &waypoints)
+{
+    waypoints.clear();
+    const int nodesCount = CAST_S32(mNodes.size());
+    const int startNode = nodesCount;
+    const int goalNode = nodesCount + 1;
+    const int startCluster = getCluster(startX, startY);
+    const int destCluster = getCluster(destX, destY);
+
+    // connect destination to portals of own cluster
+    const STD_VECTOR<int> &destNodes = mClusterNodes[destCluster];
+    calcLocalCosts(tiles, destCluster, destX, destY);
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, destNodes)
+    {
+        const Node &node = mNodes[*it];
+        mGoalCost[*it] = getLocalCost(destCluster, node.x, node.y);
+    }
+
+    // connect start to portals of own cluster
+    mStartEdges.clear();
+    calcLocalCosts(tiles, startCluster, startX, startY);
+    const STD_VECTOR<int> &startNodes = mClusterNodes[startCluster];
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, startNodes)
+    {
+        const Node &node = mNodes[*it];
+        const int cost = getLocalCost(startCluster, node.x, node.y);
+        if (cost != INT_MAX)
+            mStartEdges.push_back(Edge(*it, cost));
+    }
+    if (startCluster == destCluster)
+    {
+        const int cost = getLocalCost(startCluster, destX, destY);
+        if (cost != INT_MAX)
+            mStartEdges.push_back(Edge(goalNode, cost));
+    }
+
+    std::fill(mGcost.begin(), mGcost.end(), INT_MAX);
+    std::fill(mParent.begin(), mParent.end(), -1);
+    std::fill(mClosed.begin(), mClosed.end(), 0U);
+
+    CostQueue openList;
+    mGcost[startNode] = 0;
+    openList.push(CostNode(0, startNode));
+
+    while (!openList.empty())
+    {
+        const int curr = openList.top().second;
+        openList.pop();
+        if (mClosed[curr] != 0U)
+            continue;
+        mClosed[curr] = 1U;
+        if (curr == goalNode)
+            break;
+
+        const int currGcost = mGcost[curr];
+        const STD_VECTOR<Edge> &edges = curr == startNode ?
+            mStartEdges : mNodes[curr].edges;
+        FOR_EACH (STD_VECTOR<Edge>::const_iterator, it, edges)
+        {
+            const int next = (*it).node;
+            const int cost = currGcost + (*it).cost;
+            if (mClosed[next] != 0U || cost >= mGcost[next])
+                continue;
+            mGcost[next] = cost;
+            mParent[next] = curr;
+            int heuristic = 0;
+            if (next != goalNode)
+            {
+                heuristic = calcHeuristic(mNodes[next].x, mNodes[next].y,
+                    destX, destY);
+            }
+            openList.push(CostNode(cost + heuristic, next));
+        }
+        if (curr != startNode && mGoalCost[curr] != INT_MAX)
+        {
+            const int cost = currGcost + mGoalCost[curr];
+            if (mClosed[goalNode] == 0U && cost < mGcost[goalNode])
+            {
+                mGcost[goalNode] = cost;
+                mParent[goalNode] = curr;
+                openList.push(CostNode(cost, goalNode));
+            }
+        }
+    }
+
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, destNodes)
+        mGoalCost[*it] = INT_MAX;
+
+    if (mClosed[goalNode] == 0U)
+        return false;
+
+    waypoints.push_back(Position(destX, destY));
+    int x = destX;
+    int y = destY;
+    for (int node = mParent[goalNode];
+         node != startNode;
+         node = mParent[node])
+    {
+        const Node &restrict portal = mNodes[node];
+        if (portal.x == x && portal.y == y)
+            continue;
+        x = portal.x;
+        y = portal.y;
+        waypoints.push_back(Position(x, y));
+    }
+    std::reverse(waypoints.begin(), waypoints.end());
+    if (waypoints.front().x == startX && waypoints.front().y == startY)
+        waypoints.erase(waypoints.begin());
+    return true;
+}
+
+int ClusterGraph::calcMemoryLocal() const
+{
+    int sz = static_cast<int>(sizeof(ClusterGraph) +
+        sizeof(Node) * mNodes.capacity() +
+        sizeof(STD_VECTOR<int>) * mClusterNodes.capacity() +
+        sizeof(int) * (mLocalCost.capacity() +
+        mFreeNodes.capacity() +
+        mDirtyClusters.capacity() +
+        mGoalCost.capacity() +
+        mGcost.capacity() +
+        mParent.capacity()) +
+        sizeof(Edge) * mStartEdges.capacity() +
+        mClosed.capacity() +
+        mDirtyFlags.capacity());
+    FOR_EACH (STD_VECTOR<Node>::const_iterator, it, mNodes)
+        sz += CAST_S32(sizeof(Edge) * (*it).edges.capacity());
+    FOR_EACH (STD_VECTOR<STD_VECTOR<int> >::const_iterator,
+              it, mClusterNodes)
+    {
+        sz += CAST_S32(sizeof(int) * (*it).capacity());
+    }
+    return sz;
+}
@@ -0,0 +1,196 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_CLUSTERGRAPH_H
+#define RESOURCES_MAP_CLUSTERGRAPH_H
+
+#include "position.h"
+
+#include "resources/memorycounter.h"
+
+#include "utils/cast.h"
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+struct MetaTile;
+
+/**
+ * Abstract graph for hierarchical (HPA*) path finding.
+ *
+ * Map split to square clusters. Each walkable opening between two
+ * neighbour clusters gets pair of portal nodes, and portal nodes inside
+ * same cluster connected by precalculated walk costs.
+ */
+class ClusterGraph final : public MemoryCounter
+{
+    public:
+        ClusterGraph(const int width,
+                     const int height,
+                     const unsigned char blockWalkMask);
+
+        A_DELETE_COPY(ClusterGraph)
+
+        ~ClusterGraph() override final;
+
+        /**
+         * Rebuilds portals and edges from map collision data.
+         */
+        void build(const MetaTile *const tiles) A_NONNULL(2);
+
+        /**
+         * Builds graph if it not built yet, or rebuilds only clusters
+         * marked by updateTile.
+         */
+        void update(const MetaTile *const tiles) A_NONNULL(2);
+
+        /**
+         * Marks cluster with changed tile for rebuild on next update.
+         */
+        void updateTile(const int x,
+                        const int y);
+
+        /**
+         * Searches abstract graph and fills portal tiles what path must
+         * pass, destination included. Returns false if destination
+         * is not reachable.
+         */
+        bool findPath(const MetaTile *const tiles,
+                      const int startX, const int startY,
+                      const int destX, const int destY,
+                      STD_VECTOR<Position> &waypoints) A_NONNULL(2);
+
+        void invalidate() noexcept2
+        { mValid = false; }
+
+        bool isValid() const noexcept2 A_WARN_UNUSED
+        { return mValid; }
+
+        unsigned char getBlockWalkMask() const noexcept2 A_WARN_UNUSED
+        { return mBlockWalkMask; }
+
+        int getNodesCount() const A_WARN_UNUSED
+        { return CAST_S32(mNodes.size()); }
+
+        int calcMemoryLocal() const override final;
+
+        std::string getCounterName() const override final
+        { return "cluster graph"; }
+
+    private:
+        struct Edge final
+        {
+            Edge(const int node0,
+                 const int cost0) :
+                node(node0),
+                cost(cost0)
+            {
+            }
+
+            A_DEFAULT_COPY(Edge)
+
+            int node;
+            int cost;
+        };
+
+        struct Node final
+        {
+            Node(const int x0,
+                 const int y0) :
+                x(x0),
+                y(y0),
+                pair(-1),
+                edges()
+            {
+            }
+
+            A_DEFAULT_COPY(Node)
+
+            int x;
+            int y;
+            // portal node in neighbour cluster
+            int pair;
+            STD_VECTOR<Edge> edges;
+        };
+
+        bool isBlocked(const MetaTile *const tiles,
+                       const int x,
+                       const int y) const A_WARN_UNUSED A_NONNULL(2);
+
+        int getCluster(const int x,
+                       const int y) const A_WARN_UNUSED;
+
+        void addEntrances(const MetaTile *const tiles,
+                          const int ax, const int ay,
+                          const int bx, const int by,
+                          const int stepX, const int stepY,
+                          const int length) A_NONNULL(2);
+
+        void addPortal(const int ax, const int ay,
+                       const int bx, const int by);
+
+        int addNode(const int x, const int y);
+
+        void removeNode(const int node);
+
+        int getBorder(const int node1,
+                      const int node2) const A_WARN_UNUSED;
+
+        void addBorderEntrances(const MetaTile *const tiles,
+                                const int border) A_NONNULL(2);
+
+        void rebuildClusters(const MetaTile *const tiles) A_NONNULL(2);
+
+        void resizeBuffers();
+
+        void connectCluster(const MetaTile *const tiles,
+                            const int cluster) A_NONNULL(2);
+
+        void calcLocalCosts(const MetaTile *const tiles,
+                            const int cluster,
+                            const int startX,
+                            const int startY) A_NONNULL(2);
+
+        int getLocalCost(const int cluster,
+                         const int x,
+                         const int y) const A_WARN_UNUSED;
+
+        int mWidth;
+        int mHeight;
+        int mClustersX;
+        int mClustersY;
+        unsigned char mBlockWalkMask;
+        bool mValid;
+        STD_VECTOR<Node> mNodes;
+        STD_VECTOR<int> mFreeNodes;
+        STD_VECTOR<STD_VECTOR<int> > mClusterNodes;
+        STD_VECTOR<int> mDirtyClusters;
+        STD_VECTOR<unsigned char> mDirtyFlags;
+
+        // search buffers kept between calls
+        STD_VECTOR<int> mLocalCost;
+        STD_VECTOR<Edge> mStartEdges;
+        STD_VECTOR<int> mGoalCost;
+        STD_VECTOR<int> mGcost;
+        STD_VECTOR<int> mParent;
+        STD_VECTOR<unsigned char> mClosed;
+};
+
+#endif  // RESOURCES_MAP_CLUSTERGRAPH_H
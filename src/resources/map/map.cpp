@@ -51,12 +51,13 @@
 
 #include "resources/loaders/imageloader.h"
 
-#include "resources/map/location.h"
+#include "resources/map/clustergraph.h"
 #include "resources/map/mapheights.h"
 #include "resources/map/mapobjectlist.h"
 #include "resources/map/maplayer.h"
 #include "resources/map/mapitem.h"
 #include "resources/map/objectslayer.h"
+#include "resources/map/pathfinder.h"
 #include "resources/map/speciallayer.h"
 #include "resources/map/tileanimation.h"
 #include "resources/map/tileset.h"
@@ -74,9 +75,8 @@
 
 #include <sys/stat.h>
 
-#include <climits>
+#include <algorithm>
 #include <fstream>
-#include <queue>
 
 #include "debug.h"
 
@@ -85,12 +85,10 @@ class ActorFunctuator final
     public:
         A_DEFAULT_COPY(ActorFunctuator)
 
-        bool operator()(const Actor *const a,
-                        const Actor *const b) const
+        bool operator()(const MapActor &a,
+                        const MapActor &b) const
         {
-            if ((a == nullptr) || (b == nullptr))
-                return false;
-            return a->getSortPixelY() < b->getSortPixelY();
+            return a.sortY < b.sortY;
         }
 } actorCompare;
 
@@ -105,15 +103,19 @@ Map::Map(const std::string &name,
     mMaxTileHeight(height),
     mMetaTiles(new MetaTile[mWidth * mHeight]),
     mWalkLayer(nullptr),
+    mClusterGraph(nullptr),
     mLayers(),
     mDrawUnderLayers(),
     mDrawOverLayers(),
     mTilesets(),
     mActors(),
+    mSortedActors(0),
     mHasWarps(false),
     mDrawLayersFlags(MapType::NORMAL),
-    mOnClosedList(1),
-    mOnOpenList(2),
+    mPathFinder(new PathFinder(mMetaTiles, mWidth, mHeight)),
+    mPathWaypoints(),
+    mPathNodes(0),
+    mBlockMaskVersion(0),
     mBackgrounds(),
     mForegrounds(),
     mLastAScrollX(0.0F),
@@ -165,11 +167,16 @@ Map::Map(const std::string &name,
 #endif  // USE_OPENGL
     mCustom(false),
     mDrawOnlyFringe(false),
-    mClear(false)
+    mClear(false),
+    mHierarchicalPath(config.getBoolValue("enableHierarchicalPath"))
 {
     config.addListener("OverlayDetail", this);
     config.addListener("guialpha", this);
     config.addListener("beingopacity", this);
+    config.addListener("enableHierarchicalPath", this);
+    config.addListener("enableJumpPointSearch", this);
+    mPathFinder->setJumpPointSearch(
+        config.getBoolValue("enableJumpPointSearch"));
 
     if (mOpacity != 1.0F)
         mBeingOpacity = config.getBoolValue("beingopacity");
@@ -196,6 +203,8 @@ Map::~Map()
     delete2(mSpecialLayer)
     delete2(mTempLayer)
     delete2(mObjects)
+    delete2(mClusterGraph)
+    delete2(mPathFinder)
     delete_all(mMapPortals);
 #ifdef USE_OPENGL
     if (mAtlas != nullptr)
@@ -229,6 +238,15 @@ void Map::optionChanged(const std::string &restrict value) restrict2
         else
             mBeingOpacity = false;
     }
+    else if (value == "enableHierarchicalPath")
+    {
+        mHierarchicalPath = config.getBoolValue("enableHierarchicalPath");
+    }
+    else if (value == "enableJumpPointSearch")
+    {
+        mPathFinder->setJumpPointSearch(
+            config.getBoolValue("enableJumpPointSearch"));
+    }
 }
 
 void Map::initializeAmbientLayers() restrict2
@@ -358,7 +376,7 @@ void Map::draw(Graphics *restrict const graphics,
     // Make sure actors are sorted ascending by Y-coordinate
     // so that they overlap correctly
     BLOCK_START("Map::draw sort")
-    mActors.sort(actorCompare);
+    sortActors();
     BLOCK_END("Map::draw sort")
 
     // update scrolling of all ambient layers
@@ -422,7 +440,36 @@ void Map::draw(Graphics *restrict const graphics,
     else
     {
 #ifdef USE_OPENGL
-        if (mCachedDraw)
+        if (mCachedDraw && graphics->isAllowMoveVertexes())
+        {
+            FOR_EACH (Layers::iterator, it, mDrawUnderLayers)
+            {
+                (*it)->drawChunks(graphics,
+                    startX, startY,
+                    endX, endY,
+                    scrollX, scrollY);
+            }
+
+            if (mFringeLayer != nullptr)
+            {
+                mFringeLayer->setSpecialLayer(mSpecialLayer);
+                mFringeLayer->setTempLayer(mTempLayer);
+                mFringeLayer->drawFringe(graphics,
+                    startX, startY,
+                    endX, endY,
+                    scrollX, scrollY,
+                    mActors);
+            }
+
+            FOR_EACH (Layers::iterator, it, mDrawOverLayers)
+            {
+                (*it)->drawChunks(graphics,
+                    startX, startY,
+                    endX, endY,
+                    scrollX, scrollY);
+            }
+        }
+        else if (mCachedDraw)
         {
             if (updateFlag != 0)
             {
@@ -502,7 +549,7 @@ void Map::draw(Graphics *restrict const graphics,
         {
             while (ai != ai_end)
             {
-                if (Actor *restrict const actor = *ai)
+                if (Actor *restrict const actor = (*ai).actor)
                 {
                     const int x = actor->getTileX();
                     const int y = actor->getTileY();
@@ -526,7 +573,7 @@ void Map::draw(Graphics *restrict const graphics,
         {
             while (ai != ai_end)
             {
-                if (Actor *const actor = *ai)
+                if (Actor *const actor = (*ai).actor)
                 {
                     actor->setAlpha(0.3F);
                     actor->draw(graphics, -scrollX, -scrollY);
@@ -711,6 +758,7 @@ void Map::addBlockMask(const int x, const int y,
         return;
 
     const int tileNum = x + y * mWidth;
+    const unsigned char oldMask = mMetaTiles[tileNum].blockmask;
 
     switch (type)
     {
@@ -741,6 +789,7 @@ void Map::addBlockMask(const int x, const int y,
             // Do nothing.
             break;
     }
+    updateBlockMask(tileNum, oldMask);
 }
 
 void Map::setBlockMask(const int x, const int y,
@@ -750,6 +799,7 @@ void Map::setBlockMask(const int x, const int y,
         return;
 
     const int tileNum = x + y * mWidth;
+    const unsigned char oldMask = mMetaTiles[tileNum].blockmask;
 
     switch (type)
     {
@@ -780,6 +830,31 @@ void Map::setBlockMask(const int x, const int y,
             // Do nothing.
             break;
     }
+    updateBlockMask(tileNum, oldMask);
+}
+
+void Map::updateBlockMask(const int tileNum,
+                          const unsigned char oldMask) restrict2
+{
+    const unsigned char newMask = mMetaTiles[tileNum].blockmask;
+    if (newMask == oldMask)
+        return;
+    mBlockMaskVersion ++;
+    if (mWalkLayer != nullptr &&
+        ((oldMask ^ newMask) & mWalkLayer->getBlockWalkMask()) != 0)
+    {
+        mWalkLayer->updateTile(mMetaTiles,
+            tileNum % mWidth,
+            tileNum / mWidth);
+    }
+    if (mClusterGraph == nullptr)
+        return;
+    if (((oldMask ^ newMask) & (mClusterGraph->getBlockWalkMask() |
+        BlockMask::WALL)) != 0)
+    {
+        mClusterGraph->updateTile(tileNum % mWidth,
+            tileNum / mWidth);
+    }
 }
 
 bool Map::getWalk(const int x, const int y,
@@ -819,19 +894,68 @@ const MetaTile *Map::getMetaTile(const int x, const int y) const restrict2
     return &mMetaTiles[x + y * mWidth];
 }
 
-Actors::iterator Map::addActor(Actor *const actor) restrict2
+int Map::addActor(Actor *const actor) restrict2
 {
-    mActors.push_front(actor);
+    mActors.push_back(MapActor(actor, actor->getSortPixelY()));
 //    mSpritesUpdated = true;
-    return mActors.begin();
+    return CAST_S32(mActors.size()) - 1;
 }
 
-void Map::removeActor(const Actors::iterator &restrict iterator) restrict2
+void Map::removeActor(const int index) restrict2
 {
-    mActors.erase(iterator);
+    const int last = CAST_S32(mActors.size()) - 1;
+    if (index < 0 || index > last)
+        return;
+    // last actor moved to free place, order fixed by sortActors
+    if (index != last)
+    {
+        mActors[index] = mActors[last];
+        mActors[index].actor->mMapActor = index;
+    }
+    mActors.pop_back();
+    if (mSortedActors > last)
+        mSortedActors = last;
 //    mSpritesUpdated = true;
 }
 
+void Map::sortActors() restrict2
+{
+    // refresh sort keys
+    const int count = CAST_S32(mActors.size());
+    for (int f = 0; f < count; f ++)
+    {
+        MapActor &restrict item = mActors[f];
+        item.sortY = item.actor->getSortPixelY();
+    }
+    const int sorted = mSortedActors;
+
+    // actors moves only a bit between frames,
+    // so insertion sort here is almost linear
+    for (int f = 1; f < sorted; f ++)
+    {
+        const MapActor item = mActors[f];
+        int pos = f;
+        while (pos > 0 && item.sortY < mActors[pos - 1].sortY)
+        {
+            mActors[pos] = mActors[pos - 1];
+            pos --;
+        }
+        mActors[pos] = item;
+    }
+
+    if (sorted < count)
+    {
+        const Actors::iterator middle = mActors.begin() + sorted;
+        std::stable_sort(middle, mActors.end(), actorCompare);
+        std::inplace_merge(mActors.begin(), middle, mActors.end(),
+            actorCompare);
+    }
+
+    for (int f = 0; f < count; f ++)
+        mActors[f].actor->mMapActor = f;
+    mSortedActors = count;
+}
+
 const std::string Map::getMusicFile() const restrict2
 {
     return getProperty("music", std::string());
@@ -865,237 +989,115 @@ Path Map::findPath(const int startX, const int startY,
                    const unsigned char blockWalkMask,
                    const int maxCost) restrict2
 {
-    BLOCK_START("Map::findPath")
-    // The basic walking cost of a tile.
-    static const int basicCost = 100;
-    const int basicCost2 = 100 * 362 / 256;
-    const float basicCostF = 100.0 * 362 / 256;
-
-    // Path to be built up (empty by default)
     Path path;
+    findPath(path,
+        startX, startY,
+        destX, destY,
+        blockWalkMask,
+        maxCost);
+    return path;
+}
 
-    if (startX >= mWidth || startY >= mHeight || startX < 0 || startY < 0)
-    {
-        BLOCK_END("Map::findPath")
-        return path;
+void Map::findPath(Path &restrict path,
+                   const int startX, const int startY,
+                   const int destX, const int destY,
+                   const unsigned char blockWalkMask,
+                   const int maxCost) restrict2
+{
+    path.clear();
+    mPathNodes = 0;
+
+    // Long unlimited paths first searched in cluster graph
+    if (mHierarchicalPath &&
+        maxCost == 0 &&
+        mClusterGraph != nullptr &&
+        mClusterGraph->getBlockWalkMask() == blockWalkMask &&
+        contains(startX, startY) &&
+        getWalk(destX, destY, blockWalkMask) &&
+        std::max(std::abs(destX - startX), std::abs(destY - startY)) >=
+        mapClusterSize * 2)
+    {
+        findHierarchicalPath(path,
+            startX, startY,
+            destX, destY,
+            blockWalkMask);
+        return;
     }
+    findTilePath(path,
+        startX, startY,
+        destX, destY,
+        blockWalkMask,
+        maxCost);
+}
 
-    // Return when destination not walkable
-    if (!getWalk(destX, destY, blockWalkMask))
-    {
-        BLOCK_END("Map::findPath")
-        return path;
-    }
+void Map::findHierarchicalPath(Path &restrict path,
+                               const int startX, const int startY,
+                               const int destX, const int destY,
+                               const unsigned char blockWalkMask) restrict2
+{
+    BLOCK_START("Map::findHierarchicalPath")
+    // built on first use and updated only in changed clusters
+    mClusterGraph->update(mMetaTiles);
 
-    // Reset starting tile's G cost to 0
-    MetaTile *const startTile = &mMetaTiles[startX + startY * mWidth];
-    if (startTile == nullptr)
+    if (!mClusterGraph->findPath(mMetaTiles,
+        startX, startY,
+        destX, destY,
+        mPathWaypoints))
     {
-        BLOCK_END("Map::findPath")
-        return path;
+        BLOCK_END("Map::findHierarchicalPath")
+        return;
     }
 
-    startTile->Gcost = 0;
-
-    // Declare open list, a list with open tiles sorted on F cost
-    std::priority_queue<Location> openList;
-
-    // Add the start point to the open list
-    openList.push(Location(startX, startY, startTile));
-
-    bool foundPath = false;
-
-    // Keep trying new open tiles until no more tiles to try or target found
-    while (!openList.empty() && !foundPath)
+    int x = startX;
+    int y = startY;
+    FOR_EACH (STD_VECTOR<Position>::const_iterator, it, mPathWaypoints)
     {
-        // Take the location with the lowest F cost from the open list.
-        const Location curr = openList.top();
-        openList.pop();
-
-        const MetaTile *const tile = curr.tile;
-
-        // If the tile is already on the closed list, this means it has already
-        // been processed with a shorter path to the start point (lower G cost)
-        if (tile->whichList == mOnClosedList)
-            continue;
-
-        // Put the current tile on the closed list
-        curr.tile->whichList = mOnClosedList;
-
-        const int curWidth = curr.y * mWidth;
-        const int tileGcost = tile->Gcost;
-
-        // Check the adjacent tiles
-        for (int dy = -1; dy <= 1; dy++)
+        const Position &pos = *it;
+        // portals of neighbour clusters always connected by straight step
+        if (std::abs(pos.x - x) + std::abs(pos.y - y) == 1)
         {
-            const int y = curr.y + dy;
-            if (y < 0 || y >= mHeight)
-                continue;
-
-            const int yWidth = y * mWidth;
-            const int dy1 = std::abs(y - destY);
-
-            for (int dx = -1; dx <= 1; dx++)
-            {
-                // Calculate location of tile to check
-                const int x = curr.x + dx;
-
-                // Skip if if we're checking the same tile we're leaving from,
-                // or if the new location falls outside of the map boundaries
-                if ((dx == 0 && dy == 0) || x < 0 || x >= mWidth)
-                    continue;
-
-                MetaTile *const newTile = &mMetaTiles[x + yWidth];
-
-                // Skip if the tile is on the closed list or is not walkable
-                // unless its the destination tile
-                // +++ probably here "newTile->blockmask & BlockMask::WALL"
-                // can be removed. It left here only for protect from
-                // walk on wall in any case
-                if (newTile->whichList == mOnClosedList ||
-                    (((newTile->blockmask & blockWalkMask) != 0)
-                    && !(x == destX && y == destY))
-                    || ((newTile->blockmask & BlockMask::WALL) != 0))
-                {
-                    continue;
-                }
-
-                // When taking a diagonal step, verify that we can skip the
-                // corner.
-                if (dx != 0 && dy != 0)
-                {
-                    const MetaTile *const t1 = &mMetaTiles[curr.x +
-                        (curr.y + dy) * mWidth];
-                    const MetaTile *const t2 = &mMetaTiles[curr.x +
-                        dx + curWidth];
-
-                    // on player abilities.
-                    if (((t1->blockmask | t2->blockmask) & blockWalkMask) != 0)
-                        continue;
-                }
-
-                // Calculate G cost for this route, ~sqrt(2) for moving diagonal
-                int Gcost = tileGcost + (dx == 0 || dy == 0
-                    ? basicCost : basicCost2);
-
-                /* Demote an arbitrary direction to speed pathfinding by
-                   adding a defect
-                   Important: as long as the total defect along any path is
-                   less than the basicCost, the pathfinder will still find one
-                   of the shortest paths! */
-                if (dx == 0 || dy == 0)
-                {
-                    // Demote horizontal and vertical directions, so that two
-                    // consecutive directions cannot have the same Fcost.
-                    ++Gcost;
-                }
-
-/*
-                // It costs extra to walk through a being (needs to be enough
-                // to make it more attractive to walk around).
-                if (occupied(x, y))
-                {
-                    Gcost += 3 * basicCost;
-                }
-*/
-
-                // Skip if Gcost becomes too much
-                // Warning: probably not entirely accurate
-                if (maxCost > 0 && Gcost > maxCost * basicCost)
-                    continue;
-
-                if (newTile->whichList != mOnOpenList)
-                {
-                    // Found a new tile (not on open nor on closed list)
-
-                    /* Update Hcost of the new tile. The pathfinder does not
-                       work reliably if the heuristic cost is higher than the
-                       real cost. In particular, using Manhattan distance is
-                       forbidden here. */
-                    const int dx1 = std::abs(x - destX);
-                    newTile->Hcost = std::abs(dx1 - dy1) * basicCost +
-                        CAST_S32(static_cast<float>(std::min(dx1, dy1)) *
-                        (basicCostF));
-
-                    // Set the current tile as the parent of the new tile
-                    newTile->parentX = curr.x;
-                    newTile->parentY = curr.y;
-
-                    // Update Gcost and Fcost of new tile
-                    newTile->Gcost = Gcost;
-                    newTile->Fcost = Gcost + newTile->Hcost;
-
-                    if (x != destX || y != destY)
-                    {
-                        // Add this tile to the open list
-                        newTile->whichList = mOnOpenList;
-                        openList.push(Location(x, y, newTile));
-                    }
-                    else
-                    {
-                        // Target location was found
-                        foundPath = true;
-                    }
-                }
-                else if (Gcost < newTile->Gcost)
-                {
-                    // Found a shorter route.
-                    // Update Gcost and Fcost of the new tile
-                    newTile->Gcost = Gcost;
-                    newTile->Fcost = Gcost + newTile->Hcost;
-
-                    // Set the current tile as the parent of the new tile
-                    newTile->parentX = curr.x;
-                    newTile->parentY = curr.y;
-
-                    // Add this tile to the open list (it's already
-                    // there, but this instance has a lower F score)
-                    openList.push(Location(x, y, newTile));
-                }
-            }
+            path.push_back(pos);
         }
-    }
-
-    // Two new values to indicate whether a tile is on the open or closed list,
-    // this way we don't have to clear all the values between each pathfinding.
-    if (mOnOpenList > UINT_MAX - 2)
-    {
-        // We reset the list memebers value.
-        mOnClosedList = 1;
-        mOnOpenList = 2;
-
-        // Clean up the metaTiles
-        const int size = mWidth * mHeight;
-        for (int i = 0; i < size; ++i)
-            mMetaTiles[i].whichList = 0;
-    }
-    else
-    {
-        mOnClosedList += 2;
-        mOnOpenList += 2;
-    }
-
-    // If a path has been found, iterate backwards using the parent locations
-    // to extract it.
-    if (foundPath)
-    {
-        int pathX = destX;
-        int pathY = destY;
-
-        while (pathX != startX || pathY != startY)
+        else if (!findTilePath(path,
+                 x, y,
+                 pos.x, pos.y,
+                 blockWalkMask,
+                 0))
         {
-            // Add the new path node to the start of the path list
-            path.push_front(Position(pathX, pathY));
-
-            // Find out the next parent
-            const MetaTile *const tile = &mMetaTiles[pathX + pathY * mWidth];
-            pathX = tile->parentX;
-            pathY = tile->parentY;
+            // graph out of sync with tiles, use full search
+            path.clear();
+            findTilePath(path,
+                startX, startY,
+                destX, destY,
+                blockWalkMask,
+                0);
+            break;
         }
+        x = pos.x;
+        y = pos.y;
     }
+    BLOCK_END("Map::findHierarchicalPath")
+}
 
-    BLOCK_END("Map::findPath")
-    return path;
+bool Map::findTilePath(Path &restrict path,
+                       const int startX, const int startY,
+                       const int destX, const int destY,
+                       const unsigned char blockWalkMask,
+                       const int maxCost) restrict2
+{
+    const bool found = mPathFinder->findPath(path,
+        startX, startY,
+        destX, destY,
+        blockWalkMask,
+        maxCost);
+    mPathNodes += mPathFinder->getNodes();
+    return found;
+}
+
+void Map::setClusterGraph(ClusterGraph *restrict const graph) restrict2
+{
+    delete mClusterGraph;
+    mClusterGraph = graph;
 }
 
 void Map::addParticleEffect(const std::string &effectFile,
@@ -1289,12 +1291,14 @@ void Map::addRange(const std::string &restrict name,
 }
 
 void Map::addPortal(const std::string &restrict name,
+                    const std::string &restrict destination,
                     const int type,
                     const int x, const int y,
                     const int dx, const int dy) restrict2
 {
     addPortalTile(name, type, (x / mapTileSize) + (dx / mapTileSize / 2),
         (y / mapTileSize) + (dy / mapTileSize / 2));
+    mMapPortals.back()->setDestination(destination);
 }
 
 void Map::addPortalTile(const std::string &restrict name,
@@ -1762,13 +1766,16 @@ int Map::calcMemoryLocal() const
         mDrawUnderLayers.capacity() +
         mDrawOverLayers.capacity()) +
         sizeof(Tileset*) * mTilesets.capacity() +
-        sizeof(Actor*) * mActors.size() +
+        sizeof(MapActor) * mActors.capacity() +
         sizeof(AmbientLayer*) * (mBackgrounds.capacity()
         + mForegrounds.capacity()) +
         sizeof(ParticleEffectData) * mParticleEffects.capacity() +
         sizeof(MapItem) * mMapPortals.capacity() +
         (sizeof(TileAnimation) + sizeof(int)) * mTileAnimations.size() +
-        sizeof(Tileset*) * mIndexedTilesetsSize);
+        sizeof(Tileset*) * mIndexedTilesetsSize +
+        sizeof(PathFinder) +
+        sizeof(Location) * mPathFinder->getOpenListCapacity() +
+        sizeof(Position) * mPathWaypoints.capacity());
 }
 
 int Map::calcMemoryChilds(const int level) const
@@ -1777,6 +1784,8 @@ int Map::calcMemoryChilds(const int level) const
 
     if (mWalkLayer != nullptr)
         sz += mWalkLayer->calcMemory(level + 1);
+    if (mClusterGraph != nullptr)
+        sz += mClusterGraph->calcMemory(level + 1);
     FOR_EACH (LayersCIter, it, mLayers)
     {
         sz += (*it)->calcMemory(level + 1);
@@ -1824,4 +1833,11 @@ int Map::getAtlasCount() const restrict2
         return 0;
     return CAST_S32(mAtlas->atlases.size());
 }
+
+int Map::getAtlasOccupancy() const restrict2
+{
+    if (mAtlas == nullptr)
+        return 0;
+    return mAtlas->getOccupancy();
+}
 #endif  // USE_OPENGL
@@ -43,6 +43,7 @@
 #include "resources/map/properties.h"
 
 class AmbientLayer;
+class ClusterGraph;
 #ifdef USE_OPENGL
 class AtlasResource;
 #endif  // USE_OPENGL
@@ -51,6 +52,7 @@ class MapHeights;
 class MapItem;
 class MapLayer;
 class ObjectsLayer;
+class PathFinder;
 class SpecialLayer;
 class Tileset;
 class TileAnimation;
@@ -205,6 +207,29 @@ class Map final : public Properties,
                       const unsigned char blockWalkmask,
                       const int maxCost) restrict2 A_WARN_UNUSED;
 
+        /**
+         * Find a path from one location to the next and store it in
+         * given path. Memory already reserved by path is reused.
+         */
+        void findPath(Path &restrict path,
+                      const int startX, const int startY,
+                      const int destX, const int destY,
+                      const unsigned char blockWalkmask,
+                      const int maxCost) restrict2;
+
+        /**
+         * Returns number what changed each time when block mask
+         * of any tile changed.
+         */
+        int getBlockMaskVersion() const restrict2 noexcept2 A_WARN_UNUSED
+        { return mBlockMaskVersion; }
+
+        /**
+         * Returns number of tiles expanded by last path search.
+         */
+        int getPathNodes() const restrict2 noexcept2 A_WARN_UNUSED
+        { return mPathNodes; }
+
         /**
          * Adds a particle effect
          */
@@ -250,6 +275,7 @@ class Map final : public Properties,
         std::string getUserMapDirectory() const restrict2 A_WARN_UNUSED;
 
         void addPortal(const std::string &restrict name,
+                       const std::string &restrict destination,
                        const int type,
                        const int x, const int y,
                        const int dx, const int dy) restrict2;
@@ -334,6 +360,8 @@ class Map final : public Properties,
 #ifdef USE_OPENGL
         int getAtlasCount() const restrict2 A_WARN_UNUSED;
 
+        int getAtlasOccupancy() const restrict2 A_WARN_UNUSED;
+
         void setAtlas(AtlasResource *restrict const atlas) restrict2 noexcept2
         { mAtlas = atlas; }
 
@@ -350,6 +378,11 @@ class Map final : public Properties,
         void setWalkLayer(WalkLayer *restrict const layer) restrict2 noexcept2
         { mWalkLayer = layer; }
 
+        const ClusterGraph *getClusterGraph() const restrict2 noexcept2
+        { return mClusterGraph; }
+
+        void setClusterGraph(ClusterGraph *restrict const graph) restrict2;
+
         void addHeights(const MapHeights *restrict const heights) restrict2
                         A_NONNULL(2);
 
@@ -380,16 +413,23 @@ class Map final : public Properties,
         friend class Minimap;
 
         /**
-         * Adds an actor to the map.
+         * Adds an actor to the map. Returns actor index in draw order.
          */
-        Actors::iterator addActor(Actor *const actor) restrict2 A_NONNULL(2);
+        int addActor(Actor *const actor) restrict2 A_NONNULL(2);
 
         /**
-         * Removes an actor from the map.
+         * Removes an actor from the map. Last actor moved to its index.
          */
-        void removeActor(const Actors::iterator &restrict iterator) restrict2;
+        void removeActor(const int index) restrict2;
 
     private:
+        /**
+         * Sorts actors ascending by sort Y coordinate. Order from previous
+         * frame kept, so moved actors fixed by insertion sort and only
+         * actors added after previous sort sorted fully and merged.
+         */
+        void sortActors() restrict2;
+
         /**
          * Updates scrolling of ambient layers. Has to be called each game tick.
          */
@@ -403,6 +443,28 @@ class Map final : public Properties,
                                const MapLayerPositionT type,
                                const int detail) const restrict2 A_NONNULL(2);
 
+        /**
+         * Find a path using tiles only and append it to path.
+         * Returns false if path not found.
+         */
+        bool findTilePath(Path &restrict path,
+                          const int startX, const int startY,
+                          const int destX, const int destY,
+                          const unsigned char blockWalkmask,
+                          const int maxCost) restrict2;
+
+        /**
+         * Find a path using cluster graph and refine it by tiles.
+         */
+        void findHierarchicalPath(Path &restrict path,
+                                  const int startX, const int startY,
+                                  const int destX, const int destY,
+                                  const unsigned char blockWalkmask)
+                                  restrict2;
+
+        void updateBlockMask(const int tileNum,
+                             const unsigned char oldMask) restrict2;
+
         /**
          * Tells whether the given coordinates fall within the map boundaries.
          */
@@ -416,19 +478,23 @@ class Map final : public Properties,
         int mMaxTileHeight;
         MetaTile *const mMetaTiles;
         WalkLayer *mWalkLayer;
+        ClusterGraph *mClusterGraph;
         Layers mLayers;
         Layers mDrawUnderLayers;
         Layers mDrawOverLayers;
         Tilesets mTilesets;
         Actors mActors;
+        int mSortedActors;
         bool mHasWarps;
 
         // draw flags
         MapTypeT mDrawLayersFlags;
 
         // Pathfinding members
-        unsigned int mOnClosedList;
-        unsigned int mOnOpenList;
+        PathFinder *mPathFinder;
+        STD_VECTOR<Position> mPathWaypoints;
+        int mPathNodes;
+        int mBlockMaskVersion;
 
         // Overlay data
         AmbientLayerVector mBackgrounds;
@@ -504,6 +570,7 @@ class Map final : public Properties,
         bool mCustom;
         bool mDrawOnlyFringe;
         bool mClear;
+        bool mHierarchicalPath;
 };
 
 #endif  // RESOURCES_MAP_MAP_H
@@ -0,0 +1,608 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/mapcache.h"
+
+#include "logger.h"
+#include "settings.h"
+
+#include "fs/files.h"
+#include "fs/mkdir.h"
+
+#include "fs/virtfs/fs.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+#include "utils/stringutils.h"
+
+#include <fstream>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "debug.h"
+
+namespace
+{
+    // "MPMC" in file start
+    const int cacheMagic = 0x434d504d;
+    const int cacheVersion = 4;
+
+    enum
+    {
+        HEADER_MAGIC = 0,
+        HEADER_VERSION,
+        // hash of source files names, sizes and times
+        HEADER_SOURCES,
+        // adler32 of data after header
+        HEADER_CHECKSUM,
+        HEADER_LENGTH
+    };
+
+    unsigned int getChecksum(const void *const data,
+                             const size_t size)
+    {
+        const uLong adler = adler32(0L, nullptr, 0);
+        return CAST_U32(adler32(adler,
+            static_cast<const Bytef*>(data),
+            CAST_U32(size)));
+    }
+
+    void writeString(STD_VECTOR<int> &data,
+                     const std::string &str)
+    {
+        const int size = CAST_S32(str.size());
+        data.push_back(size);
+        if (size == 0)
+            return;
+        const size_t pos = data.size();
+        data.resize(pos + (size + 3) / 4, 0);
+        memcpy(&data[pos], str.c_str(), size);
+    }
+
+    void writeProperties(STD_VECTOR<int> &data,
+                         const MapCacheProperties &props)
+    {
+        data.push_back(CAST_S32(props.size()));
+        FOR_EACH (MapCachePropertiesCIter, it, props)
+        {
+            writeString(data, (*it).first);
+            writeString(data, (*it).second);
+        }
+    }
+
+    struct CacheReader final
+    {
+        explicit CacheReader(const STD_VECTOR<int> &data0) :
+            data(data0),
+            pos(HEADER_LENGTH),
+            ok(true)
+        {
+        }
+
+        A_DELETE_COPY(CacheReader)
+
+        int readInt()
+        {
+            if (pos >= CAST_S32(data.size()))
+            {
+                ok = false;
+                return 0;
+            }
+            return data[pos++];
+        }
+
+        // count of items, each item at least one value long
+        int readCount()
+        {
+            const int count = readInt();
+            if (count < 0 || count > CAST_S32(data.size()) - pos)
+            {
+                ok = false;
+                return 0;
+            }
+            return count;
+        }
+
+        std::string readString()
+        {
+            const int size = readInt();
+            if (size <= 0)
+            {
+                if (size < 0)
+                    ok = false;
+                return std::string();
+            }
+            const int words = (size + 3) / 4;
+            if (words > CAST_S32(data.size()) - pos)
+            {
+                ok = false;
+                return std::string();
+            }
+            const std::string str(reinterpret_cast<const char*>(
+                &data[pos]), size);
+            pos += words;
+            return str;
+        }
+
+        void readProperties(MapCacheProperties &props)
+        {
+            const int count = readCount();
+            for (int f = 0; f < count && ok; f ++)
+            {
+                const std::string name = readString();
+                props.push_back(MapCacheProperty(name, readString()));
+            }
+        }
+
+        const STD_VECTOR<int> &data;
+        int pos;
+        bool ok;
+    };
+}  // namespace
+
+MapCache::MapCache(const std::string &mapName) :
+    mFileName(getFileName(mapName)),
+    mSources(),
+    mData(),
+    mEntries(),
+    mTilesets(),
+    mLayers(),
+    mProperties(),
+    mObjects(),
+    mWidth(0),
+    mHeight(0),
+    mTileWidth(0),
+    mTileHeight(0),
+    mLoaded(false),
+    mCacheable(true)
+{
+    addSource(mapName);
+}
+
+void MapCache::addSource(const std::string &name)
+{
+    int size = 0;
+    int time = 0;
+    if (!getSourceInfo(name, size, time))
+        mCacheable = false;
+    mSources.push_back(MapCacheSource(name, size, time));
+}
+
+unsigned int MapCache::getSourcesHash(const STD_VECTOR<MapCacheSource>
+                                      &sources)
+{
+    STD_VECTOR<int> data;
+    FOR_EACH (STD_VECTOR<MapCacheSource>::const_iterator, it, sources)
+    {
+        writeString(data, (*it).name);
+        data.push_back((*it).size);
+        data.push_back((*it).time);
+    }
+    if (data.empty())
+        return 0U;
+    return getChecksum(&data[0], data.size() * sizeof(int));
+}
+
+void MapCache::clear()
+{
+    // only map file stays in sources
+    if (mSources.size() > 1)
+        mSources.erase(mSources.begin() + 1, mSources.end());
+    mData.clear();
+    mEntries.clear();
+    mTilesets.clear();
+    mLayers.clear();
+    mProperties.clear();
+    mObjects.clear();
+    mWidth = 0;
+    mHeight = 0;
+    mTileWidth = 0;
+    mTileHeight = 0;
+    mLoaded = false;
+}
+
+void MapCache::setSize(const int width,
+                       const int height,
+                       const int tileWidth,
+                       const int tileHeight)
+{
+    mWidth = width;
+    mHeight = height;
+    mTileWidth = tileWidth;
+    mTileHeight = tileHeight;
+}
+
+MapCacheTileset &MapCache::addTileset()
+{
+    mEntries.push_back(Entry(ENTRY_TILESET, CAST_S32(mTilesets.size())));
+    mTilesets.push_back(MapCacheTileset());
+    return mTilesets.back();
+}
+
+MapCacheLayer &MapCache::addLayer()
+{
+    mEntries.push_back(Entry(ENTRY_LAYER, CAST_S32(mLayers.size())));
+    mLayers.push_back(MapCacheLayer());
+    return mLayers.back();
+}
+
+MapCacheProperties &MapCache::addProperties()
+{
+    mEntries.push_back(Entry(ENTRY_PROPERTIES,
+        CAST_S32(mProperties.size())));
+    mProperties.push_back(MapCacheProperties());
+    return mProperties.back();
+}
+
+MapCacheObject &MapCache::addObject()
+{
+    mEntries.push_back(Entry(ENTRY_OBJECT, CAST_S32(mObjects.size())));
+    mObjects.push_back(MapCacheObject());
+    return mObjects.back();
+}
+
+bool MapCache::load()
+{
+    clear();
+
+    std::ifstream file;
+    file.open(mFileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        return false;
+    file.seekg(0, std::ios::end);
+    const int length = CAST_S32(file.tellg());
+    if (length < CAST_S32(HEADER_LENGTH * sizeof(int)) ||
+        length % CAST_S32(sizeof(int)) != 0)
+    {
+        return false;
+    }
+    file.seekg(0, std::ios::beg);
+    STD_VECTOR<int> &data = mData;
+    data.resize(length / sizeof(int));
+    file.read(reinterpret_cast<char*>(&data[0]), length);
+    if (!file)
+    {
+        mData.clear();
+        return false;
+    }
+    file.close();
+
+    if (data[HEADER_MAGIC] != cacheMagic ||
+        data[HEADER_VERSION] != cacheVersion)
+    {
+        logger->log_r("Map cache outdated: %s", mFileName.c_str());
+        mData.clear();
+        return false;
+    }
+    if (CAST_U32(data[HEADER_CHECKSUM]) != getChecksum(
+        &data[HEADER_LENGTH], (data.size() - HEADER_LENGTH) * sizeof(int)))
+    {
+        logger->log_r("Map cache broken: %s", mFileName.c_str());
+        mData.clear();
+        return false;
+    }
+
+    CacheReader reader(data);
+
+    // files changed since cache was saved, checked by current state
+    STD_VECTOR<MapCacheSource> sources;
+    int count = reader.readCount();
+    for (int f = 0; f < count && reader.ok; f ++)
+    {
+        const std::string name = reader.readString();
+        int size = 0;
+        int time = 0;
+        if (!getSourceInfo(name, size, time))
+            reader.ok = false;
+        sources.push_back(MapCacheSource(name, size, time));
+    }
+    if (!reader.ok ||
+        sources.empty() ||
+        sources[0].name != mSources[0].name ||
+        CAST_U32(data[HEADER_SOURCES]) != getSourcesHash(sources))
+    {
+        logger->log_r("Map cache outdated: %s", mFileName.c_str());
+        clear();
+        return false;
+    }
+    mSources.swap(sources);
+
+    mWidth = reader.readInt();
+    mHeight = reader.readInt();
+    mTileWidth = reader.readInt();
+    mTileHeight = reader.readInt();
+
+    count = reader.readCount();
+    for (int f = 0; f < count && reader.ok; f ++)
+    {
+        mTilesets.push_back(MapCacheTileset());
+        MapCacheTileset &tileset = mTilesets.back();
+        tileset.source = reader.readString();
+        tileset.image = reader.readString();
+        tileset.imageName = reader.readString();
+        reader.readProperties(tileset.properties);
+        tileset.firstGid = reader.readInt();
+        tileset.margin = reader.readInt();
+        tileset.spacing = reader.readInt();
+        tileset.tileWidth = reader.readInt();
+        tileset.tileHeight = reader.readInt();
+        tileset.valid = reader.readInt() != 0;
+        const int animations = reader.readCount();
+        for (int i = 0; i < animations && reader.ok; i ++)
+        {
+            tileset.animations.push_back(MapCacheAnimation());
+            MapCacheAnimation &animation = tileset.animations.back();
+            animation.gid = reader.readInt();
+            animation.fromProperties = reader.readInt() != 0;
+            const int frames = reader.readCount();
+            for (int k = 0; k < frames && reader.ok; k ++)
+            {
+                const int tile = reader.readInt();
+                animation.frames.push_back(MapCacheFrame(tile,
+                    reader.readInt()));
+            }
+        }
+    }
+
+    count = reader.readCount();
+    for (int f = 0; f < count && reader.ok; f ++)
+    {
+        mLayers.push_back(MapCacheLayer());
+        MapCacheLayer &layer = mLayers.back();
+        layer.name = reader.readString();
+        reader.readProperties(layer.properties);
+        layer.width = reader.readInt();
+        layer.height = reader.readInt();
+        layer.offsetX = reader.readInt();
+        layer.offsetY = reader.readInt();
+        layer.haveData = reader.readInt() != 0;
+        const int size = reader.readCount();
+        if (size > 0 && reader.ok)
+        {
+            // tiles not copied, data kept while cache exists
+            layer.cacheTiles = &data[reader.pos];
+            layer.cacheTilesSize = size;
+            reader.pos += size;
+        }
+    }
+
+    count = reader.readCount();
+    for (int f = 0; f < count && reader.ok; f ++)
+    {
+        mProperties.push_back(MapCacheProperties());
+        reader.readProperties(mProperties.back());
+    }
+
+    count = reader.readCount();
+    for (int f = 0; f < count && reader.ok; f ++)
+    {
+        mObjects.push_back(MapCacheObject());
+        MapCacheObject &object = mObjects.back();
+        object.type = reader.readString();
+        object.name = reader.readString();
+        object.destination = reader.readString();
+        object.x = reader.readInt();
+        object.y = reader.readInt();
+        object.width = reader.readInt();
+        object.height = reader.readInt();
+        object.offsetX = reader.readInt();
+        object.offsetY = reader.readInt();
+    }
+
+    count = reader.readCount();
+    for (int f = 0; f < count && reader.ok; f ++)
+    {
+        const int type = reader.readInt();
+        const int index = reader.readInt();
+        int size = 0;
+        switch (type)
+        {
+            case ENTRY_TILESET:
+                size = CAST_S32(mTilesets.size());
+                break;
+            case ENTRY_LAYER:
+                size = CAST_S32(mLayers.size());
+                break;
+            case ENTRY_PROPERTIES:
+                size = CAST_S32(mProperties.size());
+                break;
+            case ENTRY_OBJECT:
+                size = CAST_S32(mObjects.size());
+                break;
+            default:
+                break;
+        }
+        if (index < 0 || index >= size)
+            reader.ok = false;
+        else
+            mEntries.push_back(Entry(static_cast<EntryType>(type), index));
+    }
+
+    if (!reader.ok || reader.pos != CAST_S32(data.size()))
+    {
+        logger->log_r("Map cache broken: %s", mFileName.c_str());
+        clear();
+        return false;
+    }
+    mLoaded = true;
+    return true;
+}
+
+bool MapCache::save() const
+{
+    if (!mCacheable)
+        return false;
+
+    STD_VECTOR<int> data;
+    data.resize(HEADER_LENGTH);
+    data[HEADER_MAGIC] = cacheMagic;
+    data[HEADER_VERSION] = cacheVersion;
+    data[HEADER_SOURCES] = CAST_S32(getSourcesHash(mSources));
+
+    data.push_back(CAST_S32(mSources.size()));
+    FOR_EACH (STD_VECTOR<MapCacheSource>::const_iterator, it, mSources)
+        writeString(data, (*it).name);
+
+    data.push_back(mWidth);
+    data.push_back(mHeight);
+    data.push_back(mTileWidth);
+    data.push_back(mTileHeight);
+
+    data.push_back(CAST_S32(mTilesets.size()));
+    FOR_EACH (STD_VECTOR<MapCacheTileset>::const_iterator, it, mTilesets)
+    {
+        const MapCacheTileset &tileset = *it;
+        writeString(data, tileset.source);
+        writeString(data, tileset.image);
+        writeString(data, tileset.imageName);
+        writeProperties(data, tileset.properties);
+        data.push_back(tileset.firstGid);
+        data.push_back(tileset.margin);
+        data.push_back(tileset.spacing);
+        data.push_back(tileset.tileWidth);
+        data.push_back(tileset.tileHeight);
+        data.push_back(tileset.valid ? 1 : 0);
+        data.push_back(CAST_S32(tileset.animations.size()));
+        FOR_EACH (STD_VECTOR<MapCacheAnimation>::const_iterator,
+                  it2, tileset.animations)
+        {
+            const MapCacheAnimation &animation = *it2;
+            data.push_back(animation.gid);
+            data.push_back(animation.fromProperties ? 1 : 0);
+            data.push_back(CAST_S32(animation.frames.size()));
+            FOR_EACH (STD_VECTOR<MapCacheFrame>::const_iterator,
+                      it3, animation.frames)
+            {
+                data.push_back((*it3).tile);
+                data.push_back((*it3).delay);
+            }
+        }
+    }
+
+    data.push_back(CAST_S32(mLayers.size()));
+    FOR_EACH (STD_VECTOR<MapCacheLayer>::const_iterator, it, mLayers)
+    {
+        const MapCacheLayer &layer = *it;
+        writeString(data, layer.name);
+        writeProperties(data, layer.properties);
+        data.push_back(layer.width);
+        data.push_back(layer.height);
+        data.push_back(layer.offsetX);
+        data.push_back(layer.offsetY);
+        data.push_back(layer.haveData ? 1 : 0);
+        const int *const tiles = layer.getTiles();
+        const int size = layer.getTilesSize();
+        data.push_back(size);
+        if (size > 0)
+            data.insert(data.end(), tiles, tiles + size);
+    }
+
+    data.push_back(CAST_S32(mProperties.size()));
+    FOR_EACH (STD_VECTOR<MapCacheProperties>::const_iterator,
+              it, mProperties)
+    {
+        writeProperties(data, *it);
+    }
+
+    data.push_back(CAST_S32(mObjects.size()));
+    FOR_EACH (STD_VECTOR<MapCacheObject>::const_iterator, it, mObjects)
+    {
+        const MapCacheObject &object = *it;
+        writeString(data, object.type);
+        writeString(data, object.name);
+        writeString(data, object.destination);
+        data.push_back(object.x);
+        data.push_back(object.y);
+        data.push_back(object.width);
+        data.push_back(object.height);
+        data.push_back(object.offsetX);
+        data.push_back(object.offsetY);
+    }
+
+    data.push_back(CAST_S32(mEntries.size()));
+    FOR_EACH (STD_VECTOR<Entry>::const_iterator, it, mEntries)
+    {
+        data.push_back(CAST_S32((*it).type));
+        data.push_back((*it).index);
+    }
+    data[HEADER_CHECKSUM] = CAST_S32(getChecksum(&data[HEADER_LENGTH],
+        (data.size() - HEADER_LENGTH) * sizeof(int)));
+
+    const size_t pos = mFileName.rfind('/');
+    if (pos != std::string::npos &&
+        mkdir_r(mFileName.substr(0, pos).c_str()) != 0)
+    {
+        return false;
+    }
+
+    const std::string tempName = mFileName + ".tmp";
+    std::ofstream file;
+    file.open(tempName.c_str(), std::ios::out | std::ios::binary);
+    if (!file.is_open())
+    {
+        logger->log_r("Error opening map cache for writing: %s",
+            tempName.c_str());
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&data[0]),
+        data.size() * sizeof(int));
+    file.close();
+    if (!file)
+    {
+        ::remove(tempName.c_str());
+        return false;
+    }
+    ::remove(mFileName.c_str());
+    return Files::renameFile(tempName, mFileName) == 0;
+}
+
+std::string MapCache::getFileName(const std::string &mapName)
+{
+    std::string name = mapName;
+    replaceAll(name, "/", "_");
+    replaceAll(name, "\\", "_");
+    replaceAll(name, ":", "_");
+    const std::string realDir = VirtFs::getRealDir(mapName);
+    const unsigned int dirHash = getChecksum(realDir.c_str(),
+        realDir.size());
+    return pathJoin(settings.localDataDir, "mapcache",
+        strprintf("%s_%08x.bin", name.c_str(), dirHash));
+}
+
+bool MapCache::getSourceInfo(const std::string &mapName,
+                             int &size,
+                             int &time)
+{
+    size = 0;
+    time = 0;
+    const std::string realDir = VirtFs::getRealDir(mapName);
+    if (realDir.empty())
+        return false;
+    // map from archive checked by archive size and time
+    struct stat statbuf;
+    if (stat(pathJoin(realDir, mapName).c_str(), &statbuf) == 0 ||
+        stat(realDir.c_str(), &statbuf) == 0)
+    {
+        size = CAST_S32(statbuf.st_size);
+        time = CAST_S32(statbuf.st_mtime);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,348 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_MAPCACHE_H
+#define RESOURCES_MAP_MAPCACHE_H
+
+#include "utils/cast.h"
+#include "utils/vector.h"
+
+#include <string>
+
+#include "localconsts.h"
+
+typedef std::pair<std::string, std::string> MapCacheProperty;
+typedef STD_VECTOR<MapCacheProperty> MapCacheProperties;
+typedef MapCacheProperties::const_iterator MapCachePropertiesCIter;
+
+struct MapCacheFrame final
+{
+    MapCacheFrame(const int tile0,
+                  const int delay0) :
+        tile(tile0),
+        delay(delay0)
+    {
+    }
+
+    A_DEFAULT_COPY(MapCacheFrame)
+
+    int tile;
+    int delay;
+};
+
+struct MapCacheAnimation final
+{
+    MapCacheAnimation() :
+        frames(),
+        gid(0),
+        fromProperties(false)
+    {
+    }
+
+    A_DEFAULT_COPY(MapCacheAnimation)
+
+    STD_VECTOR<MapCacheFrame> frames;
+    int gid;
+    // animation set by tile properties, used only if map animations enabled
+    bool fromProperties;
+};
+
+struct MapCacheTileset final
+{
+    MapCacheTileset() :
+        source(),
+        image(),
+        imageName(),
+        properties(),
+        animations(),
+        firstGid(0),
+        margin(0),
+        spacing(0),
+        tileWidth(0),
+        tileHeight(0),
+        valid(true)
+    {
+    }
+
+    A_DEFAULT_COPY(MapCacheTileset)
+
+    // external tileset file, empty after tileset was read
+    std::string source;
+    std::string image;
+    std::string imageName;
+    MapCacheProperties properties;
+    STD_VECTOR<MapCacheAnimation> animations;
+    int firstGid;
+    int margin;
+    int spacing;
+    int tileWidth;
+    int tileHeight;
+    bool valid;
+};
+
+struct MapCacheLayer final
+{
+    MapCacheLayer() :
+        name(),
+        properties(),
+        tiles(),
+        cacheTiles(nullptr),
+        cacheTilesSize(0),
+        width(0),
+        height(0),
+        offsetX(0),
+        offsetY(0),
+        haveData(false)
+    {
+    }
+
+    A_DEFAULT_COPY(MapCacheLayer)
+
+    const int *getTiles() const A_WARN_UNUSED
+    {
+        if (cacheTiles != nullptr)
+            return cacheTiles;
+        return tiles.empty() ? nullptr : &tiles[0];
+    }
+
+    int getTilesSize() const A_WARN_UNUSED
+    {
+        if (cacheTiles != nullptr)
+            return cacheTilesSize;
+        return CAST_S32(tiles.size());
+    }
+
+    std::string name;
+    // layer properties what was before layer data
+    MapCacheProperties properties;
+    // tiles decoded from map file
+    STD_VECTOR<int> tiles;
+    // tiles inside of loaded cache file, used without copy
+    const int *cacheTiles;
+    int cacheTilesSize;
+    int width;
+    int height;
+    int offsetX;
+    int offsetY;
+    bool haveData;
+};
+
+struct MapCacheObject final
+{
+    MapCacheObject() :
+        type(),
+        name(),
+        destination(),
+        x(0),
+        y(0),
+        width(0),
+        height(0),
+        offsetX(0),
+        offsetY(0)
+    {
+    }
+
+    A_DEFAULT_COPY(MapCacheObject)
+
+    std::string type;
+    std::string name;
+    // target map of warp
+    std::string destination;
+    int x;
+    int y;
+    int width;
+    int height;
+    int offsetX;
+    int offsetY;
+};
+
+struct MapCacheSource final
+{
+    MapCacheSource(const std::string &name0,
+                   const int size0,
+                   const int time0) :
+        name(name0),
+        size(size0),
+        time(time0)
+    {
+    }
+
+    A_DEFAULT_COPY(MapCacheSource)
+
+    std::string name;
+    int size;
+    int time;
+};
+
+/**
+ * Compiled map. Keeps everything what needed for creating map: map
+ * properties, tilesets, decoded layer tiles and objects, in same order
+ * as in map file. Map created from it without parsing xml.
+ *
+ * Cache file is flat array of 32 bit values in native byte order. It is
+ * read in one block and used in place: layer tiles point into loaded
+ * data. Header holds format version, checksum of data and hash of
+ * names, sizes and modification times of map and external tileset
+ * files, so cache checked without parsing any source file. Cache not
+ * uses shared state and can be filled in any thread.
+ */
+class MapCache final
+{
+    public:
+        enum EntryType
+        {
+            ENTRY_TILESET = 0,
+            ENTRY_LAYER,
+            ENTRY_PROPERTIES,
+            ENTRY_OBJECT
+        };
+
+        struct Entry final
+        {
+            Entry(const EntryType type0,
+                  const int index0) :
+                type(type0),
+                index(index0)
+            {
+            }
+
+            A_DEFAULT_COPY(Entry)
+
+            EntryType type;
+            int index;
+        };
+
+        explicit MapCache(const std::string &mapName);
+
+        A_DELETE_COPY(MapCache)
+
+        /**
+         * Reads cache file. Returns false if file missing, broken or
+         * any of source files changed.
+         */
+        bool load();
+
+        bool save() const;
+
+        bool isLoaded() const noexcept2 A_WARN_UNUSED
+        { return mLoaded; }
+
+        /**
+         * Returns false if map or some of its tilesets not real files,
+         * so cache can not be checked.
+         */
+        bool isCacheable() const noexcept2 A_WARN_UNUSED
+        { return mCacheable; }
+
+        /**
+         * Adds file what map compiled from, like external tileset.
+         */
+        void addSource(const std::string &name);
+
+        void clear();
+
+        void setSize(const int width,
+                     const int height,
+                     const int tileWidth,
+                     const int tileHeight);
+
+        int getWidth() const noexcept2 A_WARN_UNUSED
+        { return mWidth; }
+
+        int getHeight() const noexcept2 A_WARN_UNUSED
+        { return mHeight; }
+
+        int getTileWidth() const noexcept2 A_WARN_UNUSED
+        { return mTileWidth; }
+
+        int getTileHeight() const noexcept2 A_WARN_UNUSED
+        { return mTileHeight; }
+
+        /**
+         * Adds new item at end of map and returns it.
+         */
+        MapCacheTileset &addTileset();
+
+        MapCacheLayer &addLayer();
+
+        MapCacheProperties &addProperties();
+
+        MapCacheObject &addObject();
+
+        const STD_VECTOR<Entry> &getEntries() const noexcept2 A_WARN_UNUSED
+        { return mEntries; }
+
+        STD_VECTOR<MapCacheTileset> &getTilesets() noexcept2 A_WARN_UNUSED
+        { return mTilesets; }
+
+        const STD_VECTOR<MapCacheTileset> &getTilesets() const noexcept2
+                                                         A_WARN_UNUSED
+        { return mTilesets; }
+
+        const STD_VECTOR<MapCacheLayer> &getLayers() const noexcept2
+                                                     A_WARN_UNUSED
+        { return mLayers; }
+
+        const STD_VECTOR<MapCacheProperties> &getProperties() const noexcept2
+                                                              A_WARN_UNUSED
+        { return mProperties; }
+
+        const STD_VECTOR<MapCacheObject> &getObjects() const noexcept2
+                                                       A_WARN_UNUSED
+        { return mObjects; }
+
+        /**
+         * Returns cache file name for map file from virtual fs.
+         * Same map from other data directory uses other cache file.
+         */
+        static std::string getFileName(const std::string &mapName)
+                                       A_WARN_UNUSED;
+
+        /**
+         * Gets size and modification time of map file, or of its
+         * archive. Returns false if map is not real file.
+         */
+        static bool getSourceInfo(const std::string &mapName,
+                                  int &size,
+                                  int &time);
+
+    private:
+        static unsigned int getSourcesHash(const STD_VECTOR<MapCacheSource>
+                                           &sources) A_WARN_UNUSED;
+
+        std::string mFileName;
+        // map file first, then external tilesets
+        STD_VECTOR<MapCacheSource> mSources;
+        // loaded cache file, layers tiles point into it
+        STD_VECTOR<int> mData;
+        STD_VECTOR<Entry> mEntries;
+        STD_VECTOR<MapCacheTileset> mTilesets;
+        STD_VECTOR<MapCacheLayer> mLayers;
+        STD_VECTOR<MapCacheProperties> mProperties;
+        STD_VECTOR<MapCacheObject> mObjects;
+        int mWidth;
+        int mHeight;
+        int mTileWidth;
+        int mTileHeight;
+        bool mLoaded;
+        bool mCacheable;
+};
+
+#endif  // RESOURCES_MAP_MAPCACHE_H
@@ -40,6 +40,7 @@ MapItem::MapItem() :
     mImage(nullptr),
     mComment(),
     mName(),
+    mDestination(),
     mType(MapItemType::EMPTY),
     mX(-1),
     mY(-1)
@@ -51,6 +52,7 @@ MapItem::MapItem(const int type) :
     mImage(nullptr),
     mComment(),
     mName(),
+    mDestination(),
     mType(type),
     mX(-1),
     mY(-1)
@@ -63,6 +65,7 @@ MapItem::MapItem(const int type,
     mImage(nullptr),
     mComment(comment),
     mName(),
+    mDestination(),
     mType(type),
     mX(-1),
     mY(-1)
@@ -77,6 +80,7 @@ MapItem::MapItem(const int type,
     mImage(nullptr),
     mComment(comment),
     mName(),
+    mDestination(),
     mType(type),
     mX(x),
     mY(y)
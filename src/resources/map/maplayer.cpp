@@ -32,6 +32,7 @@
 
 #include "gui/userpalette.h"
 
+#include "utils/delete2.h"
 #ifdef USE_OPENGL
 #include "utils/foreach.h"
 #endif  // USE_OPENGL
@@ -47,6 +48,12 @@
 
 #include "debug.h"
 
+namespace
+{
+    // size of static chunk side in tiles
+    const int chunkSize = 32;
+}  // namespace
+
 MapLayer::MapLayer(const std::string &name,
                    const int x,
                    const int y,
@@ -67,6 +74,8 @@ MapLayer::MapLayer(const std::string &name,
     mTempLayer(nullptr),
     mName(name),
     mTempRows(),
+    mChunks(),
+    mChunksWidth((width + chunkSize - 1) / chunkSize),
     mMask(mask),
     mTileCondition(tileCondition),
     mActorsFix(0),
@@ -86,6 +95,8 @@ MapLayer::~MapLayer()
     delete []mTiles;
     delete_all(mTempRows);
     mTempRows.clear();
+    delete_all(mChunks);
+    mChunks.clear();
 }
 
 void MapLayer::optionChanged(const std::string &value) restrict
@@ -365,8 +376,162 @@ void MapLayer::drawOGL(Graphics *const graphics) const restrict2
     }
     BLOCK_END("MapLayer::drawOGL")
 }
+
+void MapLayer::updateChunk(Graphics *const graphics,
+                           MapRowVertexes *const chunk,
+                           const int chunkX,
+                           const int chunkY) restrict
+{
+    const int startX = chunkX * chunkSize;
+    const int startY = chunkY * chunkSize;
+    const int endX = std::min(startX + chunkSize, mWidth);
+    const int endY = std::min(startY + chunkSize, mHeight);
+
+    Image *lastImage = nullptr;
+    ImageVertexes *imgVert = nullptr;
+    typedef std::map<int, ImageVertexes*> ImageVertexesMap;
+    ImageVertexesMap imgSet;
+
+    for (int y = startY; y < endY; y++)
+    {
+        const int yWidth = y * mWidth;
+        const int py0 = y * mapTileSize + mPixelY;
+        TileInfo *tilePtr = &mTiles[CAST_SIZE(startX + yWidth)];
+        for (int x = startX; x < endX; x++, tilePtr++)
+        {
+            if (!tilePtr->isEnabled)
+                continue;
+            Image *const img = (*tilePtr).image;
+            const int px = x * mapTileSize + mPixelX;
+            const int py = py0 - img->mBounds.h;
+            const GLuint imgGlImage = img->mGLImage;
+            if (mSpecialFlag ||
+                img->mBounds.h <= mapTileSize)
+            {
+                if ((lastImage == nullptr) ||
+                    lastImage->mGLImage != imgGlImage)
+                {
+                    if (img->mBounds.w > mapTileSize)
+                        imgSet.clear();
+
+                    if (imgSet.find(imgGlImage) != imgSet.end())
+                    {
+                        imgVert = imgSet[imgGlImage];
+                    }
+                    else
+                    {
+                        if (lastImage != nullptr)
+                            imgSet[lastImage->mGLImage] = imgVert;
+                        imgVert = new ImageVertexes;
+                        imgVert->ogl.init();
+                        imgVert->image = img;
+                        chunk->images.push_back(imgVert);
+                    }
+                }
+                lastImage = img;
+                graphics->calcTileVertexes(imgVert, lastImage, px, py);
+            }
+        }
+    }
+    FOR_EACH (MapRowImages::iterator, it, chunk->images)
+    {
+        graphics->finalize(*it);
+    }
+}
+
+void MapLayer::drawChunks(Graphics *const graphics,
+                          int startX,
+                          int startY,
+                          int endX,
+                          int endY,
+                          const int scrollX,
+                          const int scrollY) restrict2
+{
+    BLOCK_START("MapLayer::drawChunks")
+    startX -= mX;
+    startY -= mY;
+    endX -= mX;
+    endY -= mY;
+
+    if (startX < 0)
+        startX = 0;
+    if (startY < 0)
+        startY = 0;
+    if (endX > mWidth)
+        endX = mWidth;
+    if (endY > mHeight)
+        endY = mHeight;
+    if (startX >= endX || startY >= endY)
+    {
+        BLOCK_END("MapLayer::drawChunks")
+        return;
+    }
+
+    if (mChunks.empty())
+    {
+        mChunks.resize(mChunksWidth *
+            ((mHeight + chunkSize - 1) / chunkSize), nullptr);
+    }
+
+    const int chunkX1 = startX / chunkSize;
+    const int chunkY1 = startY / chunkSize;
+    const int chunkX2 = (endX - 1) / chunkSize;
+    const int chunkY2 = (endY - 1) / chunkSize;
+    bool pushed = false;
+
+    for (int chunkY = chunkY1; chunkY <= chunkY2; chunkY ++)
+    {
+        for (int chunkX = chunkX1; chunkX <= chunkX2; chunkX ++)
+        {
+            MapRowVertexes *&chunk = mChunks[chunkX +
+                chunkY * mChunksWidth];
+            if (chunk == nullptr)
+            {
+                // chunk vertexes must not depend on current clip area
+                if (!pushed)
+                {
+                    const ClipRect &clipArea = graphics->getTopClip();
+                    graphics->pushClipArea(Rect(-clipArea.xOffset,
+                        -clipArea.yOffset,
+                        clipArea.xOffset + clipArea.width,
+                        clipArea.yOffset + clipArea.height));
+                    pushed = true;
+                }
+                chunk = new MapRowVertexes;
+                updateChunk(graphics, chunk, chunkX, chunkY);
+            }
+        }
+    }
+    if (pushed)
+        graphics->popClipArea();
+
+    for (int chunkY = chunkY1; chunkY <= chunkY2; chunkY ++)
+    {
+        for (int chunkX = chunkX1; chunkX <= chunkX2; chunkX ++)
+        {
+            const MapRowImages &images = mChunks[chunkX +
+                chunkY * mChunksWidth]->images;
+            FOR_EACH (MapRowImages::const_iterator, it, images)
+                graphics->drawMovedTileVertexes(*it, -scrollX, -scrollY);
+        }
+    }
+    BLOCK_END("MapLayer::drawChunks")
+}
 #endif  // USE_OPENGL
 
+void MapLayer::invalidateChunk(const int index) restrict
+{
+    const int chunk = (index % mWidth) / chunkSize +
+        (index / mWidth) / chunkSize * mChunksWidth;
+    delete2(mChunks[chunk])
+}
+
+void MapLayer::clearChunks() restrict
+{
+    delete_all(mChunks);
+    mChunks.clear();
+}
+
 void MapLayer::drawSpecialLayer(Graphics *const graphics,
                                 const int y,
                                 const int startX,
@@ -477,9 +642,9 @@ void MapLayer::drawFringe(Graphics *const graphics,
             BLOCK_START("MapLayer::drawFringe drawmobs")
             // If drawing the fringe layer, make sure all actors above this
             // row of tiles have been drawn
-            while (ai != ai_end && (*ai)->getSortPixelY() <= y32s)
+            while (ai != ai_end && (*ai).sortY <= y32s)
             {
-                (*ai)->draw(graphics, -scrollX, -scrollY);
+                (*ai).actor->draw(graphics, -scrollX, -scrollY);
                 ++ ai;
             }
             BLOCK_END("MapLayer::drawFringe drawmobs")
@@ -503,9 +668,9 @@ void MapLayer::drawFringe(Graphics *const graphics,
             BLOCK_START("MapLayer::drawFringe drawmobs")
             // If drawing the fringe layer, make sure all actors above this
             // row of tiles have been drawn
-            while (ai != ai_end && (*ai)->getSortPixelY() <= y32s)
+            while (ai != ai_end && (*ai).sortY <= y32s)
             {
-                (*ai)->draw(graphics, -scrollX, -scrollY);
+                (*ai).actor->draw(graphics, -scrollX, -scrollY);
                 ++ ai;
             }
             BLOCK_END("MapLayer::drawFringe drawmobs")
@@ -523,9 +688,9 @@ void MapLayer::drawFringe(Graphics *const graphics,
             // If drawing the fringe layer, make sure all actors above this
             // row of tiles have been drawn
             while (ai != ai_end &&
-                   (*ai)->getSortPixelY() <= y32s)
+                   (*ai).sortY <= y32s)
             {
-                (*ai)->draw(graphics, -scrollX, -scrollY);
+                (*ai).actor->draw(graphics, -scrollX, -scrollY);
                 ++ ai;
             }
             BLOCK_END("MapLayer::drawFringe drawmobs")
@@ -600,9 +765,9 @@ void MapLayer::drawFringe(Graphics *const graphics,
             BLOCK_START("MapLayer::drawFringe drawmobs")
             // If drawing the fringe layer, make sure all actors above this
             // row of tiles have been drawn
-            while (ai != ai_end && (*ai)->getSortPixelY() <= y32s)
+            while (ai != ai_end && (*ai).sortY <= y32s)
             {
-                (*ai)->draw(graphics, -scrollX, -scrollY);
+                (*ai).actor->draw(graphics, -scrollX, -scrollY);
                 ++ ai;
             }
             BLOCK_END("MapLayer::drawFringe drawmobs")
@@ -658,7 +823,7 @@ void MapLayer::drawFringe(Graphics *const graphics,
         BLOCK_START("MapLayer::drawFringe drawmobs")
         while (ai != ai_end)
         {
-            (*ai)->draw(graphics, -scrollX, -scrollY);
+            (*ai).actor->draw(graphics, -scrollX, -scrollY);
             ++ai;
         }
         BLOCK_END("MapLayer::drawFringe drawmobs")
@@ -785,6 +950,7 @@ void MapLayer::updateConditionTiles(const MetaTile *const metaTiles,
             }
         }
     }
+    clearChunks();
 }
 
 void MapLayer::updateCache(const int width,
@@ -825,7 +991,8 @@ int MapLayer::calcMemoryLocal() const
 {
     return static_cast<int>(sizeof(MapLayer) +
         sizeof(TileInfo) * mWidth * mHeight +
-        sizeof(MapRowVertexes) * mTempRows.capacity());
+        sizeof(MapRowVertexes) * mTempRows.capacity() +
+        sizeof(MapRowVertexes*) * mChunks.capacity());
 }
 
 int MapLayer::calcMemoryChilds(const int level) const
@@ -85,9 +85,13 @@ class MapLayer final : public MemoryCounter, public ConfigListener
         /**
          * Set tile image with x + y * width already known.
          */
-        constexpr3 void setTile(const int index,
-                                Image *restrict const img) restrict
-        { mTiles[index].image = img; }
+        void setTile(const int index,
+                     Image *restrict const img) restrict
+        {
+            mTiles[index].image = img;
+            if (!mChunks.empty())
+                invalidateChunk(index);
+        }
 
         /**
          * Draws this layer to the given graphics context. The coordinates are
@@ -119,6 +123,20 @@ class MapLayer final : public MemoryCounter, public ConfigListener
                        int endY,
                        const int scrollX,
                        const int scrollY) restrict2 A_NONNULL(2);
+
+        /**
+         * Draws layer from static chunks of tiles vertexes.
+         * Chunks calculated once when first time visible, and moved by
+         * scroll offset on drawing. Used only if graphics can move
+         * vertexes.
+         */
+        void drawChunks(Graphics *restrict const graphics,
+                        int startX,
+                        int startY,
+                        int endX,
+                        int endY,
+                        const int scrollX,
+                        const int scrollY) restrict2 A_NONNULL(2);
 #endif  // USE_OPENGL
 
         void updateSDL(const Graphics *restrict const graphics,
@@ -158,13 +176,17 @@ class MapLayer final : public MemoryCounter, public ConfigListener
         void optionChanged(const std::string &restrict value)
                            restrict override final;
 
-        void setDrawLayerFlags(const MapTypeT &restrict n)
-                               restrict noexcept2
+        void setDrawLayerFlags(const MapTypeT &restrict n) restrict
         {
             mDrawLayerFlags = n;
-            mSpecialFlag = (mDrawLayerFlags != MapType::SPECIAL &&
+            const bool specialFlag = (mDrawLayerFlags != MapType::SPECIAL &&
                 mDrawLayerFlags != MapType::SPECIAL2 &&
                 mDrawLayerFlags != MapType::SPECIAL4);
+            if (specialFlag != mSpecialFlag)
+            {
+                mSpecialFlag = specialFlag;
+                clearChunks();
+            }
         }
 
         void setActorsFix(const int y) restrict noexcept2
@@ -217,6 +239,17 @@ class MapLayer final : public MemoryCounter, public ConfigListener
                               const int scrollX,
                               const int scrollY) const restrict;
 
+        void invalidateChunk(const int index) restrict;
+
+        void clearChunks() restrict;
+
+#ifdef USE_OPENGL
+        void updateChunk(Graphics *restrict const graphics,
+                         MapRowVertexes *restrict const chunk,
+                         const int chunkX,
+                         const int chunkY) restrict A_NONNULL(2, 3);
+#endif  // USE_OPENGL
+
     private:
         const int mX;
         const int mY;
@@ -231,6 +264,8 @@ class MapLayer final : public MemoryCounter, public ConfigListener
         const std::string mName;
         typedef STD_VECTOR<MapRowVertexes*> MapRows;
         MapRows mTempRows;
+        MapRows mChunks;
+        int mChunksWidth;
         int mMask;
         int mTileCondition;
         int mActorsFix;
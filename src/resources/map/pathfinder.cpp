@@ -0,0 +1,622 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2004-2009  The Mana World Development Team
+ *  Copyright (C) 2009-2010  The Mana Developers
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/pathfinder.h"
+
+#include "enums/resources/map/blockmask.h"
+
+#include "resources/map/metatile.h"
+
+#include "utils/cast.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "debug.h"
+
+namespace
+{
+    // open list bigger than this freed after search
+    const size_t maxOpenListCapacity = 4096U;
+}  // namespace
+
+PathFinder::PathFinder(MetaTile *const tiles,
+                       const int width,
+                       const int height) :
+    mTiles(tiles),
+    mWidth(width),
+    mHeight(height),
+    mOnClosedList(1),
+    mOnOpenList(2),
+    mOpenList(),
+    mNodes(0),
+    mJumpPointSearch(false)
+{
+}
+
+bool PathFinder::findPath(Path &restrict path,
+                          const int startX, const int startY,
+                          const int destX, const int destY,
+                          const unsigned char blockWalkMask,
+                          const int maxCost) restrict2
+{
+    mNodes = 0;
+
+    bool found;
+    // Jump point search use same rule for corners and walking,
+    // what true only if walls block walking.
+    if (mJumpPointSearch &&
+        (blockWalkMask & BlockMask::WALL) != 0)
+    {
+        found = findJumpPath(path,
+            startX, startY,
+            destX, destY,
+            blockWalkMask,
+            maxCost);
+    }
+    else
+    {
+        found = findTilePath(path,
+            startX, startY,
+            destX, destY,
+            blockWalkMask,
+            maxCost);
+    }
+
+    // dont keep memory of rare huge search
+    if (mOpenList.capacity() > maxOpenListCapacity)
+        STD_VECTOR<Location>().swap(mOpenList);
+    return found;
+}
+
+bool PathFinder::findTilePath(Path &restrict path,
+                              const int startX, const int startY,
+                              const int destX, const int destY,
+                              const unsigned char blockWalkMask,
+                              const int maxCost) restrict2
+{
+    BLOCK_START("PathFinder::findTilePath")
+    // The basic walking cost of a tile.
+    static const int basicCost = 100;
+    const int basicCost2 = 100 * 362 / 256;
+    const float basicCostF = 100.0 * 362 / 256;
+
+    if (startX >= mWidth || startY >= mHeight || startX < 0 || startY < 0)
+    {
+        BLOCK_END("PathFinder::findTilePath")
+        return false;
+    }
+
+    // Return when destination not walkable
+    if (!getWalk(destX, destY, blockWalkMask))
+    {
+        BLOCK_END("PathFinder::findTilePath")
+        return false;
+    }
+
+    // Reset starting tile's G cost to 0
+    MetaTile *const startTile = &mTiles[startX + startY * mWidth];
+    if (startTile == nullptr)
+    {
+        BLOCK_END("PathFinder::findTilePath")
+        return false;
+    }
+
+    startTile->Gcost = 0;
+
+    // Open list is a heap with open tiles sorted on F cost
+    mOpenList.clear();
+
+    // Add the start point to the open list
+    mOpenList.push_back(Location(startX, startY, startTile));
+
+    bool foundPath = false;
+
+    // Keep trying new open tiles until no more tiles to try or target found
+    while (!mOpenList.empty() && !foundPath)
+    {
+        // Take the location with the lowest F cost from the open list.
+        std::pop_heap(mOpenList.begin(), mOpenList.end());
+        const Location curr = mOpenList.back();
+        mOpenList.pop_back();
+
+        const MetaTile *const tile = curr.tile;
+
+        // If the tile is already on the closed list, this means it has already
+        // been processed with a shorter path to the start point (lower G cost)
+        if (tile->whichList == mOnClosedList)
+            continue;
+
+        // Put the current tile on the closed list
+        curr.tile->whichList = mOnClosedList;
+        mNodes ++;
+
+        const int curWidth = curr.y * mWidth;
+        const int tileGcost = tile->Gcost;
+
+        // Check the adjacent tiles
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            const int y = curr.y + dy;
+            if (y < 0 || y >= mHeight)
+                continue;
+
+            const int yWidth = y * mWidth;
+            const int dy1 = std::abs(y - destY);
+
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                // Calculate location of tile to check
+                const int x = curr.x + dx;
+
+                // Skip if if we're checking the same tile we're leaving from,
+                // or if the new location falls outside of the map boundaries
+                if ((dx == 0 && dy == 0) || x < 0 || x >= mWidth)
+                    continue;
+
+                MetaTile *const newTile = &mTiles[x + yWidth];
+
+                // Skip if the tile is on the closed list or is not walkable
+                // unless its the destination tile
+                // +++ probably here "newTile->blockmask & BlockMask::WALL"
+                // can be removed. It left here only for protect from
+                // walk on wall in any case
+                if (newTile->whichList == mOnClosedList ||
+                    (((newTile->blockmask & blockWalkMask) != 0)
+                    && !(x == destX && y == destY))
+                    || ((newTile->blockmask & BlockMask::WALL) != 0))
+                {
+                    continue;
+                }
+
+                // When taking a diagonal step, verify that we can skip the
+                // corner.
+                if (dx != 0 && dy != 0)
+                {
+                    const MetaTile *const t1 = &mTiles[curr.x +
+                        (curr.y + dy) * mWidth];
+                    const MetaTile *const t2 = &mTiles[curr.x +
+                        dx + curWidth];
+
+                    // on player abilities.
+                    if (((t1->blockmask | t2->blockmask) & blockWalkMask) != 0)
+                        continue;
+                }
+
+                // Calculate G cost for this route, ~sqrt(2) for moving diagonal
+                int Gcost = tileGcost + (dx == 0 || dy == 0
+                    ? basicCost : basicCost2);
+
+                /* Demote an arbitrary direction to speed pathfinding by
+                   adding a defect
+                   Important: as long as the total defect along any path is
+                   less than the basicCost, the pathfinder will still find one
+                   of the shortest paths! */
+                if (dx == 0 || dy == 0)
+                {
+                    // Demote horizontal and vertical directions, so that two
+                    // consecutive directions cannot have the same Fcost.
+                    ++Gcost;
+                }
+
+/*
+                // It costs extra to walk through a being (needs to be enough
+                // to make it more attractive to walk around).
+                if (occupied(x, y))
+                {
+                    Gcost += 3 * basicCost;
+                }
+*/
+
+                // Skip if Gcost becomes too much
+                // Warning: probably not entirely accurate
+                if (maxCost > 0 && Gcost > maxCost * basicCost)
+                    continue;
+
+                if (newTile->whichList != mOnOpenList)
+                {
+                    // Found a new tile (not on open nor on closed list)
+
+                    /* Update Hcost of the new tile. The pathfinder does not
+                       work reliably if the heuristic cost is higher than the
+                       real cost. In particular, using Manhattan distance is
+                       forbidden here. */
+                    const int dx1 = std::abs(x - destX);
+                    newTile->Hcost = std::abs(dx1 - dy1) * basicCost +
+                        CAST_S32(static_cast<float>(std::min(dx1, dy1)) *
+                        (basicCostF));
+
+                    // Set the current tile as the parent of the new tile
+                    newTile->parentX = curr.x;
+                    newTile->parentY = curr.y;
+
+                    // Update Gcost and Fcost of new tile
+                    newTile->Gcost = Gcost;
+                    newTile->Fcost = Gcost + newTile->Hcost;
+
+                    if (x != destX || y != destY)
+                    {
+                        // Add this tile to the open list
+                        newTile->whichList = mOnOpenList;
+                        mOpenList.push_back(Location(x, y, newTile));
+                        std::push_heap(mOpenList.begin(), mOpenList.end());
+                    }
+                    else
+                    {
+                        // Target location was found
+                        foundPath = true;
+                    }
+                }
+                else if (Gcost < newTile->Gcost)
+                {
+                    // Found a shorter route.
+                    // Update Gcost and Fcost of the new tile
+                    newTile->Gcost = Gcost;
+                    newTile->Fcost = Gcost + newTile->Hcost;
+
+                    // Set the current tile as the parent of the new tile
+                    newTile->parentX = curr.x;
+                    newTile->parentY = curr.y;
+
+                    // Add this tile to the open list (it's already
+                    // there, but this instance has a lower F score)
+                    mOpenList.push_back(Location(x, y, newTile));
+                    std::push_heap(mOpenList.begin(), mOpenList.end());
+                }
+            }
+        }
+    }
+
+    nextLists();
+
+    // If a path has been found, iterate backwards using the parent locations
+    // to extract it.
+    if (foundPath)
+    {
+        int pathX = destX;
+        int pathY = destY;
+        const size_t pathStart = path.size();
+
+        while (pathX != startX || pathY != startY)
+        {
+            // Add the new path node to the end of the path and reverse
+            // added nodes later
+            path.push_back(Position(pathX, pathY));
+
+            // Find out the next parent
+            const MetaTile *const tile = &mTiles[pathX + pathY * mWidth];
+            pathX = tile->parentX;
+            pathY = tile->parentY;
+        }
+        std::reverse(path.begin() + pathStart, path.end());
+    }
+
+    BLOCK_END("PathFinder::findTilePath")
+    return foundPath;
+}
+
+bool PathFinder::findJumpPath(Path &restrict path,
+                              const int startX, const int startY,
+                              const int destX, const int destY,
+                              const unsigned char blockWalkMask,
+                              const int maxCost) restrict2
+{
+    BLOCK_START("PathFinder::findJumpPath")
+    static const int basicCost = 100;
+    const int basicCost2 = 100 * 362 / 256;
+    const float basicCostF = 100.0 * 362 / 256;
+
+    if (startX >= mWidth || startY >= mHeight || startX < 0 || startY < 0 ||
+        !getWalk(destX, destY, blockWalkMask) ||
+        (startX == destX && startY == destY))
+    {
+        BLOCK_END("PathFinder::findJumpPath")
+        return false;
+    }
+
+    const int limit = maxCost > 0 ? maxCost * basicCost : INT_MAX;
+
+    MetaTile *const startTile = &mTiles[startX + startY * mWidth];
+    startTile->Gcost = 0;
+    startTile->parentX = startX;
+    startTile->parentY = startY;
+
+    mOpenList.clear();
+    mOpenList.push_back(Location(startX, startY, startTile));
+
+    bool foundPath = false;
+
+    while (!mOpenList.empty())
+    {
+        std::pop_heap(mOpenList.begin(), mOpenList.end());
+        const Location curr = mOpenList.back();
+        mOpenList.pop_back();
+
+        MetaTile *const tile = curr.tile;
+        if (tile->whichList == mOnClosedList)
+            continue;
+        tile->whichList = mOnClosedList;
+        mNodes ++;
+
+        if (curr.x == destX && curr.y == destY)
+        {
+            foundPath = true;
+            break;
+        }
+
+        // Directions to check. Start tile checks all neighbours,
+        // other tiles only continue move from parent and check
+        // neighbours what can be reached only from this tile.
+        int dirs[8][2];
+        int dirsCount = 0;
+        const int x = curr.x;
+        const int y = curr.y;
+        const int moveX = x - tile->parentX;
+        const int moveY = y - tile->parentY;
+        const int dirX = moveX > 0 ? 1 : (moveX < 0 ? -1 : 0);
+        const int dirY = moveY > 0 ? 1 : (moveY < 0 ? -1 : 0);
+        if (dirX == 0 && dirY == 0)
+        {
+            for (int dy = -1; dy <= 1; dy ++)
+            {
+                for (int dx = -1; dx <= 1; dx ++)
+                {
+                    if (dx == 0 && dy == 0)
+                        continue;
+                    dirs[dirsCount][0] = dx;
+                    dirs[dirsCount][1] = dy;
+                    dirsCount ++;
+                }
+            }
+        }
+        else if (dirX != 0 && dirY != 0)
+        {
+            const bool walkX = getWalk(x + dirX, y, blockWalkMask);
+            const bool walkY = getWalk(x, y + dirY, blockWalkMask);
+            if (walkX)
+            {
+                dirs[dirsCount][0] = dirX;
+                dirs[dirsCount][1] = 0;
+                dirsCount ++;
+            }
+            if (walkY)
+            {
+                dirs[dirsCount][0] = 0;
+                dirs[dirsCount][1] = dirY;
+                dirsCount ++;
+            }
+            if (walkX && walkY)
+            {
+                dirs[dirsCount][0] = dirX;
+                dirs[dirsCount][1] = dirY;
+                dirsCount ++;
+            }
+        }
+        else
+        {
+            // side directions perpendicular to move
+            const int sideX = dirY;
+            const int sideY = dirX;
+            const bool walkNext = getWalk(x + dirX, y + dirY,
+                blockWalkMask);
+            dirs[dirsCount][0] = dirX;
+            dirs[dirsCount][1] = dirY;
+            dirsCount ++;
+            for (int side = -1; side <= 1; side += 2)
+            {
+                if (!getWalk(x + sideX * side, y + sideY * side,
+                    blockWalkMask))
+                {
+                    continue;
+                }
+                dirs[dirsCount][0] = sideX * side;
+                dirs[dirsCount][1] = sideY * side;
+                dirsCount ++;
+                if (walkNext)
+                {
+                    dirs[dirsCount][0] = dirX + sideX * side;
+                    dirs[dirsCount][1] = dirY + sideY * side;
+                    dirsCount ++;
+                }
+            }
+        }
+
+        const int tileGcost = tile->Gcost;
+        for (int f = 0; f < dirsCount; f ++)
+        {
+            const int dx = dirs[f][0];
+            const int dy = dirs[f][1];
+            if (dx != 0 && dy != 0 &&
+                (!getWalk(x + dx, y, blockWalkMask) ||
+                !getWalk(x, y + dy, blockWalkMask)))
+            {
+                continue;
+            }
+            int jumpX = x + dx;
+            int jumpY = y + dy;
+            if (!findJumpPoint(jumpX, jumpY,
+                dx, dy,
+                destX, destY,
+                blockWalkMask,
+                limit - tileGcost))
+            {
+                continue;
+            }
+
+            const int steps = std::max(std::abs(jumpX - x),
+                std::abs(jumpY - y));
+            const int Gcost = tileGcost + steps * (dx == 0 || dy == 0
+                ? basicCost + 1 : basicCost2);
+            if (maxCost > 0 && Gcost > limit)
+                continue;
+
+            MetaTile *const newTile = &mTiles[jumpX + jumpY * mWidth];
+            if (newTile->whichList == mOnClosedList)
+                continue;
+            if (newTile->whichList != mOnOpenList)
+            {
+                const int dx1 = std::abs(jumpX - destX);
+                const int dy1 = std::abs(jumpY - destY);
+                newTile->Hcost = std::abs(dx1 - dy1) * basicCost +
+                    CAST_S32(static_cast<float>(std::min(dx1, dy1)) *
+                    (basicCostF));
+                newTile->whichList = mOnOpenList;
+            }
+            else if (Gcost >= newTile->Gcost)
+            {
+                continue;
+            }
+            newTile->parentX = x;
+            newTile->parentY = y;
+            newTile->Gcost = Gcost;
+            newTile->Fcost = Gcost + newTile->Hcost;
+            mOpenList.push_back(Location(jumpX, jumpY, newTile));
+            std::push_heap(mOpenList.begin(), mOpenList.end());
+        }
+    }
+
+    nextLists();
+
+    // Jump points connected by straight or diagonal lines,
+    // fill path with all tiles between them.
+    if (foundPath)
+    {
+        int pathX = destX;
+        int pathY = destY;
+        const size_t pathStart = path.size();
+
+        while (pathX != startX || pathY != startY)
+        {
+            const MetaTile *const tile = &mTiles[pathX + pathY * mWidth];
+            const int parentX = tile->parentX;
+            const int parentY = tile->parentY;
+            const int stepX = parentX > pathX ? 1 : (parentX < pathX ? -1 : 0);
+            const int stepY = parentY > pathY ? 1 : (parentY < pathY ? -1 : 0);
+            while (pathX != parentX || pathY != parentY)
+            {
+                path.push_back(Position(pathX, pathY));
+                pathX += stepX;
+                pathY += stepY;
+            }
+        }
+        std::reverse(path.begin() + pathStart, path.end());
+    }
+
+    BLOCK_END("PathFinder::findJumpPath")
+    return foundPath;
+}
+
+bool PathFinder::findJumpPoint(int &restrict x,
+                               int &restrict y,
+                               const int dirX,
+                               const int dirY,
+                               const int destX,
+                               const int destY,
+                               const unsigned char blockWalkMask,
+                               const int maxCost) const restrict2
+{
+    const bool diagonal = dirX != 0 && dirY != 0;
+    const int stepCost = diagonal ? 100 * 362 / 256 : 101;
+    int cost = stepCost;
+
+    while (cost <= maxCost && getWalk(x, y, blockWalkMask))
+    {
+        if (x == destX && y == destY)
+            return true;
+
+        if (diagonal)
+        {
+            // tile is jump point if straight move from it finds jump point
+            int x1 = x + dirX;
+            int y1 = y;
+            if (findJumpPoint(x1, y1, dirX, 0, destX, destY,
+                blockWalkMask, maxCost - cost))
+            {
+                return true;
+            }
+            x1 = x;
+            y1 = y + dirY;
+            if (findJumpPoint(x1, y1, 0, dirY, destX, destY,
+                blockWalkMask, maxCost - cost))
+            {
+                return true;
+            }
+            // corner cutting not allowed
+            if (!getWalk(x + dirX, y, blockWalkMask) ||
+                !getWalk(x, y + dirY, blockWalkMask))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // forced neighbour: side tile walkable but tile behind it not
+            const int sideX = dirY;
+            const int sideY = dirX;
+            if ((getWalk(x + sideX, y + sideY, blockWalkMask) &&
+                !getWalk(x + sideX - dirX, y + sideY - dirY,
+                blockWalkMask)) ||
+                (getWalk(x - sideX, y - sideY, blockWalkMask) &&
+                !getWalk(x - sideX - dirX, y - sideY - dirY,
+                blockWalkMask)))
+            {
+                return true;
+            }
+        }
+        x += dirX;
+        y += dirY;
+        cost += stepCost;
+    }
+    return false;
+}
+
+bool PathFinder::getWalk(const int x,
+                         const int y,
+                         const unsigned char blockWalkMask) const restrict2
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+        return false;
+    return (mTiles[x + y * mWidth].blockmask & blockWalkMask) == 0;
+}
+
+void PathFinder::nextLists() restrict2
+{
+    // Two new values to indicate whether a tile is on the open or closed list,
+    // this way we don't have to clear all the values between each pathfinding.
+    if (mOnOpenList > UINT_MAX - 2)
+    {
+        // We reset the list memebers value.
+        mOnClosedList = 1;
+        mOnOpenList = 2;
+
+        // Clean up the metaTiles
+        const int size = mWidth * mHeight;
+        for (int i = 0; i < size; ++i)
+            mTiles[i].whichList = 0;
+    }
+    else
+    {
+        mOnClosedList += 2;
+        mOnOpenList += 2;
+    }
+}
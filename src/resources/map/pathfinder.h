@@ -0,0 +1,125 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2004-2009  The Mana World Development Team
+ *  Copyright (C) 2009-2010  The Mana Developers
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_PATHFINDER_H
+#define RESOURCES_MAP_PATHFINDER_H
+
+#include "position.h"
+
+#include "resources/map/location.h"
+
+#include "utils/cast.h"
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+struct MetaTile;
+
+/**
+ * Tile path search (A* or jump point search) over MetaTile array.
+ * Search state stored in tiles and open list kept between searches,
+ * so each tiles array must have own PathFinder.
+ */
+class PathFinder final
+{
+    public:
+        PathFinder(MetaTile *const tiles,
+                   const int width,
+                   const int height);
+
+        A_DELETE_COPY(PathFinder)
+
+        /**
+         * Find a path and append it to given path.
+         * Returns false if path not found.
+         */
+        bool findPath(Path &restrict path,
+                      const int startX, const int startY,
+                      const int destX, const int destY,
+                      const unsigned char blockWalkmask,
+                      const int maxCost) restrict2;
+
+        void setJumpPointSearch(const bool b) noexcept2
+        { mJumpPointSearch = b; }
+
+        /**
+         * Returns number of tiles expanded by last search.
+         */
+        int getNodes() const noexcept2 A_WARN_UNUSED
+        { return mNodes; }
+
+        int getOpenListCapacity() const A_WARN_UNUSED
+        { return CAST_S32(mOpenList.capacity()); }
+
+    private:
+        /**
+         * Find a path using plain A*.
+         */
+        bool findTilePath(Path &restrict path,
+                          const int startX, const int startY,
+                          const int destX, const int destY,
+                          const unsigned char blockWalkmask,
+                          const int maxCost) restrict2;
+
+        /**
+         * Find a path using jump point search.
+         * All tiles have same walk cost.
+         */
+        bool findJumpPath(Path &restrict path,
+                          const int startX, const int startY,
+                          const int destX, const int destY,
+                          const unsigned char blockWalkmask,
+                          const int maxCost) restrict2;
+
+        /**
+         * Moves from x, y in given direction until jump point found.
+         * Returns false if reached blocked tile or maxCost.
+         */
+        bool findJumpPoint(int &restrict x,
+                           int &restrict y,
+                           const int dirX,
+                           const int dirY,
+                           const int destX,
+                           const int destY,
+                           const unsigned char blockWalkmask,
+                           const int maxCost) const restrict2;
+
+        bool getWalk(const int x,
+                     const int y,
+                     const unsigned char blockWalkmask) const
+                     restrict2 A_WARN_UNUSED;
+
+        void nextLists() restrict2;
+
+        MetaTile *const mTiles;
+        const int mWidth;
+        const int mHeight;
+        unsigned int mOnClosedList;
+        unsigned int mOnOpenList;
+        // open list heap, kept between searches
+        STD_VECTOR<Location> mOpenList;
+        int mNodes;
+        bool mJumpPointSearch;
+};
+
+#endif  // RESOURCES_MAP_PATHFINDER_H
@@ -21,13 +21,39 @@
 
 #include "resources/map/walklayer.h"
 
+#include "resources/map/metatile.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+
+#include <climits>
+
 #include "debug.h"
 
-WalkLayer::WalkLayer(const int width, const int height) :
+namespace
+{
+    int findGroup(const int *const groups,
+                  int group)
+    {
+        while (groups[group] != group)
+            group = groups[group];
+        return group;
+    }
+}  // namespace
+
+WalkLayer::WalkLayer(const int width,
+                     const int height,
+                     const unsigned char blockWalkMask) :
     Resource(),
     mWidth(width),
     mHeight(height),
-    mTiles(new int[width * height])
+    mTiles(new int[width * height]),
+    mBlockWalkMask(blockWalkMask),
+    mSizes(1, 0),
+    mVisitStamp(),
+    mVisitGroup(),
+    mQueues(),
+    mStamp(0)
 {
     std::fill_n(mTiles, width * height, 0);
 }
@@ -44,9 +70,324 @@ int WalkLayer::getDataAt(const int x, const int y) const
     return mTiles[x + y * mWidth];
 }
 
+void WalkLayer::calcAreaSizes()
+{
+    const int size = mWidth * mHeight;
+    int maxNum = 0;
+    for (int f = 0; f < size; f ++)
+    {
+        if (mTiles[f] > maxNum)
+            maxNum = mTiles[f];
+    }
+    mSizes.assign(maxNum + 1, 0);
+    for (int f = 0; f < size; f ++)
+    {
+        const int num = mTiles[f];
+        if (num > 0)
+            mSizes[num] ++;
+    }
+}
+
+void WalkLayer::updateTile(const MetaTile *const tiles,
+                           const int x,
+                           const int y)
+{
+    if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+        return;
+    const int tile = x + y * mWidth;
+    const bool walkable = (tiles[tile].blockmask & mBlockWalkMask) == 0;
+    if (walkable == (mTiles[tile] > 0))
+        return;
+    if (walkable)
+        addWalkTile(tile);
+    else
+        removeWalkTile(tile);
+}
+
+int WalkLayer::getNeighbour(const int tile,
+                            const int dir) const
+{
+    const int x = tile % mWidth;
+    switch (dir)
+    {
+        case 0:
+            return x > 0 ? tile - 1 : -1;
+        case 1:
+            return x < mWidth - 1 ? tile + 1 : -1;
+        case 2:
+            return tile >= mWidth ? tile - mWidth : -1;
+        case 3:
+        default:
+            return tile + mWidth < mWidth * mHeight ? tile + mWidth : -1;
+    }
+}
+
+void WalkLayer::addWalkTile(const int tile)
+{
+    // join biggest area near tile, and relabel other areas
+    int num = 0;
+    int numSize = -1;
+    for (int dir = 0; dir < 4; dir ++)
+    {
+        const int near = getNeighbour(tile, dir);
+        if (near < 0)
+            continue;
+        const int nearNum = mTiles[near];
+        if (nearNum > 0 && mSizes[nearNum] > numSize)
+        {
+            num = nearNum;
+            numSize = mSizes[nearNum];
+        }
+    }
+    if (num == 0)
+    {
+        num = CAST_S32(mSizes.size());
+        mSizes.push_back(0);
+    }
+
+    mTiles[tile] = num;
+    mSizes[num] ++;
+    for (int dir = 0; dir < 4; dir ++)
+    {
+        const int near = getNeighbour(tile, dir);
+        if (near < 0)
+            continue;
+        const int nearNum = mTiles[near];
+        if (nearNum > 0)
+        {
+            if (nearNum != num)
+                relabel(near, num);
+        }
+        else
+        {
+            mTiles[near] = -num;
+        }
+    }
+}
+
+void WalkLayer::removeWalkTile(const int tile)
+{
+    const int num = mTiles[tile];
+    mSizes[num] --;
+
+    int starts[4];
+    int startsCount = 0;
+    for (int dir = 0; dir < 4; dir ++)
+    {
+        const int near = getNeighbour(tile, dir);
+        if (near >= 0 && mTiles[near] == num)
+        {
+            starts[startsCount] = near;
+            startsCount ++;
+        }
+    }
+    // blocked tiles near removed tile may reference area only by it
+    mTiles[tile] = 0;
+    markBlocked(tile);
+    for (int dir = 0; dir < 4; dir ++)
+    {
+        const int near = getNeighbour(tile, dir);
+        if (near >= 0 && mTiles[near] <= 0)
+            markBlocked(near);
+    }
+    // area with only one tile near removed tile can't be split
+    if (startsCount <= 1)
+        return;
+
+    const int size = mWidth * mHeight;
+    if (CAST_S32(mVisitStamp.size()) != size)
+    {
+        mVisitStamp.assign(size, 0);
+        mVisitGroup.assign(size, 0);
+        mStamp = 0;
+    }
+    if (mStamp == INT_MAX)
+    {
+        std::fill(mVisitStamp.begin(), mVisitStamp.end(), 0);
+        mStamp = 0;
+    }
+    mStamp ++;
+
+    // search from each tile near removed tile at same time.
+    // groups what met each other joined. Search stops when all
+    // groups except one visited all tiles in own part of area.
+    int groups[4];
+    size_t heads[4];
+    for (int f = 0; f < startsCount; f ++)
+    {
+        groups[f] = f;
+        heads[f] = 0U;
+        mQueues[f].clear();
+        mQueues[f].push_back(starts[f]);
+        mVisitStamp[starts[f]] = mStamp;
+        mVisitGroup[starts[f]] = CAST_U8(f);
+    }
+
+    int keepGroup = -1;
+    for (;;)
+    {
+        int rootsCount = 0;
+        int activeCount = 0;
+        int activeRoot = -1;
+        for (int f = 0; f < startsCount; f ++)
+        {
+            if (findGroup(groups, f) != f)
+                continue;
+            rootsCount ++;
+            for (int k = 0; k < startsCount; k ++)
+            {
+                if (findGroup(groups, k) == f && heads[k] < mQueues[k].size())
+                {
+                    activeCount ++;
+                    activeRoot = f;
+                    break;
+                }
+            }
+        }
+        // all parts connected
+        if (rootsCount == 1)
+            return;
+        if (activeCount <= 1)
+        {
+            keepGroup = activeRoot;
+            break;
+        }
+
+        for (int f = 0; f < startsCount; f ++)
+        {
+            STD_VECTOR<int> &queue = mQueues[f];
+            if (heads[f] >= queue.size())
+                continue;
+            const int current = queue[heads[f]];
+            heads[f] ++;
+            for (int dir = 0; dir < 4; dir ++)
+            {
+                const int near = getNeighbour(current, dir);
+                if (near < 0 || mTiles[near] != num)
+                    continue;
+                if (mVisitStamp[near] == mStamp)
+                {
+                    const int group1 = findGroup(groups, f);
+                    const int group2 = findGroup(groups, mVisitGroup[near]);
+                    if (group1 != group2)
+                        groups[group2] = group1;
+                    continue;
+                }
+                mVisitStamp[near] = mStamp;
+                mVisitGroup[near] = CAST_U8(f);
+                queue.push_back(near);
+            }
+        }
+    }
+
+    // all parts visited, keep old number for biggest one
+    if (keepGroup < 0)
+    {
+        size_t keepSize = 0U;
+        for (int f = 0; f < startsCount; f ++)
+        {
+            if (findGroup(groups, f) != f)
+                continue;
+            size_t partSize = 0U;
+            for (int k = 0; k < startsCount; k ++)
+            {
+                if (findGroup(groups, k) == f)
+                    partSize += mQueues[k].size();
+            }
+            if (partSize > keepSize)
+            {
+                keepSize = partSize;
+                keepGroup = f;
+            }
+        }
+    }
+
+    for (int f = 0; f < startsCount; f ++)
+    {
+        if (findGroup(groups, f) != f || f == keepGroup)
+            continue;
+        const int newNum = CAST_S32(mSizes.size());
+        mSizes.push_back(0);
+        for (int k = 0; k < startsCount; k ++)
+        {
+            if (findGroup(groups, k) != f)
+                continue;
+            const STD_VECTOR<int> &queue = mQueues[k];
+            FOR_EACH (STD_VECTOR<int>::const_iterator, it, queue)
+            {
+                mTiles[*it] = newNum;
+                markBlockedNear(*it, num, newNum);
+            }
+            mSizes[newNum] += CAST_S32(queue.size());
+            mSizes[num] -= CAST_S32(queue.size());
+        }
+    }
+}
+
+void WalkLayer::relabel(const int tile,
+                        const int num)
+{
+    const int oldNum = mTiles[tile];
+    STD_VECTOR<int> &queue = mQueues[0];
+    queue.clear();
+    queue.push_back(tile);
+    mTiles[tile] = num;
+    for (size_t f = 0; f < queue.size(); f ++)
+    {
+        const int current = queue[f];
+        for (int dir = 0; dir < 4; dir ++)
+        {
+            const int near = getNeighbour(current, dir);
+            if (near < 0)
+                continue;
+            if (mTiles[near] == oldNum)
+            {
+                mTiles[near] = num;
+                queue.push_back(near);
+            }
+            else if (mTiles[near] == -oldNum)
+            {
+                mTiles[near] = -num;
+            }
+        }
+    }
+    mSizes[num] += CAST_S32(queue.size());
+    mSizes[oldNum] -= CAST_S32(queue.size());
+}
+
+void WalkLayer::markBlocked(const int tile)
+{
+    mTiles[tile] = 0;
+    for (int dir = 0; dir < 4; dir ++)
+    {
+        const int near = getNeighbour(tile, dir);
+        if (near >= 0 && mTiles[near] > 0)
+        {
+            mTiles[tile] = -mTiles[near];
+            return;
+        }
+    }
+}
+
+void WalkLayer::markBlockedNear(const int tile,
+                                const int oldNum,
+                                const int num)
+{
+    for (int dir = 0; dir < 4; dir ++)
+    {
+        const int near = getNeighbour(tile, dir);
+        if (near >= 0 && mTiles[near] == -oldNum)
+            mTiles[near] = -num;
+    }
+}
+
 int WalkLayer::calcMemoryLocal() const
 {
     return Resource::calcMemoryLocal() +
         static_cast<int>(sizeof(WalkLayer) +
-        sizeof(int) * mWidth * mHeight);
+        sizeof(int) * mWidth * mHeight +
+        sizeof(int) * (mSizes.capacity() + mVisitStamp.capacity() +
+        mQueues[0].capacity() + mQueues[1].capacity() +
+        mQueues[2].capacity() + mQueues[3].capacity()) +
+        mVisitGroup.capacity());
 }
@@ -24,12 +24,27 @@
 
 #include "resources/resource.h"
 
+#include "utils/vector.h"
+
 #include "localconsts.h"
 
+struct MetaTile;
+
+/**
+ * Connected walkable areas of map.
+ *
+ * Walkable tiles store positive area number, blocked tiles near area
+ * store negative area number. Numbers updated incrementally when block
+ * mask of tile changed: merged areas relabeled from smaller area, and
+ * for split areas searches started from all neighbours of blocked tile
+ * at same time, so only smaller parts visited.
+ */
 class WalkLayer final : public Resource
 {
     public:
-        WalkLayer(const int width, const int height);
+        WalkLayer(const int width,
+                  const int height,
+                  const unsigned char blockWalkMask);
 
         A_DELETE_COPY(WalkLayer)
 
@@ -40,15 +55,56 @@ class WalkLayer final : public Resource
 
         int getDataAt(const int x, const int y) const;
 
+        /**
+         * Counts tiles in each area after data was filled.
+         */
+        void calcAreaSizes();
+
+        /**
+         * Updates areas after block mask of tile x, y changed.
+         */
+        void updateTile(const MetaTile *const tiles,
+                        const int x,
+                        const int y) A_NONNULL(2);
+
+        unsigned char getBlockWalkMask() const noexcept2 A_WARN_UNUSED
+        { return mBlockWalkMask; }
+
         int calcMemoryLocal() const override final;
 
         std::string getCounterName() const override final
         { return "walk layer"; }
 
     private:
+        void addWalkTile(const int tile);
+
+        void removeWalkTile(const int tile);
+
+        void relabel(const int tile,
+                     const int num);
+
+        void markBlocked(const int tile);
+
+        void markBlockedNear(const int tile,
+                             const int oldNum,
+                             const int num);
+
+        int getNeighbour(const int tile,
+                         const int dir) const A_WARN_UNUSED;
+
         int mWidth;
         int mHeight;
         int *mTiles;
+        unsigned char mBlockWalkMask;
+
+        // tiles count in each area, index is area number
+        STD_VECTOR<int> mSizes;
+
+        // search buffers kept between updates
+        STD_VECTOR<int> mVisitStamp;
+        STD_VECTOR<unsigned char> mVisitGroup;
+        STD_VECTOR<int> mQueues[4];
+        int mStamp;
 };
 
 #endif  // RESOURCES_MAP_WALKLAYER_H
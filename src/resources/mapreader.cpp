@@ -28,15 +28,18 @@
 #include "graphicsmanager.h"
 #endif  // USE_OPENGL
 #include "main.h"
+#include "navigationmanager.h"
 
 #include "const/resources/map/map.h"
 
 #include "enums/resources/map/collisiontype.h"
+#include "enums/resources/map/maplayertype.h"
 #include "enums/resources/map/mapitemtype.h"
 
 #include "fs/virtfs/fs.h"
 
 #include "resources/map/map.h"
+#include "resources/map/mapcache.h"
 #include "resources/map/mapheights.h"
 #include "resources/map/maplayer.h"
 #include "resources/map/tileset.h"
@@ -62,9 +65,15 @@
 #include "utils/checkutils.h"
 #include "utils/delete2.h"
 #include "utils/stringmap.h"
+#include "utils/threadpool.h"
 
 #include "utils/translation/podict.h"
 
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_timer.h>
+PRAGMA48(GCC diagnostic pop)
+
 #include <zlib.h>
 
 #include "debug.h"
@@ -80,6 +89,28 @@ namespace
 {
     std::map<std::string, XmlNodePtr> mKnownLayers;
     std::set<XML::Document*> mKnownDocs;
+    // pool for layers decoding, kept between map loads
+    ThreadPool *mThreadPool = nullptr;
+
+    struct LayerDecodeJob final
+    {
+        LayerDecodeJob() :
+            node(),
+            compression(),
+            tiles(),
+            csv(false),
+            decoded(false)
+        {
+        }
+
+        A_DEFAULT_COPY(LayerDecodeJob)
+
+        XmlNodePtr node;
+        std::string compression;
+        STD_VECTOR<int> tiles;
+        bool csv;
+        bool decoded;
+    };
 }  // namespace
 
 static int inflateMemory(unsigned char *restrict const in,
@@ -263,31 +294,62 @@ Map *MapReader::readMap(const std::string &restrict filename,
 {
     BLOCK_START("MapReader::readMap str")
     logger->log("Attempting to read map %s", realFilename.c_str());
+    const uint32_t startTime = SDL_GetTicks();
 
-    XML::Document doc(realFilename, UseVirtFs_true, SkipError_false);
-    if (!doc.isLoaded())
+    // cache checked by size and time of source files, without reading them
+    MapCache cache(realFilename);
+    const bool useCache = config.getBoolValue("enableMapCache") &&
+        cache.isCacheable();
+    if (useCache && cache.load())
     {
-        BLOCK_END("MapReader::readMap str")
-        return createEmptyMap(filename, realFilename);
+        logger->log("Using map cache for %s", realFilename.c_str());
     }
+    else
+    {
+        int size = 0;
+        char *const data = const_cast<char*>(VirtFs::loadFile(
+            realFilename,
+            size));
+        if (data == nullptr)
+        {
+            reportAlways("Error loading map file %s", realFilename.c_str())
+            BLOCK_END("MapReader::readMap str")
+            return createEmptyMap(filename, realFilename);
+        }
 
-    XmlNodePtrConst node = doc.rootNode();
+        XML::Document doc(data, size);
+        delete [] data;
+        if (!doc.isLoaded())
+        {
+            BLOCK_END("MapReader::readMap str")
+            return createEmptyMap(filename, realFilename);
+        }
 
-    Map *map = nullptr;
-    // Parse the inflated map data
-    if (node != nullptr)
-    {
+        XmlNodePtrConst node = doc.rootNode();
+        if (node == nullptr)
+        {
+            reportAlways("Error while parsing map file (%s)!",
+                realFilename.c_str())
+            BLOCK_END("MapReader::readMap str")
+            return nullptr;
+        }
         if (!xmlNameEqual(node, "map"))
+        {
             logger->log("Error: Not a map file (%s)!", realFilename.c_str());
-        else
-            map = readMap(node, realFilename);
-    }
-    else
-    {
-        reportAlways("Error while parsing map file (%s)!",
-            realFilename.c_str())
+            BLOCK_END("MapReader::readMap str")
+            return nullptr;
+        }
+        if (!compileMap(node, realFilename, cache, false))
+        {
+            BLOCK_END("MapReader::readMap str")
+            return nullptr;
+        }
+        compileTilesets(cache, false);
+        if (useCache)
+            cache.save();
     }
 
+    Map *const map = buildMap(cache, realFilename);
     if (map != nullptr)
     {
         map->setProperty("_filename", realFilename);
@@ -298,6 +360,13 @@ Map *MapReader::readMap(const std::string &restrict filename,
 
         map->updateConditionLayers();
         map->preCacheLayers();
+
+        logger->log("Map %s loaded in %u ms (parallel decoding: %s,"
+            " map cache: %s)",
+            realFilename.c_str(),
+            CAST_U32(SDL_GetTicks() - startTime),
+            config.getBoolValue("enableParallelMapLoad") ? "on" : "off",
+            cache.isLoaded() ? "hit" : "miss");
     }
 
     BLOCK_END("MapReader::readMap str")
@@ -327,12 +396,187 @@ static void loadReplaceLayer(const LayerInfoIterator &it,
     MapReader::readLayer((*it).second, map);
 }
 
-Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
+static unsigned char *decodeBase64(const char *const xmlChars,
+                                   int &binLen) A_NONNULL(1);
+
+static unsigned char *decodeBase64(const char *const xmlChars,
+                                   int &binLen)
 {
-    if (node == nullptr)
-        return nullptr;
+    const size_t len = strlen(xmlChars) + 1;
+    unsigned char *charData = new unsigned char[len + 1];
+    const char *charStart = xmlChars;
+    unsigned char *charIndex = charData;
+
+    while (*charStart != 0)
+    {
+        if (*charStart != ' ' &&
+            *charStart != '\t' &&
+            *charStart != '\n')
+        {
+            *charIndex = *charStart;
+            charIndex++;
+        }
+        charStart++;
+    }
+    *charIndex = '\0';
+
+    unsigned char *binData = php3_base64_decode(charData,
+        CAST_S32(strlen(reinterpret_cast<char*>(
+        charData))), &binLen);
+
+    delete [] charData;
+    return binData;
+}
+
+/**
+ * Decodes layer data to tile ids without touching map.
+ * Called from pool threads, so errors not reported here. Layers what
+ * failed decoding read again on main thread with error messages.
+ */
+static void decodeLayerJob(void *const data,
+                           const int index)
+{
+    LayerDecodeJob &job = *(*static_cast<STD_VECTOR<LayerDecodeJob*>*>(
+        data))[index];
+    if (!XmlHaveChildContent(job.node))
+    {
+        job.decoded = true;
+        return;
+    }
+    const char *const xmlChars = XmlChildContent(job.node);
+    if (xmlChars == nullptr)
+        return;
+
+    if (job.csv)
+    {
+        // same as readCsvLayer, only values followed by comma used
+        const char *start = xmlChars;
+        const char *pos = strchr(start, ',');
+        while (pos != nullptr)
+        {
+            job.tiles.push_back(atoi(start));
+            start = pos + 1;
+            pos = strchr(start, ',');
+        }
+        job.decoded = true;
+        return;
+    }
+
+    int binLen = 0;
+    unsigned char *binData = decodeBase64(xmlChars, binLen);
+    if (binData == nullptr)
+        return;
+    if (!job.compression.empty())
+    {
+        unsigned char *inflated = nullptr;
+        unsigned int inflatedSize = 0;
+        const int ret = inflateMemory(binData, binLen,
+            inflated, inflatedSize);
+        free(binData);
+        if (ret != Z_OK || inflated == nullptr)
+        {
+            free(inflated);
+            return;
+        }
+        binData = inflated;
+        binLen = CAST_S32(inflatedSize);
+    }
+
+    job.tiles.reserve(binLen / 4);
+    for (int i = 0; i < binLen - 3; i += 4)
+    {
+        job.tiles.push_back(binData[i] |
+            binData[i + 1] << 8 |
+            binData[i + 2] << 16 |
+            binData[i + 3] << 24);
+    }
+    free(binData);
+    job.decoded = true;
+}
+
+/**
+ * Decodes data of all map layers on pool threads. Jobs indexed same
+ * as layers in map file. Background decoding done in calling thread.
+ */
+static void decodeLayers(XmlNodePtrConst node,
+                         STD_VECTOR<LayerDecodeJob> &jobs,
+                         const bool background)
+{
+    BLOCK_START("MapReader::decodeLayers")
+    STD_VECTOR<int> indexes;
+    for_each_xml_child_node(childNode, node)
+    {
+        if (!xmlNameEqual(childNode, "layer"))
+            continue;
+        jobs.push_back(LayerDecodeJob());
+        for_each_xml_child_node(dataNode, childNode)
+        {
+            if (!xmlNameEqual(dataNode, "data"))
+                continue;
+            const std::string encoding =
+                XML::getProperty(dataNode, "encoding", "");
+            const std::string compression =
+                XML::getProperty(dataNode, "compression", "");
+            if ((encoding == "base64" &&
+                (compression.empty() ||
+                compression == "gzip" ||
+                compression == "zlib")) ||
+                encoding == "csv")
+            {
+                LayerDecodeJob &job = jobs.back();
+                job.node = dataNode;
+                job.compression = compression;
+                job.csv = (encoding == "csv");
+                indexes.push_back(CAST_S32(jobs.size()) - 1);
+            }
+            break;
+        }
+    }
+
+    STD_VECTOR<LayerDecodeJob*> active;
+    FOR_EACH (STD_VECTOR<int>::const_iterator, it, indexes)
+        active.push_back(&jobs[*it]);
+    if (background)
+    {
+        for (int f = 0; f < CAST_S32(active.size()); f ++)
+            decodeLayerJob(&active, f);
+    }
+    else if (active.size() > 1)
+    {
+        if (mThreadPool == nullptr)
+        {
+            mThreadPool = new ThreadPool(
+                ThreadPool::getDefaultThreadsCount(7));
+        }
+        mThreadPool->run(&decodeLayerJob, &active, CAST_S32(active.size()));
+    }
+    else if (!active.empty())
+    {
+        decodeLayerJob(&active, 0);
+    }
+    BLOCK_END("MapReader::decodeLayers")
+}
+
+bool MapReader::compileMap(const char *const data,
+                           const int size,
+                           const std::string &realFilename,
+                           MapCache &cache)
+{
+    XML::Document doc(data, size);
+    XmlNodePtrConst node = doc.rootNode();
+    if (node == nullptr || !xmlNameEqual(node, "map"))
+        return false;
+    return compileMap(node, realFilename, cache, true);
+}
+
+bool MapReader::compileMap(XmlNodePtrConst node,
+                           const std::string &path,
+                           MapCache &cache,
+                           const bool background)
+{
+    BLOCK_START("MapReader::compileMap")
+    cache.clear();
 
-    BLOCK_START("MapReader::readMap xml")
     // Take the filename off the path
     const std::string pathDir = path.substr(0, path.rfind('/') + 1);
 
@@ -341,24 +585,169 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
     const int tilew = XML::getProperty(node, "tilewidth", -1);
     const int tileh = XML::getProperty(node, "tileheight", -1);
 
-    const bool showWarps = config.getBoolValue("warpParticle");
-    const std::string warpPath = pathJoin(paths.getStringValue("particles"),
-        paths.getStringValue("portalEffectFile"));
-
     if (tilew < 0 || tileh < 0)
     {
-        reportAlways("MapReader: Warning: "
-            "Uninitialized tile width or height value for map: %s",
-            path.c_str())
-        BLOCK_END("MapReader::readMap xml")
-        return nullptr;
+        if (!background)
+        {
+            reportAlways("MapReader: Warning: "
+                "Uninitialized tile width or height value for map: %s",
+                path.c_str())
+        }
+        BLOCK_END("MapReader::compileMap")
+        return false;
+    }
+    cache.setSize(w, h, tilew, tileh);
+
+    STD_VECTOR<LayerDecodeJob> decodeJobs;
+    if (background)
+        decodeLayers(node, decodeJobs, true);
+    else if (config.getBoolValue("enableParallelMapLoad"))
+        decodeLayers(node, decodeJobs, false);
+
+    int layerIndex = 0;
+    for_each_xml_child_node(childNode, node)
+    {
+        if (xmlNameEqual(childNode, "tileset"))
+        {
+            MapCacheTileset &tileset = cache.addTileset();
+            tileset.firstGid = XML::getProperty(childNode, "firstgid", 0);
+            tileset.margin = XML::getProperty(childNode, "margin", 0);
+            tileset.spacing = XML::getProperty(childNode, "spacing", 0);
+            if (XmlHasProp(childNode, "source"))
+            {
+                // external tileset read later by compileTilesets
+                tileset.source = resolveRelativePath(pathDir,
+                    XML::getProperty(childNode, "source", ""));
+            }
+            else
+            {
+                compileTileset(childNode, pathDir, tilew, tileh,
+                    background, tileset);
+            }
+        }
+        else if (xmlNameEqual(childNode, "layer"))
+        {
+            const STD_VECTOR<int> *decodedTiles = nullptr;
+            if (layerIndex < CAST_S32(decodeJobs.size()) &&
+                decodeJobs[layerIndex].decoded)
+            {
+                decodedTiles = &decodeJobs[layerIndex].tiles;
+            }
+            if (!compileLayer(childNode, w, h, decodedTiles, background,
+                cache.addLayer()))
+            {
+                BLOCK_END("MapReader::compileMap")
+                return false;
+            }
+            layerIndex ++;
+        }
+        else if (xmlNameEqual(childNode, "properties"))
+        {
+            readProperties(childNode, cache.addProperties());
+        }
+        else if (xmlNameEqual(childNode, "objectgroup"))
+        {
+            // The object group offset is applied to each object individually
+            const int offsetX = XML::getProperty(childNode, "x", 0) * tilew;
+            const int offsetY = XML::getProperty(childNode, "y", 0) * tileh;
+
+            for_each_xml_child_node(objectNode, childNode)
+            {
+                if (!xmlNameEqual(objectNode, "object"))
+                    continue;
+                MapCacheObject &object = cache.addObject();
+                object.type = XML::getProperty(objectNode, "type", "");
+                toUpper(object.type);
+                object.name = XML::getProperty(objectNode, "name", "");
+                object.x = XML::getProperty(objectNode, "x", 0);
+                object.y = XML::getProperty(objectNode, "y", 0);
+                object.width = XML::getProperty(objectNode, "width", 0);
+                object.height = XML::getProperty(objectNode, "height", 0);
+                object.offsetX = offsetX;
+                object.offsetY = offsetY;
+                for_each_xml_child_node(propsNode, objectNode)
+                {
+                    if (!xmlNameEqual(propsNode, "properties"))
+                        continue;
+                    for_each_xml_child_node(propNode, propsNode)
+                    {
+                        if (xmlNameEqual(propNode, "property") &&
+                            XML::getProperty(propNode, "name", "") ==
+                            "dest_map")
+                        {
+                            object.destination = XML::getProperty(
+                                propNode, "value", "");
+                        }
+                    }
+                }
+            }
+        }
+    }
+    BLOCK_END("MapReader::compileMap")
+    return true;
+}
+
+void MapReader::compileTilesets(MapCache &cache,
+                                const bool background)
+{
+    STD_VECTOR<MapCacheTileset> &tilesets = cache.getTilesets();
+    FOR_EACH (STD_VECTOR<MapCacheTileset>::iterator, it, tilesets)
+    {
+        MapCacheTileset &tileset = *it;
+        if (tileset.source.empty())
+            continue;
+        const std::string filename = tileset.source;
+        tileset.source.clear();
+        cache.addSource(filename);
+
+        // file loaded here, because XML::Document logs loading errors
+        int size = 0;
+        const char *const data = VirtFs::loadFile(filename, size);
+        if (data == nullptr)
+        {
+            if (!background)
+            {
+                reportAlways("MapReader: Error loading tileset %s",
+                    filename.c_str())
+            }
+            tileset.valid = false;
+            continue;
+        }
+        XML::Document doc(data, size);
+        delete [] data;
+        XmlNodePtrConst node = doc.rootNode();
+        if (node == nullptr)
+        {
+            tileset.valid = false;
+            continue;
+        }
+        // paths in tileset are realtive to the tsx file
+        compileTileset(node,
+            filename.substr(0, filename.rfind('/') + 1),
+            cache.getTileWidth(),
+            cache.getTileHeight(),
+            background,
+            tileset);
     }
+}
+
+Map *MapReader::buildMap(const MapCache &cache,
+                         const std::string &path)
+{
+    BLOCK_START("MapReader::readMap xml")
+    const int tilew = cache.getTileWidth();
+    const int tileh = cache.getTileHeight();
+
+    const bool showWarps = config.getBoolValue("warpParticle");
+    const bool showParticles = config.getBoolValue("mapparticleeffects");
+    const std::string warpPath = pathJoin(paths.getStringValue("particles"),
+        paths.getStringValue("portalEffectFile"));
 
     logger->log("loading replace layer list");
     loadLayers(path + "_replace.d");
 
     Map *const map = new Map(path,
-        w, h,
+        cache.getWidth(), cache.getHeight(),
         tilew, tileh);
 
     map->screenResized();
@@ -386,124 +775,122 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
     BLOCK_END("MapReader::readMap load atlas")
 #endif  // USE_OPENGL
 
-    for_each_xml_child_node(childNode, node)
+    const STD_VECTOR<MapCache::Entry> &entries = cache.getEntries();
+    FOR_EACH (STD_VECTOR<MapCache::Entry>::const_iterator, it, entries)
     {
-        if (xmlNameEqual(childNode, "tileset"))
-        {
-            Tileset *const tileset = readTileset(childNode, pathDir, map);
-            if (tileset != nullptr)
-                map->addTileset(tileset);
-        }
-        else if (xmlNameEqual(childNode, "layer"))
+        const int index = (*it).index;
+        switch ((*it).type)
         {
-            std::string name = XML::getProperty(childNode, "name", "");
-            name = toLower(name);
-            LayerInfoIterator it = mKnownLayers.find(name);
-            if (it == mKnownLayers.end())
+            case MapCache::ENTRY_TILESET:
             {
-                readLayer(childNode, map);
+                Tileset *const tileset = buildTileset(
+                    cache.getTilesets()[index], map);
+                if (tileset != nullptr)
+                    map->addTileset(tileset);
+                break;
             }
-            else
+            case MapCache::ENTRY_LAYER:
             {
-                logger->log("load replace layer: " + name);
-                loadReplaceLayer(it, map);
+                const MapCacheLayer &layer = cache.getLayers()[index];
+                LayerInfoIterator it2 = mKnownLayers.find(layer.name);
+                if (it2 == mKnownLayers.end())
+                {
+                    buildLayer(layer, map);
+                }
+                else
+                {
+                    logger->log("load replace layer: " + layer.name);
+                    loadReplaceLayer(it2, map);
+                }
+                break;
             }
-        }
-        else if (xmlNameEqual(childNode, "properties"))
-        {
-            readProperties(childNode, map);
-            map->setVersion(atoi(map->getProperty(
-                "manaplus version", std::string()).c_str()));
-        }
-        else if (xmlNameEqual(childNode, "objectgroup"))
-        {
-            // The object group offset is applied to each object individually
-            const int tileOffsetX = XML::getProperty(childNode, "x", 0);
-            const int tileOffsetY = XML::getProperty(childNode, "y", 0);
-            const int offsetX = tileOffsetX * tilew;
-            const int offsetY = tileOffsetY * tileh;
-            const bool showParticles =
-                config.getBoolValue("mapparticleeffects");
-
-            for_each_xml_child_node(objectNode, childNode)
+            case MapCache::ENTRY_PROPERTIES:
             {
-                if (xmlNameEqual(objectNode, "object"))
+                const MapCacheProperties &props =
+                    cache.getProperties()[index];
+                FOR_EACH (MapCachePropertiesCIter, it2, props)
                 {
-                    std::string objType = XML::getProperty(
-                        objectNode, "type", "");
-
-                    objType = toUpper(objType);
-
-/*
-                    if (objType == "NPC" ||
-                        objType == "SCRIPT")
+                    const std::string &name = (*it2).first;
+                    if (name == "name")
                     {
-                        logger->log("hidden obj: " + objType);
-                        // Silently skip server-side objects.
-                        continue;
+                        map->setProperty(name,
+                            translator->getStr((*it2).second));
                     }
-*/
-
-                    const std::string objName = XML::getProperty(
-                        objectNode, "name", "");
-                    const int objX = XML::getProperty(objectNode, "x", 0);
-                    const int objY = XML::getProperty(objectNode, "y", 0);
-                    const int objW = XML::getProperty(objectNode, "width", 0);
-                    const int objH = XML::getProperty(objectNode, "height", 0);
-
-                    logger->log("- Loading object name: %s type: %s at %d:%d"
-                        " (%dx%d)", objName.c_str(), objType.c_str(),
-                        objX, objY, objW, objH);
-
-                    if (objType == "PARTICLE_EFFECT")
+                    else
                     {
-                        if (objName.empty())
-                        {
-                            logger->log1("   Warning: No particle file given");
-                            continue;
-                        }
-
-                        if (showParticles)
-                        {
-                            map->addParticleEffect(objName,
-                                objX + offsetX,
-                                objY + offsetY,
-                                objW,
-                                objH);
-                        }
-                        else
-                        {
-                            logger->log("Ignore particle effect: " + objName);
-                        }
+                        map->setProperty(name, (*it2).second);
                     }
-                    else if (objType == "WARP")
+                }
+                map->setVersion(atoi(map->getProperty(
+                    "manaplus version", std::string()).c_str()));
+                break;
+            }
+            case MapCache::ENTRY_OBJECT:
+            {
+                const MapCacheObject &object = cache.getObjects()[index];
+                const std::string &objType = object.type;
+                const std::string &objName = object.name;
+                const int objX = object.x;
+                const int objY = object.y;
+                const int objW = object.width;
+                const int objH = object.height;
+
+                logger->log("- Loading object name: %s type: %s at %d:%d"
+                    " (%dx%d)", objName.c_str(), objType.c_str(),
+                    objX, objY, objW, objH);
+
+                if (objType == "PARTICLE_EFFECT")
+                {
+                    if (objName.empty())
                     {
-                        if (showWarps)
-                        {
-                            map->addParticleEffect(warpPath,
-                                objX, objY, objW, objH);
-                        }
-                        map->addPortal(objName, MapItemType::PORTAL,
-                                       objX, objY, objW, objH);
+                        logger->log1("   Warning: No particle file given");
+                        break;
                     }
-                    else if (objType == "SPAWN")
+
+                    if (showParticles)
                     {
-                        // TRANSLATORS: spawn name
-//                      map->addPortal(_("Spawn: ") + objName,
-//                            MapItemType::PORTAL,
-//                            objX, objY, objW, objH);
+                        map->addParticleEffect(objName,
+                            objX + object.offsetX,
+                            objY + object.offsetY,
+                            objW,
+                            objH);
                     }
-                    else if (objType == "MUSIC")
+                    else
                     {
-                        map->addRange(objName, MapItemType::MUSIC,
-                            objX, objY, objW, objH);
+                        logger->log("Ignore particle effect: " + objName);
                     }
-                    else
+                }
+                else if (objType == "WARP")
+                {
+                    if (showWarps)
                     {
-                        logger->log1("   Warning: Unknown object type");
+                        map->addParticleEffect(warpPath,
+                            objX, objY, objW, objH);
                     }
+                    map->addPortal(objName, object.destination,
+                                   MapItemType::PORTAL,
+                                   objX, objY, objW, objH);
                 }
+                else if (objType == "SPAWN")
+                {
+                    // TRANSLATORS: spawn name
+//                  map->addPortal(_("Spawn: ") + objName,
+//                        MapItemType::PORTAL,
+//                        objX, objY, objW, objH);
+                }
+                else if (objType == "MUSIC")
+                {
+                    map->addRange(objName, MapItemType::MUSIC,
+                        objX, objY, objW, objH);
+                }
+                else
+                {
+                    logger->log1("   Warning: Unknown object type");
+                }
+                break;
             }
+            default:
+                break;
         }
     }
 
@@ -512,7 +899,8 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
     map->setActorsFix(0,
         atoi(map->getProperty("actorsfix", std::string()).c_str()));
     map->reduce();
-    map->setWalkLayer(Loader::getWalkLayer(fileName, map));
+    map->setWalkLayer(Loader::getWalkLayer(map));
+    map->setClusterGraph(NavigationManager::loadClusterGraph(map));
     unloadTempLayers();
     map->updateDrawLayersList();
     BLOCK_END("MapReader::readMap xml")
@@ -520,7 +908,7 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
 }
 
 void MapReader::readProperties(XmlNodeConstPtrConst node,
-                               Properties *const props)
+                               MapCacheProperties &props)
 {
     BLOCK_START("MapReader::readProperties")
     if (node == nullptr)
@@ -539,12 +927,7 @@ void MapReader::readProperties(XmlNodeConstPtrConst node,
         const std::string value = XML::getProperty(childNode, "value", "");
 
         if (!name.empty() && !value.empty())
-        {
-            if (name == "name")
-                props->setProperty(name, translator->getStr(value));
-            else
-                props->setProperty(name, value);
-        }
+            props.push_back(MapCacheProperty(name, value));
     }
     BLOCK_END("MapReader::readProperties")
 }
@@ -661,14 +1044,55 @@ inline static void setTile(Map *const map,
     }
 }
 
-bool MapReader::readBase64Layer(XmlNodeConstPtrConst childNode,
-                                Map *const map,
-                                MapLayer *const layer,
-                                const MapLayerTypeT &layerType,
-                                MapHeights *const heights,
-                                const std::string &compression,
-                                int &restrict x, int &restrict y,
-                                const int w, const int h)
+static void setTiles(Map *const map,
+                     MapLayer *const layer,
+                     const MapLayerTypeT &layerType,
+                     MapHeights *const heights,
+                     const int *const tiles,
+                     const int size,
+                     const int w, const int h) A_NONNULL(1, 5);
+
+static void setTiles(Map *const map,
+                     MapLayer *const layer,
+                     const MapLayerTypeT &layerType,
+                     MapHeights *const heights,
+                     const int *const tiles,
+                     const int size,
+                     const int w, const int h)
+{
+    const std::map<int, TileAnimation*> &tileAnimations
+        = map->getTileAnimations();
+    const bool hasAnimations = !tileAnimations.empty();
+    int x = 0;
+    int y = 0;
+    for (int f = 0; f < size; f ++)
+    {
+        const int gid = tiles[f];
+        setTile(map, layer, layerType, heights, x, y, gid);
+        if (hasAnimations)
+        {
+            TileAnimationMapCIter it = tileAnimations.find(gid);
+            if (it != tileAnimations.end())
+            {
+                TileAnimation *const ani = it->second;
+                if (ani != nullptr)
+                    ani->addAffectedTile(layer, x + y * w);
+            }
+        }
+
+        x++;
+        if (x == w)
+        {
+            x = 0; y++;
+            if (y == h)
+                break;
+        }
+    }
+}
+
+bool MapReader::readBase64Layer(XmlNodeConstPtrConst childNode,
+                                const std::string &compression,
+                                STD_VECTOR<int> &tiles)
 {
     if (childNode == nullptr)
         return false;
@@ -685,38 +1109,12 @@ bool MapReader::readBase64Layer(XmlNodeConstPtrConst childNode,
     if (!XmlHaveChildContent(childNode))
         return true;
 
-    const size_t len = strlen(XmlChildContent(childNode)) + 1;
-    unsigned char *charData = new unsigned char[len + 1];
     const char *const xmlChars = XmlChildContent(childNode);
-    const char *charStart = reinterpret_cast<const char*>(xmlChars);
-    if (charStart == nullptr)
-    {
-        delete [] charData;
+    if (xmlChars == nullptr)
         return false;
-    }
-
-    unsigned char *charIndex = charData;
-
-    while (*charStart != 0)
-    {
-        if (*charStart != ' ' &&
-            *charStart != '\t' &&
-            *charStart != '\n')
-        {
-            *charIndex = *charStart;
-            charIndex++;
-        }
-        charStart++;
-    }
-    *charIndex = '\0';
 
     int binLen;
-    unsigned char *binData = php3_base64_decode(charData,
-        CAST_S32(strlen(reinterpret_cast<char*>(
-        charData))), &binLen);
-
-    delete [] charData;
-//    XmlFree(const_cast<char*>(xmlChars));
+    unsigned char *binData = decodeBase64(xmlChars, binLen);
 
     if (binData != nullptr)
     {
@@ -738,60 +1136,13 @@ bool MapReader::readBase64Layer(XmlNodeConstPtrConst childNode,
             }
         }
 
-        const std::map<int, TileAnimation*> &tileAnimations
-            = map->getTileAnimations();
-
-        const bool hasAnimations = !tileAnimations.empty();
-        if (hasAnimations)
-        {
-            for (int i = 0; i < binLen - 3; i += 4)
-            {
-                const int gid = binData[i] |
-                    binData[i + 1] << 8 |
-                    binData[i + 2] << 16 |
-                    binData[i + 3] << 24;
-
-                setTile(map, layer, layerType, heights, x, y, gid);
-                TileAnimationMapCIter it = tileAnimations.find(gid);
-                if (it != tileAnimations.end())
-                {
-                    TileAnimation *const ani = it->second;
-                    if (ani != nullptr)
-                        ani->addAffectedTile(layer, x + y * w);
-                }
-
-                x++;
-                if (x == w)
-                {
-                    x = 0; y++;
-
-                    // When we're done, don't crash on too much data
-                    if (y == h)
-                        break;
-                }
-            }
-        }
-        else
+        tiles.reserve(binLen / 4);
+        for (int i = 0; i < binLen - 3; i += 4)
         {
-            for (int i = 0; i < binLen - 3; i += 4)
-            {
-                const int gid = binData[i] |
-                    binData[i + 1] << 8 |
-                    binData[i + 2] << 16 |
-                    binData[i + 3] << 24;
-
-                setTile(map, layer, layerType, heights, x, y, gid);
-
-                x++;
-                if (x == w)
-                {
-                    x = 0; y++;
-
-                    // When we're done, don't crash on too much data
-                    if (y == h)
-                        break;
-                }
-            }
+            tiles.push_back(binData[i] |
+                binData[i + 1] << 8 |
+                binData[i + 2] << 16 |
+                binData[i + 3] << 24);
         }
         free(binData);
     }
@@ -799,12 +1150,7 @@ bool MapReader::readBase64Layer(XmlNodeConstPtrConst childNode,
 }
 
 bool MapReader::readCsvLayer(XmlNodeConstPtrConst childNode,
-                             Map *const map,
-                             MapLayer *const layer,
-                             const MapLayerTypeT &layerType,
-                             MapHeights *const heights,
-                             int &restrict x, int &restrict y,
-                             const int w, const int h)
+                             STD_VECTOR<int> &tiles)
 {
     if (childNode == nullptr)
         return false;
@@ -817,81 +1163,99 @@ bool MapReader::readCsvLayer(XmlNodeConstPtrConst childNode,
     if (data == nullptr)
         return false;
 
+    // only values followed by comma used
     std::string csv(data);
     size_t oldPos = 0;
+    while (oldPos != std::string::npos)
+    {
+        const size_t pos = csv.find_first_of(',', oldPos);
+        if (pos == std::string::npos)
+            break;
 
-    const std::map<int, TileAnimation*> &tileAnimations
-        = map->getTileAnimations();
-    const bool hasAnimations = !tileAnimations.empty();
+        tiles.push_back(atoi(csv.substr(oldPos, pos - oldPos).c_str()));
+        oldPos = pos + 1;
+    }
+    return true;
+}
+
+bool MapReader::compileLayer(XmlNodeConstPtr node,
+                             const int mapWidth,
+                             const int mapHeight,
+                             const STD_VECTOR<int> *const decodedTiles,
+                             const bool background,
+                             MapCacheLayer &layer)
+{
+    // Layers are not necessarily the same size as the map
+    layer.width = XML::getProperty(node, "width", mapWidth);
+    layer.height = XML::getProperty(node, "height", mapHeight);
+    layer.offsetX = XML::getProperty(node, "x", 0);
+    layer.offsetY = XML::getProperty(node, "y", 0);
+    layer.name = XML::getProperty(node, "name", "");
+    toLower(layer.name);
 
-    if (hasAnimations)
+    for_each_xml_child_node(childNode, node)
     {
-        while (oldPos != std::string::npos)
+        if (xmlNameEqual(childNode, "properties"))
         {
-            const size_t pos = csv.find_first_of(',', oldPos);
-            if (pos == std::string::npos)
-                return false;
-
-            const int gid = atoi(csv.substr(oldPos, pos - oldPos).c_str());
-            setTile(map, layer, layerType, heights, x, y, gid);
-            TileAnimationMapCIter it = tileAnimations.find(gid);
-            if (it != tileAnimations.end())
+            for_each_xml_child_node(prop, childNode)
             {
-                TileAnimation *const ani = it->second;
-                if (ani != nullptr)
-                    ani->addAffectedTile(layer, x + y * w);
+                if (!xmlNameEqual(prop, "property"))
+                    continue;
+                layer.properties.push_back(MapCacheProperty(
+                    XML::getProperty(prop, "name", ""),
+                    XML::getProperty(prop, "value", "")));
             }
+        }
 
-            x++;
-            if (x == w)
-            {
-                x = 0; y++;
+        if (!xmlNameEqual(childNode, "data"))
+            continue;
 
-                // When we're done, don't crash on too much data
-                if (y == h)
-                    return false;
-            }
-            oldPos = pos + 1;
+        // There can be only one data element
+        layer.haveData = true;
+        if (decodedTiles != nullptr)
+        {
+            layer.tiles = *decodedTiles;
+            break;
         }
-    }
-    else
-    {
-        while (oldPos != std::string::npos)
+
+        const std::string encoding =
+            XML::getProperty(childNode, "encoding", "");
+        if (encoding == "base64" || encoding == "csv")
         {
-            const size_t pos = csv.find_first_of(',', oldPos);
-            if (pos == std::string::npos)
+            // errors reported only in main thread
+            if (background)
                 return false;
-
-            const int gid = atoi(csv.substr(oldPos, pos - oldPos).c_str());
-            setTile(map, layer, layerType, heights, x, y, gid);
-
-            x++;
-            if (x == w)
+            if (encoding == "base64")
             {
-                x = 0; y++;
-
-                // When we're done, don't crash on too much data
-                if (y == h)
-                    return false;
+                readBase64Layer(childNode,
+                    XML::getProperty(childNode, "compression", ""),
+                    layer.tiles);
             }
-            oldPos = pos + 1;
+            else
+            {
+                readCsvLayer(childNode, layer.tiles);
+            }
+            break;
+        }
+
+        // Read plain XML map file
+        for_each_xml_child_node(childNode2, childNode)
+        {
+            if (!xmlNameEqual(childNode2, "tile"))
+                continue;
+            layer.tiles.push_back(XML::getProperty(childNode2, "gid", -1));
         }
+        break;
     }
     return true;
 }
 
-void MapReader::readLayer(XmlNodeConstPtr node, Map *const map)
+void MapReader::buildLayer(const MapCacheLayer &layer,
+                           Map *const map)
 {
-    if (node == nullptr)
-        return;
-
-    // Layers are not necessarily the same size as the map
-    const int w = XML::getProperty(node, "width", map->getWidth());
-    const int h = XML::getProperty(node, "height", map->getHeight());
-    const int offsetX = XML::getProperty(node, "x", 0);
-    const int offsetY = XML::getProperty(node, "y", 0);
-    std::string name = XML::getProperty(node, "name", "");
-    name = toLower(name);
+    const std::string &name = layer.name;
+    const int w = layer.width;
+    const int h = layer.height;
 
     const bool isFringeLayer = (name.substr(0, 6) == "fringe");
     const bool isCollisionLayer = (name.substr(0, 9) == "collision");
@@ -911,250 +1275,129 @@ void MapReader::readLayer(XmlNodeConstPtr node, Map *const map)
 
     map->indexTilesets();
 
-    MapLayer *layer = nullptr;
+    MapLayer *mapLayer = nullptr;
     MapHeights *heights = nullptr;
 
     logger->log("- Loading layer \"%s\"", name.c_str());
-    int x = 0;
-    int y = 0;
 
-    // Load the tile data
-    for_each_xml_child_node(childNode, node)
+    FOR_EACH (MapCachePropertiesCIter, it, layer.properties)
     {
-        if (xmlNameEqual(childNode, "properties"))
+        const std::string &pname = (*it).first;
+        const std::string &value = (*it).second;
+        // ignoring any layer if property Hidden is 1
+        if (pname == "Hidden")
         {
-            for_each_xml_child_node(prop, childNode)
-            {
-                if (!xmlNameEqual(prop, "property"))
-                    continue;
-                const std::string pname = XML::getProperty(prop, "name", "");
-                const std::string value = XML::getProperty(prop, "value", "");
-                // ignoring any layer if property Hidden is 1
-                if (pname == "Hidden")
-                {
-                    if (value == "1")
-                        return;
-                }
-                else if (pname == "Version")
-                {
-                    if (value > CHECK_VERSION)
-                        return;
-                }
-                else if (pname == "NotVersion")
-                {
-                    if (value <= CHECK_VERSION)
-                        return;
-                }
-                else if (pname == "Mask")
-                {
-                    mask = atoi(value.c_str());
-                }
-                else if (pname == "TileCondition")
-                {
-                    tileCondition = atoi(value.c_str());
-                }
-                else if (pname == "ConditionLayer")
-                {
-                    conditionLayer = atoi(value.c_str());
-                }
-                else if (pname == "SideView")
-                {
-                    if (value != "down")
-                        return;
-                }
-            }
+            if (value == "1")
+                return;
         }
-
-        if (!xmlNameEqual(childNode, "data"))
-            continue;
-
-        // Disable for future usage "TileCondition" attribute
-        // if already set ConditionLayer to non zero
-        if (conditionLayer != 0)
-            tileCondition = -1;
-
-        switch (layerType)
+        else if (pname == "Version")
         {
-            case MapLayerType::TILES:
-            {
-                layer = new MapLayer(name,
-                    offsetX, offsetY,
-                    w, h,
-                    isFringeLayer,
-                    mask,
-                    tileCondition);
-                map->addLayer(layer);
-                break;
-            }
-            case MapLayerType::HEIGHTS:
-            {
-                heights = new MapHeights(w, h);
-                map->addHeights(heights);
-                break;
-            }
-            default:
-            case MapLayerType::ACTIONS:
-            case MapLayerType::COLLISION:
-                break;
+            if (value > CHECK_VERSION)
+                return;
         }
-
-        const std::string encoding =
-            XML::getProperty(childNode, "encoding", "");
-        const std::string compression =
-            XML::getProperty(childNode, "compression", "");
-
-        if (encoding == "base64")
+        else if (pname == "NotVersion")
         {
-            if (readBase64Layer(childNode, map, layer, layerType,
-                heights, compression, x, y, w, h))
-            {
-                continue;
-            }
-            else
-            {
+            if (value <= CHECK_VERSION)
                 return;
-            }
         }
-        else if (encoding == "csv")
+        else if (pname == "Mask")
         {
-            if (readCsvLayer(childNode, map, layer, layerType,
-                heights, x, y, w, h))
-            {
-                continue;
-            }
-            else
-            {
-                return;
-            }
+            mask = atoi(value.c_str());
         }
-        else
+        else if (pname == "TileCondition")
+        {
+            tileCondition = atoi(value.c_str());
+        }
+        else if (pname == "ConditionLayer")
+        {
+            conditionLayer = atoi(value.c_str());
+        }
+        else if (pname == "SideView")
         {
-            const std::map<int, TileAnimation*> &tileAnimations
-                = map->getTileAnimations();
-            const bool hasAnimations = !tileAnimations.empty();
+            if (value != "down")
+                return;
+        }
+    }
 
-            // Read plain XML map file
-            for_each_xml_child_node(childNode2, childNode)
-            {
-                if (!xmlNameEqual(childNode2, "tile"))
-                    continue;
+    if (!layer.haveData)
+        return;
 
-                const int gid = XML::getProperty(childNode2, "gid", -1);
-                setTile(map, layer, layerType, heights, x, y, gid);
-                if (hasAnimations)
-                {
-                    TileAnimationMapCIter it = tileAnimations.find(gid);
-                    if (it != tileAnimations.end())
-                    {
-                        TileAnimation *const ani = it->second;
-                        if (ani != nullptr)
-                            ani->addAffectedTile(layer, x + y * w);
-                    }
-                }
+    // Disable for future usage "TileCondition" attribute
+    // if already set ConditionLayer to non zero
+    if (conditionLayer != 0)
+        tileCondition = -1;
 
-                x++;
-                if (x == w)
-                {
-                    x = 0; y++;
-                    if (y >= h)
-                        break;
-                }
-            }
+    switch (layerType)
+    {
+        case MapLayerType::TILES:
+        {
+            mapLayer = new MapLayer(name,
+                layer.offsetX, layer.offsetY,
+                w, h,
+                isFringeLayer,
+                mask,
+                tileCondition);
+            map->addLayer(mapLayer);
+            break;
         }
+        case MapLayerType::HEIGHTS:
+        {
+            heights = new MapHeights(w, h);
+            map->addHeights(heights);
+            break;
+        }
+        default:
+        case MapLayerType::ACTIONS:
+        case MapLayerType::COLLISION:
+            break;
+    }
 
-        if (y < h)
-            std::cerr << "TOO SMALL!\n";
-        if (x != 0)
-            std::cerr << "TOO SMALL!\n";
-
-        // There can be only one data element
-        break;
+    const int *const tiles = layer.getTiles();
+    if (tiles != nullptr)
+    {
+        setTiles(map, mapLayer, layerType, heights,
+            tiles, layer.getTilesSize(), w, h);
     }
 }
 
-Tileset *MapReader::readTileset(XmlNodePtr node,
-                                const std::string &path,
-                                Map *const map)
+void MapReader::readLayer(XmlNodeConstPtr node,
+                          Map *const map)
 {
-    BLOCK_START("MapReader::readTileset")
     if (node == nullptr)
-    {
-        BLOCK_END("MapReader::readTileset")
-        return nullptr;
-    }
-
-    const int firstGid = XML::getProperty(node, "firstgid", 0);
-    const int margin = XML::getProperty(node, "margin", 0);
-    const int spacing = XML::getProperty(node, "spacing", 0);
-    XML::Document* doc = nullptr;
-    Tileset *set = nullptr;
-    std::string pathDir(path);
-    std::map<std::string, std::string> props;
-
-    if (XmlHasProp(node, "source"))
-    {
-        std::string filename = XML::getProperty(node, "source", "");
-        filename = resolveRelativePath(path, filename);
-
-        doc = new XML::Document(filename, UseVirtFs_true, SkipError_false);
-        node = doc->rootNode();
-        if (node == nullptr)
-        {
-            delete doc;
-            BLOCK_END("MapReader::readTileset")
-            return nullptr;
-        }
+        return;
 
-        // Reset path to be realtive to the tsx file
-        pathDir = filename.substr(0, filename.rfind('/') + 1);
-    }
+    MapCacheLayer layer;
+    compileLayer(node, map->getWidth(), map->getHeight(),
+        nullptr, false, layer);
+    buildLayer(layer, map);
+}
 
-    const int tw = XML::getProperty(node, "tilewidth", map->getTileWidth());
-    const int th = XML::getProperty(node, "tileheight", map->getTileHeight());
+void MapReader::compileTileset(XmlNodeConstPtr node,
+                               const std::string &pathDir,
+                               const int mapTileWidth,
+                               const int mapTileHeight,
+                               const bool background,
+                               MapCacheTileset &tileset)
+{
+    BLOCK_START("MapReader::compileTileset")
+    tileset.tileWidth = XML::getProperty(node, "tilewidth", mapTileWidth);
+    tileset.tileHeight = XML::getProperty(node, "tileheight", mapTileHeight);
 
+    const int firstGid = tileset.firstGid;
     for_each_xml_child_node(childNode, node)
     {
         if (xmlNameEqual(childNode, "image"))
         {
             // ignore second other <image> tags in tileset
-            if (set != nullptr)
+            if (!tileset.image.empty())
                 continue;
 
             const std::string source = XML::getProperty(
                 childNode, "source", "");
-
             if (!source.empty())
             {
-                const std::string sourceResolved = resolveRelativePath(pathDir,
-                    source);
-
-                Image *const tilebmp = Loader::getImage(sourceResolved);
-
-                if (tilebmp != nullptr)
-                {
-                    set = new Tileset(tilebmp,
-                        tw, th,
-                        firstGid,
-                        margin,
-                        spacing);
-                    tilebmp->decRef();
-#ifdef USE_OPENGL
-                    if (MapDB::isEmptyTileset(sourceResolved))
-                        set->setEmpty(true);
-                    if (tilebmp->getType() == ImageType::Image &&
-                        map->haveAtlas() == true &&
-                        graphicsManager.getUseAtlases())
-                    {
-                        reportAlways("Error: image '%s' not present in atlas",
-                            source.c_str())
-                    }
-#endif  // USE_OPENGL
-                }
-                else
-                {
-                    reportAlways("Error: Failed to load tileset (%s)",
-                        source.c_str())
-                }
+                tileset.imageName = source;
+                tileset.image = resolveRelativePath(pathDir, source);
             }
         }
         else if (xmlNameEqual(childNode, "properties"))
@@ -1166,7 +1409,10 @@ Tileset *MapReader::readTileset(XmlNodePtr node,
                 const std::string name = XML::getProperty(
                     propertyNode, "name", "");
                 if (!name.empty())
-                    props[name] = XML::getProperty(propertyNode, "value", "");
+                {
+                    tileset.properties.push_back(MapCacheProperty(name,
+                        XML::getProperty(propertyNode, "value", "")));
+                }
             }
         }
         else if (xmlNameEqual(childNode, "tile"))
@@ -1180,10 +1426,12 @@ Tileset *MapReader::readTileset(XmlNodePtr node,
                 if (!isProps && !isAnim)
                     continue;
 
-                const int tileGID = firstGid + XML::getProperty(
-                    childNode, "id", 0);
+                // animation frames taken from tileset image
+                if (tileset.image.empty())
+                    continue;
 
-                Animation *ani = new Animation("from map");
+                MapCacheAnimation ani;
+                ani.gid = firstGid + XML::getProperty(childNode, "id", 0);
 
                 if (isProps)
                 {
@@ -1202,19 +1450,15 @@ Tileset *MapReader::readTileset(XmlNodePtr node,
                             const int value = XML::getProperty(
                                 propertyNode, "value", 0);
                             tileProperties[name] = value;
-                            logger->log("Tile Prop of %d \"%s\" = \"%d\"",
-                                tileGID, name.c_str(), value);
+                            if (!background)
+                            {
+                                logger->log("Tile Prop of %d \"%s\" = "
+                                    "\"%d\"", ani.gid, name.c_str(), value);
+                            }
                         }
                     }
 
-                    // create animation
-                    if (set == nullptr ||
-                        !config.getBoolValue("playMapAnimations"))
-                    {
-                        delete ani;
-                        continue;
-                    }
-
+                    ani.fromProperties = true;
                     for (int i = 0; ; i++)
                     {
                         const std::string iStr(toString(i));
@@ -1226,8 +1470,8 @@ Tileset *MapReader::readTileset(XmlNodePtr node,
                         if (iFrame != tileProperties.end()
                             && iDelay != tileProperties.end())
                         {
-                            ani->addFrame(set->get(iFrame->second),
-                                iDelay->second, 0, 0, 100);
+                            ani.frames.push_back(MapCacheFrame(
+                                iFrame->second, iDelay->second));
                         }
                         else
                         {
@@ -1242,32 +1486,82 @@ Tileset *MapReader::readTileset(XmlNodePtr node,
                         if (!xmlNameEqual(frameNode, "frame"))
                             continue;
 
-                        if (set != nullptr)
-                        {
-                            const int tileId = XML::getProperty(
-                                frameNode, "tileid", 0);
-                            const int duration = XML::getProperty(
-                                frameNode, "duration", 0) /  10;
-
-                            ani->addFrame(set->get(tileId),
-                                duration,
-                                0, 0, 100);
-                        }
+                        ani.frames.push_back(MapCacheFrame(
+                            XML::getProperty(frameNode, "tileid", 0),
+                            XML::getProperty(frameNode, "duration", 0) / 10));
                     }
                 }
 
-                if (ani->getLength() > 0)
-                    map->addAnimation(tileGID, new TileAnimation(ani));
-                else
-                    delete2(ani)
+                if (!ani.frames.empty())
+                    tileset.animations.push_back(ani);
             }
         }
     }
+    BLOCK_END("MapReader::compileTileset")
+}
 
-    delete doc;
+Tileset *MapReader::buildTileset(const MapCacheTileset &tileset,
+                                 Map *const map)
+{
+    BLOCK_START("MapReader::readTileset")
+    if (!tileset.valid || tileset.image.empty())
+    {
+        BLOCK_END("MapReader::readTileset")
+        return nullptr;
+    }
 
-    if (set != nullptr)
-        set->setProperties(props);
+    Image *const tilebmp = Loader::getImage(tileset.image);
+    if (tilebmp == nullptr)
+    {
+        reportAlways("Error: Failed to load tileset (%s)",
+            tileset.imageName.c_str())
+        BLOCK_END("MapReader::readTileset")
+        return nullptr;
+    }
+
+    Tileset *const set = new Tileset(tilebmp,
+        tileset.tileWidth, tileset.tileHeight,
+        tileset.firstGid,
+        tileset.margin,
+        tileset.spacing);
+    tilebmp->decRef();
+#ifdef USE_OPENGL
+    if (MapDB::isEmptyTileset(tileset.image))
+        set->setEmpty(true);
+    if (tilebmp->getType() == ImageType::Image &&
+        map->haveAtlas() == true &&
+        graphicsManager.getUseAtlases())
+    {
+        reportAlways("Error: image '%s' not present in atlas",
+            tileset.imageName.c_str())
+    }
+#endif  // USE_OPENGL
+
+    const bool playAnimations = config.getBoolValue("playMapAnimations");
+    FOR_EACH (STD_VECTOR<MapCacheAnimation>::const_iterator,
+              it, tileset.animations)
+    {
+        const MapCacheAnimation &animation = *it;
+        if (animation.fromProperties && !playAnimations)
+            continue;
+        Animation *ani = new Animation("from map");
+        FOR_EACH (STD_VECTOR<MapCacheFrame>::const_iterator,
+                  it2, animation.frames)
+        {
+            ani->addFrame(set->get((*it2).tile),
+                (*it2).delay,
+                0, 0, 100);
+        }
+        if (ani->getLength() > 0)
+            map->addAnimation(animation.gid, new TileAnimation(ani));
+        else
+            delete2(ani)
+    }
+
+    std::map<std::string, std::string> props;
+    FOR_EACH (MapCachePropertiesCIter, it, tileset.properties)
+        props[(*it).first] = (*it).second;
+    set->setProperties(props);
     BLOCK_END("MapReader::readTileset")
     return set;
 }
@@ -1304,6 +1598,11 @@ Map *MapReader::createEmptyMap(const std::string &restrict filename,
     return map;
 }
 
+void MapReader::deleteThreadPool()
+{
+    delete2(mThreadPool)
+}
+
 void MapReader::updateMusic(Map *const map)
 {
     std::string name = map->getProperty("shortName", std::string());
@@ -24,14 +24,13 @@
 #ifndef RESOURCES_MAPREADER_H
 #define RESOURCES_MAPREADER_H
 
-#include "enums/resources/map/maplayertype.h"
+#include "resources/map/mapcache.h"
 
+#include "utils/stringvector.h"
+#include "utils/vector.h"
 #include "utils/xml.h"
 
 class Map;
-class MapHeights;
-class MapLayer;
-class Properties;
 class Resource;
 class Tileset;
 
@@ -50,13 +49,6 @@ class MapReader final
                             const std::string &restrict realFilename)
                             A_WARN_UNUSED;
 
-        /**
-         * Read an XML map from a parsed XML tree. The path is used to find the
-         * location of referenced tileset images.
-         */
-        static Map *readMap(XmlNodePtrConst node,
-                            const std::string &path) A_WARN_UNUSED;
-
         static Map *createEmptyMap(const std::string &restrict filename,
                                    const std::string &restrict realFilename)
                                    A_WARN_UNUSED;
@@ -67,45 +59,87 @@ class MapReader final
         static void readLayer(XmlNodeConstPtr node,
                               Map *const map) A_NONNULL(2);
 
+        /**
+         * Compiles map file to map cache. External tilesets not read,
+         * so can be called from any thread.
+         */
+        static bool compileMap(const char *const data,
+                               const int size,
+                               const std::string &realFilename,
+                               MapCache &cache) A_NONNULL(1);
+
+        /**
+         * Reads external tilesets of compiled map. In background nothing
+         * logged, so can be called from any thread.
+         */
+        static void compileTilesets(MapCache &cache,
+                                    const bool background);
+
+        /**
+         * Stops threads used for layers decoding.
+         */
+        static void deleteThreadPool();
+
 #ifdef USE_OPENGL
         static void loadEmptyAtlas();
         static void unloadEmptyAtlas();
 #endif  // USE_OPENGL
 
     private:
+        static bool compileMap(XmlNodePtrConst node,
+                               const std::string &path,
+                               MapCache &cache,
+                               const bool background);
+
+        /**
+         * Creates map from compiled map. The path is used as map name.
+         */
+        static Map *buildMap(const MapCache &cache,
+                             const std::string &path) A_WARN_UNUSED;
+
         /**
          * Reads the properties element.
          *
          * @param node  The <code>properties</code> element.
-         * @param props The Properties instance to which the properties will
-         *              be assigned.
+         * @param props The list to which the properties will be added.
          */
         static void readProperties(XmlNodeConstPtrConst node,
-                                   Properties *const props) A_NONNULL(2);
+                                   MapCacheProperties &props);
 
         static bool readBase64Layer(XmlNodeConstPtrConst childNode,
-                                    Map *const map,
-                                    MapLayer *const layer,
-                                    const MapLayerTypeT &layerType,
-                                    MapHeights *const heights,
                                     const std::string &compression,
-                                    int &restrict x, int &restrict y,
-                                    const int w, const int h) A_NONNULL(2);
+                                    STD_VECTOR<int> &tiles);
 
         static bool readCsvLayer(XmlNodeConstPtrConst childNode,
-                                 Map *const map,
-                                 MapLayer *const layer,
-                                 const MapLayerTypeT &layerType,
-                                 MapHeights *const heights,
-                                 int &restrict x, int &restrict y,
-                                 const int w, const int h) A_NONNULL(2);
+                                 STD_VECTOR<int> &tiles);
+
+        /**
+         * Reads a map layer. Tiles what already decoded used instead of
+         * layer data. In background layer data not decoded.
+         */
+        static bool compileLayer(XmlNodeConstPtr node,
+                                 const int mapWidth,
+                                 const int mapHeight,
+                                 const STD_VECTOR<int> *const decodedTiles,
+                                 const bool background,
+                                 MapCacheLayer &layer);
+
+        static void buildLayer(const MapCacheLayer &layer,
+                               Map *const map) A_NONNULL(2);
 
         /**
-         * Reads a tile set.
+         * Reads a tile set. In background tile properties not logged.
          */
-        static Tileset *readTileset(XmlNodePtr node,
-                                    const std::string &path,
-                                    Map *const map) A_WARN_UNUSED A_NONNULL(3);
+        static void compileTileset(XmlNodeConstPtr node,
+                                   const std::string &pathDir,
+                                   const int mapTileWidth,
+                                   const int mapTileHeight,
+                                   const bool background,
+                                   MapCacheTileset &tileset);
+
+        static Tileset *buildTileset(const MapCacheTileset &tileset,
+                                     Map *const map)
+                                     A_WARN_UNUSED A_NONNULL(2);
 
         static void updateMusic(Map *const map) A_NONNULL(1);
 
@@ -76,8 +76,11 @@ SDL_Surface *Sdl2SoftwareScreenshotHelper::getScreenshot()
 
     if (screenshot)
     {
-        SDL_BlitSurface(static_cast<SDL2SoftwareGraphics*>(
-            mainGraphics)->mSurface, nullptr, screenshot, nullptr);
+        SDL2SoftwareGraphics *const graphics =
+            static_cast<SDL2SoftwareGraphics*>(mainGraphics);
+        // draw delayed commands before reading screen
+        graphics->flushDeferred();
+        SDL_BlitSurface(graphics->mSurface, nullptr, screenshot, nullptr);
     }
 
     return screenshot;
@@ -39,11 +39,14 @@
 #include "resources/resourcemanager/resourcemanager.h"
 
 #include "resources/sprite/animationdelayload.h"
+#include "resources/sprite/spritedef.h"
 
 #include "utils/delete2.h"
 #include "utils/likely.h"
 #include "utils/mrand.h"
 
+#include <climits>
+
 #include "debug.h"
 
 bool AnimatedSprite::mEnableCache = false;
@@ -51,6 +54,7 @@ bool AnimatedSprite::mEnableCache = false;
 AnimatedSprite::AnimatedSprite(SpriteDef *restrict const sprite) :
     mDirection(SpriteDirection::DOWN),
     mLastTime(0),
+    mNextTime(0),
     mFrameIndex(0),
     mFrameTime(0),
     mSprite(sprite),
@@ -148,6 +152,7 @@ bool AnimatedSprite::reset() restrict2
     mFrameIndex = 0;
     mFrameTime = 0;
     mLastTime = 0;
+    mNextTime = 0;
 
     if (mAnimation != nullptr)
         mFrame = &mAnimation->mFrames[0];
@@ -157,16 +162,21 @@ bool AnimatedSprite::reset() restrict2
 }
 
 bool AnimatedSprite::play(const std::string &restrict spriteAction) restrict2
+{
+    return play(SpriteDef::getActionId(spriteAction));
+}
+
+bool AnimatedSprite::play(const int actionId) restrict2
 {
     if (mSprite == nullptr)
     {
         if (mDelayLoad == nullptr)
             return false;
-        mDelayLoad->setAction(spriteAction);
+        mDelayLoad->setAction(SpriteDef::getActionName(actionId));
         return true;
     }
 
-    const Action *const action = mSprite->getAction(spriteAction, mNumber);
+    const Action *const action = mSprite->getAction(actionId, mNumber);
     if (action == nullptr)
         return false;
 
@@ -190,12 +200,23 @@ bool AnimatedSprite::update(const int time) restrict2
 {
     // Avoid freaking out at first frame or when tick_time overflows
     if (A_UNLIKELY(time < mLastTime || mLastTime == 0))
+    {
         mLastTime = time;
+        mNextTime = 0;
+    }
 
     // If not enough time has passed yet, do nothing
     if (time <= mLastTime || (mAnimation == nullptr))
         return false;
 
+    // Current frame can not change yet, so only frame time updated
+    if (time < mNextTime)
+    {
+        mFrameTime += CAST_U32(time - mLastTime);
+        mLastTime = time;
+        return false;
+    }
+
     const unsigned int dt = time - mLastTime;
     mLastTime = time;
 
@@ -208,11 +229,50 @@ bool AnimatedSprite::update(const int time) restrict2
         play(SpriteAction::STAND);
         mTerminated = true;
     }
+    updateNextTime();
 
     // Make sure something actually changed
     return animation != mAnimation || frame != mFrame;
 }
 
+void AnimatedSprite::updateNextTime() restrict2
+{
+    if (mLastTime == 0 ||
+        mFrame == nullptr ||
+        mAnimation == nullptr)
+    {
+        mNextTime = 0;
+        return;
+    }
+    // terminator and control frames processed at next update
+    if ((mFrame->image == nullptr && mFrame->type == FrameType::ANIMATION) ||
+        (mFrame->type != FrameType::ANIMATION &&
+        mFrame->type != FrameType::PAUSE))
+    {
+        mNextTime = 0;
+        return;
+    }
+    // frame without delay never changes
+    if (mFrame->delay <= 0)
+    {
+        mNextTime = INT_MAX;
+        return;
+    }
+    // frame changes after frame time became bigger than delay
+    mNextTime = mLastTime + mFrame->delay - CAST_S32(mFrameTime) + 1;
+}
+
+int AnimatedSprite::getNextUpdateTime() const restrict2
+{
+    // delayed sprite can be loaded at any time
+    if (mDelayLoad != nullptr)
+        return 0;
+    // without animation sprite changes only by play
+    if (mAnimation == nullptr)
+        return INT_MAX;
+    return mNextTime;
+}
+
 bool AnimatedSprite::updateCurrentAnimation(const unsigned int time) restrict2
 {
     // move code from Animation::isTerminator(*mFrame)
@@ -225,6 +285,12 @@ bool AnimatedSprite::updateCurrentAnimation(const unsigned int time) restrict2
 
     mFrameTime += time;
 
+    // after long pause (sprite of culled actor) skip whole loops of
+    // animation, but keep one loop for animations what can end
+    const unsigned int duration = CAST_U32(mAnimation->getDuration());
+    if (duration > 0U && mFrameTime > duration * 2U)
+        mFrameTime = duration + mFrameTime % duration;
+
     while ((mFrameTime > CAST_U32(mFrame->delay) &&
            mFrame->delay > 0) ||
            (mFrame->type != FrameType::ANIMATION &&
@@ -453,6 +519,21 @@ const void *AnimatedSprite::getHash() const restrict2
     return this;
 }
 
+bool AnimatedSprite::getCacheKey(SpriteCacheKey &key) const restrict2
+{
+    if (mSprite == nullptr ||
+        mFrame == nullptr ||
+        mSprite->getCacheId() == 0U)
+    {
+        return false;
+    }
+    // frame address can be reused only after definition removed,
+    // and definition ids never reused
+    key.first = mSprite->getCacheId();
+    key.second = mFrame;
+    return true;
+}
+
 bool AnimatedSprite::updateNumber(const unsigned num) restrict2
 {
     if (mSprite == nullptr)
@@ -68,8 +68,12 @@ class AnimatedSprite final : public Sprite
         bool play(const std::string &restrict spriteAction)
                   restrict2 override final;
 
+        bool play(const int actionId) restrict2 override final;
+
         bool update(const int time) restrict2 override final;
 
+        int getNextUpdateTime() const restrict2 override final A_WARN_UNUSED;
+
         void draw(Graphics *restrict const graphics,
                   const int posX,
                   const int posY) const restrict2 override final A_NONNULL(2);
@@ -110,6 +114,9 @@ class AnimatedSprite final : public Sprite
 
         const void *getHash() const restrict2 override final A_WARN_UNUSED;
 
+        bool getCacheKey(SpriteCacheKey &key) const
+                         restrict2 override final A_WARN_UNUSED;
+
         bool updateNumber(const unsigned num) restrict2 override final;
 
         void clearDelayLoad() restrict2 noexcept2
@@ -155,6 +162,8 @@ class AnimatedSprite final : public Sprite
     private:
         bool updateCurrentAnimation(const unsigned int dt) restrict2;
 
+        void updateNextTime() restrict2;
+
         void setDelayLoad(const std::string &restrict filename,
                           const int variant) restrict2;
 
@@ -164,6 +173,7 @@ class AnimatedSprite final : public Sprite
 
         SpriteDirection::Type mDirection;  /**< The sprite direction. */
         int mLastTime;                 /**< The last time update was called. */
+        int mNextTime;                 /**< Time when frame can change. */
 
         unsigned int mFrameIndex;      /**< The index of the current frame. */
         unsigned int mFrameTime;       /**< The time since start of frame. */
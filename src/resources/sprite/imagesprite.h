@@ -27,6 +27,8 @@
 
 #include "resources/image/image.h"
 
+#include <climits>
+
 class Graphics;
 
 class ImageSprite final : public Sprite
@@ -44,9 +46,15 @@ class ImageSprite final : public Sprite
         bool play(const std::string &action A_UNUSED) override final
         { return false; }
 
+        bool play(const int actionId A_UNUSED) override final
+        { return false; }
+
         bool update(const int time A_UNUSED) override final
         { return false; }
 
+        int getNextUpdateTime() const override final
+        { return INT_MAX; }
+
         void draw(Graphics *const graphics,
                   const int posX, const int posY)
                   const override final A_NONNULL(2);
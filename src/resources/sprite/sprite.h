@@ -25,11 +25,19 @@
 
 #include "resources/sprite/spritedef.h"
 
+#include "utils/vector.h"
+
+#include <utility>
+
 #include "localconsts.h"
 
 class Graphics;
 class Image;
 
+// sprite definition id and frame in it
+typedef std::pair<unsigned int, const void*> SpriteCacheKey;
+typedef STD_VECTOR<SpriteCacheKey> SpriteCacheKeys;
+
 class Sprite notfinal
 {
     public:
@@ -52,6 +60,13 @@ class Sprite notfinal
          */
         virtual bool play(const std::string &action) = 0;
 
+        /**
+         * Plays an action by action id from SpriteDef::getActionId.
+         *
+         * @returns true if the sprite changed, false otherwise
+         */
+        virtual bool play(const int actionId) = 0;
+
         /**
          * Inform the animation of the passed time so that it can output the
          * correct animation frame.
@@ -60,6 +75,12 @@ class Sprite notfinal
          */
         virtual bool update(const int time) = 0;
 
+        /**
+         * Returns time before which update can not change sprite,
+         * or 0 if sprite must be updated at next time.
+         */
+        virtual int getNextUpdateTime() const = 0;
+
         /**
          * Draw the current animation frame at the coordinates given in screen
          * pixels.
@@ -119,6 +140,15 @@ class Sprite notfinal
         virtual const void *getHash2() const A_WARN_UNUSED
         { return this; }
 
+        /**
+         * Sets key of current image, what not reused by other images
+         * after sprite definition removed. Returns false if sprite
+         * have no such key.
+         */
+        virtual bool getCacheKey(SpriteCacheKey &key A_UNUSED) const
+                                 A_WARN_UNUSED
+        { return false; }
+
         virtual bool updateNumber(const unsigned num) = 0;
 
     protected:
@@ -30,8 +30,11 @@
 
 #include "const/resources/map/map.h"
 
+#include "utils/cast.h"
 #include "utils/checkutils.h"
 #include "utils/foreach.h"
+#include "utils/stringmap.h"
+#include "utils/stringvector.h"
 
 #include "resources/action.h"
 #include "resources/imageset.h"
@@ -49,8 +52,47 @@
 
 SpriteReference *SpriteReference::Empty = nullptr;
 
+namespace
+{
+    StringIntMap actionIds;
+    StringVect actionNames;
+    unsigned int lastCacheId = 0U;
+}  // namespace
+
+int SpriteDef::getActionId(const std::string &action)
+{
+    const StringIntMapCIter it = actionIds.find(action);
+    if (it != actionIds.end())
+        return (*it).second;
+    const int id = CAST_S32(actionNames.size());
+    actionIds[action] = id;
+    actionNames.push_back(action);
+    return id;
+}
+
+const std::string &SpriteDef::getActionName(const int actionId)
+{
+    if (actionId < 0 || actionId >= CAST_S32(actionNames.size()))
+        return SpriteAction::INVALID;
+    return actionNames[actionId];
+}
+
+Action *SpriteDef::findAction(const ActionMap *const actionMap,
+                              const int actionId)
+{
+    if (actionId < 0 || actionId >= CAST_S32(actionMap->size()))
+        return nullptr;
+    return (*actionMap)[actionId];
+}
+
 const Action *SpriteDef::getAction(const std::string &action,
                                    const unsigned num) const
+{
+    return getAction(getActionId(action), num);
+}
+
+const Action *SpriteDef::getAction(const int actionId,
+                                   const unsigned num) const
 {
     Actions::const_iterator i = mActions.find(num);
     if (i == mActions.end() && num != 100)
@@ -59,18 +101,15 @@ const Action *SpriteDef::getAction(const std::string &action,
     if (i == mActions.end() || ((*i).second == nullptr))
         return nullptr;
 
-    const ActionMap *const actMap = (*i).second;
-    if (actMap == nullptr)
-        return nullptr;
-    const ActionMap::const_iterator it = actMap->find(action);
-
-    if (it == actMap->end())
+    const Action *const action = findAction((*i).second, actionId);
+    if (action == nullptr)
     {
-        logger->log("Warning: no action \"%s\" defined!", action.c_str());
+        logger->log("Warning: no action \"%s\" defined!",
+            getActionName(actionId).c_str());
         return nullptr;
     }
 
-    return (*it).second;
+    return action;
 }
 
 unsigned SpriteDef::findNumber(const unsigned num) const
@@ -117,6 +156,7 @@ SpriteDef *SpriteDef::load(const std::string &animationFile,
     }
 
     SpriteDef *const def = new SpriteDef;
+    def->mCacheId = ++ lastCacheId;
     def->mSource = animationFile;
     def->mProcessedFiles.insert(animationFile);
     def->loadSprite(rootNode, variant, palettes);
@@ -135,19 +175,19 @@ SpriteDef *SpriteDef::load(const std::string &animationFile,
 
 void SpriteDef::fixDeadAction()
 {
+    const int deadId = getActionId(SpriteAction::DEAD);
+    const int standId = getActionId(SpriteAction::STAND);
     FOR_EACH (ActionsIter, it, mActions)
     {
-        ActionMap *const d = (*it).second;
+        const ActionMap *const d = (*it).second;
         if (d == nullptr)
             continue;
-        const ActionMap::iterator i = d->find(SpriteAction::DEAD);
-        const ActionMap::iterator i2 = d->find(SpriteAction::STAND);
+        Action *const dead = findAction(d, deadId);
         // search dead action and check what it not same with stand action
-        if (i != d->end() &&
-            i->second != nullptr &&
-            (i2 == d->end() || i->second != i2->second))
+        if (dead != nullptr &&
+            dead != findAction(d, standId))
         {
-            (i->second)->setLastFrameDelay(0);
+            dead->setLastFrameDelay(0);
         }
     }
 }
@@ -155,16 +195,18 @@ void SpriteDef::fixDeadAction()
 void SpriteDef::substituteAction(const std::string &restrict complete,
                                  const std::string &restrict with)
 {
+    const int completeId = getActionId(complete);
+    const int withId = getActionId(with);
     FOR_EACH (ActionsConstIter, it, mActions)
     {
-        ActionMap *const d = (*it).second;
+        const ActionMap *const d = (*it).second;
         if (reportTrue(d == nullptr))
             continue;
-        if (d->find(complete) == d->end())
+        if (findAction(d, completeId) == nullptr)
         {
-            const ActionMap::iterator i = d->find(with);
-            if (i != d->end())
-                (*d)[complete] = i->second;
+            Action *const action = findAction(d, withId);
+            if (action != nullptr)
+                addAction((*it).first, complete, action);
         }
     }
 }
@@ -313,7 +355,13 @@ void SpriteDef::loadAction(XmlNodeConstPtr node,
     // When first action, set it as default direction.
     // i here always correct, because hp was added above.
     const Actions::const_iterator i = mActions.find(hp);
-    if ((*i).second->size() == 1)
+    int actionsCount = 0;
+    FOR_EACHP (ActionMap::const_iterator, it, (*i).second)
+    {
+        if (*it != nullptr)
+            actionsCount ++;
+    }
+    if (actionsCount == 1)
         addAction(hp, SpriteAction::DEFAULT, action);
 
     // Load animations
@@ -528,7 +576,10 @@ SpriteDef::~SpriteDef()
     FOR_EACH (Actions::iterator, i, mActions)
     {
         FOR_EACHP (ActionMap::iterator, it, (*i).second)
-            actions.insert(it->second);
+        {
+            if (*it != nullptr)
+                actions.insert(*it);
+        }
         delete (*i).second;
     }
 
@@ -580,7 +631,11 @@ void SpriteDef::addAction(const unsigned hp, const std::string &name,
     if (i == mActions.end())
         mActions[hp] = new ActionMap;
 
-    (*mActions[hp])[name] = action;
+    ActionMap &actionMap = *mActions[hp];
+    const size_t id = CAST_SIZE(getActionId(name));
+    if (id >= actionMap.size())
+        actionMap.resize(id + 1, nullptr);
+    actionMap[id] = action;
 }
 
 bool SpriteDef::addSequence(const int start,
@@ -686,9 +741,10 @@ int SpriteDef::calcMemoryChilds(const int level) const
         const ActionMap *const actionMap = (*it).second;
         FOR_EACHP (ActionMap::const_iterator, it2, actionMap)
         {
-            sz += static_cast<int>((*it2).first.capacity());
-            const Action *const action = (*it2).second;
-            sz += action->calcMemory(level + 1);
+            sz += sizeof(Action*);
+            const Action *const action = *it2;
+            if (action != nullptr)
+                sz += action->calcMemory(level + 1);
         }
     }
     return sz;
@@ -26,6 +26,7 @@
 
 #include "enums/resources/spritedirection.h"
 
+#include "utils/vector.h"
 #include "utils/xml.h"
 
 #include <map>
@@ -56,6 +57,21 @@ class SpriteDef final : public Resource
         const Action *getAction(const std::string &action,
                                 const unsigned num) const A_WARN_UNUSED;
 
+        /**
+         * Returns the specified action by action id.
+         */
+        const Action *getAction(const int actionId,
+                                const unsigned num) const A_WARN_UNUSED;
+
+        /**
+         * Returns id for action name. Ids shared by all sprites, and new
+         * names get new ids.
+         */
+        static int getActionId(const std::string &action) A_WARN_UNUSED;
+
+        static const std::string &getActionName(const int actionId)
+                                                A_WARN_UNUSED;
+
         unsigned findNumber(const unsigned num) const A_WARN_UNUSED;
 
         /**
@@ -67,6 +83,12 @@ class SpriteDef final : public Resource
         void addAction(const unsigned hp, const std::string &name,
                        Action *const action);
 
+        /**
+         * Returns id what unique for each loaded sprite definition.
+         */
+        unsigned int getCacheId() const noexcept2 A_WARN_UNUSED
+        { return mCacheId; }
+
         int calcMemoryLocal() const override final;
 
         int calcMemoryChilds(const int level) const override final;
@@ -90,7 +112,8 @@ class SpriteDef final : public Resource
             Resource(),
             mImageSets(),
             mActions(),
-            mProcessedFiles()
+            mProcessedFiles(),
+            mCacheId(0U)
         { }
 
         /**
@@ -153,15 +176,20 @@ class SpriteDef final : public Resource
         typedef std::map<std::string, ImageSet*> ImageSets;
         typedef ImageSets::iterator ImageSetIterator;
         typedef ImageSets::const_iterator ImageSetCIterator;
-        typedef std::map<std::string, Action*> ActionMap;
+        // actions indexed by action id
+        typedef STD_VECTOR<Action*> ActionMap;
         typedef std::map<unsigned, ActionMap*> Actions;
         typedef Actions::const_iterator ActionsConstIter;
         typedef Actions::iterator ActionsIter;
         typedef Actions::const_iterator ActionsCIter;
 
+        static Action *findAction(const ActionMap *const actionMap,
+                                  const int actionId) A_WARN_UNUSED;
+
         ImageSets mImageSets;
         Actions mActions;
         std::set<std::string> mProcessedFiles;
+        unsigned int mCacheId;
 };
 
 #endif  // RESOURCES_SPRITE_SPRITEDEF_H
@@ -23,10 +23,16 @@
 
 #ifdef USE_OPENGL
 
+#include "configuration.h"
 #include "graphicsmanager.h"
+#include "navigationmanager.h"
 #include "settings.h"
 #include "soundmanager.h"
 
+#include "const/resources/map/map.h"
+
+#include "enums/resources/map/blockmask.h"
+
 #include "fs/virtfs/rwops.h"
 
 #include "gui/skin.h"
@@ -55,6 +61,8 @@
 
 #include "resources/image/image.h"
 
+#include "resources/map/map.h"
+
 PRAGMA48(GCC diagnostic push)
 PRAGMA48(GCC diagnostic ignored "-Wshadow")
 #ifndef USE_SDL2
@@ -134,6 +142,10 @@ int TestLauncher::exec()
         return testDyeASpeed();
     else if (mTest == "108")
         return testBlitSpeed();
+    else if (mTest == "109")
+        return testPathSpeed();
+    else if (mTest == "110")
+        return testFps4();
 
     return -1;
 }
@@ -310,6 +322,90 @@ int TestLauncher::testFps3()
     sleep(1);
     return 0;
 }
+
+int TestLauncher::testFps4()
+{
+    timeval start;
+    timeval end;
+
+    Wallpaper::loadWallpapers();
+    Wallpaper::getWallpaper(800, 600);
+    Image *img[3];
+
+    img[0] = Theme::getImageFromTheme("graphics/images/login_wallpaper.png");
+    img[1] = Theme::getImageFromTheme("themes/wood/window.png");
+    img[2] = Theme::getImageFromTheme("graphics/sprites/arrow_up.png");
+    if (img[0] == nullptr || img[1] == nullptr || img[2] == nullptr)
+        return 1;
+
+    const int cnt = 200;
+
+    gettimeofday(&start, nullptr);
+    for (int k = 0; k < cnt; k ++)
+    {
+        mainGraphics->drawPattern(img[0], 0, 0, 800, 600);
+        for (int x = 0; x < 800; x += 100)
+        {
+            for (int y = 0; y < 600; y += 75)
+            {
+                mainGraphics->drawImage(img[1], x + k % 7, y);
+                mainGraphics->drawImage(img[2], x + 40, y + 30);
+            }
+        }
+        mainGraphics->setColor(Color(0x20U, 0x60U, 0xA0U, 0x90U));
+        mainGraphics->fillRectangle(Rect(50 + k % 11, 40, 500, 300));
+        mainGraphics->setColor(Color(0x80U, 0x20U, 0x20U, 0xFFU));
+        mainGraphics->fillRectangle(Rect(300, 250 + k % 13, 200, 200));
+        mainGraphics->setColor(Color(0xF0U, 0xF0U, 0x40U, 0xFFU));
+        for (int f = 0; f < 20; f ++)
+        {
+            mainGraphics->drawRectangle(Rect(20 + f * 38, 20 + k % 5,
+                30, 500));
+            mainGraphics->drawLine(0, 30 + f * 28, 799, 30 + f * 28);
+        }
+        mainGraphics->setColor(Color(0x40U, 0xF0U, 0x40U, 0x80U));
+        for (int f = 0; f < 20; f ++)
+        {
+            mainGraphics->drawLine(10 + f * 39, 0,
+                10 + f * 39, 599 - k % 9);
+            mainGraphics->drawRectangle(Rect(100 + f * 5, 100 + f * 5,
+                600 - f * 10, 400 - f * 10));
+        }
+        mainGraphics->updateScreen();
+    }
+
+    gettimeofday(&end, nullptr);
+    const int tFps = calcFps(start, end, cnt);
+
+    // checksum allow compare output with different render options
+    uint32_t checksum = 2166136261U;
+    SDL_Surface *const screen = screenshortHelper->getScreenshot();
+    if (screen != nullptr)
+    {
+        const int rowSize = screen->w * screen->format->BytesPerPixel;
+        for (int y = 0; y < screen->h; y ++)
+        {
+            const uint8_t *const row = static_cast<const uint8_t*>(
+                screen->pixels) + y * screen->pitch;
+            for (int x = 0; x < rowSize; x ++)
+            {
+                checksum ^= row[x];
+                checksum *= 16777619U;
+            }
+        }
+        SDL_FreeSurface(screen);
+    }
+
+    file << mTest << std::endl;
+    file << tFps << std::endl;
+    file << checksum << std::endl;
+
+    printf("fps: %d\n", tFps / 10);
+    printf("frame time: %d us\n", tFps > 0 ? 10000000 / tFps : 0);
+    printf("checksum: %08x\n", checksum);
+    sleep(1);
+    return 0;
+}
 PRAGMA45(GCC diagnostic pop)
 
 int TestLauncher::testBatches()
@@ -646,6 +742,90 @@ int TestLauncher::testBlitSpeed()
     return 0;
 }
 
+int TestLauncher::testPathSpeed()
+{
+#if defined __linux__ || defined __linux
+    const int sz = 512;
+    const int cnt = 200;
+    const unsigned char blockWalkMask = BlockMask::WALL |
+        BlockMask::AIR |
+        BlockMask::WATER |
+        BlockMask::PLAYERWALL;
+    timespec time1;
+    timespec time2;
+
+    // rooms with few doors and random rocks inside
+    Map *const map = new Map("test map", sz, sz, mapTileSize, mapTileSize);
+    srand(1);
+    for (int y = 0; y < sz; y ++)
+    {
+        for (int x = 0; x < sz; x ++)
+        {
+            const bool wall = (x % 32 == 0 || y % 32 == 0) &&
+                (x % 32) != 16 && (y % 32) != 16;
+            if (wall || rand() % 100 < 15)
+                map->addBlockMask(x, y, BlockType::WALL);
+        }
+    }
+    map->setClusterGraph(NavigationManager::loadClusterGraph(map));
+
+    STD_VECTOR<int> points;
+    while (CAST_S32(points.size()) < cnt * 4)
+    {
+        const int x = rand() % sz;
+        const int y = rand() % sz;
+        if (map->getWalk(x, y, blockWalkMask))
+        {
+            points.push_back(x);
+            points.push_back(y);
+        }
+    }
+
+    // options changed only for test
+    const bool jumpPointSearch = config.getBoolValue("enableJumpPointSearch");
+    const bool hierarchicalPath = config.getBoolValue(
+        "enableHierarchicalPath");
+
+    // a*, jump point search, hierarchical search
+    const char *const names[3] = { "a* ", "jps", "hpa" };
+    for (int f = 0; f < 3; f ++)
+    {
+        config.setValue("enableJumpPointSearch", f == 1);
+        config.setValue("enableHierarchicalPath", f == 2);
+        int steps = 0;
+        int nodes = 0;
+        Path path;
+        clock_gettime(CLOCK_MONOTONIC, &time1);
+        for (int d = 0; d < cnt * 4; d += 4)
+        {
+            map->findPath(path,
+                points[d],
+                points[d + 1],
+                points[d + 2],
+                points[d + 3],
+                blockWalkMask,
+                0);
+            steps += CAST_S32(path.size());
+            nodes += map->getPathNodes();
+        }
+        clock_gettime(CLOCK_MONOTONIC, &time2);
+        const long diff = ((static_cast<long int>(time2.tv_sec) *
+            1000000000L + static_cast<long int>(time2.tv_nsec)) / 1) -
+            ((static_cast<long int>(time1.tv_sec) * 1000000000L +
+            static_cast<long int>(time1.tv_nsec)) / 1);
+        printf("%s path steps: %d\n", names[f], steps);
+        printf("%s path nodes: %d\n", names[f], nodes / cnt);
+        printf("%s path time:  %011ld\n", names[f], diff / cnt);
+        file << mTest << std::endl;
+        file << diff / cnt << std::endl;
+    }
+    config.setValue("enableJumpPointSearch", jumpPointSearch);
+    config.setValue("enableHierarchicalPath", hierarchicalPath);
+    delete map;
+#endif  // defined __linux__ || defined __linux
+    return 0;
+}
+
 int TestLauncher::testStackSpeed()
 {
 /*
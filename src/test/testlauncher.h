@@ -63,6 +63,8 @@ class TestLauncher final
 
         int testFps3();
 
+        int testFps4();
+
         int testInternal();
 
         int testDye();
@@ -83,6 +85,8 @@ class TestLauncher final
 
         int testBlitSpeed();
 
+        int testPathSpeed();
+
     private:
         std::string mTest;
 
@@ -62,7 +62,12 @@ Text::Text(const std::string &text,
     mOutlineColor(color != nullptr ? (isSpeech == Speech_true ?
         *color : theme->getColor(ThemeColorId::OUTLINE, 255)) : Color()),
     mIsSpeech(isSpeech),
-    mTextChanged(true)
+    mTextChanged(true),
+    mGridX1(0),
+    mGridY1(0),
+    mGridX2(0),
+    mGridY2(0),
+    mInGrid(false)
 {
     if (textManager == nullptr)
     {
@@ -152,6 +157,8 @@ void Text::adviseXY(const int x, const int y,
     {
         mX = x - mXOffset;
         mY = y;
+        if (textManager != nullptr)
+            textManager->updateText(this);
     }
 }
 
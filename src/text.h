@@ -99,6 +99,11 @@ class Text notfinal
         Color mOutlineColor;
         Speech mIsSpeech;      /**< Is this text a speech bubble? */
         bool mTextChanged;
+        int mGridX1;           /**< Cells occupied in manager. */
+        int mGridY1;
+        int mGridX2;
+        int mGridY2;
+        bool mInGrid;          /**< Is text added to manager cells? */
 
     protected:
         static ImageRect mBubble;   /**< Speech bubble graphic */
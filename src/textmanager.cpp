@@ -24,16 +24,29 @@
 
 #include "text.h"
 
+#include "utils/cast.h"
 #include "utils/foreach.h"
 
 #include <cstring>
 
 #include "debug.h"
 
+namespace
+{
+    // cell size in pixels
+    const int cellWidth = 64;
+    const int cellHeight = 32;
+    // must be power of two
+    const int bucketsCount = 1024;
+    // Number of lines to test for text
+    const int TEST = 50;
+}  // namespace
+
 TextManager *textManager = nullptr;
 
 TextManager::TextManager() :
-    mTextList()
+    mTextList(),
+    mBuckets(bucketsCount)
 {
 }
 
@@ -43,16 +56,33 @@ void TextManager::addText(Text *const text)
         return;
     place(text, nullptr, text->mX, text->mY, text->mHeight);
     mTextList.push_back(text);
+    addToGrid(text);
 }
 
 void TextManager::moveText(Text *const text,
-                           const int x, const int y) const
+                           const int x, const int y)
 {
     if (text == nullptr)
         return;
     text->mX = x;
     text->mY = y;
     place(text, text, text->mX, text->mY, text->mHeight);
+    updateText(text);
+}
+
+void TextManager::updateText(Text *const text)
+{
+    if (text == nullptr || !text->mInGrid)
+        return;
+    if (getCellX(text->mX) == text->mGridX1 &&
+        getCellY(text->mY) == text->mGridY1 &&
+        getCellX(getRight(text)) == text->mGridX2 &&
+        getCellY(getBottom(text)) == text->mGridY2)
+    {
+        return;
+    }
+    removeFromGrid(text);
+    addToGrid(text);
 }
 
 void TextManager::removeText(const Text *const text)
@@ -61,12 +91,88 @@ void TextManager::removeText(const Text *const text)
     {
         if (*ptr == text)
         {
+            removeFromGrid(*ptr);
             mTextList.erase(ptr);
             return;
         }
     }
 }
 
+int TextManager::getCellX(const int x)
+{
+    // round to negative infinity, texts can be left of map
+    if (x < 0)
+        return (x - cellWidth + 1) / cellWidth;
+    return x / cellWidth;
+}
+
+int TextManager::getCellY(const int y)
+{
+    if (y < 0)
+        return (y - cellHeight + 1) / cellHeight;
+    return y / cellHeight;
+}
+
+int TextManager::getRight(const Text *const text)
+{
+    // empty texts still use one cell
+    if (text->mWidth > 0)
+        return text->mX + text->mWidth - 1;
+    return text->mX;
+}
+
+int TextManager::getBottom(const Text *const text)
+{
+    if (text->mHeight > 0)
+        return text->mY + text->mHeight - 1;
+    return text->mY;
+}
+
+int TextManager::getBucket(const int cellX,
+                           const int cellY)
+{
+    return CAST_S32((CAST_U32(cellX) * 73856093U ^
+        CAST_U32(cellY) * 19349663U) & (bucketsCount - 1));
+}
+
+void TextManager::addToGrid(Text *const text)
+{
+    text->mGridX1 = getCellX(text->mX);
+    text->mGridY1 = getCellY(text->mY);
+    text->mGridX2 = getCellX(getRight(text));
+    text->mGridY2 = getCellY(getBottom(text));
+    text->mInGrid = true;
+    for (int cellY = text->mGridY1; cellY <= text->mGridY2; cellY ++)
+    {
+        for (int cellX = text->mGridX1; cellX <= text->mGridX2; cellX ++)
+            mBuckets[getBucket(cellX, cellY)].push_back(text);
+    }
+}
+
+void TextManager::removeFromGrid(Text *const text)
+{
+    if (!text->mInGrid)
+        return;
+    text->mInGrid = false;
+    // one entry removed for each cell, same as added
+    for (int cellY = text->mGridY1; cellY <= text->mGridY2; cellY ++)
+    {
+        for (int cellX = text->mGridX1; cellX <= text->mGridX2; cellX ++)
+        {
+            STD_VECTOR<Text*> &bucket = mBuckets[getBucket(cellX, cellY)];
+            FOR_EACH (STD_VECTOR<Text*>::iterator, it, bucket)
+            {
+                if (*it == text)
+                {
+                    *it = bucket.back();
+                    bucket.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
 TextManager::~TextManager()
 {
 }
@@ -90,35 +196,43 @@ void TextManager::place(const Text *const textObj,
         return;
     const int xLeft = textObj->mX;
     const int xRight1 = xLeft + textObj->mWidth;
-    const int TEST = 50;  // Number of lines to test for text
-    const int nBeings = 30;
     bool occupied[TEST];  // is some other text obscuring this line?
     std::memset(&occupied, 0, sizeof(occupied));  // set all to false
     const int wantedTop = (TEST - h) / 2;   // Entry in occupied at top of text
     const int occupiedTop = y - wantedTop;  // Line in map representing
                                             // to of occupied
-    int cnt = 0;
 
-    for (TextList::const_iterator ptr = mTextList.begin(),
-         pfEnd = mTextList.end();
-         ptr != pfEnd && cnt < nBeings;
-         ++ptr, cnt ++)
+    // texts from all cells near tested lines, text can be found
+    // many times, but this not changes result
+    const int cellX1 = getCellX(xLeft);
+    const int cellX2 = getCellX(getRight(textObj));
+    const int cellY1 = getCellY(occupiedTop);
+    const int cellY2 = getCellY(occupiedTop + TEST - 1);
+    for (int cellY = cellY1; cellY <= cellY2; cellY ++)
     {
-        const Text *const text = *ptr;
-
-        if (text != omit && text->mX + 1 <= xRight1
-            && text->mX + text->mWidth > xLeft)
+        for (int cellX = cellX1; cellX <= cellX2; cellX ++)
         {
-            int from = text->mY - occupiedTop;
-            int to = from + text->mHeight - 1;
-            if (to < 0 || from >= TEST)  // out of range considered
-                continue;
-            if (from < 0)
-                from = 0;
-            if (to >= TEST)
-                to = TEST - 1;
-            for (int i = from; i <= to; ++i)
-                occupied[i] = true;
+            const STD_VECTOR<Text*> &bucket =
+                mBuckets[getBucket(cellX, cellY)];
+            FOR_EACH (STD_VECTOR<Text*>::const_iterator, ptr, bucket)
+            {
+                const Text *const text = *ptr;
+
+                if (text != omit && text->mX + 1 <= xRight1
+                    && text->mX + text->mWidth > xLeft)
+                {
+                    int from = text->mY - occupiedTop;
+                    int to = from + text->mHeight - 1;
+                    if (to < 0 || from >= TEST)  // out of range considered
+                        continue;
+                    if (from < 0)
+                        from = 0;
+                    if (to >= TEST)
+                        to = TEST - 1;
+                    for (int i = from; i <= to; ++i)
+                        occupied[i] = true;
+                }
+            }
         }
     }
     bool ok = true;
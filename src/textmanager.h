@@ -23,6 +23,8 @@
 #ifndef TEXTMANAGER_H
 #define TEXTMANAGER_H
 
+#include "utils/vector.h"
+
 #include <list>
 
 #include "localconsts.h"
@@ -53,7 +55,12 @@ class TextManager final
         /**
          * Move the text around the screen
          */
-        void moveText(Text *const text, const int x, const int y) const;
+        void moveText(Text *const text, const int x, const int y);
+
+        /**
+         * Updates text cells after text position changed without placing
+         */
+        void updateText(Text *const text);
 
         /**
          * Remove the text from the manager
@@ -74,8 +81,29 @@ class TextManager final
         void place(const Text *const textObj, const Text *const omit,
                    const int &x, int &y, const int h) const;
 
+        void addToGrid(Text *const text);
+
+        void removeFromGrid(Text *const text);
+
+        static int getCellX(const int x) A_WARN_UNUSED;
+
+        static int getCellY(const int y) A_WARN_UNUSED;
+
+        static int getRight(const Text *const text) A_WARN_UNUSED;
+
+        static int getBottom(const Text *const text) A_WARN_UNUSED;
+
+        static int getBucket(const int cellX,
+                             const int cellY) A_WARN_UNUSED;
+
         typedef std::list<Text *> TextList; /**< The container type */
         TextList mTextList; /**< The container */
+
+        /**
+         * Texts by screen cells, hashed to fixed number of buckets.
+         * Text added to all cells what it covers.
+         */
+        STD_VECTOR<STD_VECTOR<Text*> > mBuckets;
 };
 
 extern TextManager *textManager;
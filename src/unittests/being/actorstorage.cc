@@ -0,0 +1,230 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "client.h"
+#include "configmanager.h"
+#include "configuration.h"
+#include "dirs.h"
+
+#include "being/actorsprite.h"
+#include "being/actorstorage.h"
+
+#include "fs/virtfs/fs.h"
+
+#include "utils/delete2.h"
+
+#include "debug.h"
+
+namespace
+{
+    class TestActor final : public ActorSprite
+    {
+        public:
+            explicit TestActor(const BeingId id) :
+                ActorSprite(id)
+            {
+            }
+
+            A_DELETE_COPY(TestActor)
+
+            void draw(Graphics *const graphics A_UNUSED,
+                      const int offsetX A_UNUSED,
+                      const int offsetY A_UNUSED) const override final
+            {
+            }
+    };
+}  // namespace
+
+TEST_CASE("ActorStorage tests", "actorstorage")
+{
+    client = new Client;
+    VirtFs::mountDirSilent("data", Append_false);
+    VirtFs::mountDirSilent("../data", Append_false);
+
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    ConfigManager::initConfiguration();
+    setConfigDefaults2(config);
+
+    TestActor *const actor1 = new TestActor(fromInt(1, BeingId));
+    TestActor *const actor2 = new TestActor(fromInt(2, BeingId));
+    TestActor *const actor3 = new TestActor(fromInt(3, BeingId));
+
+    SECTION("add")
+    {
+        ActorStorage storage;
+        REQUIRE(storage.empty());
+        storage.add(actor1);
+        storage.add(actor2);
+        storage.add(actor3);
+        // adding again not changes storage
+        storage.add(actor2);
+        REQUIRE(storage.size() == 3);
+        REQUIRE(storage.contains(actor1));
+        REQUIRE(storage.contains(actor2));
+        REQUIRE(storage.contains(actor3));
+        REQUIRE(storage.findById(fromInt(1, BeingId)) == actor1);
+        REQUIRE(storage.findById(fromInt(2, BeingId)) == actor2);
+        REQUIRE(storage.findById(fromInt(3, BeingId)) == actor3);
+        REQUIRE(storage.findById(fromInt(4, BeingId)) == nullptr);
+        REQUIRE(storage.getAll()[0] == actor1);
+        REQUIRE(storage.getAll()[1] == actor2);
+        REQUIRE(storage.getAll()[2] == actor3);
+        storage.clear();
+    }
+
+    SECTION("remove")
+    {
+        ActorStorage storage;
+        storage.add(actor1);
+        storage.add(actor2);
+        storage.add(actor3);
+        storage.remove(actor1);
+        REQUIRE(storage.size() == 2);
+        REQUIRE_FALSE(storage.contains(actor1));
+        REQUIRE(storage.findById(fromInt(1, BeingId)) == nullptr);
+        // last actor moved to removed position
+        REQUIRE(storage.getAll()[0] == actor3);
+        REQUIRE(storage.getAll()[1] == actor2);
+        REQUIRE(storage.findById(fromInt(2, BeingId)) == actor2);
+        REQUIRE(storage.findById(fromInt(3, BeingId)) == actor3);
+
+        // removing not added actor do nothing
+        storage.remove(actor1);
+        REQUIRE(storage.size() == 2);
+
+        storage.remove(actor2);
+        storage.remove(actor3);
+        REQUIRE(storage.empty());
+        REQUIRE(storage.findById(fromInt(3, BeingId)) == nullptr);
+
+        storage.add(actor1);
+        REQUIRE(storage.size() == 1);
+        REQUIRE(storage.findById(fromInt(1, BeingId)) == actor1);
+        storage.clear();
+        REQUIRE(storage.empty());
+        REQUIRE_FALSE(storage.contains(actor1));
+        REQUIRE(storage.findById(fromInt(1, BeingId)) == nullptr);
+    }
+
+    SECTION("same id")
+    {
+        ActorStorage storage;
+        storage.add(actor1);
+        actor2->setId(fromInt(1, BeingId));
+        storage.add(actor2);
+        REQUIRE(storage.size() == 2);
+        REQUIRE(storage.findById(fromInt(1, BeingId)) == actor2);
+        // old actor not removes id of new actor
+        storage.remove(actor1);
+        REQUIRE(storage.findById(fromInt(1, BeingId)) == actor2);
+        storage.remove(actor2);
+        REQUIRE(storage.findById(fromInt(1, BeingId)) == nullptr);
+    }
+
+    SECTION("generation reuse")
+    {
+        ActorStorage storage;
+        storage.add(actor1);
+        // id changed after adding, so old id left in storage
+        actor1->setId(fromInt(5, BeingId));
+        storage.remove(actor1);
+        REQUIRE(storage.empty());
+
+        // new actor reuses slot of removed actor
+        storage.add(actor3);
+        REQUIRE(storage.size() == 1);
+        REQUIRE(storage.findById(fromInt(3, BeingId)) == actor3);
+        REQUIRE(storage.findById(fromInt(1, BeingId)) == nullptr);
+        REQUIRE(storage.findById(fromInt(5, BeingId)) == nullptr);
+        storage.clear();
+    }
+
+    SECTION("handles")
+    {
+        ActorStorage storage;
+        REQUIRE(storage.get(ActorHandle()) == nullptr);
+        // not added actor has no handle
+        REQUIRE(storage.getHandle(actor1).slot == -1);
+
+        storage.add(actor1);
+        storage.add(actor2);
+        const ActorHandle handle1 = storage.getHandle(actor1);
+        const ActorHandle handle2 = storage.getHandle(actor2);
+        REQUIRE(storage.get(handle1) == actor1);
+        REQUIRE(storage.get(handle2) == actor2);
+        REQUIRE(storage.get(ActorHandle(100, 0U)) == nullptr);
+
+        // handle of removed actor not finds actor what reused slot
+        storage.remove(actor1);
+        REQUIRE(storage.get(handle1) == nullptr);
+        storage.add(actor3);
+        REQUIRE(storage.getHandle(actor3).slot == handle1.slot);
+        REQUIRE(storage.get(handle1) == nullptr);
+        REQUIRE(storage.get(storage.getHandle(actor3)) == actor3);
+        // moving actor in dense array not changes its handle
+        REQUIRE(storage.get(handle2) == actor2);
+
+        storage.clear();
+        REQUIRE(storage.get(handle2) == nullptr);
+    }
+
+    SECTION("many")
+    {
+        ActorStorage storage;
+        STD_VECTOR<TestActor*> actors;
+        for (int f = 0; f < 1000; f ++)
+        {
+            TestActor *const actor = new TestActor(fromInt(f * 64 + 10,
+                BeingId));
+            actors.push_back(actor);
+            storage.add(actor);
+        }
+        for (int f = 0; f < 1000; f += 2)
+            storage.remove(actors[f]);
+        REQUIRE(storage.size() == 500);
+        for (int f = 0; f < 1000; f ++)
+        {
+            if ((f % 2) == 0)
+            {
+                REQUIRE(storage.findById(fromInt(f * 64 + 10, BeingId))
+                    == nullptr);
+            }
+            else
+            {
+                REQUIRE(storage.findById(fromInt(f * 64 + 10, BeingId))
+                    == actors[f]);
+            }
+        }
+        storage.clear();
+        for (int f = 0; f < 1000; f ++)
+            delete actors[f];
+    }
+
+    delete actor1;
+    delete actor2;
+    delete actor3;
+    delete2(client)
+    VirtFs::unmountDirSilent("data");
+    VirtFs::unmountDirSilent("../data");
+}
@@ -0,0 +1,91 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "being/beingcacheentry.h"
+#include "being/beinginfocache.h"
+
+#include "debug.h"
+
+TEST_CASE("BeingInfoCache get", "")
+{
+    BeingInfoCache cache(3);
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.get(fromInt(1, BeingId)) == nullptr);
+    REQUIRE(cache.getMisses() == 1);
+
+    BeingCacheEntry *const entry = cache.add(fromInt(1, BeingId));
+    REQUIRE(entry != nullptr);
+    REQUIRE(entry->getId() == fromInt(1, BeingId));
+    REQUIRE(cache.add(fromInt(1, BeingId)) == entry);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.get(fromInt(1, BeingId)) == entry);
+    REQUIRE(cache.getHits() == 1);
+    REQUIRE(cache.getMisses() == 1);
+}
+
+TEST_CASE("BeingInfoCache lru", "")
+{
+    BeingInfoCache cache(3);
+    REQUIRE(cache.add(fromInt(1, BeingId)) != nullptr);
+    REQUIRE(cache.add(fromInt(2, BeingId)) != nullptr);
+    REQUIRE(cache.add(fromInt(3, BeingId)) != nullptr);
+    REQUIRE(cache.get(fromInt(1, BeingId)) != nullptr);
+    REQUIRE(cache.add(fromInt(4, BeingId)) != nullptr);
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.get(fromInt(2, BeingId)) == nullptr);
+    REQUIRE(cache.get(fromInt(1, BeingId)) != nullptr);
+    REQUIRE(cache.get(fromInt(3, BeingId)) != nullptr);
+    REQUIRE(cache.get(fromInt(4, BeingId)) != nullptr);
+    REQUIRE(cache.getHits() == 4);
+    REQUIRE(cache.getMisses() == 1);
+
+    // 3 is oldest now
+    REQUIRE(cache.get(fromInt(1, BeingId)) != nullptr);
+    REQUIRE(cache.get(fromInt(4, BeingId)) != nullptr);
+    REQUIRE(cache.add(fromInt(5, BeingId)) != nullptr);
+    REQUIRE(cache.get(fromInt(3, BeingId)) == nullptr);
+    REQUIRE(cache.get(fromInt(1, BeingId)) != nullptr);
+    REQUIRE(cache.get(fromInt(5, BeingId)) != nullptr);
+    REQUIRE(cache.getHits() == 8);
+    REQUIRE(cache.getMisses() == 2);
+}
+
+TEST_CASE("BeingInfoCache many", "")
+{
+    BeingInfoCache cache(50);
+    for (int f = 0; f < 1000; f ++)
+        REQUIRE(cache.add(fromInt(f * 64, BeingId)) != nullptr);
+    REQUIRE(cache.size() == 50);
+    for (int f = 0; f < 950; f ++)
+        REQUIRE(cache.get(fromInt(f * 64, BeingId)) == nullptr);
+    for (int f = 950; f < 1000; f ++)
+    {
+        const BeingCacheEntry *const entry = cache.get(fromInt(f * 64,
+            BeingId));
+        REQUIRE(entry != nullptr);
+        REQUIRE(entry->getId() == fromInt(f * 64, BeingId));
+    }
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.get(fromInt(999 * 64, BeingId)) == nullptr);
+}
@@ -0,0 +1,98 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "being/spriteordercache.h"
+
+#include "debug.h"
+
+namespace
+{
+    STD_VECTOR<int> makeKey(const int id,
+                            const int dir)
+    {
+        STD_VECTOR<int> key;
+        key.push_back(id);
+        key.push_back(0);
+        key.push_back(dir);
+        return key;
+    }
+}  // namespace
+
+TEST_CASE("SpriteOrderCache get", "")
+{
+    SpriteOrderCache cache(3);
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.get(makeKey(1, 0)) == nullptr);
+    REQUIRE(cache.getMisses() == 1);
+
+    SpriteOrder *const order = cache.add(makeKey(1, 0));
+    REQUIRE(order != nullptr);
+    REQUIRE(order->reordered == false);
+    order->remap.push_back(1);
+    order->remap.push_back(0);
+    order->reordered = true;
+    REQUIRE(cache.size() == 1);
+
+    const SpriteOrder *const order2 = cache.get(makeKey(1, 0));
+    REQUIRE(order2 == order);
+    REQUIRE(order2->remap.size() == 2);
+    REQUIRE(order2->remap[0] == 1);
+    REQUIRE(cache.get(makeKey(1, 1)) == nullptr);
+    REQUIRE(cache.getHits() == 1);
+    REQUIRE(cache.getMisses() == 2);
+
+    // adding existing key keeps result, caller clears it
+    REQUIRE(cache.add(makeKey(1, 0)) == order);
+    REQUIRE(order->remap.size() == 2);
+    REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("SpriteOrderCache lru", "")
+{
+    SpriteOrderCache cache(3);
+    REQUIRE(cache.add(makeKey(1, 0)) != nullptr);
+    REQUIRE(cache.add(makeKey(2, 0)) != nullptr);
+    REQUIRE(cache.add(makeKey(3, 0)) != nullptr);
+    REQUIRE(cache.get(makeKey(1, 0)) != nullptr);
+    REQUIRE(cache.add(makeKey(4, 0)) != nullptr);
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.get(makeKey(2, 0)) == nullptr);
+    REQUIRE(cache.get(makeKey(1, 0)) != nullptr);
+    REQUIRE(cache.get(makeKey(3, 0)) != nullptr);
+    REQUIRE(cache.get(makeKey(4, 0)) != nullptr);
+}
+
+TEST_CASE("SpriteOrderCache many", "")
+{
+    SpriteOrderCache cache(50);
+    for (int f = 0; f < 1000; f ++)
+        REQUIRE(cache.add(makeKey(f, f % 10)) != nullptr);
+    REQUIRE(cache.size() == 50);
+    for (int f = 0; f < 950; f ++)
+        REQUIRE(cache.get(makeKey(f, f % 10)) == nullptr);
+    for (int f = 950; f < 1000; f ++)
+        REQUIRE(cache.get(makeKey(f, f % 10)) != nullptr);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.get(makeKey(999, 9)) == nullptr);
+}
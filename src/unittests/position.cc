@@ -0,0 +1,125 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "unittests/unittests.h"
+
+#include "position.h"
+
+#include "utils/foreach.h"
+
+#include "debug.h"
+
+TEST_CASE("Path", "")
+{
+    Path path;
+    REQUIRE(path.empty());
+    REQUIRE(path.size() == 0);
+
+    SECTION("push and pop")
+    {
+        path.push_back(Position(1, 2));
+        path.push_back(Position(3, 4));
+        path.push_back(Position(5, 6));
+        REQUIRE(path.size() == 3);
+        REQUIRE(path.front().x == 1);
+        REQUIRE(path.back().y == 6);
+
+        path.pop_front();
+        REQUIRE(path.size() == 2);
+        REQUIRE(path.front().x == 3);
+        REQUIRE(path.front().y == 4);
+
+        path.pop_back();
+        REQUIRE(path.size() == 1);
+        REQUIRE(path.front().x == 3);
+        REQUIRE(path.back().x == 3);
+
+        path.pop_front();
+        REQUIRE(path.empty());
+        path.push_back(Position(7, 8));
+        REQUIRE(path.size() == 1);
+        REQUIRE(path.front().x == 7);
+    }
+
+    SECTION("copy")
+    {
+        path.push_back(Position(1, 2));
+        path.push_back(Position(3, 4));
+        path.pop_front();
+        Path path2(path);
+        REQUIRE(path2.size() == 1);
+        REQUIRE(path2.front().x == 3);
+        path2.push_back(Position(5, 6));
+        path = path2;
+        REQUIRE(path.size() == 2);
+        REQUIRE(path.front().x == 3);
+        REQUIRE(path.back().x == 5);
+    }
+
+    SECTION("append")
+    {
+        Path path2;
+        path.push_back(Position(1, 2));
+        path2.push_back(Position(3, 4));
+        path2.push_back(Position(5, 6));
+        path2.pop_front();
+        path.append(path2);
+        REQUIRE(path.size() == 2);
+        REQUIRE(path.back().x == 5);
+    }
+
+    SECTION("clear capacity")
+    {
+        const size_t maxCapacity = Path::maxCapacity;
+        for (int f = 0; f < 10; f ++)
+            path.push_back(Position(f, f));
+        const size_t capacity = path.capacity();
+        path.clear();
+        REQUIRE(path.empty());
+        REQUIRE(path.capacity() == capacity);
+
+        for (size_t f = 0; f <= maxCapacity; f ++)
+            path.push_back(Position(1, 2));
+        REQUIRE(path.capacity() > maxCapacity);
+        path.clear();
+        REQUIRE(path.empty());
+        REQUIRE(path.capacity() <= maxCapacity);
+        path.push_back(Position(3, 4));
+        REQUIRE(path.front().x == 3);
+    }
+
+    SECTION("reverse iterate")
+    {
+        path.push_back(Position(1, 2));
+        path.push_back(Position(3, 4));
+        path.push_back(Position(5, 6));
+        path.pop_front();
+        int sum = 0;
+        int last = 0;
+        FOR_EACHR (PathRIterator, it, path)
+        {
+            sum += (*it).x;
+            last = (*it).x;
+        }
+        REQUIRE(sum == 8);
+        REQUIRE(last == 3);
+    }
+}
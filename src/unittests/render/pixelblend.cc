@@ -0,0 +1,275 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "render/pixelblend.h"
+
+#include "utils/cast.h"
+#include "utils/cpu.h"
+#include "utils/vector.h"
+
+#include "debug.h"
+
+namespace
+{
+    uint32_t randomValue = 12345U;
+
+    uint32_t nextRandom()
+    {
+        randomValue = randomValue * 1103515245U + 12345U;
+        return (randomValue >> 16) | (randomValue << 16);
+    }
+
+    void fillRandom(STD_VECTOR<uint32_t> &data)
+    {
+        const size_t sz = data.size();
+        for (size_t f = 0; f < sz; f ++)
+            data[f] = nextRandom();
+    }
+
+    // blending from SDL2SoftwareGraphics::drawHLine before PixelBlend
+    void hlineBlend(uint32_t *q,
+                    const int count,
+                    const uint32_t pixel,
+                    const unsigned int alpha)
+    {
+        unsigned char a = CAST_U8(alpha);
+        unsigned char a1 = CAST_U8(255U - a);
+        const unsigned int b0 = (pixel & 0xff) * a;
+        const unsigned int g0 = (pixel & 0xff00) * a;
+        const unsigned int r0 = (pixel & 0xff0000) * a;
+        for (int f = 0; f < count; f ++)
+        {
+            const unsigned int b = (b0 + (*q & 0xff) * a1) >> 8;
+            const unsigned int g = (g0 + (*q & 0xff00) * a1) >> 8;
+            const unsigned int r = (r0 + (*q & 0xff0000) * a1) >> 8;
+            *q = (b & 0xff) | (g & 0xff00) | (r & 0xff0000);
+            q++;
+        }
+    }
+
+    // table blending from SDL2SoftwareGraphics::fillRectangle
+    void tableBlend(uint32_t *const p0,
+                    const int count,
+                    const uint32_t pixel,
+                    const unsigned int alpha)
+    {
+        const unsigned rMask = 0xff0000U;
+        const unsigned gMask = 0xff00U;
+        const unsigned bMask = 0xffU;
+        const unsigned rShift = rMask / 0xff;
+        const unsigned gShift = gMask / 0xff;
+        const unsigned bShift = bMask / 0xff;
+        const unsigned pb = (pixel & bMask) * alpha;
+        const unsigned pg = (pixel & gMask) * alpha;
+        const unsigned pr = (pixel & rMask) * alpha;
+        const unsigned a0 = (255 - alpha);
+        const unsigned int a1 = a0 * bShift;
+        const unsigned int a2 = a0 * gShift;
+        const unsigned int a3 = a0 * rShift;
+        unsigned int cR[0x100];
+        unsigned int cG[0x100];
+        unsigned int cB[0x100];
+        for (int f = 0; f <= 0xff; f ++)
+        {
+            cB[f] = ((pb + f * a1) >> 8) & bMask;
+            cG[f] = ((pg + f * a2) >> 8) & gMask;
+            cR[f] = ((pr + f * a3) >> 8) & rMask;
+        }
+        for (int x = 0; x < count; x++)
+        {
+            uint32_t *const p = p0 + x;
+            const uint32_t dst = *p;
+            *p = cB[dst & bMask / bShift]
+                | cG[(dst & gMask) / gShift]
+                | cR[(dst & rMask) / rShift];
+        }
+    }
+
+    const unsigned int alphas[] =
+    {
+        0U, 1U, 0x40U, 0x7fU, 0x80U, 0xb0U, 0xfeU, 0xffU
+    };
+    const int alphasCount = 8;
+
+    const uint32_t masks[] =
+    {
+        0xffffffU, 0xffffff00U, 0xff00ffffU, 0xffffffffU
+    };
+    const int masksCount = 4;
+
+    // compare function with default, including unaligned start and tail
+    bool compareBlend(const PixelBlend::BlendFunctionPtr func)
+    {
+        for (int count = 0; count < 70; count ++)
+        {
+            for (int offset = 0; offset < 3; offset ++)
+            {
+                for (int k = 0; k < alphasCount; k ++)
+                {
+                    for (int m = 0; m < masksCount; m ++)
+                    {
+                        STD_VECTOR<uint32_t> data1(count + 4);
+                        fillRandom(data1);
+                        STD_VECTOR<uint32_t> data2 = data1;
+                        const uint32_t pixel = nextRandom();
+                        PixelBlend::blendDefault(&data1[offset], count,
+                            pixel, alphas[k], masks[m]);
+                        func(&data2[offset], count,
+                            pixel, alphas[k], masks[m]);
+                        if (data1 != data2)
+                            return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool compareFill(const PixelBlend::FillFunctionPtr func)
+    {
+        for (int count = 0; count < 70; count ++)
+        {
+            for (int offset = 0; offset < 3; offset ++)
+            {
+                STD_VECTOR<uint32_t> data1(count + 4);
+                fillRandom(data1);
+                STD_VECTOR<uint32_t> data2 = data1;
+                const uint32_t pixel = nextRandom();
+                PixelBlend::fillDefault(&data1[offset], count, pixel);
+                func(&data2[offset], count, pixel);
+                if (data1 != data2)
+                    return false;
+            }
+        }
+        return true;
+    }
+}  // namespace
+
+TEST_CASE("PixelBlend getColorMask", "")
+{
+    REQUIRE(PixelBlend::getColorMask(0xff0000U, 0xff00U, 0xffU) ==
+        0xffffffU);
+    REQUIRE(PixelBlend::getColorMask(0xffU, 0xff00U, 0xff0000U) ==
+        0xffffffU);
+    REQUIRE(PixelBlend::getColorMask(0xff000000U, 0xff0000U, 0xff00U) ==
+        0xffffff00U);
+    REQUIRE(PixelBlend::getColorMask(0x3ff00000U, 0xffc00U, 0x3ffU) == 0U);
+    REQUIRE(PixelBlend::getColorMask(0xf800U, 0x7e0U, 0x1fU) == 0U);
+}
+
+TEST_CASE("PixelBlend blendDefault", "")
+{
+    SECTION("simple")
+    {
+        uint32_t data[2];
+        data[0] = 0xff000000U;
+        data[1] = 0x00ffffffU;
+        PixelBlend::blendDefault(&data[0], 2, 0x00ffffffU, 0x80U, 0xffffffU);
+        REQUIRE(data[0] == 0x007f7f7fU);
+        REQUIRE(data[1] == 0x00fefefeU);
+    }
+
+    SECTION("same as hline")
+    {
+        for (int k = 0; k < alphasCount; k ++)
+        {
+            STD_VECTOR<uint32_t> data1(67);
+            fillRandom(data1);
+            STD_VECTOR<uint32_t> data2 = data1;
+            const uint32_t pixel = nextRandom() & 0xffffffU;
+            hlineBlend(&data1[0], 67, pixel, alphas[k]);
+            PixelBlend::blendDefault(&data2[0], 67, pixel, alphas[k],
+                0xffffffU);
+            REQUIRE(data1 == data2);
+        }
+    }
+
+    SECTION("same as table")
+    {
+        for (int k = 0; k < alphasCount; k ++)
+        {
+            STD_VECTOR<uint32_t> data1(67);
+            fillRandom(data1);
+            STD_VECTOR<uint32_t> data2 = data1;
+            const uint32_t pixel = nextRandom() & 0xffffffU;
+            tableBlend(&data1[0], 67, pixel, alphas[k]);
+            PixelBlend::blendDefault(&data2[0], 67, pixel, alphas[k],
+                0xffffffU);
+            REQUIRE(data1 == data2);
+        }
+    }
+}
+
+TEST_CASE("PixelBlend fillDefault", "")
+{
+    uint32_t data[4];
+    data[0] = 1U;
+    data[1] = 2U;
+    data[2] = 3U;
+    data[3] = 4U;
+    PixelBlend::fillDefault(&data[1], 2, 0x12345678U);
+    REQUIRE(data[0] == 1U);
+    REQUIRE(data[1] == 0x12345678U);
+    REQUIRE(data[2] == 0x12345678U);
+    REQUIRE(data[3] == 4U);
+}
+
+#ifdef SIMD_SUPPORTED
+TEST_CASE("PixelBlend sse2", "")
+{
+    if ((Cpu::getFlags() & Cpu::FEATURE_SSE2) == 0U)
+        return;
+
+    SECTION("blend")
+    {
+        REQUIRE(compareBlend(&PixelBlend::blendSse2));
+    }
+
+    SECTION("fill")
+    {
+        REQUIRE(compareFill(&PixelBlend::fillSse2));
+    }
+}
+
+TEST_CASE("PixelBlend avx2", "")
+{
+    if ((Cpu::getFlags() & Cpu::FEATURE_AVX2) == 0U)
+        return;
+
+    SECTION("blend")
+    {
+        REQUIRE(compareBlend(&PixelBlend::blendAvx2));
+    }
+
+    SECTION("fill")
+    {
+        REQUIRE(compareFill(&PixelBlend::fillAvx2));
+    }
+}
+#endif  // SIMD_SUPPORTED
+
+TEST_CASE("PixelBlend initFunctions", "")
+{
+    PixelBlend::initFunctions();
+    REQUIRE(compareBlend(PixelBlend::blend));
+    REQUIRE(compareFill(PixelBlend::fill));
+}
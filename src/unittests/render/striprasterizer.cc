@@ -0,0 +1,287 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef USE_SDL2
+
+#include "unittests/unittests.h"
+
+#include "render/pixelblend.h"
+#include "render/striprasterizer.h"
+
+#include "utils/cast.h"
+
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_endian.h>
+PRAGMA48(GCC diagnostic pop)
+
+#include <cstring>
+
+#include "debug.h"
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+
+namespace
+{
+    uint32_t randomValue = 54321U;
+
+    uint32_t nextRandom()
+    {
+        randomValue = randomValue * 1103515245U + 12345U;
+        return (randomValue >> 16) | (randomValue << 16);
+    }
+
+    SDL_Surface *createSurface(const int width,
+                               const int height,
+                               const bool alpha)
+    {
+        SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+            width, height, 32,
+            0x00ff0000U, 0x0000ff00U, 0x000000ffU,
+            alpha ? 0xff000000U : 0U);
+        uint8_t *const pixels = static_cast<uint8_t*>(surface->pixels);
+        for (int y = 0; y < height; y ++)
+        {
+            uint32_t *const row = reinterpret_cast<uint32_t*>(
+                pixels + y * surface->pitch);
+            for (int x = 0; x < width; x ++)
+                row[x] = nextRandom();
+        }
+        return surface;
+    }
+
+    SDL_Surface *copySurface(const SDL_Surface *const src)
+    {
+        SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+            src->w, src->h, 32,
+            src->format->Rmask, src->format->Gmask, src->format->Bmask,
+            src->format->Amask);
+        for (int y = 0; y < src->h; y ++)
+        {
+            memcpy(static_cast<uint8_t*>(surface->pixels)
+                + y * surface->pitch,
+                static_cast<const uint8_t*>(src->pixels) + y * src->pitch,
+                src->w * 4);
+        }
+        return surface;
+    }
+
+    bool isSamePixels(const SDL_Surface *const surface1,
+                      const SDL_Surface *const surface2)
+    {
+        for (int y = 0; y < surface1->h; y ++)
+        {
+            if (memcmp(static_cast<const uint8_t*>(surface1->pixels)
+                + y * surface1->pitch,
+                static_cast<const uint8_t*>(surface2->pixels)
+                + y * surface2->pitch,
+                surface1->w * 4) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    SDL_Rect makeRect(const int x, const int y, const int w, const int h)
+    {
+        SDL_Rect rect;
+        rect.x = x;
+        rect.y = y;
+        rect.w = w;
+        rect.h = h;
+        return rect;
+    }
+
+    // serial drawing what used by renderer if strips disabled
+    void blitSerial(SDL_Surface *const src,
+                    SDL_Rect srcRect,
+                    SDL_Rect dstRect,
+                    SDL_Surface *const screen)
+    {
+        SDL_LowerBlit(src, &srcRect, screen, &dstRect);
+    }
+
+    void fillAlphaSerial(SDL_Surface *const screen,
+                         const SDL_Rect &rect,
+                         const uint32_t pixel,
+                         const unsigned int alpha)
+    {
+        const SDL_PixelFormat *const format = screen->format;
+        const uint32_t colorMask = PixelBlend::getColorMask(format->Rmask,
+            format->Gmask,
+            format->Bmask);
+        for (int y = rect.y; y < rect.y + rect.h; y ++)
+        {
+            uint32_t *const p0 = reinterpret_cast<uint32_t*>(
+                static_cast<uint8_t*>(screen->pixels)
+                + y * screen->pitch);
+            PixelBlend::blend(p0 + rect.x, rect.w, pixel, alpha, colorMask);
+        }
+    }
+}  // namespace
+
+TEST_CASE("StripRasterizer flush", "")
+{
+    // odd height, so strips have different heights
+    SDL_Surface *const screen1 = createSurface(97, 61, false);
+    SDL_Surface *const screen2 = copySurface(screen1);
+    SDL_Surface *const image1 = createSurface(40, 30, true);
+    SDL_Surface *const image2 = createSurface(25, 25, false);
+    StripRasterizer *const rasterizer = new StripRasterizer(3);
+    REQUIRE(rasterizer->getStripsCount() > 1);
+    REQUIRE(rasterizer->isEmpty() == true);
+
+    SECTION("blits")
+    {
+        SDL_SetSurfaceBlendMode(image1, SDL_BLENDMODE_BLEND);
+        const SDL_Rect src1 = makeRect(0, 0, 40, 30);
+        const SDL_Rect dst1 = makeRect(3, 0, 40, 30);
+        const SDL_Rect src2 = makeRect(5, 2, 30, 28);
+        const SDL_Rect dst2 = makeRect(50, 20, 30, 28);
+        const SDL_Rect src3 = makeRect(0, 0, 25, 25);
+        const SDL_Rect dst3 = makeRect(10, 36, 25, 25);
+        blitSerial(image1, src1, dst1, screen1);
+        blitSerial(image1, src2, dst2, screen1);
+        blitSerial(image2, src3, dst3, screen1);
+        REQUIRE(rasterizer->addBlit(image1, src1, dst1) == true);
+        REQUIRE(rasterizer->addBlit(image1, src2, dst2) == true);
+        REQUIRE(rasterizer->addBlit(image2, src3, dst3) == true);
+        REQUIRE(rasterizer->isEmpty() == false);
+        rasterizer->flush(screen2);
+        REQUIRE(rasterizer->isEmpty() == true);
+        REQUIRE(isSamePixels(screen1, screen2) == true);
+    }
+
+    SECTION("surface settings changed after blit added")
+    {
+        const SDL_Rect src1 = makeRect(0, 0, 40, 30);
+        const SDL_Rect dst1 = makeRect(20, 10, 40, 30);
+        const SDL_Rect src2 = makeRect(0, 0, 25, 25);
+        const SDL_Rect dst2 = makeRect(30, 30, 25, 25);
+
+        SDL_SetSurfaceBlendMode(image1, SDL_BLENDMODE_BLEND);
+        SDL_SetSurfaceAlphaMod(image1, 128);
+        SDL_SetSurfaceColorMod(image1, 255, 100, 50);
+        SDL_SetColorKey(image2, SDL_TRUE,
+            *static_cast<uint32_t*>(image2->pixels));
+        blitSerial(image1, src1, dst1, screen1);
+        blitSerial(image2, src2, dst2, screen1);
+        REQUIRE(rasterizer->addBlit(image1, src1, dst1) == true);
+        REQUIRE(rasterizer->addBlit(image2, src2, dst2) == true);
+
+        SDL_SetSurfaceBlendMode(image1, SDL_BLENDMODE_NONE);
+        SDL_SetSurfaceAlphaMod(image1, 255);
+        SDL_SetSurfaceColorMod(image1, 255, 255, 255);
+        SDL_SetColorKey(image2, SDL_FALSE, 0);
+        const SDL_Rect dst3 = makeRect(30, 30, 40, 30);
+        blitSerial(image1, src1, dst3, screen1);
+        REQUIRE(rasterizer->addBlit(image1, src1, dst3) == true);
+
+        rasterizer->flush(screen2);
+        REQUIRE(isSamePixels(screen1, screen2) == true);
+    }
+
+    SECTION("fills")
+    {
+        const SDL_Rect rect1 = makeRect(0, 0, 97, 61);
+        const SDL_Rect rect2 = makeRect(7, 5, 60, 40);
+        const SDL_Rect rect3 = makeRect(30, 14, 67, 47);
+        const SDL_Rect rect4 = makeRect(1, 59, 96, 1);
+        const uint32_t pixel1 = nextRandom() & 0xffffffU;
+        const uint32_t pixel2 = nextRandom() & 0xffffffU;
+        const uint32_t pixel3 = nextRandom() & 0xffffffU;
+
+        fillAlphaSerial(screen1, rect1, pixel1, 0x40U);
+        SDL_FillRect(screen1, &rect2, pixel2);
+        fillAlphaSerial(screen1, rect3, pixel3, 0xb0U);
+        SDL_FillRect(screen1, &rect4, pixel1);
+        REQUIRE(rasterizer->addFillAlpha(screen2->format,
+            rect1, pixel1, 0x40U) == true);
+        rasterizer->addFill(rect2, pixel2);
+        REQUIRE(rasterizer->addFillAlpha(screen2->format,
+            rect3, pixel3, 0xb0U) == true);
+        rasterizer->addFill(rect4, pixel1);
+        rasterizer->flush(screen2);
+        REQUIRE(isSamePixels(screen1, screen2) == true);
+    }
+
+    SECTION("mixed")
+    {
+        SDL_SetSurfaceBlendMode(image1, SDL_BLENDMODE_BLEND);
+        for (int f = 0; f < 50; f ++)
+        {
+            const int x = CAST_S32(nextRandom() % 60U);
+            const int y = CAST_S32(nextRandom() % 35U);
+            const int w = 1 + CAST_S32(nextRandom() % 25U);
+            const int h = 1 + CAST_S32(nextRandom() % 25U);
+            const SDL_Rect dst = makeRect(x, y, w, h);
+            const uint32_t pixel = nextRandom() & 0xffffffU;
+            switch (f % 4)
+            {
+                case 0:
+                {
+                    const SDL_Rect src = makeRect(0, 0, w, h);
+                    blitSerial(image1, src, dst, screen1);
+                    REQUIRE(rasterizer->addBlit(image1, src, dst) == true);
+                    break;
+                }
+                case 1:
+                {
+                    const SDL_Rect src = makeRect(0, 0, w, h);
+                    blitSerial(image2, src, dst, screen1);
+                    REQUIRE(rasterizer->addBlit(image2, src, dst) == true);
+                    break;
+                }
+                case 2:
+                    SDL_FillRect(screen1, &dst, pixel);
+                    rasterizer->addFill(dst, pixel);
+                    break;
+                default:
+                {
+                    const unsigned int alpha = nextRandom() & 0xffU;
+                    fillAlphaSerial(screen1, dst, pixel, alpha);
+                    REQUIRE(rasterizer->addFillAlpha(screen2->format,
+                        dst, pixel, alpha) == true);
+                    break;
+                }
+            }
+        }
+        rasterizer->flush(screen2);
+        REQUIRE(isSamePixels(screen1, screen2) == true);
+
+        // second frame uses cached strips and source surfaces
+        const SDL_Rect src = makeRect(0, 0, 40, 30);
+        const SDL_Rect dst = makeRect(50, 25, 40, 30);
+        blitSerial(image1, src, dst, screen1);
+        REQUIRE(rasterizer->addBlit(image1, src, dst) == true);
+        rasterizer->flush(screen2);
+        REQUIRE(isSamePixels(screen1, screen2) == true);
+    }
+
+    delete rasterizer;
+    MSDL_FreeSurface(image2);
+    MSDL_FreeSurface(image1);
+    MSDL_FreeSurface(screen2);
+    MSDL_FreeSurface(screen1);
+}
+
+#endif  // SDL_BYTEORDER == SDL_LIL_ENDIAN
+#endif  // USE_SDL2
@@ -0,0 +1,94 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "settings.h"
+
+#include "resources/atlas/atlascache.h"
+
+#include <cstdio>
+
+#include "debug.h"
+
+TEST_CASE("AtlasCache save and load", "")
+{
+    const std::string oldDir = settings.localDataDir;
+    settings.localDataDir = ".";
+    const std::string layoutName = "./atlascache/test.txt";
+    ::remove(layoutName.c_str());
+
+    AtlasCache *cache = new AtlasCache("test", 123U);
+    REQUIRE(cache->load() == false);
+    AtlasCache::Page page("atlas_test_image1.png", 64, 32);
+    page.items.push_back(AtlasCache::Item("image1.png", 0, 0, 32, 32));
+    page.items.push_back(AtlasCache::Item("image 2.png|W:#ff0000",
+        32, 0, 16, 8));
+    cache->addPage(page);
+    REQUIRE(cache->getPages().size() == 1);
+    REQUIRE(cache->save() == true);
+    delete cache;
+
+    SECTION("same key")
+    {
+        cache = new AtlasCache("test", 123U);
+        REQUIRE(cache->load() == true);
+        const STD_VECTOR<AtlasCache::Page> &pages = cache->getPages();
+        REQUIRE(pages.size() == 1);
+        REQUIRE(pages[0].name == "atlas_test_image1.png");
+        REQUIRE(pages[0].width == 64);
+        REQUIRE(pages[0].height == 32);
+        REQUIRE(pages[0].items.size() == 2);
+        const AtlasCache::Item &item = pages[0].items[1];
+        REQUIRE(item.name == "image 2.png|W:#ff0000");
+        REQUIRE(item.x == 32);
+        REQUIRE(item.y == 0);
+        REQUIRE(item.width == 16);
+        REQUIRE(item.height == 8);
+        REQUIRE(cache->getPageFileName(0) == "./atlascache/test_0.png");
+        delete cache;
+    }
+
+    SECTION("other key")
+    {
+        cache = new AtlasCache("test", 124U);
+        REQUIRE(cache->load() == false);
+        REQUIRE(cache->getPages().empty());
+        delete cache;
+    }
+
+    ::remove(layoutName.c_str());
+    ::remove("./atlascache");
+    settings.localDataDir = oldDir;
+}
+
+TEST_CASE("AtlasCache key", "")
+{
+    StringVect files;
+    files.push_back("image1.png");
+    files.push_back("image2.png");
+    const unsigned int key = AtlasCache::calcKey("test", files, 1024, true);
+    REQUIRE(key == AtlasCache::calcKey("test", files, 1024, true));
+    REQUIRE(key != AtlasCache::calcKey("test2", files, 1024, true));
+    REQUIRE(key != AtlasCache::calcKey("test", files, 2048, true));
+    REQUIRE(key != AtlasCache::calcKey("test", files, 1024, false));
+    files.push_back("image3.png");
+    REQUIRE(key != AtlasCache::calcKey("test", files, 1024, true));
+}
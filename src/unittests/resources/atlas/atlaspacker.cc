@@ -0,0 +1,105 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "resources/atlas/atlaspacker.h"
+
+#include "debug.h"
+
+namespace
+{
+    bool isOverlap(const Rect &rect1,
+                   const Rect &rect2)
+    {
+        return rect1.x < rect2.x + rect2.width &&
+            rect2.x < rect1.x + rect1.width &&
+            rect1.y < rect2.y + rect2.height &&
+            rect2.y < rect1.y + rect1.height;
+    }
+}  // namespace
+
+TEST_CASE("AtlasPacker insert", "")
+{
+    AtlasPacker packer(64, 64);
+    int x = -1;
+    int y = -1;
+    REQUIRE(packer.insert(32, 16, x, y) == true);
+    REQUIRE(x == 0);
+    REQUIRE(y == 0);
+    REQUIRE(packer.insert(32, 16, x, y) == true);
+    REQUIRE(x == 32);
+    REQUIRE(y == 0);
+    REQUIRE(packer.insert(16, 16, x, y) == true);
+    REQUIRE(x == 0);
+    REQUIRE(y == 16);
+    REQUIRE(packer.getUsedWidth() == 64);
+    REQUIRE(packer.getUsedHeight() == 32);
+    REQUIRE(packer.getUsedArea() == 32 * 16 * 2 + 16 * 16);
+
+    REQUIRE(packer.insert(65, 1, x, y) == false);
+    REQUIRE(packer.insert(1, 65, x, y) == false);
+    REQUIRE(packer.insert(0, 10, x, y) == false);
+}
+
+TEST_CASE("AtlasPacker full", "")
+{
+    AtlasPacker packer(64, 64);
+    int x = 0;
+    int y = 0;
+    for (int f = 0; f < 16; f ++)
+        REQUIRE(packer.insert(16, 16, x, y) == true);
+    REQUIRE(packer.insert(1, 1, x, y) == false);
+    REQUIRE(packer.getUsedArea() == 64 * 64);
+
+    AtlasPacker packer2(0, 0);
+    REQUIRE(packer2.insert(1, 1, x, y) == false);
+}
+
+TEST_CASE("AtlasPacker no overlaps", "")
+{
+    AtlasPacker packer(256, 256);
+    STD_VECTOR<Rect> rects;
+    // sizes sorted by height, like atlas manager do
+    for (int h = 40; h > 0; h -= 3)
+    {
+        for (int w = 5; w < 60; w += 11)
+        {
+            int x = 0;
+            int y = 0;
+            if (packer.insert(w, h, x, y))
+                rects.push_back(Rect(x, y, w, h));
+        }
+    }
+    REQUIRE(rects.size() > 0);
+    int area = 0;
+    for (size_t f = 0; f < rects.size(); f ++)
+    {
+        const Rect &rect = rects[f];
+        REQUIRE(rect.x >= 0);
+        REQUIRE(rect.y >= 0);
+        REQUIRE(rect.x + rect.width <= 256);
+        REQUIRE(rect.y + rect.height <= 256);
+        for (size_t k = f + 1; k < rects.size(); k ++)
+            REQUIRE(isOverlap(rect, rects[k]) == false);
+        area += rect.width * rect.height;
+    }
+    REQUIRE(packer.getUsedArea() == area);
+}
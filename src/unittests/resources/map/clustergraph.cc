@@ -0,0 +1,163 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "enums/resources/map/blockmask.h"
+
+#include "resources/map/clustergraph.h"
+#include "resources/map/metatile.h"
+
+#include "debug.h"
+
+static const unsigned char blockWalkMask = BlockMask::WALL |
+    BlockMask::AIR |
+    BlockMask::WATER;
+
+TEST_CASE("ClusterGraph findPath", "")
+{
+    const int width = 64;
+    const int height = 40;
+    MetaTile *const tiles = new MetaTile[width * height];
+    ClusterGraph *const graph = new ClusterGraph(width,
+        height,
+        blockWalkMask);
+    STD_VECTOR<Position> waypoints;
+
+    SECTION("empty map")
+    {
+        graph->build(tiles);
+        REQUIRE(graph->isValid());
+        REQUIRE(graph->getNodesCount() > 0);
+        REQUIRE(graph->findPath(tiles, 1, 1, 60, 35, waypoints));
+        REQUIRE(!waypoints.empty());
+        REQUIRE(waypoints.back().x == 60);
+        REQUIRE(waypoints.back().y == 35);
+    }
+
+    SECTION("wall with door")
+    {
+        for (int y = 0; y < height; y ++)
+        {
+            if (y != 30)
+                tiles[32 + y * width].blockmask = BlockMask::WALL;
+        }
+        graph->build(tiles);
+        REQUIRE(graph->findPath(tiles, 1, 1, 60, 1, waypoints));
+        bool door = false;
+        for (size_t f = 0; f < waypoints.size(); f ++)
+        {
+            if (waypoints[f].x == 32 && waypoints[f].y == 30)
+                door = true;
+        }
+        REQUIRE(door == true);
+    }
+
+    SECTION("closed wall")
+    {
+        for (int y = 0; y < height; y ++)
+            tiles[32 + y * width].blockmask = BlockMask::WATER;
+        graph->build(tiles);
+        REQUIRE(graph->findPath(tiles, 1, 1, 60, 1, waypoints) == false);
+        REQUIRE(graph->findPath(tiles, 1, 1, 20, 30, waypoints) == true);
+    }
+
+    SECTION("not blocking mask")
+    {
+        for (int y = 0; y < height; y ++)
+            tiles[32 + y * width].blockmask = BlockMask::PLAYERWALL;
+        graph->build(tiles);
+        REQUIRE(graph->findPath(tiles, 1, 1, 60, 1, waypoints));
+    }
+
+    delete graph;
+    delete [] tiles;
+}
+
+TEST_CASE("ClusterGraph update", "")
+{
+    const int width = 64;
+    const int height = 40;
+    MetaTile *const tiles = new MetaTile[width * height];
+    ClusterGraph *const graph = new ClusterGraph(width,
+        height,
+        blockWalkMask);
+    STD_VECTOR<Position> waypoints;
+
+    SECTION("build on first update")
+    {
+        REQUIRE(graph->isValid() == false);
+        graph->update(tiles);
+        REQUIRE(graph->isValid());
+        REQUIRE(graph->findPath(tiles, 1, 1, 60, 35, waypoints));
+    }
+
+    SECTION("changed tiles")
+    {
+        graph->update(tiles);
+        for (int y = 0; y < height; y ++)
+        {
+            tiles[32 + y * width].blockmask = BlockMask::WALL;
+            graph->updateTile(32, y);
+        }
+        graph->update(tiles);
+        REQUIRE(graph->findPath(tiles, 1, 1, 60, 1, waypoints) == false);
+
+        tiles[32 + 30 * width].blockmask = 0;
+        graph->updateTile(32, 30);
+        graph->update(tiles);
+        REQUIRE(graph->findPath(tiles, 1, 1, 60, 1, waypoints));
+        bool door = false;
+        for (size_t f = 0; f < waypoints.size(); f ++)
+        {
+            if (waypoints[f].x == 32 && waypoints[f].y == 30)
+                door = true;
+        }
+        REQUIRE(door == true);
+
+        tiles[32 + 30 * width].blockmask = BlockMask::WALL;
+        tiles[32 + 5 * width].blockmask = 0;
+        graph->updateTile(32, 30);
+        graph->updateTile(32, 5);
+        graph->update(tiles);
+        REQUIRE(graph->findPath(tiles, 1, 1, 60, 1, waypoints));
+        door = false;
+        for (size_t f = 0; f < waypoints.size(); f ++)
+        {
+            if (waypoints[f].x == 32 && waypoints[f].y == 5)
+                door = true;
+        }
+        REQUIRE(door == true);
+
+        // same result as fully built graph
+        ClusterGraph *const graph2 = new ClusterGraph(width,
+            height,
+            blockWalkMask);
+        graph2->build(tiles);
+        STD_VECTOR<Position> waypoints2;
+        REQUIRE(graph2->findPath(tiles, 3, 38, 50, 20, waypoints2));
+        REQUIRE(graph->findPath(tiles, 3, 38, 50, 20, waypoints));
+        REQUIRE(waypoints.size() == waypoints2.size());
+        delete graph2;
+    }
+
+    delete graph;
+    delete [] tiles;
+}
@@ -0,0 +1,130 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "unittests/unittests.h"
+
+#include "configmanager.h"
+#include "configuration.h"
+#include "dirs.h"
+
+#include "enums/resources/map/blockmask.h"
+
+#include "resources/map/map.h"
+
+#include "utils/foreach.h"
+
+#include "debug.h"
+
+static const unsigned char blockWalkMask = BlockMask::WALL |
+    BlockMask::AIR |
+    BlockMask::WATER;
+
+TEST_CASE("Map findPath", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    ConfigManager::initConfiguration();
+    config.setValue("enableHierarchicalPath", false);
+
+    Map *const map = new Map("map",
+        40, 40,
+        32, 32);
+    Path path;
+
+    SECTION("empty map")
+    {
+        for (int f = 0; f < 2; f ++)
+        {
+            config.setValue("enableJumpPointSearch", f == 1);
+            map->findPath(path, 1, 1, 30, 20, blockWalkMask, 0);
+            REQUIRE(path.size() == 29);
+            REQUIRE(path.back().x == 30);
+            REQUIRE(path.back().y == 20);
+            REQUIRE(map->getPathNodes() > 0);
+        }
+    }
+
+    SECTION("wall with door")
+    {
+        for (int y = 0; y < 40; y ++)
+        {
+            if (y != 35)
+                map->addBlockMask(20, y, BlockType::WALL);
+        }
+        for (int f = 0; f < 2; f ++)
+        {
+            config.setValue("enableJumpPointSearch", f == 1);
+            map->findPath(path, 1, 1, 30, 1, blockWalkMask, 0);
+            REQUIRE(!path.empty());
+            bool door = false;
+            FOR_EACH (Path::const_iterator, it, path)
+            {
+                REQUIRE(((*it).x != 20 || (*it).y == 35));
+                if ((*it).x == 20)
+                    door = true;
+            }
+            REQUIRE(door == true);
+            REQUIRE(path.back().x == 30);
+            REQUIRE(path.back().y == 1);
+        }
+    }
+
+    SECTION("corner")
+    {
+        map->addBlockMask(6, 5, BlockType::WATER);
+        for (int f = 0; f < 2; f ++)
+        {
+            config.setValue("enableJumpPointSearch", f == 1);
+            map->findPath(path, 5, 5, 6, 6, blockWalkMask, 0);
+            REQUIRE(path.size() == 2);
+            REQUIRE(path.front().x == 5);
+            REQUIRE(path.front().y == 6);
+        }
+    }
+
+    SECTION("max cost")
+    {
+        for (int f = 0; f < 2; f ++)
+        {
+            config.setValue("enableJumpPointSearch", f == 1);
+            map->findPath(path, 1, 1, 30, 1, blockWalkMask, 5);
+            REQUIRE(path.empty());
+            map->findPath(path, 1, 1, 5, 1, blockWalkMask, 5);
+            REQUIRE(path.size() == 4);
+        }
+    }
+
+    SECTION("not walkable destination")
+    {
+        map->addBlockMask(10, 10, BlockType::WALL);
+        for (int f = 0; f < 2; f ++)
+        {
+            config.setValue("enableJumpPointSearch", f == 1);
+            map->findPath(path, 1, 1, 10, 10, blockWalkMask, 0);
+            REQUIRE(path.empty());
+        }
+    }
+
+    config.setValue("enableJumpPointSearch", true);
+    config.setValue("enableHierarchicalPath", true);
+    delete map;
+}
@@ -0,0 +1,277 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "settings.h"
+
+#include "fs/mkdir.h"
+
+#include "fs/virtfs/fs.h"
+
+#include "resources/map/mapcache.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "debug.h"
+
+namespace
+{
+    std::string readFile(const std::string &name)
+    {
+        std::ifstream in(name.c_str(), std::ios::in | std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string &name,
+                   const std::string &data)
+    {
+        std::ofstream out(name.c_str(), std::ios::out | std::ios::binary);
+        out.write(data.c_str(), data.size());
+    }
+}  // namespace
+
+TEST_CASE("MapCache save and load", "")
+{
+    const std::string oldDir = settings.localDataDir;
+    settings.localDataDir = "mapcachetest";
+    mkdir_r("mapcachetest");
+    writeFile("mapcachetest/test.tmx", "<map></map>");
+    writeFile("mapcachetest/test.tsx", "<tileset></tileset>");
+    VirtFs::mountDirSilent("mapcachetest", Append_false);
+    const std::string name = MapCache::getFileName("test.tmx");
+    ::remove(name.c_str());
+
+    MapCache *cache = new MapCache("test.tmx");
+    REQUIRE(cache->isCacheable() == true);
+    REQUIRE(cache->load() == false);
+    REQUIRE(cache->isLoaded() == false);
+    // tilesets added while map compiled
+    cache->addSource("test.tsx");
+    REQUIRE(cache->isCacheable() == true);
+    cache->setSize(40, 30, 32, 32);
+    MapCacheProperties &props = cache->addProperties();
+    props.push_back(MapCacheProperty("name", "test map"));
+    props.push_back(MapCacheProperty("manaplus version", "2"));
+    MapCacheTileset &tileset = cache->addTileset();
+    tileset.image = "graphics/tiles/test.png";
+    tileset.imageName = "../graphics/tiles/test.png";
+    tileset.firstGid = 1;
+    tileset.tileWidth = 32;
+    tileset.tileHeight = 64;
+    tileset.properties.push_back(MapCacheProperty("abc", ""));
+    tileset.animations.push_back(MapCacheAnimation());
+    tileset.animations.back().gid = 5;
+    tileset.animations.back().frames.push_back(MapCacheFrame(3, 10));
+    tileset.animations.back().frames.push_back(MapCacheFrame(4, 20));
+    MapCacheLayer &layer = cache->addLayer();
+    layer.name = "ground";
+    layer.width = 40;
+    layer.height = 30;
+    layer.haveData = true;
+    for (int f = 0; f < 40 * 30; f ++)
+        layer.tiles.push_back(f * 3);
+    MapCacheLayer &layer2 = cache->addLayer();
+    layer2.name = "collision";
+    layer2.properties.push_back(MapCacheProperty("Hidden", "1"));
+    MapCacheObject &object = cache->addObject();
+    object.type = "WARP";
+    object.name = "001-1";
+    object.destination = "001-2";
+    object.x = 10;
+    object.y = 20;
+    object.width = 32;
+    object.height = 64;
+    REQUIRE(cache->save() == true);
+    delete cache;
+
+    SECTION("same source")
+    {
+        cache = new MapCache("test.tmx");
+        REQUIRE(cache->load() == true);
+        REQUIRE(cache->isLoaded() == true);
+        REQUIRE(cache->getWidth() == 40);
+        REQUIRE(cache->getHeight() == 30);
+        REQUIRE(cache->getTileWidth() == 32);
+        REQUIRE(cache->getTileHeight() == 32);
+
+        const STD_VECTOR<MapCache::Entry> &entries = cache->getEntries();
+        REQUIRE(entries.size() == 5);
+        REQUIRE(entries[0].type == MapCache::ENTRY_PROPERTIES);
+        REQUIRE(entries[1].type == MapCache::ENTRY_TILESET);
+        REQUIRE(entries[2].type == MapCache::ENTRY_LAYER);
+        REQUIRE(entries[2].index == 0);
+        REQUIRE(entries[3].type == MapCache::ENTRY_LAYER);
+        REQUIRE(entries[3].index == 1);
+        REQUIRE(entries[4].type == MapCache::ENTRY_OBJECT);
+
+        REQUIRE(cache->getProperties().size() == 1);
+        REQUIRE(cache->getProperties()[0].size() == 2);
+        REQUIRE(cache->getProperties()[0][0].first == "name");
+        REQUIRE(cache->getProperties()[0][0].second == "test map");
+        REQUIRE(cache->getProperties()[0][1].second == "2");
+
+        REQUIRE(cache->getTilesets().size() == 1);
+        const MapCacheTileset &tileset2 = cache->getTilesets()[0];
+        REQUIRE(tileset2.image == "graphics/tiles/test.png");
+        REQUIRE(tileset2.imageName == "../graphics/tiles/test.png");
+        REQUIRE(tileset2.source.empty());
+        REQUIRE(tileset2.firstGid == 1);
+        REQUIRE(tileset2.tileHeight == 64);
+        REQUIRE(tileset2.valid == true);
+        REQUIRE(tileset2.properties.size() == 1);
+        REQUIRE(tileset2.properties[0].first == "abc");
+        REQUIRE(tileset2.properties[0].second.empty());
+        REQUIRE(tileset2.animations.size() == 1);
+        REQUIRE(tileset2.animations[0].gid == 5);
+        REQUIRE(tileset2.animations[0].fromProperties == false);
+        REQUIRE(tileset2.animations[0].frames.size() == 2);
+        REQUIRE(tileset2.animations[0].frames[1].tile == 4);
+        REQUIRE(tileset2.animations[0].frames[1].delay == 20);
+
+        REQUIRE(cache->getLayers().size() == 2);
+        const MapCacheLayer &layer3 = cache->getLayers()[0];
+        REQUIRE(layer3.name == "ground");
+        REQUIRE(layer3.haveData == true);
+        REQUIRE(layer3.getTilesSize() == 40 * 30);
+        REQUIRE(layer3.tiles.empty());
+        const int *const tiles = layer3.getTiles();
+        for (int f = 0; f < 40 * 30; f ++)
+            REQUIRE(tiles[f] == f * 3);
+        const MapCacheLayer &layer4 = cache->getLayers()[1];
+        REQUIRE(layer4.name == "collision");
+        REQUIRE(layer4.haveData == false);
+        REQUIRE(layer4.getTilesSize() == 0);
+        REQUIRE(layer4.getTiles() == nullptr);
+        REQUIRE(layer4.properties.size() == 1);
+        REQUIRE(layer4.properties[0].second == "1");
+
+        REQUIRE(cache->getObjects().size() == 1);
+        const MapCacheObject &object2 = cache->getObjects()[0];
+        REQUIRE(object2.type == "WARP");
+        REQUIRE(object2.name == "001-1");
+        REQUIRE(object2.destination == "001-2");
+        REQUIRE(object2.x == 10);
+        REQUIRE(object2.y == 20);
+        REQUIRE(object2.width == 32);
+        REQUIRE(object2.height == 64);
+        delete cache;
+    }
+
+    SECTION("changed map")
+    {
+        writeFile("mapcachetest/test.tmx", "<map> </map>");
+        cache = new MapCache("test.tmx");
+        REQUIRE(cache->load() == false);
+        REQUIRE(cache->isLoaded() == false);
+        REQUIRE(cache->getEntries().empty());
+        delete cache;
+    }
+
+    SECTION("changed tileset")
+    {
+        writeFile("mapcachetest/test.tsx", "<tileset> </tileset>");
+        cache = new MapCache("test.tmx");
+        REQUIRE(cache->load() == false);
+        REQUIRE(cache->getLayers().empty());
+        delete cache;
+    }
+
+    SECTION("missing tileset")
+    {
+        ::remove("mapcachetest/test.tsx");
+        cache = new MapCache("test.tmx");
+        REQUIRE(cache->load() == false);
+        delete cache;
+    }
+
+    SECTION("truncated file")
+    {
+        std::string data = readFile(name);
+        REQUIRE(data.size() > 8);
+        data.resize(data.size() - 8);
+        writeFile(name, data);
+        cache = new MapCache("test.tmx");
+        REQUIRE(cache->load() == false);
+        REQUIRE(cache->getEntries().empty());
+        REQUIRE(cache->getLayers().empty());
+        delete cache;
+    }
+
+    SECTION("changed data")
+    {
+        std::string data = readFile(name);
+        // byte inside of ground layer tiles, file size not changed
+        data[data.size() / 2] ^= 1;
+        writeFile(name, data);
+        cache = new MapCache("test.tmx");
+        REQUIRE(cache->load() == false);
+        REQUIRE(cache->getLayers().empty());
+        delete cache;
+    }
+
+    ::remove(name.c_str());
+    ::remove("mapcachetest/test.tmx");
+    ::remove("mapcachetest/test.tsx");
+    ::remove("mapcachetest/mapcache");
+    ::remove("mapcachetest");
+    VirtFs::unmountDirSilent("mapcachetest");
+    settings.localDataDir = oldDir;
+}
+
+TEST_CASE("MapCache sources", "")
+{
+    mkdir_r("mapcachetest");
+    mkdir_r("mapcachetest2");
+    writeFile("mapcachetest/test.tmx", "<map></map>");
+    writeFile("mapcachetest2/test.tmx", "<map></map>");
+
+    SECTION("missing source")
+    {
+        VirtFs::mountDirSilent("mapcachetest", Append_false);
+        MapCache *cache = new MapCache("missing.tmx");
+        REQUIRE(cache->isCacheable() == false);
+        delete cache;
+        cache = new MapCache("test.tmx");
+        REQUIRE(cache->isCacheable() == true);
+        cache->addSource("missing.tsx");
+        REQUIRE(cache->isCacheable() == false);
+        REQUIRE(cache->save() == false);
+        delete cache;
+        VirtFs::unmountDirSilent("mapcachetest");
+    }
+
+    SECTION("other data dir")
+    {
+        VirtFs::mountDirSilent("mapcachetest", Append_false);
+        const std::string name = MapCache::getFileName("test.tmx");
+        VirtFs::unmountDirSilent("mapcachetest");
+        VirtFs::mountDirSilent("mapcachetest2", Append_false);
+        REQUIRE(MapCache::getFileName("test.tmx") != name);
+        VirtFs::unmountDirSilent("mapcachetest2");
+    }
+
+    ::remove("mapcachetest/test.tmx");
+    ::remove("mapcachetest2/test.tmx");
+    ::remove("mapcachetest");
+    ::remove("mapcachetest2");
+}
@@ -0,0 +1,103 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "enums/resources/map/blockmask.h"
+
+#include "resources/map/metatile.h"
+#include "resources/map/walklayer.h"
+
+#include "debug.h"
+
+static const unsigned char blockWalkMask = BlockMask::WALL |
+    BlockMask::AIR |
+    BlockMask::WATER;
+
+TEST_CASE("WalkLayer updateTile", "")
+{
+    const int width = 10;
+    const int height = 10;
+    MetaTile *const tiles = new MetaTile[width * height];
+    WalkLayer *const walk = new WalkLayer(width,
+        height,
+        blockWalkMask);
+    int *const data = walk->getData();
+    for (int f = 0; f < width * height; f ++)
+        data[f] = 1;
+    walk->calcAreaSizes();
+
+    // wall in column 5 with door at row 3
+    for (int y = 0; y < height; y ++)
+    {
+        if (y == 3)
+            continue;
+        tiles[5 + y * width].blockmask = BlockMask::WALL;
+        walk->updateTile(tiles, 5, y);
+        REQUIRE(walk->getDataAt(5, y) < 0);
+    }
+    REQUIRE(walk->getDataAt(0, 0) > 0);
+    REQUIRE(walk->getDataAt(0, 0) == walk->getDataAt(9, 9));
+
+    SECTION("split")
+    {
+        tiles[5 + 3 * width].blockmask = BlockMask::WATER;
+        walk->updateTile(tiles, 5, 3);
+        REQUIRE(walk->getDataAt(0, 0) > 0);
+        REQUIRE(walk->getDataAt(9, 9) > 0);
+        REQUIRE(walk->getDataAt(0, 0) != walk->getDataAt(9, 9));
+        REQUIRE(walk->getDataAt(0, 9) == walk->getDataAt(4, 0));
+        REQUIRE(walk->getDataAt(6, 0) == walk->getDataAt(9, 9));
+        REQUIRE(walk->getDataAt(5, 3) < 0);
+
+        SECTION("merge")
+        {
+            tiles[5 + 7 * width].blockmask = BlockMask::GROUND;
+            walk->updateTile(tiles, 5, 7);
+            REQUIRE(walk->getDataAt(5, 7) > 0);
+            REQUIRE(walk->getDataAt(0, 0) == walk->getDataAt(9, 9));
+            REQUIRE(walk->getDataAt(5, 0) == -walk->getDataAt(0, 0));
+        }
+    }
+
+    SECTION("not blocking mask")
+    {
+        tiles[5 + 3 * width].blockmask = BlockMask::PLAYERWALL;
+        walk->updateTile(tiles, 5, 3);
+        REQUIRE(walk->getDataAt(0, 0) == walk->getDataAt(9, 9));
+    }
+
+    SECTION("enclosed tile")
+    {
+        tiles[1].blockmask = BlockMask::WALL;
+        walk->updateTile(tiles, 1, 0);
+        tiles[width].blockmask = BlockMask::WALL;
+        walk->updateTile(tiles, 0, 1);
+        REQUIRE(walk->getDataAt(0, 0) > 0);
+        REQUIRE(walk->getDataAt(0, 0) != walk->getDataAt(2, 0));
+        tiles[0].blockmask = BlockMask::WALL;
+        walk->updateTile(tiles, 0, 0);
+        REQUIRE(walk->getDataAt(0, 0) == 0);
+        REQUIRE(walk->getDataAt(1, 0) == -walk->getDataAt(2, 0));
+    }
+
+    delete walk;
+    delete [] tiles;
+}
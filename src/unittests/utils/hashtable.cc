@@ -0,0 +1,116 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "utils/hashtable.h"
+
+#include <map>
+
+#include "debug.h"
+
+namespace
+{
+    // all keys in same chain, to test probing and deletion
+    struct BadHash final
+    {
+        unsigned int operator()(const int key A_UNUSED) const
+        {
+            return 5U;
+        }
+    };
+}  // namespace
+
+TEST_CASE("HashTable insert", "")
+{
+    HashTable<int, int, IntHash> table;
+    REQUIRE(table.empty());
+    REQUIRE(table.find(1) == nullptr);
+
+    table.insert(1) = 10;
+    table.insert(2) = 20;
+    REQUIRE(table.size() == 2);
+    REQUIRE(*table.find(1) == 10);
+    REQUIRE(*table.find(2) == 20);
+    REQUIRE(table.find(3) == nullptr);
+
+    // existing key keeps value
+    REQUIRE(table.insert(1) == 10);
+    REQUIRE(table.size() == 2);
+}
+
+TEST_CASE("HashTable erase", "")
+{
+    HashTable<int, int, BadHash> table;
+    for (int f = 0; f < 10; f ++)
+        table.insert(f) = f * 10;
+    REQUIRE(table.size() == 10);
+
+    REQUIRE(table.erase(3));
+    REQUIRE_FALSE(table.erase(3));
+    REQUIRE(table.erase(0));
+    REQUIRE(table.size() == 8);
+    for (int f = 0; f < 10; f ++)
+    {
+        if (f == 0 || f == 3)
+        {
+            REQUIRE(table.find(f) == nullptr);
+        }
+        else
+        {
+            REQUIRE(table.find(f) != nullptr);
+            REQUIRE(*table.find(f) == f * 10);
+        }
+    }
+
+    table.clear();
+    REQUIRE(table.empty());
+    REQUIRE(table.find(1) == nullptr);
+}
+
+TEST_CASE("HashTable many", "")
+{
+    HashTable<STD_VECTOR<int>, int, IntVectorHash> table;
+    std::map<STD_VECTOR<int>, int> check;
+    STD_VECTOR<int> key(2, 0);
+    for (int f = 0; f < 2000; f ++)
+    {
+        key[0] = (f * 7919) % 1000;
+        key[1] = f % 3;
+        if (f % 5 == 0)
+        {
+            table.erase(key);
+            check.erase(key);
+        }
+        else
+        {
+            table.insert(key) = f;
+            check[key] = f;
+        }
+    }
+    REQUIRE(table.size() == CAST_S32(check.size()));
+    for (std::map<STD_VECTOR<int>, int>::const_iterator it = check.begin(),
+         it_end = check.end(); it != it_end; ++ it)
+    {
+        const int *const value = table.find((*it).first);
+        REQUIRE(value != nullptr);
+        REQUIRE(*value == (*it).second);
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "utils/lrucache.h"
+#include "utils/vector.h"
+
+#include <string>
+
+#include "debug.h"
+
+TEST_CASE("LruCache get", "")
+{
+    LruCache<int, std::string, IntHash> cache(3);
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.get(1) == nullptr);
+    REQUIRE(cache.getMisses() == 1);
+
+    std::string *const value = cache.add(1);
+    REQUIRE(value != nullptr);
+    REQUIRE(value->empty());
+    *value = "test";
+    REQUIRE(cache.size() == 1);
+
+    REQUIRE(cache.get(1) == value);
+    REQUIRE(*cache.get(1) == "test");
+    REQUIRE(cache.get(2) == nullptr);
+    REQUIRE(cache.getHits() == 2);
+    REQUIRE(cache.getMisses() == 2);
+
+    // adding existing key keeps value
+    REQUIRE(cache.add(1) == value);
+    REQUIRE(*value == "test");
+    REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("LruCache lru", "")
+{
+    LruCache<int, int, IntHash> cache(3);
+    *cache.add(1) = 10;
+    *cache.add(2) = 20;
+    *cache.add(3) = 30;
+    REQUIRE(cache.get(1) != nullptr);
+    REQUIRE(cache.add(4) != nullptr);
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.get(2) == nullptr);
+    REQUIRE(*cache.get(1) == 10);
+    REQUIRE(*cache.get(3) == 30);
+    REQUIRE(cache.get(4) != nullptr);
+    *cache.get(4) = 40;
+
+    // order is from newest to oldest
+    LruCache<int, int, IntHash>::iterator it = cache.begin();
+    REQUIRE((*it).key == 4);
+    ++ it;
+    REQUIRE((*it).key == 3);
+    ++ it;
+    REQUIRE((*it).key == 1);
+    ++ it;
+    REQUIRE(it == cache.end());
+
+    const LruCache<int, int, IntHash> &constCache = cache;
+    LruCache<int, int, IntHash>::const_iterator constIt = constCache.begin();
+    REQUIRE((*constIt).key == 4);
+    REQUIRE((*constIt).value == 40);
+}
+
+TEST_CASE("LruCache reuse", "")
+{
+    LruCache<int, int, IntHash> cache(1);
+    *cache.add(1) = 10;
+    // oldest entry reused with its value
+    int *const value = cache.add(2);
+    REQUIRE(value != nullptr);
+    REQUIRE(*value == 10);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.get(1) == nullptr);
+    REQUIRE(cache.get(2) == value);
+
+    LruCache<int, int, IntHash> empty(0);
+    REQUIRE(empty.add(1) == nullptr);
+    REQUIRE(empty.size() == 0);
+}
+
+TEST_CASE("LruCache many", "")
+{
+    LruCache<STD_VECTOR<int>, int, IntVectorHash> cache(50);
+    STD_VECTOR<int> key(3, 0);
+    for (int f = 0; f < 1000; f ++)
+    {
+        key[0] = f;
+        key[2] = f % 10;
+        int *const value = cache.add(key);
+        REQUIRE(value != nullptr);
+        *value = f;
+    }
+    REQUIRE(cache.size() == 50);
+    for (int f = 0; f < 1000; f ++)
+    {
+        key[0] = f;
+        key[2] = f % 10;
+        const int *const value = cache.get(key);
+        if (f < 950)
+        {
+            REQUIRE(value == nullptr);
+        }
+        else
+        {
+            REQUIRE(value != nullptr);
+            REQUIRE(*value == f);
+        }
+    }
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.get(key) == nullptr);
+}
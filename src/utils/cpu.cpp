@@ -34,6 +34,8 @@
 
 #ifdef USE_SDL2
 #include <SDL_cpuinfo.h>
+#elif defined(__linux__) || defined(__linux) || defined(__APPLE__)
+#include <unistd.h>
 #endif  // USE_SDL2
 
 #include "debug.h"
@@ -177,3 +179,16 @@ uint32_t Cpu::getFlags()
 {
     return mCpuFlags;
 }
+
+int Cpu::getCoresCount()
+{
+#ifdef USE_SDL2
+    return SDL_GetCPUCount();
+#elif defined(__linux__) || defined(__linux) || defined(__APPLE__)
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<int>(count) : 1;
+#else  // USE_SDL2
+
+    return 1;
+#endif  // USE_SDL2
+}
@@ -44,6 +44,8 @@ namespace Cpu
     void printFlags();
 
     uint32_t getFlags();
+
+    int getCoresCount();
 }  // namespace Cpu
 
 #endif  // UTILS_CPU_H
@@ -0,0 +1,249 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_HASHTABLE_H
+#define UTILS_HASHTABLE_H
+
+#include "utils/cast.h"
+#include "utils/vector.h"
+
+#include <algorithm>
+
+#include "localconsts.h"
+
+/**
+ * Hash of int or int based enum key, like BeingId.
+ */
+struct IntHash final
+{
+    template<typename T>
+    unsigned int operator()(const T key) const
+    {
+        unsigned int hash = static_cast<unsigned int>(key);
+        hash ^= hash >> 16;
+        hash *= 0x45d9f3bU;
+        hash ^= hash >> 16;
+        return hash;
+    }
+};
+
+/**
+ * Hash of list of ints key.
+ */
+struct IntVectorHash final
+{
+    unsigned int operator()(const STD_VECTOR<int> &key) const
+    {
+        // FNV-1a by ints
+        unsigned int hash = 2166136261U;
+        for (STD_VECTOR<int>::const_iterator it = key.begin(),
+             it_end = key.end(); it != it_end; ++ it)
+        {
+            hash ^= CAST_U32(*it);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+};
+
+/**
+ * Map from key to value in open addressing hash table.
+ *
+ * Hash is functor what returns unsigned int for key. Table size is
+ * power of two and kept at least twice bigger than number of entries.
+ * Pointers to values invalidated by insert and erase.
+ */
+template<typename Key, typename Value, typename Hash>
+class HashTable final
+{
+    public:
+        HashTable() :
+            mSlots(minSize),
+            mSize(0)
+        {
+        }
+
+        A_DELETE_COPY(HashTable)
+
+        /**
+         * Returns value for key or nullptr.
+         */
+        Value *find(const Key &key) A_WARN_UNUSED
+        {
+            const int index = findIndex(key, Hash()(key));
+            if (index < 0)
+                return nullptr;
+            return &mSlots[index].value;
+        }
+
+        const Value *find(const Key &key) const A_WARN_UNUSED
+        {
+            const int index = findIndex(key, Hash()(key));
+            if (index < 0)
+                return nullptr;
+            return &mSlots[index].value;
+        }
+
+        /**
+         * Returns value for key, adds default value if key not found.
+         */
+        Value &insert(const Key &key)
+        {
+            const unsigned int hash = Hash()(key);
+            int index = findIndex(key, hash);
+            if (index >= 0)
+                return mSlots[index].value;
+
+            // keep load factor below half
+            if ((mSize + 1) * 2 > CAST_S32(mSlots.size()))
+                resize(CAST_S32(mSlots.size()) * 2);
+            index = findFreeIndex(hash);
+            Slot &slot = mSlots[index];
+            slot.key = key;
+            slot.value = Value();
+            slot.hash = hash;
+            slot.used = true;
+            mSize ++;
+            return slot.value;
+        }
+
+        /**
+         * Removes key and returns true if key was found.
+         */
+        bool erase(const Key &key)
+        {
+            int index = findIndex(key, Hash()(key));
+            if (index < 0)
+                return false;
+
+            // backward shift deletion, so no tombstones needed
+            const int mask = CAST_S32(mSlots.size()) - 1;
+            int next = (index + 1) & mask;
+            while (mSlots[next].used)
+            {
+                const int home = getHomeIndex(mSlots[next].hash);
+                // move entry if its home position not between hole and entry
+                if (((next - home) & mask) >= ((next - index) & mask))
+                {
+                    moveSlot(mSlots[next], mSlots[index]);
+                    index = next;
+                }
+                next = (next + 1) & mask;
+            }
+            Slot &slot = mSlots[index];
+            slot.key = Key();
+            slot.value = Value();
+            slot.used = false;
+            mSize --;
+            return true;
+        }
+
+        void clear()
+        {
+            STD_VECTOR<Slot> slots(minSize);
+            mSlots.swap(slots);
+            mSize = 0;
+        }
+
+        int size() const noexcept2 A_WARN_UNUSED
+        { return mSize; }
+
+        bool empty() const noexcept2 A_WARN_UNUSED
+        { return mSize == 0; }
+
+    private:
+        // must be power of two
+        static const int minSize = 16;
+
+        struct Slot final
+        {
+            Slot() :
+                key(),
+                value(),
+                hash(0U),
+                used(false)
+            {
+            }
+
+            A_DEFAULT_COPY(Slot)
+
+            Key key;
+            Value value;
+            unsigned int hash;
+            bool used;
+        };
+
+        int getHomeIndex(const unsigned int hash) const A_WARN_UNUSED
+        {
+            return CAST_S32((hash ^ (hash >> 16)) &
+                CAST_U32(mSlots.size() - 1));
+        }
+
+        int findIndex(const Key &key,
+                      const unsigned int hash) const A_WARN_UNUSED
+        {
+            const int mask = CAST_S32(mSlots.size()) - 1;
+            int index = getHomeIndex(hash);
+            while (mSlots[index].used)
+            {
+                const Slot &slot = mSlots[index];
+                if (slot.hash == hash && slot.key == key)
+                    return index;
+                index = (index + 1) & mask;
+            }
+            return -1;
+        }
+
+        int findFreeIndex(const unsigned int hash) const A_WARN_UNUSED
+        {
+            const int mask = CAST_S32(mSlots.size()) - 1;
+            int index = getHomeIndex(hash);
+            while (mSlots[index].used)
+                index = (index + 1) & mask;
+            return index;
+        }
+
+        // swap used instead of copy, so keys with memory not copied
+        static void moveSlot(Slot &from,
+                             Slot &to)
+        {
+            std::swap(from.key, to.key);
+            std::swap(from.value, to.value);
+            to.hash = from.hash;
+            to.used = true;
+        }
+
+        void resize(const int size)
+        {
+            STD_VECTOR<Slot> slots(size);
+            slots.swap(mSlots);
+            for (typename STD_VECTOR<Slot>::iterator it = slots.begin(),
+                 it_end = slots.end(); it != it_end; ++ it)
+            {
+                if ((*it).used)
+                    moveSlot(*it, mSlots[findFreeIndex((*it).hash)]);
+            }
+        }
+
+        STD_VECTOR<Slot> mSlots;
+        int mSize;
+};
+
+#endif  // UTILS_HASHTABLE_H
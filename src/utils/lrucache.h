@@ -0,0 +1,254 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_LRUCACHE_H
+#define UTILS_LRUCACHE_H
+
+#include "utils/hashtable.h"
+
+#include "localconsts.h"
+
+/**
+ * Cache with limited number of entries.
+ *
+ * Entries stored in one array and linked in least recently used order.
+ * Entries found by key in hash table, so get and add take constant time.
+ * Oldest entry reused when cache full.
+ */
+template<typename Key, typename Value, typename Hash>
+class LruCache final
+{
+    public:
+        struct Entry final
+        {
+            Entry() :
+                key(),
+                value(),
+                prev(-1),
+                next(-1)
+            {
+            }
+
+            A_DEFAULT_COPY(Entry)
+
+            Key key;
+            Value value;
+            int prev;
+            int next;
+        };
+
+        /**
+         * Iterates entries from newest to oldest.
+         */
+        template<typename EntryType, typename Entries>
+        class Iterator final
+        {
+            public:
+                Iterator(Entries *const entries,
+                         const int node) :
+                    mEntries(entries),
+                    mNode(node)
+                {
+                }
+
+                A_DEFAULT_COPY(Iterator)
+
+                EntryType &operator*() const
+                { return (*mEntries)[mNode]; }
+
+                EntryType *operator->() const
+                { return &(*mEntries)[mNode]; }
+
+                Iterator &operator++()
+                {
+                    mNode = (*mEntries)[mNode].next;
+                    return *this;
+                }
+
+                bool operator==(const Iterator &it) const
+                { return mNode == it.mNode; }
+
+                bool operator!=(const Iterator &it) const
+                { return mNode != it.mNode; }
+
+            private:
+                Entries *mEntries;
+                int mNode;
+        };
+
+        typedef Iterator<Entry, STD_VECTOR<Entry> > iterator;
+        typedef Iterator<const Entry, const STD_VECTOR<Entry> >
+            const_iterator;
+
+        explicit LruCache(const int capacity) :
+            mEntries(capacity > 0 ? capacity : 0),
+            mKeys(),
+            mHead(-1),
+            mTail(-1),
+            mFree(-1),
+            mSize(0),
+            mHits(0),
+            mMisses(0)
+        {
+            clear();
+        }
+
+        A_DELETE_COPY(LruCache)
+
+        /**
+         * Returns value for key or nullptr, and updates hit and
+         * miss counters.
+         */
+        Value *get(const Key &key) A_WARN_UNUSED
+        {
+            const int *const node = mKeys.find(key);
+            if (node == nullptr)
+            {
+                mMisses ++;
+                return nullptr;
+            }
+            mHits ++;
+            moveToFront(*node);
+            return &mEntries[*node].value;
+        }
+
+        /**
+         * Returns value for key, adds entry if needed.
+         * New entry can hold value of removed oldest entry,
+         * or nullptr returned if capacity is zero.
+         */
+        Value *add(const Key &key) A_WARN_UNUSED
+        {
+            const int *const found = mKeys.find(key);
+            if (found != nullptr)
+            {
+                moveToFront(*found);
+                return &mEntries[*found].value;
+            }
+            if (mEntries.empty())
+                return nullptr;
+
+            int node;
+            if (mFree >= 0)
+            {
+                node = mFree;
+                mFree = mEntries[node].next;
+                mSize ++;
+            }
+            else
+            {
+                // cache full, reuse oldest entry
+                node = mTail;
+                mKeys.erase(mEntries[node].key);
+                unlink(node);
+            }
+            Entry &entry = mEntries[node];
+            entry.key = key;
+            linkFront(node);
+            mKeys.insert(key) = node;
+            return &entry.value;
+        }
+
+        void clear()
+        {
+            const int capacity = CAST_S32(mEntries.size());
+            for (int f = 0; f < capacity; f ++)
+            {
+                Entry &entry = mEntries[f];
+                entry.key = Key();
+                entry.value = Value();
+                entry.prev = -1;
+                entry.next = f + 1 < capacity ? f + 1 : -1;
+            }
+            mFree = capacity > 0 ? 0 : -1;
+            mHead = -1;
+            mTail = -1;
+            mSize = 0;
+            mKeys.clear();
+        }
+
+        iterator begin() A_WARN_UNUSED
+        { return iterator(&mEntries, mHead); }
+
+        iterator end() A_WARN_UNUSED
+        { return iterator(&mEntries, -1); }
+
+        const_iterator begin() const A_WARN_UNUSED
+        { return const_iterator(&mEntries, mHead); }
+
+        const_iterator end() const A_WARN_UNUSED
+        { return const_iterator(&mEntries, -1); }
+
+        int size() const noexcept2 A_WARN_UNUSED
+        { return mSize; }
+
+        int getHits() const noexcept2 A_WARN_UNUSED
+        { return mHits; }
+
+        int getMisses() const noexcept2 A_WARN_UNUSED
+        { return mMisses; }
+
+    private:
+        void unlink(const int node)
+        {
+            Entry &entry = mEntries[node];
+            if (entry.prev >= 0)
+                mEntries[entry.prev].next = entry.next;
+            else
+                mHead = entry.next;
+            if (entry.next >= 0)
+                mEntries[entry.next].prev = entry.prev;
+            else
+                mTail = entry.prev;
+            entry.prev = -1;
+            entry.next = -1;
+        }
+
+        void linkFront(const int node)
+        {
+            Entry &entry = mEntries[node];
+            entry.prev = -1;
+            entry.next = mHead;
+            if (mHead >= 0)
+                mEntries[mHead].prev = node;
+            else
+                mTail = node;
+            mHead = node;
+        }
+
+        void moveToFront(const int node)
+        {
+            if (node == mHead)
+                return;
+            unlink(node);
+            linkFront(node);
+        }
+
+        STD_VECTOR<Entry> mEntries;
+        HashTable<Key, int, Hash> mKeys;
+        int mHead;
+        int mTail;
+        int mFree;
+        int mSize;
+        int mHits;
+        int mMisses;
+};
+
+#endif  // UTILS_LRUCACHE_H
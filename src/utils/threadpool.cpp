@@ -0,0 +1,161 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/threadpool.h"
+
+#include "utils/cpu.h"
+#include "utils/foreach.h"
+#include "utils/sdlhelper.h"
+
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_mutex.h>
+PRAGMA48(GCC diagnostic pop)
+
+#include "debug.h"
+
+ThreadPool::ThreadPool(const int threadsCount) :
+    mThreads(),
+    mMutex(SDL_CreateMutex()),
+    mStartCond(SDL_CreateCond()),
+    mDoneCond(SDL_CreateCond()),
+    mFunc(nullptr),
+    mData(nullptr),
+    mCount(0),
+    mNext(0),
+    mRunning(0),
+    mStop(false)
+{
+    if (mMutex == nullptr ||
+        mStartCond == nullptr ||
+        mDoneCond == nullptr)
+    {
+        return;
+    }
+    for (int f = 0; f < threadsCount; f ++)
+    {
+        SDL_Thread *const thread = SDL::createThread(&workerThread,
+            "pool",
+            this);
+        if (thread == nullptr)
+            break;
+        mThreads.push_back(thread);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    if (mMutex != nullptr)
+    {
+        SDL_mutexP(mMutex);
+        mStop = true;
+        if (mStartCond != nullptr)
+            SDL_CondBroadcast(mStartCond);
+        SDL_mutexV(mMutex);
+    }
+    FOR_EACH (STD_VECTOR<SDL_Thread*>::iterator, it, mThreads)
+        SDL::WaitThread(*it);
+    mThreads.clear();
+    if (mDoneCond != nullptr)
+        SDL_DestroyCond(mDoneCond);
+    if (mStartCond != nullptr)
+        SDL_DestroyCond(mStartCond);
+    if (mMutex != nullptr)
+        SDL_DestroyMutex(mMutex);
+}
+
+void ThreadPool::run(const JobFunc func,
+                     void *const data,
+                     const int count)
+{
+    if (count <= 0)
+        return;
+    if (mThreads.empty() || count == 1)
+    {
+        for (int f = 0; f < count; f ++)
+            func(data, f);
+        return;
+    }
+
+    SDL_mutexP(mMutex);
+    mFunc = func;
+    mData = data;
+    mCount = count;
+    mNext = 0;
+    mRunning = 0;
+    SDL_CondBroadcast(mStartCond);
+    while (mNext < mCount)
+    {
+        const int index = mNext;
+        mNext ++;
+        mRunning ++;
+        SDL_mutexV(mMutex);
+        func(data, index);
+        SDL_mutexP(mMutex);
+        mRunning --;
+    }
+    while (mRunning > 0)
+        SDL_CondWait(mDoneCond, mMutex);
+    mFunc = nullptr;
+    mData = nullptr;
+    mCount = 0;
+    mNext = 0;
+    SDL_mutexV(mMutex);
+}
+
+int ThreadPool::workerThread(void *ptr)
+{
+    ThreadPool *const pool = reinterpret_cast<ThreadPool*>(ptr);
+    if (pool == nullptr)
+        return 0;
+
+    SDL_mutexP(pool->mMutex);
+    while (!pool->mStop)
+    {
+        if (pool->mNext >= pool->mCount)
+        {
+            SDL_CondWait(pool->mStartCond, pool->mMutex);
+            continue;
+        }
+        const int index = pool->mNext;
+        const JobFunc func = pool->mFunc;
+        void *const data = pool->mData;
+        pool->mNext ++;
+        pool->mRunning ++;
+        SDL_mutexV(pool->mMutex);
+
+        func(data, index);
+
+        SDL_mutexP(pool->mMutex);
+        pool->mRunning --;
+        if (pool->mRunning == 0 && pool->mNext >= pool->mCount)
+            SDL_CondSignal(pool->mDoneCond);
+    }
+    SDL_mutexV(pool->mMutex);
+    return 0;
+}
+
+int ThreadPool::getDefaultThreadsCount(const int maxThreads)
+{
+    const int count = Cpu::getCoresCount() - 1;
+    if (count < 0)
+        return 0;
+    return count < maxThreads ? count : maxThreads;
+}
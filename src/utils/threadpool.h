@@ -0,0 +1,83 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2019-2022  Andrei Karas
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_THREADPOOL_H
+#define UTILS_THREADPOOL_H
+
+#include "utils/cast.h"
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+struct SDL_cond;
+struct SDL_mutex;
+struct SDL_Thread;
+
+/**
+ * Fixed set of worker threads for splitting work to independent jobs.
+ * Calling thread takes jobs too, so pool without threads runs all jobs
+ * in place.
+ */
+class ThreadPool final
+{
+    public:
+        typedef void (*JobFunc) (void *const data,
+                                 const int index);
+
+        explicit ThreadPool(const int threadsCount);
+
+        A_DELETE_COPY(ThreadPool)
+
+        ~ThreadPool();
+
+        /**
+         * Calls func for each index from 0 to count - 1.
+         * Returns after all calls finished.
+         */
+        void run(const JobFunc func,
+                 void *const data,
+                 const int count);
+
+        int getThreadsCount() const A_WARN_UNUSED
+        { return CAST_S32(mThreads.size()); }
+
+        /**
+         * Returns worker threads count what will not overload cpu
+         * together with main thread.
+         */
+        static int getDefaultThreadsCount(const int maxThreads)
+                                          A_WARN_UNUSED;
+
+    private:
+        static int workerThread(void *ptr);
+
+        STD_VECTOR<SDL_Thread*> mThreads;
+        SDL_mutex *mMutex;
+        SDL_cond *mStartCond;
+        SDL_cond *mDoneCond;
+        JobFunc mFunc;
+        void *mData;
+        int mCount;
+        int mNext;
+        int mRunning;
+        bool mStop;
+};
+
+#endif  // UTILS_THREADPOOL_H